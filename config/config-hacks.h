@@ -41,3 +41,10 @@
 #include <stdlib.h>
 #define __builtin_trap() abort()
 #endif
+
+/*
+ * GCC before 3.1 cannot prefetch.
+ */
+#if !defined(__GNUC__) || (__GNUC__ < 3) || (__GNUC__ == 3 && __GNUC_MINOR__ == 0)
+#define __builtin_prefetch(addr,rw,locality) ((void)(addr))
+#endif
@@ -128,6 +128,9 @@ typedef struct _methodTrampoline {
 /* Define if generated code uses two operands rather than one */
 #define	TWO_OPERAND
 
+/* Define if loads are not done before the loads ahead of them */
+#define	MD_LOADS_ORDERED
+
 /**/
 /* Slot management information. */
 /**/
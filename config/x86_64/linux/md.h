@@ -28,7 +28,7 @@ extern void init_md(void);
 
 #include "sigcontextinfo.h"
 
-#define SIGNAL_ARGS(sig, scp)           int sig, siginfo_t *sip, ucontext_t *scp
+#define SIGNAL_ARGS(sig, scp)           int sig, siginfo_t *sip UNUSED, ucontext_t *scp
 #define SIGNAL_CONTEXT_POINTER(scp)     ucontext_t *scp
 #define GET_SIGNAL_CONTEXT_POINTER(sc)  (sc)
 #define SIGNAL_PC(scp)                  (GET_PC((*scp)))
@@ -0,0 +1,498 @@
+/*
+ * jvmti.h
+ * Java Virtual Machine Tool Interface, the part Kaffe implements.
+ *
+ * Constants, types and callback signatures follow the JVMTI
+ * specification, and jvmtiEventCallbacks and the function table have
+ * the standard layout, so agents built against another jvmti.h find
+ * each function in its slot.  Slots of functions Kaffe does not
+ * implement are NULL and only declared as pointers here.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#ifndef _KAFFE_JVMTI_H
+#define _KAFFE_JVMTI_H
+
+#include <jni.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* JVMTI version numbers. */
+#define JVMTI_VERSION_1		0x30010000
+#define JVMTI_VERSION_1_0	0x30010000
+#define JVMTI_VERSION_1_1	0x30010100
+#define JVMTI_VERSION_1_2	0x30010200
+#define JVMTI_VERSION_9		0x30090000
+#define JVMTI_VERSION_11	0x300B0000
+
+struct _jvmtiEnv;
+struct jvmtiInterface_1_;
+
+#ifdef __cplusplus
+typedef _jvmtiEnv jvmtiEnv;
+#else
+typedef const struct jvmtiInterface_1_ *jvmtiEnv;
+#endif
+
+typedef jobject jthread;
+typedef jlong jlocation;
+
+/* Agent entry points */
+JNIEXPORT jint JNICALL Agent_OnLoad(JavaVM *vm, char *options, void *reserved);
+JNIEXPORT void JNICALL Agent_OnUnload(JavaVM *vm);
+
+typedef enum {
+	JVMTI_ERROR_NONE = 0,
+	JVMTI_ERROR_INVALID_THREAD = 10,
+	JVMTI_ERROR_THREAD_NOT_ALIVE = 15,
+	JVMTI_ERROR_INVALID_OBJECT = 20,
+	JVMTI_ERROR_INVALID_CLASS = 21,
+	JVMTI_ERROR_INVALID_METHODID = 23,
+	JVMTI_ERROR_NO_MORE_FRAMES = 31,
+	JVMTI_ERROR_NOT_AVAILABLE = 98,
+	JVMTI_ERROR_MUST_POSSESS_CAPABILITY = 99,
+	JVMTI_ERROR_NULL_POINTER = 100,
+	JVMTI_ERROR_ABSENT_INFORMATION = 101,
+	JVMTI_ERROR_INVALID_EVENT_TYPE = 102,
+	JVMTI_ERROR_ILLEGAL_ARGUMENT = 103,
+	JVMTI_ERROR_OUT_OF_MEMORY = 110,
+	JVMTI_ERROR_WRONG_PHASE = 112,
+	JVMTI_ERROR_INTERNAL = 113,
+	JVMTI_ERROR_UNATTACHED_THREAD = 115,
+	JVMTI_ERROR_INVALID_ENVIRONMENT = 116
+} jvmtiError;
+
+typedef enum {
+	JVMTI_DISABLE = 0,
+	JVMTI_ENABLE = 1
+} jvmtiEventMode;
+
+typedef enum {
+	JVMTI_MIN_EVENT_TYPE_VAL = 50,
+	JVMTI_EVENT_VM_INIT = 50,
+	JVMTI_EVENT_VM_DEATH = 51,
+	JVMTI_EVENT_THREAD_START = 52,
+	JVMTI_EVENT_THREAD_END = 53,
+	JVMTI_EVENT_CLASS_FILE_LOAD_HOOK = 54,
+	JVMTI_EVENT_CLASS_LOAD = 55,
+	JVMTI_EVENT_CLASS_PREPARE = 56,
+	JVMTI_EVENT_VM_START = 57,
+	JVMTI_EVENT_EXCEPTION = 58,
+	JVMTI_EVENT_EXCEPTION_CATCH = 59,
+	JVMTI_EVENT_SINGLE_STEP = 60,
+	JVMTI_EVENT_FRAME_POP = 61,
+	JVMTI_EVENT_BREAKPOINT = 62,
+	JVMTI_EVENT_FIELD_ACCESS = 63,
+	JVMTI_EVENT_FIELD_MODIFICATION = 64,
+	JVMTI_EVENT_METHOD_ENTRY = 65,
+	JVMTI_EVENT_METHOD_EXIT = 66,
+	JVMTI_EVENT_NATIVE_METHOD_BIND = 67,
+	JVMTI_EVENT_COMPILED_METHOD_LOAD = 68,
+	JVMTI_EVENT_COMPILED_METHOD_UNLOAD = 69,
+	JVMTI_EVENT_DYNAMIC_CODE_GENERATED = 70,
+	JVMTI_EVENT_DATA_DUMP_REQUEST = 71,
+	JVMTI_EVENT_MONITOR_WAIT = 73,
+	JVMTI_EVENT_MONITOR_WAITED = 74,
+	JVMTI_EVENT_MONITOR_CONTENDED_ENTER = 75,
+	JVMTI_EVENT_MONITOR_CONTENDED_ENTERED = 76,
+	JVMTI_EVENT_RESOURCE_EXHAUSTED = 80,
+	JVMTI_EVENT_GARBAGE_COLLECTION_START = 81,
+	JVMTI_EVENT_GARBAGE_COLLECTION_FINISH = 82,
+	JVMTI_EVENT_OBJECT_FREE = 83,
+	JVMTI_EVENT_VM_OBJECT_ALLOC = 84,
+	JVMTI_MAX_EVENT_TYPE_VAL = 84
+} jvmtiEvent;
+
+typedef struct {
+	jmethodID method;
+	jlocation location;
+} jvmtiFrameInfo;
+
+typedef struct {
+	const void *start_address;
+	jlocation location;
+} jvmtiAddrLocationMap;
+
+typedef struct {
+	unsigned int can_tag_objects : 1;
+	unsigned int can_generate_field_modification_events : 1;
+	unsigned int can_generate_field_access_events : 1;
+	unsigned int can_get_bytecodes : 1;
+	unsigned int can_get_synthetic_attribute : 1;
+	unsigned int can_get_owned_monitor_info : 1;
+	unsigned int can_get_current_contended_monitor : 1;
+	unsigned int can_get_monitor_info : 1;
+	unsigned int can_pop_frame : 1;
+	unsigned int can_redefine_classes : 1;
+	unsigned int can_signal_thread : 1;
+	unsigned int can_get_source_file_name : 1;
+	unsigned int can_get_line_numbers : 1;
+	unsigned int can_get_source_debug_extension : 1;
+	unsigned int can_access_local_variables : 1;
+	unsigned int can_maintain_original_method_order : 1;
+	unsigned int can_generate_single_step_events : 1;
+	unsigned int can_generate_exception_events : 1;
+	unsigned int can_generate_frame_pop_events : 1;
+	unsigned int can_generate_breakpoint_events : 1;
+	unsigned int can_suspend : 1;
+	unsigned int can_redefine_any_class : 1;
+	unsigned int can_get_current_thread_cpu_time : 1;
+	unsigned int can_get_thread_cpu_time : 1;
+	unsigned int can_generate_method_entry_events : 1;
+	unsigned int can_generate_method_exit_events : 1;
+	unsigned int can_generate_all_class_hook_events : 1;
+	unsigned int can_generate_compiled_method_load_events : 1;
+	unsigned int can_generate_monitor_events : 1;
+	unsigned int can_generate_vm_object_alloc_events : 1;
+	unsigned int can_generate_native_method_bind_events : 1;
+	unsigned int can_generate_garbage_collection_events : 1;
+	unsigned int can_generate_object_free_events : 1;
+	unsigned int can_force_early_return : 1;
+	unsigned int can_get_owned_monitor_stack_depth_info : 1;
+	unsigned int can_get_constant_pool : 1;
+	unsigned int can_set_native_method_prefix : 1;
+	unsigned int can_retransform_classes : 1;
+	unsigned int can_retransform_any_class : 1;
+	unsigned int can_generate_resource_exhaustion_heap_events : 1;
+	unsigned int can_generate_resource_exhaustion_threads_events : 1;
+	unsigned int : 7;
+	unsigned int : 16;
+	unsigned int : 16;
+	unsigned int : 16;
+	unsigned int : 16;
+	unsigned int : 16;
+} jvmtiCapabilities;
+
+/* Callbacks of the events Kaffe posts */
+typedef void (JNICALL *jvmtiEventVMInit)
+	(jvmtiEnv *jvmti_env, JNIEnv *jni_env, jthread thread);
+typedef void (JNICALL *jvmtiEventVMDeath)
+	(jvmtiEnv *jvmti_env, JNIEnv *jni_env);
+typedef void (JNICALL *jvmtiEventCompiledMethodLoad)
+	(jvmtiEnv *jvmti_env, jmethodID method, jint code_size,
+	 const void *code_addr, jint map_length,
+	 const jvmtiAddrLocationMap *map, const void *compile_info);
+typedef void (JNICALL *jvmtiEventMonitorContendedEnter)
+	(jvmtiEnv *jvmti_env, JNIEnv *jni_env, jthread thread,
+	 jobject object);
+typedef void (JNICALL *jvmtiEventGarbageCollectionStart)
+	(jvmtiEnv *jvmti_env);
+typedef void (JNICALL *jvmtiEventGarbageCollectionFinish)
+	(jvmtiEnv *jvmti_env);
+typedef void (JNICALL *jvmtiEventVMObjectAlloc)
+	(jvmtiEnv *jvmti_env, JNIEnv *jni_env, jthread thread,
+	 jobject object, jclass object_klass, jlong size);
+
+/* Placeholder for the callbacks of events Kaffe does not post */
+typedef void *jvmtiEventReserved;
+
+typedef struct {
+	jvmtiEventVMInit VMInit;	/* 50 */
+	jvmtiEventVMDeath VMDeath;
+	jvmtiEventReserved ThreadStart;
+	jvmtiEventReserved ThreadEnd;
+	jvmtiEventReserved ClassFileLoadHook;
+	jvmtiEventReserved ClassLoad;
+	jvmtiEventReserved ClassPrepare;
+	jvmtiEventReserved VMStart;
+	jvmtiEventReserved Exception;
+	jvmtiEventReserved ExceptionCatch;
+	jvmtiEventReserved SingleStep;	/* 60 */
+	jvmtiEventReserved FramePop;
+	jvmtiEventReserved Breakpoint;
+	jvmtiEventReserved FieldAccess;
+	jvmtiEventReserved FieldModification;
+	jvmtiEventReserved MethodEntry;
+	jvmtiEventReserved MethodExit;
+	jvmtiEventReserved NativeMethodBind;
+	jvmtiEventCompiledMethodLoad CompiledMethodLoad;
+	jvmtiEventReserved CompiledMethodUnload;
+	jvmtiEventReserved DynamicCodeGenerated;	/* 70 */
+	jvmtiEventReserved DataDumpRequest;
+	jvmtiEventReserved reserved72;
+	jvmtiEventReserved MonitorWait;
+	jvmtiEventReserved MonitorWaited;
+	jvmtiEventMonitorContendedEnter MonitorContendedEnter;
+	jvmtiEventReserved MonitorContendedEntered;
+	jvmtiEventReserved reserved77;
+	jvmtiEventReserved reserved78;
+	jvmtiEventReserved reserved79;
+	jvmtiEventReserved ResourceExhausted;	/* 80 */
+	jvmtiEventGarbageCollectionStart GarbageCollectionStart;
+	jvmtiEventGarbageCollectionFinish GarbageCollectionFinish;
+	jvmtiEventReserved ObjectFree;
+	jvmtiEventVMObjectAlloc VMObjectAlloc;
+} jvmtiEventCallbacks;
+
+/*
+ * The functions, numbered by their slot in the specification.  Memory
+ * returned through them is allocated with Allocate and must be given
+ * back with Deallocate.
+ */
+struct jvmtiInterface_1_ {
+	/*   1 */ void *reserved1;
+	/*   2 */ jvmtiError (JNICALL *SetEventNotificationMode)
+		(jvmtiEnv *env, jvmtiEventMode mode, jvmtiEvent event_type,
+		 jthread event_thread, ...);
+	/*   3 */ void *GetAllModules;
+	/*   4 */ jvmtiError (JNICALL *GetAllThreads)
+		(jvmtiEnv *env, jint *threads_count_ptr, jthread **threads_ptr);
+	/*   5 */ void *SuspendThread;
+	/*   6 */ void *ResumeThread;
+	/*   7 */ void *StopThread;
+	/*   8 */ void *InterruptThread;
+	/*   9 */ void *GetThreadInfo;
+	/*  10 */ void *GetOwnedMonitorInfo;
+	/*  11 */ void *GetCurrentContendedMonitor;
+	/*  12 */ void *RunAgentThread;
+	/*  13 */ void *GetTopThreadGroups;
+	/*  14 */ void *GetThreadGroupInfo;
+	/*  15 */ void *GetThreadGroupChildren;
+	/*  16 */ void *GetFrameCount;
+	/*  17 */ void *GetThreadState;
+	/*  18 */ void *GetCurrentThread;
+	/*  19 */ void *GetFrameLocation;
+	/*  20 */ void *NotifyFramePop;
+	/*  21 */ void *GetLocalObject;
+	/*  22 */ void *GetLocalInt;
+	/*  23 */ void *GetLocalLong;
+	/*  24 */ void *GetLocalFloat;
+	/*  25 */ void *GetLocalDouble;
+	/*  26 */ void *SetLocalObject;
+	/*  27 */ void *SetLocalInt;
+	/*  28 */ void *SetLocalLong;
+	/*  29 */ void *SetLocalFloat;
+	/*  30 */ void *SetLocalDouble;
+	/*  31 */ void *CreateRawMonitor;
+	/*  32 */ void *DestroyRawMonitor;
+	/*  33 */ void *RawMonitorEnter;
+	/*  34 */ void *RawMonitorExit;
+	/*  35 */ void *RawMonitorWait;
+	/*  36 */ void *RawMonitorNotify;
+	/*  37 */ void *RawMonitorNotifyAll;
+	/*  38 */ void *SetBreakpoint;
+	/*  39 */ void *ClearBreakpoint;
+	/*  40 */ void *GetNamedModule;
+	/*  41 */ void *SetFieldAccessWatch;
+	/*  42 */ void *ClearFieldAccessWatch;
+	/*  43 */ void *SetFieldModificationWatch;
+	/*  44 */ void *ClearFieldModificationWatch;
+	/*  45 */ void *IsModifiableClass;
+	/*  46 */ jvmtiError (JNICALL *Allocate)
+		(jvmtiEnv *env, jlong size, unsigned char **mem_ptr);
+	/*  47 */ jvmtiError (JNICALL *Deallocate)
+		(jvmtiEnv *env, unsigned char *mem);
+	/*  48 */ jvmtiError (JNICALL *GetClassSignature)
+		(jvmtiEnv *env, jclass klass, char **signature_ptr,
+		 char **generic_ptr);
+	/*  49 */ void *GetClassStatus;
+	/*  50 */ void *GetSourceFileName;
+	/*  51 */ void *GetClassModifiers;
+	/*  52 */ void *GetClassMethods;
+	/*  53 */ void *GetClassFields;
+	/*  54 */ void *GetImplementedInterfaces;
+	/*  55 */ void *IsInterface;
+	/*  56 */ void *IsArrayClass;
+	/*  57 */ void *GetClassLoader;
+	/*  58 */ void *GetObjectHashCode;
+	/*  59 */ void *GetObjectMonitorUsage;
+	/*  60 */ void *GetFieldName;
+	/*  61 */ void *GetFieldDeclaringClass;
+	/*  62 */ void *GetFieldModifiers;
+	/*  63 */ void *IsFieldSynthetic;
+	/*  64 */ jvmtiError (JNICALL *GetMethodName)
+		(jvmtiEnv *env, jmethodID method, char **name_ptr,
+		 char **signature_ptr, char **generic_ptr);
+	/*  65 */ jvmtiError (JNICALL *GetMethodDeclaringClass)
+		(jvmtiEnv *env, jmethodID method, jclass *declaring_class_ptr);
+	/*  66 */ void *GetMethodModifiers;
+	/*  67 */ void *reserved67;
+	/*  68 */ void *GetMaxLocals;
+	/*  69 */ void *GetArgumentsSize;
+	/*  70 */ void *GetLineNumberTable;
+	/*  71 */ void *GetMethodLocation;
+	/*  72 */ void *GetLocalVariableTable;
+	/*  73 */ void *SetNativeMethodPrefix;
+	/*  74 */ void *SetNativeMethodPrefixes;
+	/*  75 */ void *GetBytecodes;
+	/*  76 */ void *IsMethodNative;
+	/*  77 */ void *IsMethodSynthetic;
+	/*  78 */ void *GetLoadedClasses;
+	/*  79 */ void *GetClassLoaderClasses;
+	/*  80 */ void *PopFrame;
+	/*  81 */ void *ForceEarlyReturnObject;
+	/*  82 */ void *ForceEarlyReturnInt;
+	/*  83 */ void *ForceEarlyReturnLong;
+	/*  84 */ void *ForceEarlyReturnFloat;
+	/*  85 */ void *ForceEarlyReturnDouble;
+	/*  86 */ void *ForceEarlyReturnVoid;
+	/*  87 */ void *RedefineClasses;
+	/*  88 */ jvmtiError (JNICALL *GetVersionNumber)
+		(jvmtiEnv *env, jint *version_ptr);
+	/*  89 */ jvmtiError (JNICALL *GetCapabilities)
+		(jvmtiEnv *env, jvmtiCapabilities *capabilities_ptr);
+	/*  90 */ void *GetSourceDebugExtension;
+	/*  91 */ void *IsMethodObsolete;
+	/*  92 */ void *SuspendThreadList;
+	/*  93 */ void *ResumeThreadList;
+	/*  94 */ void *AddModuleReads;
+	/*  95 */ void *AddModuleExports;
+	/*  96 */ void *AddModuleOpens;
+	/*  97 */ void *AddModuleUses;
+	/*  98 */ void *AddModuleProvides;
+	/*  99 */ void *IsModifiableModule;
+	/* 100 */ void *GetAllStackTraces;
+	/* 101 */ void *GetThreadListStackTraces;
+	/* 102 */ void *GetThreadLocalStorage;
+	/* 103 */ void *SetThreadLocalStorage;
+	/* 104 */ jvmtiError (JNICALL *GetStackTrace)
+		(jvmtiEnv *env, jthread thread, jint start_depth,
+		 jint max_frame_count, jvmtiFrameInfo *frame_buffer,
+		 jint *count_ptr);
+	/* 105 */ void *reserved105;
+	/* 106 */ void *GetTag;
+	/* 107 */ void *SetTag;
+	/* 108 */ void *ForceGarbageCollection;
+	/* 109 */ void *IterateOverObjectsReachableFromObject;
+	/* 110 */ void *IterateOverReachableObjects;
+	/* 111 */ void *IterateOverHeap;
+	/* 112 */ void *IterateOverInstancesOfClass;
+	/* 113 */ void *reserved113;
+	/* 114 */ void *GetObjectsWithTags;
+	/* 115 */ void *FollowReferences;
+	/* 116 */ void *IterateThroughHeap;
+	/* 117 */ void *reserved117;
+	/* 118 */ void *reserved118;
+	/* 119 */ void *reserved119;
+	/* 120 */ void *SetJNIFunctionTable;
+	/* 121 */ void *GetJNIFunctionTable;
+	/* 122 */ jvmtiError (JNICALL *SetEventCallbacks)
+		(jvmtiEnv *env, const jvmtiEventCallbacks *callbacks,
+		 jint size_of_callbacks);
+	/* 123 */ void *GenerateEvents;
+	/* 124 */ void *GetExtensionFunctions;
+	/* 125 */ void *GetExtensionEvents;
+	/* 126 */ void *SetExtensionEventCallback;
+	/* 127 */ void *DisposeEnvironment;
+	/* 128 */ void *GetErrorName;
+	/* 129 */ void *GetJLocationFormat;
+	/* 130 */ void *GetSystemProperties;
+	/* 131 */ void *GetSystemProperty;
+	/* 132 */ void *SetSystemProperty;
+	/* 133 */ void *GetPhase;
+	/* 134 */ void *GetCurrentThreadCpuTimerInfo;
+	/* 135 */ void *GetCurrentThreadCpuTime;
+	/* 136 */ void *GetThreadCpuTimerInfo;
+	/* 137 */ void *GetThreadCpuTime;
+	/* 138 */ void *GetTimerInfo;
+	/* 139 */ void *GetTime;
+	/* 140 */ jvmtiError (JNICALL *GetPotentialCapabilities)
+		(jvmtiEnv *env, jvmtiCapabilities *capabilities_ptr);
+	/* 141 */ void *reserved141;
+	/* 142 */ jvmtiError (JNICALL *AddCapabilities)
+		(jvmtiEnv *env, const jvmtiCapabilities *capabilities_ptr);
+	/* 143 */ jvmtiError (JNICALL *RelinquishCapabilities)
+		(jvmtiEnv *env, const jvmtiCapabilities *capabilities_ptr);
+	/* 144 */ void *GetAvailableProcessors;
+	/* 145 */ void *GetClassVersionNumbers;
+	/* 146 */ void *GetConstantPool;
+	/* 147 */ void *GetEnvironmentLocalStorage;
+	/* 148 */ void *SetEnvironmentLocalStorage;
+	/* 149 */ void *AddToBootstrapClassLoaderSearch;
+	/* 150 */ void *SetVerboseFlag;
+	/* 151 */ void *AddToSystemClassLoaderSearch;
+	/* 152 */ void *RetransformClasses;
+	/* 153 */ void *GetOwnedMonitorStackDepthInfo;
+	/* 154 */ void *GetObjectSize;
+	/* 155 */ void *GetLocalInstance;
+	/* 156 */ jvmtiError (JNICALL *SetHeapSamplingInterval)
+		(jvmtiEnv *env, jint sampling_interval);
+};
+
+#ifdef __cplusplus
+struct _jvmtiEnv {
+	const struct jvmtiInterface_1_ *functions;
+
+	jvmtiError SetEventNotificationMode(jvmtiEventMode mode,
+					    jvmtiEvent event_type,
+					    jthread event_thread) {
+		return functions->SetEventNotificationMode(this, mode,
+							   event_type,
+							   event_thread);
+	}
+	jvmtiError SetEventCallbacks(const jvmtiEventCallbacks *callbacks,
+				     jint size_of_callbacks) {
+		return functions->SetEventCallbacks(this, callbacks,
+						    size_of_callbacks);
+	}
+	jvmtiError GetAllThreads(jint *threads_count_ptr,
+				 jthread **threads_ptr) {
+		return functions->GetAllThreads(this, threads_count_ptr,
+						threads_ptr);
+	}
+	jvmtiError GetStackTrace(jthread thread, jint start_depth,
+				 jint max_frame_count,
+				 jvmtiFrameInfo *frame_buffer,
+				 jint *count_ptr) {
+		return functions->GetStackTrace(this, thread, start_depth,
+						max_frame_count,
+						frame_buffer, count_ptr);
+	}
+	jvmtiError GetMethodName(jmethodID method, char **name_ptr,
+				 char **signature_ptr, char **generic_ptr) {
+		return functions->GetMethodName(this, method, name_ptr,
+						signature_ptr, generic_ptr);
+	}
+	jvmtiError GetMethodDeclaringClass(jmethodID method,
+					   jclass *declaring_class_ptr) {
+		return functions->GetMethodDeclaringClass(this, method,
+							  declaring_class_ptr);
+	}
+	jvmtiError GetClassSignature(jclass klass, char **signature_ptr,
+				     char **generic_ptr) {
+		return functions->GetClassSignature(this, klass,
+						    signature_ptr,
+						    generic_ptr);
+	}
+	jvmtiError GetVersionNumber(jint *version_ptr) {
+		return functions->GetVersionNumber(this, version_ptr);
+	}
+	jvmtiError GetPotentialCapabilities(jvmtiCapabilities *capabilities_ptr) {
+		return functions->GetPotentialCapabilities(this,
+							   capabilities_ptr);
+	}
+	jvmtiError AddCapabilities(const jvmtiCapabilities *capabilities_ptr) {
+		return functions->AddCapabilities(this, capabilities_ptr);
+	}
+	jvmtiError RelinquishCapabilities(const jvmtiCapabilities *capabilities_ptr) {
+		return functions->RelinquishCapabilities(this,
+							 capabilities_ptr);
+	}
+	jvmtiError GetCapabilities(jvmtiCapabilities *capabilities_ptr) {
+		return functions->GetCapabilities(this, capabilities_ptr);
+	}
+	jvmtiError Allocate(jlong size, unsigned char **mem_ptr) {
+		return functions->Allocate(this, size, mem_ptr);
+	}
+	jvmtiError Deallocate(unsigned char *mem) {
+		return functions->Deallocate(this, mem);
+	}
+	jvmtiError SetHeapSamplingInterval(jint sampling_interval) {
+		return functions->SetHeapSamplingInterval(this,
+							  sampling_interval);
+	}
+};
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _KAFFE_JVMTI_H */
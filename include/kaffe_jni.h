@@ -27,6 +27,8 @@ typedef struct KaffeVM_Arguments {
         const char*     libraryhome;
         const char*     profilerLibname;
         const char*     profilerArguments;
+        const char*     agentLibname;
+        const char*     agentArguments;
 } KaffeVM_Arguments;
 
 extern KaffeVM_Arguments Kaffe_JavaVMArgs;
@@ -35,6 +35,10 @@
 #include "version.h"
 #include "debugFile.h"
 #include "xprofiler.h"
+#include "allocProfile.h"
+#include "cpuProfile.h"
+#include "startupTrace.h"
+#include "clinitAhead.h"
 #include "fileSections.h"
 #if defined(KAFFE_FEEDBACK)
 #include "feedback.h"
@@ -84,6 +88,7 @@ main(int argc, char* argv[])
 {
 	int farg;
 	const char* cp;
+	statTime traceStart;
 	void* env;
 
 #if defined(MAIN_MD)
@@ -175,6 +180,7 @@ main(int argc, char* argv[])
 	}
 
 	/* Initialise */
+	traceStart = STARTUP_TRACE_START();
 	if (JNI_CreateJavaVM(&global_vm, 
 			     &env, 
 			     &vmargs) 
@@ -183,6 +189,7 @@ main(int argc, char* argv[])
 	    fprintf(stderr, "Cannot create the Java VM\n");
 	    exit(EXIT_FAILURE);
 	  }
+	STARTUP_TRACE_END(traceStart, "vm", "JNI_CreateJavaVM", NULL);
 
 	return main2(env, argv, farg, argc);
 }
@@ -232,6 +239,7 @@ main2(JNIEnv* env, char *argv[], int farg, int argc)
 	int i;
 	int ret_code;
 	const char* exec;
+	statTime traceStart;
 
 	/* make sure no compiler optimizes this away */
 	gc_safe_zone[0] = gc_safe_zone[sizeof gc_safe_zone - 1] = 0;
@@ -246,9 +254,11 @@ main2(JNIEnv* env, char *argv[], int farg, int argc)
 		argc--;
 	}
 	
+	traceStart = STARTUP_TRACE_START();
 	mcls = (*env)->FindClass(env, exec);
 	if (checkException(env))
 		goto exception_happened;
+	STARTUP_TRACE_END(traceStart, "vm", "findMainClass", exec);
 	
 	/* ... and run main. */
 	mmth = (*env)->GetStaticMethodID(env,
@@ -273,6 +283,7 @@ main2(JNIEnv* env, char *argv[], int farg, int argc)
 	}
 
 	/* Call method, check for errors and then exit */
+	startupTraceInstant("main");
 	(*env)->CallStaticVoidMethod(env, mcls, mmth, args);
 	if (checkException(env))
 	  goto exception_happened;
@@ -764,6 +775,39 @@ options(char** argv, int argc)
 
 		  vmargs.profilerLibname = libName;
 		}
+		else if (strncmp(argv[i], "-agentlib:", 10) == 0
+			 || strncmp(argv[i], "-agentpath:", 11) == 0) {
+		  const char *spec;
+		  char *argPos;
+		  char *libName;
+
+		  /* There is one JVMTI environment to hand out */
+		  if (vmargs.agentLibname != NULL) {
+		    fprintf(stderr, _("Only one agent may be loaded: %s\n"),
+			    argv[i]);
+		    exit(EXIT_FAILURE);
+		  }
+
+		  if (argv[i][6] == 'l') {
+		    spec = &argv[i][10];
+		    libName = malloc(strlen(spec) + 4);
+		    strcpy(libName, "lib");
+		    strcat(libName, spec);
+		  }
+		  else {
+		    spec = &argv[i][11];
+		    libName = strdup(spec);
+		  }
+
+		  argPos = strchr(libName, '=');
+		  if (argPos != NULL)
+		    {
+		      *argPos = '\0';
+		      vmargs.agentArguments = strdup(argPos+1);
+		    }
+
+		  vmargs.agentLibname = libName;
+		}
 #if defined(KAFFE_PROFILER)
 		else if (strcmp(argv[i], "-prof") == 0) {
 			profFlag = 1;
@@ -805,6 +849,83 @@ options(char** argv, int argc)
 			}
 		}
 #endif
+		else if (strcmp(argv[i], "-Xallocprof") == 0) {
+			i++;
+			if (argv[i] == 0) {
+				fprintf(stderr, 
+					"%s", _("Error: -Xallocprof option requires "
+					"a file name.\n"));
+			}
+			else {
+				allocProfileSetFile(argv[i]);
+			}
+		}
+		else if (strcmp(argv[i], "-Xallocprof_rate") == 0) {
+			i++;
+			if (argv[i] == 0) {
+				fprintf(stderr, 
+					"%s", _("Error: -Xallocprof_rate option requires "
+					"a number of bytes.\n"));
+			}
+			else {
+				allocProfileSetRate(argv[i]);
+			}
+		}
+		else if (strcmp(argv[i], "-Xcpuprof") == 0) {
+			i++;
+			if (argv[i] == 0) {
+				fprintf(stderr, 
+					"%s", _("Error: -Xcpuprof option requires "
+					"a file name.\n"));
+			}
+			else {
+				cpuProfileSetFile(argv[i]);
+			}
+		}
+		else if (strcmp(argv[i], "-Xcpuprof_interval") == 0) {
+			i++;
+			if (argv[i] == 0) {
+				fprintf(stderr, 
+					"%s", _("Error: -Xcpuprof_interval option requires "
+					"a number of microseconds.\n"));
+			}
+			else {
+				cpuProfileSetInterval(argv[i]);
+			}
+		}
+		else if (strcmp(argv[i], "-Xstarttrace") == 0) {
+			i++;
+			if (argv[i] == 0) {
+				fprintf(stderr, 
+					"%s", _("Error: -Xstarttrace option requires "
+					"a file name.\n"));
+			}
+			else {
+				startupTraceSetFile(argv[i]);
+			}
+		}
+		else if (strcmp(argv[i], "-Xclinitrecord") == 0) {
+			i++;
+			if (argv[i] == 0) {
+				fprintf(stderr, 
+					"%s", _("Error: -Xclinitrecord option requires "
+					"a file name.\n"));
+			}
+			else {
+				clinitAheadSetRecordFile(argv[i]);
+			}
+		}
+		else if (strcmp(argv[i], "-Xclinitahead") == 0) {
+			i++;
+			if (argv[i] == 0) {
+				fprintf(stderr, 
+					"%s", _("Error: -Xclinitahead option requires "
+					"a file name.\n"));
+			}
+			else {
+				clinitAheadSetOrderFile(argv[i]);
+			}
+		}
 #if defined(KAFFE_XDEBUGGING)
 		else if (strcmp(argv[i], "-Xxdebug") == 0) {
 			/* Use a default name */
@@ -840,7 +961,6 @@ options(char** argv, int argc)
 		else if (strcmp(argv[i], "-nodeadlock") == 0) {
 			KaffeVM_setDeadlockDetection(0);
 		}
-#if defined(KAFFE_STATS)
                 else if (strcmp(argv[i], "-vmstats") == 0) {
 			extern void statsSetMaskStr(char *);
                         i++;
@@ -852,7 +972,17 @@ options(char** argv, int argc)
                         }
                         statsSetMaskStr(argv[i]);
                 }
-#endif
+                else if (strcmp(argv[i], "-vmmetrics") == 0) {
+			extern void statsSetExport(char *);
+                        i++;
+                        if (argv[i] == 0) { /* forgot second arg */
+                                fprintf(stderr, 
+					"%s", _("Error: -vmmetrics option requires a "
+					"second arg.\n"));
+                                exit(EXIT_FAILURE);
+                        }
+                        statsSetExport(argv[i]);
+                }
 #if defined(KAFFE_VMDEBUG)
                 else if (strcmp(argv[i], "-vmdebug") == 0) {
                         i++;
@@ -946,7 +1076,9 @@ usage(void)
 			  "	-verbosejit		 Print message during JIT code generation\n"
 			  "	-verbosemem		 Print detailed memory allocation statistics\n"
 			  "	-verbosecall		 Print detailed call flow information\n"
-			  "	-nodeadlock		 Disable deadlock detection\n"));
+			  "	-nodeadlock		 Disable deadlock detection\n"
+			  "	-agentlib:<lib>[=<opts>] Load the JVMTI agent lib<lib>\n"
+			  "	-agentpath:<file>[=<opts>] Load the JVMTI agent in file\n"));
 #if defined(KAFFE_PROFILER)
 	fprintf(stderr, "%s", _("	-prof			 Enable profiling of Java methods\n"));
 #endif
@@ -955,6 +1087,13 @@ usage(void)
 			  "	-Xxprof_syms <file>	 Name of the profiling symbols file [Default: kaffe-jit-symbols.s]\n"
 			  "	-Xxprof_gmon <file>	 Base name for gmon files [Default: xgmon.out]\n"));
 #endif
+	fprintf(stderr, "%s", _("	-Xallocprof <file>	 Write sampled allocation sites to file at exit\n"
+			  "	-Xallocprof_rate <bytes> Average bytes allocated between samples [Default: 524288]\n"));
+	fprintf(stderr, "%s", _("	-Xcpuprof <file>	 Write sampled Java stacks to file at exit\n"
+			  "	-Xcpuprof_interval <us>	 CPU time between samples [Default: 10000]\n"));
+	fprintf(stderr, "%s", _("	-Xstarttrace <file>	 Write a trace of VM startup to file at exit\n"));
+	fprintf(stderr, "%s", _("	-Xclinitrecord <file>	 Write the order static initializers ran in to file at exit\n"
+			  "	-Xclinitahead <file>	 Run the static initializers recorded in file ahead of use\n"));
 #if defined(KAFFE_XDEBUGGING)
 	fprintf(stderr, "%s", _("	-Xxdebug_file <file>	 Name of the debugging symbols file\n"));
 #endif
@@ -970,9 +1109,8 @@ usage(void)
         fprintf(stderr, "%s", _("	-vmdebug <flag{,flag}>	 Internal VM debugging.  Set flag=list for a list\n"));
 #endif
         fprintf(stderr, "%s", _("	-debug-fd <descriptor>	 Descriptor to send debug info to\n"));
-#ifdef KAFFE_STATS
         fprintf(stderr, "%s", _("	-vmstats <flag{,flag}>	 Print VM statistics.  Set flag=all for all\n"));
-#endif
+        fprintf(stderr, "%s", _("	-vmmetrics <file>[,<sec>] Write VM metrics to file every sec seconds\n"));
 #if defined(USE_GMP)
         fprintf(stderr, "%s", _("	-Xnative-big-math	 Use GMP for faster, native bignum calculations\n"));
 #endif /* defined(USE_GMP) */
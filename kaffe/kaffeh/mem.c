@@ -64,6 +64,11 @@ struct GarbageCollectorInterface_Ops GC_Ops = {
 	gcRmRef,
 	NULL,
 	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
+	NULL,
 };
 
 struct _Collector c = { & GC_Ops }, *main_collector = &c;
@@ -379,23 +379,31 @@ addField(Hjava_lang_Class* this,
 	f->bsize = 0; /* not used by kaffeh */
 	f->info.idx = 0; /* not used by kaffeh */
 
-	if (include != NULL) {
-		/*
-		 * Non-static fields are represented in the struct.
-		 */
-		if ((!(access_flags & ACC_STATIC)
-		     && outputField)) {
-			const char* arg;
-			int argsize = 0;
+	return f;
+}
 
-			arg = translateSig(CLASS_CONST_UTF8(this, signature_index)->data,
-					   NULL, &argsize);
-			fprintf(include, "  %s %s;\n",
-				arg, CLASS_CONST_UTF8(this, name_index)->data);
-		}
+/*
+ * The size of a field with signature sig in an object.
+ */
+static int
+fieldSize(const char *sig)
+{
+	switch (sig[0]) {
+	case 'J':
+	case 'D':
+		return 8;
+	case 'I':
+	case 'F':
+		return 4;
+	case 'S':
+	case 'C':
+		return 2;
+	case 'B':
+	case 'Z':
+		return 1;
+	default:
+		return sizeof(void*);
 	}
-
-	return f;
 }
 
 
@@ -483,12 +491,37 @@ setFieldValue(Hjava_lang_Class* this, Field* f, u2 idx)
 }
 
 void
-finishFields(Hjava_lang_Class* this UNUSED)
+finishFields(Hjava_lang_Class* this)
 {
+	int group;
+	int i;
+
 	if (include == NULL) {
 		return;
 	}
 
+	/*
+	 * Non-static fields are represented in the struct, in the order
+	 * the virtual machine lays them out, see resolveObjectFields.
+	 */
+	for (group = 0; outputField && group < FIELD_LAYOUT_GROUPS; group++) {
+		for (i = 0; i < CLASS_NFIELDS(this); i++) {
+			Field *f = &this->fields[i];
+			const char *sig = ((Utf8Const *)f->type)->data;
+			const char* arg;
+			int argsize = 0;
+
+			if ((f->accflags & ACC_STATIC)
+			    || FIELD_LAYOUT_GROUP(fieldSize(sig),
+				   fieldIsCollected(CLASS_CNAME(this),
+						    f->name->data, sig)) != group) {
+				continue;
+			}
+			arg = translateSig(sig, NULL, &argsize);
+			fprintf(include, "  %s %s;\n", arg, f->name->data);
+		}
+	}
+
 	if (objectDepth == 0) {
 		if (outputField) {
 			fprintf(include, "} H%s;\n\n", className);
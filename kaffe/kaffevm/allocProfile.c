@@ -0,0 +1,297 @@
+/*
+ * allocProfile.c
+ * Sampled allocation profiling.
+ *
+ * Every thread counts down the bytes it allocates.  When the count runs
+ * out, the allocation is charged to the Java methods on the thread's
+ * stack and a new count is drawn.  Samples with the same stack and
+ * allocation type are added up in a table, which is written out at exit
+ * in the collapsed stack format read by flame graph tools:  one line per
+ * site, the frames from outermost to innermost separated by semicolons,
+ * followed by the estimated number of bytes allocated there.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include "config.h"
+#include "config-std.h"
+#include "config-mem.h"
+#include "jni_md.h"
+#include "gtypes.h"
+#include "classMethod.h"
+#include "jthread.h"
+#include "thread.h"
+#include "threadData.h"
+#include "locks.h"
+#include "stackTrace.h"
+#include "debug.h"
+#include "allocProfile.h"
+
+/* Size of the site table, a power of two */
+#define	ALLOCPROFILE_SITES	4096
+
+typedef struct _allocSite {
+	uint32		hash;
+	int		depth;
+	const char	*what;
+	Method		*meths[ALLOCPROFILE_DEPTH];
+	char		*stack;		/* collapsed, see allocSiteName */
+	jlong		samples;
+	jlong		bytes;
+} allocSite;
+
+size_t allocProfileRate;
+
+static const char *profileFile;
+static size_t sampleRate = ALLOCPROFILE_DEFAULT_RATE;
+static iStaticLock siteLock;
+static allocSite *sites;
+static int nsites;
+static jlong droppedBytes;
+static uint32 intervalSeed = 2463534242U;
+
+/*
+ * Draw the number of bytes to the next sample, uniformly from
+ * [rate/2, 3*rate/2) so that samples do not lock onto periodic
+ * allocation patterns.  Races on the seed are harmless.
+ */
+static jlong
+nextInterval(void)
+{
+	uint32 x = intervalSeed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	intervalSeed = x;
+	return ((jlong)(allocProfileRate / 2 + x % allocProfileRate));
+}
+
+static uint32
+siteHash(Method **meths, int depth, const char *what)
+{
+	uint32 h = (uint32)(uintp)what;
+	int i;
+
+	for (i = 0; i < depth; i++) {
+		h = h * 31 + (uint32)((uintp)meths[i] >> 2);
+	}
+	return (h ^ (h >> 16));
+}
+
+/*
+ * Build the collapsed name of a site once, when it is first seen, so
+ * that dumping it later does not depend on its methods still being
+ * loaded.
+ */
+static char *
+allocSiteName(Method **meths, int depth, const char *what)
+{
+	size_t len;
+	char *name;
+	char *p;
+	int i;
+
+	len = strlen(what) + 3;
+	for (i = 0; i < depth; i++) {
+		len += strlen(CLASS_CNAME(meths[i]->class))
+			+ strlen(meths[i]->name->data) + 2;
+	}
+
+	name = malloc(len);
+	if (name == NULL) {
+		return (NULL);
+	}
+
+	p = name;
+	for (i = depth - 1; i >= 0; i--) {
+		p += sprintf(p, "%s.%s;", CLASS_CNAME(meths[i]->class),
+			     meths[i]->name->data);
+	}
+	sprintf(p, "[%s]", what);
+
+	for (p = name; *p != '\0'; p++) {
+		if (*p == '/') {
+			*p = '.';
+		}
+		else if (*p == ' ') {
+			*p = '_';
+		}
+	}
+	return (name);
+}
+
+static void
+allocProfileRecord(Method **meths, int depth, const char *what, jlong bytes)
+{
+	uint32 hash = siteHash(meths, depth, what);
+	uint32 i;
+	allocSite *site;
+
+	lockStaticMutex(&siteLock);
+	if (sites == NULL) {
+		sites = calloc(ALLOCPROFILE_SITES, sizeof(allocSite));
+		if (sites == NULL) {
+			allocProfileRate = 0;
+			unlockStaticMutex(&siteLock);
+			return;
+		}
+	}
+
+	for (i = hash;; i++) {
+		site = &sites[i & (ALLOCPROFILE_SITES - 1)];
+		if (site->stack == NULL) {
+			/* Keep the table at most three quarters full */
+			if (nsites * 4 >= ALLOCPROFILE_SITES * 3) {
+				droppedBytes += bytes;
+				unlockStaticMutex(&siteLock);
+				return;
+			}
+			site->stack = allocSiteName(meths, depth, what);
+			if (site->stack == NULL) {
+				droppedBytes += bytes;
+				unlockStaticMutex(&siteLock);
+				return;
+			}
+			site->hash = hash;
+			site->depth = depth;
+			site->what = what;
+			memcpy(site->meths, meths, depth * sizeof(Method *));
+			nsites++;
+			break;
+		}
+		if (site->hash == hash && site->depth == depth
+		    && site->what == what
+		    && memcmp(site->meths, meths, depth * sizeof(Method *)) == 0) {
+			break;
+		}
+	}
+
+	site->samples++;
+	site->bytes += bytes;
+	unlockStaticMutex(&siteLock);
+}
+
+/*
+ * Charge size bytes of what to the current thread, and take a sample
+ * when its count runs out.
+ */
+void
+allocProfileCount(size_t size, const char *what)
+{
+	Method *meths[ALLOCPROFILE_DEPTH];
+	threadData *thread_data;
+	jthread_t cur;
+	jlong bytes;
+	int depth;
+
+	cur = KTHREAD(current)();
+	if (cur == NULL) {
+		return;
+	}
+	thread_data = KTHREAD(get_data)(cur);
+	if (!THREAD_DATA_INITIALIZED(thread_data)) {
+		return;
+	}
+
+	if (thread_data->allocProfileLeft == 0) {
+		thread_data->allocProfileInterval = nextInterval();
+		thread_data->allocProfileLeft =
+			thread_data->allocProfileInterval;
+	}
+	thread_data->allocProfileLeft -= size;
+	if (thread_data->allocProfileLeft > 0) {
+		return;
+	}
+
+	/*
+	 * Each sample stands for the bytes allocated since the last one:
+	 * the count drawn, and whatever this allocation went past it by.
+	 * One large allocation is charged in full.
+	 */
+	bytes = thread_data->allocProfileInterval
+		- thread_data->allocProfileLeft;
+	thread_data->allocProfileInterval = nextInterval();
+	thread_data->allocProfileLeft = thread_data->allocProfileInterval;
+
+	depth = stackTraceMethods(NULL, meths, ALLOCPROFILE_DEPTH);
+	allocProfileRecord(meths, depth, what, bytes);
+}
+
+/*
+ * Write all sites in the collapsed stack format.
+ */
+void
+allocProfileDump(FILE *fp)
+{
+	int i;
+
+	if (sites == NULL) {
+		return;
+	}
+
+	lockStaticMutex(&siteLock);
+	for (i = 0; i < ALLOCPROFILE_SITES; i++) {
+		if (sites[i].stack != NULL) {
+			fprintf(fp, "%s %lld\n", sites[i].stack,
+				(long long)sites[i].bytes);
+		}
+	}
+	if (droppedBytes > 0) {
+		fprintf(fp, "[dropped] %lld\n", (long long)droppedBytes);
+	}
+	unlockStaticMutex(&siteLock);
+}
+
+static void
+allocProfileWrite(void)
+{
+	FILE *fp;
+
+	fp = fopen(profileFile, "w");
+	if (fp == NULL) {
+		dprintf("Unable to write allocation profile %s\n", profileFile);
+		return;
+	}
+	allocProfileDump(fp);
+	fclose(fp);
+}
+
+/*
+ * Ask for an allocation profile to be written to file at exit.
+ */
+void
+allocProfileSetFile(const char *file)
+{
+	profileFile = file;
+}
+
+/*
+ * Set the average number of bytes between samples.
+ */
+void
+allocProfileSetRate(const char *rate)
+{
+	long r = strtol(rate, NULL, 0);
+
+	sampleRate = r > 0 ? (size_t)r : ALLOCPROFILE_DEFAULT_RATE;
+}
+
+/*
+ * Start sampling once the threading system is up, if a profile was
+ * asked for.
+ */
+void
+allocProfileInit(void)
+{
+	if (profileFile == NULL) {
+		return;
+	}
+	initStaticLock(&siteLock);
+	atexit(allocProfileWrite);
+	allocProfileRate = sampleRate;
+}
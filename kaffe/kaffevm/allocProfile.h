@@ -0,0 +1,41 @@
+/*
+ * allocProfile.h
+ * Sampled allocation profiling.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#ifndef __kaffevm_allocProfile_h
+#define __kaffevm_allocProfile_h
+
+/* Java frames recorded for each sample */
+#define	ALLOCPROFILE_DEPTH	8
+
+/* Default number of bytes allocated by a thread between two samples */
+#define	ALLOCPROFILE_DEFAULT_RATE	(512 * 1024)
+
+/* Bytes between samples, 0 while profiling is off */
+extern size_t allocProfileRate;
+
+extern void allocProfileSetFile(const char *file);
+extern void allocProfileSetRate(const char *rate);
+extern void allocProfileInit(void);
+extern void allocProfileCount(size_t size, const char *what);
+extern void allocProfileDump(FILE *fp);
+
+/*
+ * Called by the collectors for every allocation, with the description
+ * of its allocation type.  Only tests a global while profiling is off.
+ */
+#define	ALLOCPROFILE(SIZE, WHAT)				\
+	do {							\
+		if (allocProfileRate != 0) {			\
+			allocProfileCount((SIZE), (WHAT));	\
+		}						\
+	} while (0)
+
+#endif /* __kaffevm_allocProfile_h */
@@ -0,0 +1,152 @@
+/*
+ * arena.c
+ * Memory for short lived data, released all at once.
+ *
+ * The code analysis and the verifier need many small blocks for each
+ * method and drop them all when they are done with it.  An arena hands
+ * them out of large chunks by moving a pointer, without the locking of
+ * the collector, and frees the chunks in one go.  Each thread keeps one
+ * chunk from the last arena it released for the next one.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include "config.h"
+#include "config-std.h"
+#include "config-mem.h"
+#include "jni_md.h"
+#include "gtypes.h"
+#include "jthread.h"
+#include "thread.h"
+#include "threadData.h"
+#include "arena.h"
+
+typedef struct _arenaChunk {
+	struct _arenaChunk	*next;
+	size_t			size;	/* bytes after the header */
+	size_t			used;
+} arenaChunk;
+
+/* Blocks are aligned for any of the types the virtual machine uses */
+#define	ARENA_ALIGN		8
+#define	ARENA_ROUND(N)		(((N) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+#define	ARENA_HEADER		ARENA_ROUND(sizeof(arenaChunk))
+
+static threadData *
+currentThreadData(void)
+{
+	jthread_t cur = KTHREAD(current)();
+
+	if (cur == NULL) {
+		return (NULL);
+	}
+	return (KTHREAD(get_data)(cur));
+}
+
+/*
+ * A chunk with room for size bytes: the one the thread kept if it is
+ * big enough, otherwise a new one.
+ */
+static arenaChunk *
+newChunk(size_t size)
+{
+	threadData *thread_data;
+	arenaChunk *c;
+
+	if (size <= ARENA_CHUNK) {
+		thread_data = currentThreadData();
+		if (thread_data != NULL && thread_data->arenaChunk != NULL) {
+			c = thread_data->arenaChunk;
+			thread_data->arenaChunk = NULL;
+			c->used = 0;
+			return (c);
+		}
+		size = ARENA_CHUNK;
+	}
+
+	c = malloc(ARENA_HEADER + size);
+	if (c == NULL) {
+		return (NULL);
+	}
+	c->size = size;
+	c->used = 0;
+	return (c);
+}
+
+void
+arenaInit(arena *a)
+{
+	a->chunks = NULL;
+}
+
+/*
+ * Allocate size bytes, cleared like those from the collector.  Returns
+ * NULL if we run out of memory.
+ */
+void *
+arenaAlloc(arena *a, size_t size)
+{
+	arenaChunk *c = a->chunks;
+	void *p;
+
+	size = ARENA_ROUND(size);
+	if (c == NULL || c->size - c->used < size) {
+		c = newChunk(size);
+		if (c == NULL) {
+			return (NULL);
+		}
+		/* A block bigger than a chunk fills its own, keep using
+		 * the one we had for the small ones */
+		if (size > ARENA_CHUNK && a->chunks != NULL) {
+			c->next = a->chunks->next;
+			a->chunks->next = c;
+		}
+		else {
+			c->next = a->chunks;
+			a->chunks = c;
+		}
+	}
+
+	p = (char *)c + ARENA_HEADER + c->used;
+	c->used += size;
+	memset(p, 0, size);
+	return (p);
+}
+
+/*
+ * Free everything allocated from the arena.  A chunk of the usual size
+ * is kept for the thread's next arena.
+ */
+void
+arenaRelease(arena *a)
+{
+	threadData *thread_data = currentThreadData();
+	arenaChunk *c;
+	arenaChunk *next;
+
+	for (c = a->chunks; c != NULL; c = next) {
+		next = c->next;
+		if (c->size == ARENA_CHUNK && thread_data != NULL
+		    && thread_data->arenaChunk == NULL) {
+			thread_data->arenaChunk = c;
+		}
+		else {
+			free(c);
+		}
+	}
+	a->chunks = NULL;
+}
+
+/*
+ * Called as a thread is torn down to free the chunk it kept.
+ */
+void
+arenaReleaseThread(threadData *thread_data)
+{
+	free(thread_data->arenaChunk);
+	thread_data->arenaChunk = NULL;
+}
@@ -0,0 +1,32 @@
+/*
+ * arena.h
+ * Memory for short lived data, released all at once.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#ifndef __kaffevm_arena_h
+#define __kaffevm_arena_h
+
+#include <stddef.h>
+
+/* Size of the chunks an arena allocates from */
+#define	ARENA_CHUNK	16384
+
+struct _arenaChunk;
+struct _threadData;
+
+typedef struct _arena {
+	struct _arenaChunk	*chunks;
+} arena;
+
+extern void arenaInit(arena *a);
+extern void *arenaAlloc(arena *a, size_t size);
+extern void arenaRelease(arena *a);
+extern void arenaReleaseThread(struct _threadData *thread_data);
+
+#endif /* __kaffevm_arena_h */
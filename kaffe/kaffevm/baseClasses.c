@@ -45,6 +45,13 @@
 #include "verify-type.h"
 #include "jar.h"
 #include "jni_funcs.h"
+#include "stats.h"
+#include "allocProfile.h"
+#include "cpuProfile.h"
+#include "startupTrace.h"
+#include "clinitAhead.h"
+#include "jitProfile.h"
+#include "jvmti_kaffe.h"
 
 Utf8Const* init_name;
 Utf8Const* final_name;
@@ -53,6 +60,7 @@ Utf8Const* constructor_name;
 Utf8Const* Code_name;
 Utf8Const* LineNumberTable_name;
 Utf8Const* LocalVariableTable_name;
+Utf8Const* StackMapTable_name;
 Utf8Const* ConstantValue_name;
 Utf8Const* Exceptions_name;
 Utf8Const* SourceFile_name;
@@ -180,6 +188,7 @@ initialiseKaffe(void)
 {
         /* Set default thread stack size if not set */
 	int threadStackSize;
+	statTime traceStart = STARTUP_TRACE_START();
 
 	/* Machine specific initialisation first */
 #if defined(INIT_MD)
@@ -187,8 +196,9 @@ initialiseKaffe(void)
 #endif
 
 	/* Register allocation types with gc subsystem */
-	main_collector = initCollector();
-	KGC_init(main_collector);
+	STARTUP_TRACE_PHASE("initCollector",
+		main_collector = initCollector();
+		KGC_init(main_collector));
 
 #if defined(KAFFE_XPROFILER)
 	/* Start up the profiler here so we can cover init stuff */
@@ -217,24 +227,29 @@ initialiseKaffe(void)
         }
 
 	/* Initialise the (native) threading system */
-	initNativeThreads(threadStackSize);
+	STARTUP_TRACE_PHASE("initNativeThreads",
+		initNativeThreads(threadStackSize));
 
 	initLocking();
-	initEngine();
+	startupTraceInit();
+	clinitAheadInit();
+	STARTUP_TRACE_PHASE("initEngine", initEngine());
+	jitProfileInit();
+	jvmtiInit();
 	KaffeVM_initClassPool();
 
 	/* Initialise the string and utf8 systems */
-	stringInit();
-	utf8ConstInit();
+	STARTUP_TRACE_PHASE("stringInit", stringInit());
+	STARTUP_TRACE_PHASE("utf8ConstInit", utf8ConstInit());
 
 	/* Initialize the reference tracking subsystem */
 	KaffeVM_referenceInit();
 
 	/* Setup CLASSPATH */
-	initClasspath();
+	STARTUP_TRACE_PHASE("initClasspath", initClasspath());
 
 	/* Init native support */
-	initNative();
+	STARTUP_TRACE_PHASE("initNative", initNative());
 
 #if defined(KAFFE_FEEDBACK)
 	/* Install any file sections used by feedback */
@@ -259,6 +274,7 @@ initialiseKaffe(void)
 	Code_name = utf8ConstFromString("Code");
 	LineNumberTable_name = utf8ConstFromString("LineNumberTable");
 	LocalVariableTable_name = utf8ConstFromString("LocalVariableTable");
+	StackMapTable_name = utf8ConstFromString("StackMapTable");
 	ConstantValue_name = utf8ConstFromString("ConstantValue");
 	Exceptions_name = utf8ConstFromString("Exceptions");
 	SourceFile_name = utf8ConstFromString("SourceFile");
@@ -269,8 +285,8 @@ initialiseKaffe(void)
 
 	if (!(init_name && final_name && void_signature &&
 	      constructor_name && Code_name && LineNumberTable_name &&
-	      LocalVariableTable_name && ConstantValue_name &&
-	      Exceptions_name && SourceFile_name && InnerClasses_name && 
+	      LocalVariableTable_name && StackMapTable_name &&
+	      ConstantValue_name && Exceptions_name && SourceFile_name && InnerClasses_name && 
 	      Signature_name && Synthetic_name && EnclosingMethod_name)) {
 		DBG(INIT, dprintf("not enough memory to run kaffe\n"); );
 		KAFFEVM_ABORT();
@@ -287,7 +303,7 @@ initialiseKaffe(void)
 	 * Read in base classes.  No thread context at this point, so
 	 * errors here are really hard to detect cleanly.
 	 */
-	initBaseClasses();
+	STARTUP_TRACE_PHASE("initBaseClasses", initBaseClasses());
 
 #if defined(HAVE_GCJ_SUPPORT)
 	/* tell gcj where primitive classes are */
@@ -295,16 +311,26 @@ initialiseKaffe(void)
 #endif
 
 	/* Setup exceptions */
-	initExceptions();
+	STARTUP_TRACE_PHASE("initExceptions", initExceptions());
 
 	/* Init thread support */
-	initThreads();
+	STARTUP_TRACE_PHASE("initThreads", initThreads());
+
+	/* Start exporting statistics and profiling, if asked to */
+	statsStartExport();
+	allocProfileInit();
+	cpuProfileInit();
 
 	/* Init stuff for the java security model */
-	initialiseSecurity();
+	STARTUP_TRACE_PHASE("initialiseSecurity", initialiseSecurity());
 
 	/* Now enable collector */
 	KGC_enable(main_collector);
+
+	/* Start initializing classes ahead, if asked to */
+	clinitAheadStart();
+
+	STARTUP_TRACE_END(traceStart, "vm", "initialiseKaffe", NULL);
 }
 
 static void
@@ -336,12 +362,14 @@ initBaseClasses(void)
 {
 	errorInfo einfo;
 	int i;
+	statTime traceStart;
 
 	DBG(INIT, dprintf("initBaseClasses()\n"); );
 
 	/* Primitive types */
-	initTypes();
-	initVerifierPrimTypes();
+	STARTUP_TRACE_PHASE("initTypes",
+		initTypes();
+		initVerifierPrimTypes());
 
 	loadStaticClass(&ObjectClass, OBJECTCLASS);
 	loadStaticClass(&SerialClass, SERIALCLASS);
@@ -412,10 +440,12 @@ initBaseClasses(void)
 
 	DBG(INIT, dprintf("initBaseClasses() done\n"); );
 
+	traceStart = STARTUP_TRACE_START();
 	for (i = 0; stateCompleteClass[i] != NULL; i++) {
 	    if (!processClass(*stateCompleteClass[i], CSTATE_COMPLETE, &einfo))
 	      abortWithEarlyClassFailure(&einfo);
 	}	
+	STARTUP_TRACE_END(traceStart, "vm", "initialiseBaseClasses", NULL);
 
 	/* Preresolve some fields which will be used in JNI. */	
 	gnuClasspathPointerAddress = KNI_lookupFieldC(gnuClasspathPointerClass, "data", false, &einfo);
@@ -31,6 +31,7 @@
 #include "gc-kaffe.h"
 #include "gc2.h"
 #include "jvmpi_kaffe.h"
+#include "allocProfile.h"
 
 #include <gc/gc.h>
 #include <gc/gc_mark.h>
@@ -218,6 +219,14 @@ KaffeGC_InvokeFinalizer(Collector *gcif)
  * ---------------------------------------------------------------------
  */
 
+static bool
+inCriticalRegion(void)
+{
+  jthread_t cur = KTHREAD(current)();
+
+  return (cur != NULL && KTHREAD(get_data)(cur)->criticalDepth > 0);
+}
+
 /*
  * Explicity invoke the garbage collector and wait for it to complete.
  */
@@ -237,6 +246,14 @@ KaffeGC_InvokeGC(Collector* gcif UNUSED, int mustgc)
       signalStaticCond(&gcman_lock);
   }
 
+  /* A thread inside a JNI critical region keeps the collector
+   * disabled, so waiting would dead lock.
+   */
+  if (gcDisabled && inCriticalRegion()) {
+    unlockStaticMutex(&gcman_lock);
+    return;
+  }
+
   lockStaticMutex(&gcmanend_lock);
   unlockStaticMutex(&gcman_lock);
   while (gcRunning != 0) {
@@ -252,7 +269,8 @@ gcMan(UNUSED void* arg)
   lockStaticMutex(&gcman_lock);
   gcRunning = 0;
   for (;;) {
-    while (gcRunning == 0) {
+    /* A disabled collector must not start, see KaffeGC_DisableGC */
+    while (gcRunning == 0 || gcDisabled) {
       waitStaticCond(&gcman_lock, 0);
     }
 
@@ -272,17 +290,25 @@ KaffeGC_EnableGC(Collector* gcif UNUSED)
 
   lockStaticMutex(&gcman_lock);
   gcDisabled -= 1;
+  GC_enable();
   if( gcDisabled == 0 )
     broadcastStaticCond(&gcman_lock);
   unlockStaticMutex(&gcman_lock);
 }
 
+/*
+ * Keep both our collector thread and the collections Boehm triggers
+ * itself on allocation from starting.  Used by JNI critical regions.
+ * gcMan holds gcman_lock while it collects, so this waits for a
+ * running collection to finish.
+ */
 static void
 KaffeGC_DisableGC(Collector* gcif UNUSED)
 {
 
   lockStaticMutex(&gcman_lock);
   gcDisabled += 1;
+  GC_disable();
   unlockStaticMutex(&gcman_lock);
 }
 
@@ -291,32 +317,72 @@ KaffeGC_DisableGC(Collector* gcif UNUSED)
  * ---------------------------------------------------------------------
  */
 
+/*
+ * GC_REALLOC keeps the Boehm kind of the old object, which need not be
+ * the one KaffeGC_malloc picks for the new type.  Allocate afresh, copy
+ * and free the old object instead, as gcRealloc does in kaffe-gc.
+ */
 static void*
 KaffeGC_realloc(Collector *gcif, void* mem, size_t sz, gc_alloc_type_t type)
 {
-  void *new_ptr;
+  MemDescriptor *desc;
+  void *new_mem;
 
   if (mem == NULL)
     return KGC_malloc(gcif, sz, type);
 
   assert(sz > 0);
-  
-  new_ptr = GC_REALLOC ( ALIGN_BACKWARD(mem), (size_t)SYSTEM_SIZE(sz));
-  if (new_ptr) {
-    MemDescriptor *desc = (MemDescriptor *)new_ptr;
-    
-    assert(desc->magic == MAGIC_GC);
-    if (sz > desc->memsize) {
-      memset((void *)((uintp)new_ptr + SYSTEM_SIZE(desc->memsize)), 0, sz-desc->memsize);
-    }
-    desc->memtype = type;
-    desc->memsize = sz;
-    desc->needFinal = true;
 
-    return ALIGN_FORWARD(new_ptr);
-  }
+  desc = (MemDescriptor *)ALIGN_BACKWARD(mem);
+  assert(desc->magic == MAGIC_GC);
 
-  return NULL;
+  /* If we'll fit into the current space and keep the type, send it back */
+  if (desc->memtype == type && desc->memsize >= sz)
+    return mem;
+
+  new_mem = KGC_malloc(gcif, sz, type);
+  if (new_mem == NULL)
+    return NULL;
+
+  memcpy(new_mem, mem, desc->memsize < sz ? desc->memsize : sz);
+  KGC_free(gcif, mem);
+
+  return new_mem;
+}
+
+/*
+ * Whether objects of a type get a Boehm finaliser when they are
+ * allocated.  Registering one takes the allocation lock and costs a
+ * table entry and an extra collection cycle per object.  Arrays and
+ * objects of classes without finalize() only need one once a weak
+ * reference to them exists, BoehmGC_addWeakRef registers it then.
+ */
+static bool
+needsFinalizer(gc_alloc_type_t type)
+{
+  gcFuncs *f = &gcFunctions[type];
+
+  if (f->final == KGC_OBJECT_FIXED)
+    return false;
+  if (f->destroy != NULL)
+    return true;
+  if (f->final == KGC_OBJECT_NORMAL)
+    return false;
+
+#if defined(ENABLE_JVMPI)
+  if( JVMPI_EVENT_ISENABLED(JVMPI_EVENT_OBJECT_FREE) )
+    return true;
+#endif
+
+  switch (type)
+    {
+    case KGC_ALLOC_NORMALOBJECT:
+    case KGC_ALLOC_PRIMARRAY:
+    case KGC_ALLOC_REFARRAY:
+      return false;
+    default:
+      return true;
+    }
 }
 
 static void
@@ -345,9 +411,12 @@ KaffeGC_malloc(Collector *gcif UNUSED, size_t sz, gc_alloc_type_t type)
   desc.memsize = sz;
   desc.magic = MAGIC_GC;
   desc.needFinal = true;
-  // Allocate memory
+  // Allocate memory.  Types without a walk function hold no pointers
+  // the collector has to follow, so they need not be scanned at all.
   if (gcFunctions[type].final == KGC_OBJECT_FIXED)
     mem = GC_MALLOC_UNCOLLECTABLE(SYSTEM_SIZE(sz));
+  else if (gcFunctions[type].walk == NULL)
+    mem = GC_MALLOC_ATOMIC(SYSTEM_SIZE(sz));
   else
     mem = GC_kaffe_malloc(SYSTEM_SIZE(sz));
 
@@ -355,11 +424,10 @@ KaffeGC_malloc(Collector *gcif UNUSED, size_t sz, gc_alloc_type_t type)
   if (mem != 0) {
     clearAndAddDescriptor(mem, &desc);
 
-    if ( gcFunctions[type].final != KGC_OBJECT_FIXED
-	 && (gcFunctions[type].final != KGC_OBJECT_NORMAL
-	     || gcFunctions[type].destroy != NULL)) {
+    if (needsFinalizer(type)) {
       GC_REGISTER_FINALIZER_NO_ORDER(mem, finalizeObject, 0, 0, 0);
     }
+    ALLOCPROFILE(sz, gcFunctions[type].description);
     return ALIGN_FORWARD(mem);
   }
 
@@ -367,6 +435,26 @@ KaffeGC_malloc(Collector *gcif UNUSED, size_t sz, gc_alloc_type_t type)
 }
 
 
+/*
+ * Allocate up to n objects of the same size and type.  Boehm's locks
+ * are taken inside GC_malloc, so they are simply allocated one by one.
+ */
+static int
+KaffeGC_mallocMany(Collector *gcif, size_t sz, gc_alloc_type_t type,
+		   void **objs, int n)
+{
+  int cnt;
+
+  for (cnt = 0; cnt < n; cnt++)
+    {
+      objs[cnt] = KaffeGC_malloc(gcif, sz, type);
+      if (objs[cnt] == NULL)
+	break;
+    }
+  return cnt;
+}
+
+
 /* =====================================================================
  * Utilities
  * ---------------------------------------------------------------------
@@ -458,6 +546,12 @@ KaffeGC_HeapTotal(Collector *gcif UNUSED)
   return GC_get_heap_size();
 }
 
+static uint32
+KaffeGC_getCollections(Collector *gcif UNUSED)
+{
+  return (uint32)GC_gc_no;
+}
+
 static const char *
 KaffeGC_getCollectorName(Collector *gcif UNUSED)
 {
@@ -479,6 +573,57 @@ KaffeGC_MarkAddress(UNUSED Collector* gcif, void *gc_info, const void* mem)
 		     (void **) info_mark->original_object);
 }
 
+static inline struct GC_ms_entry *
+markPointer(const void *mem, struct GC_ms_entry *mark_stack_ptr,
+	    struct GC_ms_entry *mark_stack_limit, GC_word *addr)
+{
+  if (mem == NULL)
+    return mark_stack_ptr;
+
+  return GC_mark_and_push(ALIGN_BACKWARD(mem), mark_stack_ptr,
+			  mark_stack_limit, (void **)addr);
+}
+
+/*
+ * Mark a Java object from the reference ranges of its class.  This is
+ * what walkObject does, but pushes the fields straight onto the mark
+ * stack instead of calling through the collector for each of them.
+ */
+static struct GC_ms_entry *
+markObjectLayout(GC_word *addr, struct GC_ms_entry *mark_stack_ptr,
+		 struct GC_ms_entry *mark_stack_limit)
+{
+  Hjava_lang_Object *obj = (Hjava_lang_Object *)ALIGN_FORWARD(addr);
+  Hjava_lang_Class *clazz;
+  iLock *lk;
+  gcRefRange *range;
+  void **mem;
+  uint32 i;
+  int n;
+
+  /* See walkObject */
+  if (obj->vtable == NULL)
+    return mark_stack_ptr;
+
+  clazz = obj->vtable->class;
+  if (clazz->loader != NULL)
+    mark_stack_ptr = markPointer(clazz, mark_stack_ptr, mark_stack_limit, addr);
+
+  lk = GET_HEAVYLOCK(obj->lock);
+  if (lk != NULL && KaffeGC_GetObjectIndex(&boehm_gc.collector, lk) == KGC_ALLOC_LOCK)
+    mark_stack_ptr = markPointer(lk, mark_stack_ptr, mark_stack_limit, addr);
+
+  range = clazz->gc_layout;
+  for (n = clazz->gc_nranges; n > 0; n--, range++)
+    {
+      mem = (void **)obj + range->start;
+      for (i = range->count; i > 0; i--)
+	mark_stack_ptr = markPointer(*mem++, mark_stack_ptr, mark_stack_limit, addr);
+    }
+
+  return mark_stack_ptr;
+}
+
 static struct GC_ms_entry *
 onObjectMarking(GC_word *addr, struct GC_ms_entry * mark_stack_ptr,
                 struct GC_ms_entry * mark_stack_limit, UNUSED GC_word env)
@@ -494,6 +639,9 @@ onObjectMarking(GC_word *addr, struct GC_ms_entry * mark_stack_ptr,
    */
   if (desc->magic != MAGIC_GC)
     return mark_stack_ptr;
+
+  if (type == KGC_ALLOC_NORMALOBJECT || type == KGC_ALLOC_FINALIZEOBJECT)
+    return markObjectLayout(addr, mark_stack_ptr, mark_stack_limit);
   
   info_mark.mark_current = mark_stack_ptr;
   info_mark.mark_limit = mark_stack_limit;
@@ -508,6 +656,26 @@ onObjectMarking(GC_word *addr, struct GC_ms_entry * mark_stack_ptr,
   return info_mark.mark_current;
 }
 
+/*
+ * A weak reference is cleared by the finaliser of its object, which
+ * needsFinalizer may have left out at allocation.
+ */
+static bool
+BoehmGC_addWeakRef(Collector *collector, void *mem, void **ref)
+{
+  MemDescriptor *desc = (MemDescriptor *)GC_base(mem);
+
+  if (desc != NULL)
+    {
+      assert(desc->magic == MAGIC_GC);
+      if (!needsFinalizer(desc->memtype)
+	  && gcFunctions[desc->memtype].final != KGC_OBJECT_FIXED)
+	GC_REGISTER_FINALIZER_NO_ORDER(desc, finalizeObject, 0, 0, 0);
+    }
+
+  return KaffeGC_addWeakRef(collector, mem, ref);
+}
+
 /* =====================================================================
  * Initialization
  * ---------------------------------------------------------------------
@@ -551,6 +719,16 @@ KaffeGC_Init(Collector *collector UNUSED)
 }
 
 
+/*
+ * Boehm gives us no way to enumerate the objects it marked.
+ */
+static bool
+KaffeGC_snapshotHeap(Collector *gcif UNUSED,
+		     heap_snapshot_func_t func UNUSED, void *arg UNUSED)
+{
+  return false;
+}
+
 /* =====================================================================
  * GC starter
  * ---------------------------------------------------------------------
@@ -606,8 +784,13 @@ static struct GarbageCollectorInterface_Ops GC_Ops = {
   KaffeGC_HeapTotal,
   BoehmGC_addRef,
   BoehmGC_rmRef,
-  KaffeGC_addWeakRef,
-  KaffeGC_rmWeakRef
+  BoehmGC_addWeakRef,
+  KaffeGC_rmWeakRef,
+  KaffeGC_addGlobalRef,
+  KaffeGC_rmGlobalRef,
+  KaffeGC_snapshotHeap,
+  KaffeGC_mallocMany,
+  KaffeGC_getCollections
 };
 
 /*
@@ -0,0 +1,244 @@
+/*
+ * bulkArray.c
+ * Operations on whole arrays.
+ *
+ * Copying references between arrays checks the element classes once
+ * where it can instead of once per element.  Filling and comparing
+ * primitive arrays works on memory rather than elements, with memset
+ * and memcmp or eight bytes at a time.  The translator uses the latter
+ * in place of the methods of java.util.Arrays that do the same, see
+ * bulkArrayIntrinsic.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include "config.h"
+#include "config-std.h"
+#include "config-mem.h"
+#include "gtypes.h"
+#include "object.h"
+#include "classMethod.h"
+#include "errors.h"
+#include "exception.h"
+#include "soft.h"
+#include "bulkArray.h"
+
+/*
+ * Copy len references from src at srcpos to dst at dstpos.  If an
+ * element cannot be stored in dst the copy stops there and the element
+ * is returned, with the elements before it copied.  Returns NULL if
+ * everything was copied.
+ */
+Hjava_lang_Object*
+bulkArrayCopyRefs(Hjava_lang_Object* src, jint srcpos,
+		  Hjava_lang_Object* dst, jint dstpos, jint len)
+{
+	Hjava_lang_Class* sclass;
+	Hjava_lang_Class* dclass;
+	Hjava_lang_Class* lastok;
+	Hjava_lang_Object** in;
+	Hjava_lang_Object** out;
+	Hjava_lang_Object* val;
+
+	sclass = Kaffe_get_array_element_type(OBJECT_CLASS(src));
+	dclass = Kaffe_get_array_element_type(OBJECT_CLASS(dst));
+	in = OBJARRAY_DATA(src) + srcpos;
+	out = OBJARRAY_DATA(dst) + dstpos;
+
+	/* Anything src can hold can be stored in dst */
+	if (instanceof(dclass, sclass)) {
+		memmove(out, in, (size_t)len * sizeof(Hjava_lang_Object*));
+		return (NULL);
+	}
+
+	/*
+	 * Check each element, but not again while elements of the class
+	 * that passed last follow.  The arrays differ in class here so
+	 * they cannot overlap.
+	 */
+	lastok = NULL;
+	for (; len > 0; len--) {
+		val = *in++;
+		if (val != NULL && OBJECT_CLASS(val) != lastok) {
+			if (!instanceof(dclass, OBJECT_CLASS(val))) {
+				return (val);
+			}
+			lastok = OBJECT_CLASS(val);
+		}
+		*out++ = val;
+	}
+	return (NULL);
+}
+
+/*
+ * Store the value of elemsz bytes at val in count elements at data.
+ */
+void
+bulkArrayFill(void* data, jsize count, int elemsz, const void* val)
+{
+	const uint8* v = val;
+	uint8* p = data;
+	uint8 word[8];
+	size_t len;
+	int i;
+
+	len = (size_t)count * elemsz;
+
+	/* Values made of one byte repeated, such as 0 and -1 */
+	for (i = 1; i < elemsz && v[i] == v[0]; i++)
+		;
+	if (i == elemsz) {
+		memset(p, v[0], len);
+		return;
+	}
+
+	/* Otherwise repeat the value over a word and store words */
+	for (i = 0; i < 8; i += elemsz) {
+		memcpy(word + i, v, (size_t)elemsz);
+	}
+	for (; len >= 8; len -= 8, p += 8) {
+		memcpy(p, word, 8);
+	}
+	memcpy(p, word, len);
+}
+
+/*
+ * Compare count elements of elemsz bytes at a and b, of the primitive
+ * type named by its signature character.  Floats and doubles are equal
+ * the way Float.equals and Double.equals have it: by their bits, except
+ * that all NaNs are equal.
+ */
+bool
+bulkArrayEquals(const void* a, const void* b, jsize count, int elemsz,
+		char type)
+{
+	const jfloat* fa;
+	const jfloat* fb;
+	const jdouble* da;
+	const jdouble* db;
+	jsize i;
+
+	if (memcmp(a, b, (size_t)count * elemsz) == 0) {
+		return (true);
+	}
+
+	switch (type) {
+	case 'F':
+		fa = a;
+		fb = b;
+		for (i = 0; i < count; i++) {
+			if (memcmp(&fa[i], &fb[i], sizeof(jfloat)) != 0
+			    && !(fa[i] != fa[i] && fb[i] != fb[i])) {
+				return (false);
+			}
+		}
+		return (true);
+	case 'D':
+		da = a;
+		db = b;
+		for (i = 0; i < count; i++) {
+			if (memcmp(&da[i], &db[i], sizeof(jdouble)) != 0
+			    && !(da[i] != da[i] && db[i] != db[i])) {
+				return (false);
+			}
+		}
+		return (true);
+	default:
+		return (false);
+	}
+}
+
+/*
+ * Arrays.fill(a, val) and Arrays.equals(a, b) for each primitive type,
+ * called like native methods.
+ */
+#define	BULK_ARRAY_FILL(NAME, ATYPE, JTYPE)				\
+static void								\
+NAME(ATYPE* a, JTYPE val)						\
+{									\
+	if (a == NULL) {						\
+		throwException(NullPointerException);			\
+	}								\
+	bulkArrayFill(ARRAY_DATA(a), ARRAY_SIZE(a), sizeof(JTYPE), &val); \
+}
+
+#define	BULK_ARRAY_EQUALS(NAME, ATYPE, JTYPE, SIG)			\
+static jboolean								\
+NAME(ATYPE* a, ATYPE* b)						\
+{									\
+	if (a == b) {							\
+		return (true);						\
+	}								\
+	if (a == NULL || b == NULL || ARRAY_SIZE(a) != ARRAY_SIZE(b)) { \
+		return (false);						\
+	}								\
+	return (bulkArrayEquals(ARRAY_DATA(a), ARRAY_DATA(b),		\
+				ARRAY_SIZE(a), sizeof(JTYPE), (SIG)));	\
+}
+
+BULK_ARRAY_FILL(fillBoolean, HArrayOfBoolean, jboolean)
+BULK_ARRAY_FILL(fillByte, HArrayOfByte, jbyte)
+BULK_ARRAY_FILL(fillChar, HArrayOfChar, jchar)
+BULK_ARRAY_FILL(fillShort, HArrayOfShort, jshort)
+BULK_ARRAY_FILL(fillInt, HArrayOfInt, jint)
+BULK_ARRAY_FILL(fillLong, HArrayOfLong, jlong)
+BULK_ARRAY_FILL(fillFloat, HArrayOfFloat, jfloat)
+BULK_ARRAY_FILL(fillDouble, HArrayOfDouble, jdouble)
+
+BULK_ARRAY_EQUALS(equalsBoolean, HArrayOfBoolean, jboolean, 'Z')
+BULK_ARRAY_EQUALS(equalsByte, HArrayOfByte, jbyte, 'B')
+BULK_ARRAY_EQUALS(equalsChar, HArrayOfChar, jchar, 'C')
+BULK_ARRAY_EQUALS(equalsShort, HArrayOfShort, jshort, 'S')
+BULK_ARRAY_EQUALS(equalsInt, HArrayOfInt, jint, 'I')
+BULK_ARRAY_EQUALS(equalsLong, HArrayOfLong, jlong, 'J')
+BULK_ARRAY_EQUALS(equalsFloat, HArrayOfFloat, jfloat, 'F')
+BULK_ARRAY_EQUALS(equalsDouble, HArrayOfDouble, jdouble, 'D')
+
+static const struct {
+	const char*	name;
+	const char*	sig;
+	void*		func;
+} arraysIntrinsics[] = {
+	{ "fill",	"([ZZ)V",	(void*)fillBoolean },
+	{ "fill",	"([BB)V",	(void*)fillByte },
+	{ "fill",	"([CC)V",	(void*)fillChar },
+	{ "fill",	"([SS)V",	(void*)fillShort },
+	{ "fill",	"([II)V",	(void*)fillInt },
+	{ "fill",	"([JJ)V",	(void*)fillLong },
+	{ "fill",	"([FF)V",	(void*)fillFloat },
+	{ "fill",	"([DD)V",	(void*)fillDouble },
+	{ "equals",	"([Z[Z)Z",	(void*)equalsBoolean },
+	{ "equals",	"([B[B)Z",	(void*)equalsByte },
+	{ "equals",	"([C[C)Z",	(void*)equalsChar },
+	{ "equals",	"([S[S)Z",	(void*)equalsShort },
+	{ "equals",	"([I[I)Z",	(void*)equalsInt },
+	{ "equals",	"([J[J)Z",	(void*)equalsLong },
+	{ "equals",	"([F[F)Z",	(void*)equalsFloat },
+	{ "equals",	"([D[D)Z",	(void*)equalsDouble },
+};
+
+/*
+ * If meth is one of the methods of java.util.Arrays done here, return
+ * the function to call like a native method in its place, else NULL.
+ */
+void*
+bulkArrayIntrinsic(Method* meth)
+{
+	unsigned int i;
+
+	if (meth->class->loader != NULL || !METHOD_IS_STATIC(meth)
+	    || strcmp(CLASS_CNAME(meth->class), "java/util/Arrays") != 0) {
+		return (NULL);
+	}
+	for (i = 0; i < sizeof(arraysIntrinsics) / sizeof(arraysIntrinsics[0]); i++) {
+		if (strcmp(meth->name->data, arraysIntrinsics[i].name) == 0
+		    && strcmp(METHOD_SIGD(meth), arraysIntrinsics[i].sig) == 0) {
+			return (arraysIntrinsics[i].func);
+		}
+	}
+	return (NULL);
+}
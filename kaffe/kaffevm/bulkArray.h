@@ -0,0 +1,30 @@
+/*
+ * bulkArray.h
+ * Operations on whole arrays.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#ifndef __kaffevm_bulkArray_h
+#define __kaffevm_bulkArray_h
+
+#include "gtypes.h"
+
+struct Hjava_lang_Object;
+struct _jmethodID;
+
+extern struct Hjava_lang_Object* bulkArrayCopyRefs(struct Hjava_lang_Object* src,
+						   jint srcpos,
+						   struct Hjava_lang_Object* dst,
+						   jint dstpos, jint len);
+extern void	bulkArrayFill(void* data, jsize count, int elemsz,
+			      const void* val);
+extern bool	bulkArrayEquals(const void* a, const void* b, jsize count,
+				int elemsz, char type);
+extern void*	bulkArrayIntrinsic(struct _jmethodID* meth);
+
+#endif /* __kaffevm_bulkArray_h */
@@ -49,6 +49,8 @@
 #include "jvmpi_kaffe.h"
 #include "kaffe/jmalloc.h"
 #include "methodcalls.h"
+#include "startupTrace.h"
+#include "clinitAhead.h"
 
 /* interfaces supported by arrays */
 static Hjava_lang_Class* arr_interfaces[2];
@@ -116,7 +118,7 @@ initialiseSecurity (void)
 #define	ALIGNMENT_OF_SIZE(S)	(S)
 #endif
 
-/* set a class's alloc_type field */
+/* set a class's alloc_type field, class->finalizer must be known */
 static void
 determineAllocType(Hjava_lang_Class *class)
 {
@@ -126,7 +128,10 @@ determineAllocType(Hjava_lang_Class *class)
     if (ClassLoaderClass != 0 && instanceof(ClassLoaderClass, class))
       class->alloc_type = KGC_ALLOC_JAVALOADER;
     else
-      class->alloc_type = KGC_ALLOC_FINALIZEOBJECT;
+      if (class->finalizer == NULL)
+        class->alloc_type = KGC_ALLOC_NORMALOBJECT;
+      else
+        class->alloc_type = KGC_ALLOC_FINALIZEOBJECT;
 }
 
 /*
@@ -145,18 +150,32 @@ processClass(Hjava_lang_Class* class, int tostate, errorInfo *einfo)
 	classEntry *ce;
 	Hjava_lang_Class* nclass;
 	bool success = true;	/* optimistic */
+	statTime traceStart;
 #if !(defined(NDEBUG) || !defined(KAFFE_VMDEBUG))
 	int i;
 	static int depth;
 #endif /* !(defined(NDEBUG) || !defined(KAFFE_VMDEBUG)) */
 	static Method *object_fin;
 
+	/* Whether the running static initializer is a leaf, see clinitAhead.c */
+	if (clinitRecording && tostate == CSTATE_COMPLETE) {
+		clinitRecordTouch(class);
+	}
+
 	/* If this class is initialised to the required point, quit now */
-	if (class->state >= tostate) {
+	if (getClassState(class) >= tostate) {
 		return (true);
 	}
 
-#define	SET_CLASS_STATE(S)	class->state = (S)
+/*
+ * Threads read the state without the class lock, see getClassState, so
+ * everything done to reach a state must be seen before the state itself.
+ */
+#define	SET_CLASS_STATE(S)						\
+	do {								\
+		atomic_write_barrier();					\
+		class->state = (S);					\
+	} while (0)
 #define	DO_CLASS_STATE(S)	if ((S) > class->state && (S) <= tostate)
 
 	/* For the moment we only allow one thread to initialise any classes
@@ -260,6 +279,7 @@ retry:
 			 */
 			CLASS_FSIZE(class) = CLASS_FSIZE(getSuperclass(class));
 			class->gc_layout = getSuperclass(class)->gc_layout;
+			class->gc_nranges = getSuperclass(class)->gc_nranges;
 		}
 		if( class->superclass )
 		{
@@ -272,7 +292,10 @@ retry:
 		/*
 		 * Second stage verification - check the class format is okay
 		 */
+		traceStart = STARTUP_TRACE_START();
 		success =  verify2(class, einfo);
+		STARTUP_TRACE_END(traceStart, "verify", CLASS_CNAME(class),
+				  "format");
 		if (success == false) {
 			goto done;
 		}
@@ -282,6 +305,7 @@ retry:
 	
 	DO_CLASS_STATE(CSTATE_PREPARED) {
 
+		traceStart = STARTUP_TRACE_START();
 		if( (class->loader == 0) && !gc_add_ref(class) )
 		{
 			postOutOfMemory(einfo);
@@ -358,6 +382,8 @@ retry:
 		}
 
 		SET_CLASS_STATE(CSTATE_PREPARED);
+		STARTUP_TRACE_END(traceStart, "link", CLASS_CNAME(class),
+				  "prepare");
 		
 		setClassMappingState(ce, NMS_DONE);
 		
@@ -401,7 +427,10 @@ retry:
 		SET_CLASS_STATE(CSTATE_DOING_LINK);
 		
 		/* Third stage verification - check the bytecode is okay */
+		traceStart = STARTUP_TRACE_START();
 		success = verify3(class, einfo);
+		STARTUP_TRACE_END(traceStart, "verify", CLASS_CNAME(class),
+				  "bytecode");
 		if (success == false) {
 			goto done;
 		}
@@ -442,7 +471,10 @@ retry:
 #endif /* defined(HAVE_GCJ_SUPPORT) */
 
 		/* Initialise the constants */
+		traceStart = STARTUP_TRACE_START();
 		success = resolveConstants(class, einfo);
+		STARTUP_TRACE_END(traceStart, "link", CLASS_CNAME(class),
+				  "constants");
 		if (success == false) {
 			goto done;
 		}
@@ -587,9 +619,18 @@ DBG(STATICINIT, dprintf("Initialising %s static %d\n", class->name->data,
 		excpending = THREAD_DATA()->exceptObj;
 		THREAD_DATA()->exceptObj = NULL;
 
+		if (clinitRecording) {
+			clinitRecordBegin(class);
+		}
+		traceStart = STARTUP_TRACE_START();
 		KaffeVM_safeCallMethodA(meth, METHOD_NATIVECODE(meth), NULL, NULL, NULL, 0);
+		STARTUP_TRACE_END(traceStart, "clinit", CLASS_CNAME(class),
+				  NULL);
 		exc = THREAD_DATA()->exceptObj;
 		THREAD_DATA()->exceptObj = excpending;
+		if (clinitRecording) {
+			clinitRecordEnd(class, exc == NULL);
+		}
 
 		lockClass(class);
 
@@ -1722,6 +1763,19 @@ resolveFieldType(Field *fld, Hjava_lang_Class* this, errorInfo *einfo)
 	return (clas);
 }
 
+/*
+ * Whether the collector follows the instance field fld of class.
+ */
+static bool
+isCollectedField(Hjava_lang_Class* class, Field* fld)
+{
+	if (FIELD_RESOLVED(fld)) {
+		return (FIELD_ISREF(fld));
+	}
+	return (fieldIsCollected(CLASS_CNAME(class), FIELD_NAME(fld),
+				 fld->signature->data));
+}
+
 static
 bool
 resolveObjectFields(Hjava_lang_Class* class, errorInfo *einfo)
@@ -1729,122 +1783,85 @@ resolveObjectFields(Hjava_lang_Class* class, errorInfo *einfo)
 	int fsize;
 	int align;
 	Field* fld;
-	int nbits, nifields;
+	int nifields;
 	int offset;
-	int maxalign;
-	int oldoffset;
-	int *map;
-	jboolean is_reference;
+	int group;
+	int nrefs;
+	int refstart;
+	int nranges;
+	gcRefRange* ranges;
 
 	/* Find start of new fields in this object.  If start is zero, we must
 	 * allow for the object headers.
 	 */
 	offset = CLASS_FSIZE(class);
-	oldoffset = offset;	/* remember initial offset */
 	if (offset == 0) {
 		offset = sizeof(Hjava_lang_Object);
 	}
 
-	/* Find the largest alignment in this class */
-	maxalign = 1;
-	fld = CLASS_IFIELDS(class);
-	nifields = CLASS_NIFIELDS(class);
-	for (; --nifields >= 0; fld++) {
-		fsize = FIELD_SIZE(fld);
-		/* Work out alignment for this size entity */
-		fsize = ALIGNMENT_OF_SIZE(fsize);
-		/* If field is bigger than biggest alignment, change
-		 * biggest alignment
-		 */
-		if (fsize > maxalign) {
-			maxalign = fsize;
+	/* Now work out where to put each field, group by group (see
+	 * FIELD_LAYOUT_GROUP) and in declaration order within a group.
+	 */
+	nrefs = 0;
+	refstart = offset;
+	for (group = 0; group < FIELD_LAYOUT_GROUPS; group++) {
+		fld = CLASS_IFIELDS(class);
+		nifields = CLASS_NIFIELDS(class);
+		for (; --nifields >= 0; fld++) {
+			fsize = FIELD_SIZE(fld);
+			if (FIELD_LAYOUT_GROUP(fsize, isCollectedField(class, fld))
+			    != group) {
+				continue;
+			}
+			/* Align field */
+			align = ALIGNMENT_OF_SIZE(fsize);
+			offset = ((offset + align - 1) / align) * align;
+			FIELD_BOFFSET(fld) = offset;
+			if (group == 0 && nrefs++ == 0) {
+				refstart = offset;
+			}
+			offset += fsize;
 		}
 	}
 
-	/* Now work out where to put each field */
-	fld = CLASS_IFIELDS(class);
-	nifields = CLASS_NIFIELDS(class);
-	for (; --nifields >= 0; fld++) {
-		fsize = FIELD_SIZE(fld);
-		/* Align field */
-		align = ALIGNMENT_OF_SIZE(fsize);
-		offset = ((offset + align - 1) / align) * align;
-		FIELD_BOFFSET(fld) = offset;
-		offset += fsize;
-	}
-
 	CLASS_FSIZE(class) = offset;
 
-	/* recall old offset */
-	offset = oldoffset;
-
-	/* Check whether the class is java.lang.ref.Reference */
-	is_reference =
-	   (strcmp(CLASS_CNAME(class), "java/lang/ref/Reference") == 0);
+DBG(GCPRECISE,
+	dprintf("GCLayout for %s: %d new references at offset %d\n",
+		CLASS_CNAME(class), nrefs, refstart);
+    );
 
-	/* Now that we know how big that object is going to be, create
-	 * a bitmap to help the gc scan the object.  The first part is
-	 * inherited from the superclass.
+	/* The references of this class follow those of the superclass,
+	 * which we keep sharing if there are none.
 	 */
-	map = BITMAP_NEW(CLASS_FSIZE(class)/ALIGNMENTOF_VOIDP, KGC_ALLOC_CLASSMISC);
-	if (map == 0) {
+	if (nrefs == 0) {
+		return (true);
+	}
+	assert(refstart % ALIGNMENTOF_VOIDP == 0);
+
+	nranges = class->gc_nranges;
+	ranges = gc_malloc((nranges + 1) * sizeof(gcRefRange),
+			   KGC_ALLOC_CLASSMISC);
+	if (ranges == NULL) {
 		postOutOfMemory(einfo);
 		return (false);
 	}
-
-	if (offset > 0) {
-		nbits = offset/ALIGNMENTOF_VOIDP;
-		BITMAP_COPY(map, class->gc_layout, nbits);
-	} else {
-		/* The walkObject routine marks the class object explicitly.
-		 * We assume that the header does not contain anything ELSE
-		 * that must be marked.
-		 */
-		offset = sizeof(Hjava_lang_Object);
-		nbits = offset/ALIGNMENTOF_VOIDP;
+	if (nranges > 0) {
+		memcpy(ranges, class->gc_layout, nranges * sizeof(gcRefRange));
 	}
-	class->gc_layout = map;
-
-	nbits = offset/ALIGNMENTOF_VOIDP;
-
-DBG(GCPRECISE,
-	dprintf("GCLayout for %s:\n", CLASS_CNAME(class));
-    );
-
-	/* Now work out the gc layout */
-	fld = CLASS_IFIELDS(class);
-	nifields = CLASS_NIFIELDS(class);
-	for (; --nifields >= 0; fld++) {
-		fsize = FIELD_SIZE(fld);
-		/* Align field */
-		align = ALIGNMENT_OF_SIZE(fsize);
-		offset += (align - (offset % align)) % align;
-		nbits = offset/ALIGNMENTOF_VOIDP;
-
-		/* paranoia */
-		assert(FIELD_BOFFSET(fld) == offset);
-
-		/* Set bit if this field is a reference type, except if
-		 * it's a kaffe.util.Ptr (PTRCLASS).  */
-		if (!FIELD_RESOLVED(fld)) {
-			Utf8Const *sig = fld->signature;
-			if ((sig->data[0] == 'L' || sig->data[0] == '[') &&
-			    strcmp(sig->data, PTRCLASSSIG) &&
-			    (!is_reference || strcmp(FIELD_NAME(fld), "referent") != 0)) {
-				BITMAP_SET(map, nbits);
-			}
-		} else {
-			if (FIELD_ISREF(fld) ) {
-				BITMAP_SET(map, nbits);
-			}
-		}
-DBG(GCPRECISE,
-		dprintf(" offset=%3d nbits=%2d ", offset, nbits);
-		BITMAP_DUMP(map, nbits+1)
-		dprintf(" fsize=%3d (%s)\n", fsize, fld->name->data);
-    );
-		offset += fsize;
+	refstart /= ALIGNMENTOF_VOIDP;
+	if (nranges > 0 && ranges[nranges - 1].start
+	    + ranges[nranges - 1].count == (uint32)refstart) {
+		ranges[nranges - 1].count += nrefs;
 	}
+	else {
+		ranges[nranges].start = refstart;
+		ranges[nranges].count = nrefs;
+		nranges++;
+	}
+	class->gc_layout = ranges;
+	class->gc_nranges = nranges;
+
 	return (true);
 }
 
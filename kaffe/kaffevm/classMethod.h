@@ -24,6 +24,7 @@
 #include "errors.h"
 #include "jthread.h"
 #include "locks.h"
+#include "clinitAhead.h"
 
 #define	MAXMETHOD		64
 
@@ -48,6 +49,7 @@ typedef enum {
 
 struct _classEntry;
 struct _innerClass;
+struct _callMethodInfo;
 struct Hjava_lang_String;
 
 #include <java_lang_ClassLoader.h>
@@ -84,6 +86,12 @@ typedef enum {
 	STYPE_MAX
 } stype_t;
 
+/* A run of references in an object, in words from its start */
+typedef struct _gcRefRange {
+	uint32			start;
+	uint32			count;
+} gcRefRange;
+
 struct Hjava_lang_Class {
 	Hjava_lang_Object	head;		/* A class is an object too */
 
@@ -159,11 +167,12 @@ struct Hjava_lang_Class {
 
 	Hjava_lang_ClassLoader*	loader;
 
-	/* A bitmap describing the layout of instances of that class.
-	   It contains CLASS_FSIZE/ALIGNMENTVOIDP bits.
-	   The MSB corresponds to the dtable field.
+	/* The references the collector follows in instances of that
+	   class, as gc_nranges runs of words, see resolveObjectFields.
+	   The object header is not part of them.
 	 */
-	int*			gc_layout;
+	gcRefRange*		gc_layout;
+	int			gc_nranges;
 	class_state_t		state;
 	void*			processingThread;
 	/* This pointer contains the method which should be called
@@ -181,6 +190,15 @@ struct Hjava_lang_Class {
 	short			nr_inner_classes;
 	struct _innerClass*	inner_classes;
 
+	/* Root reflection objects, copied before they are handed out.
+	 * They are only softly reachable, see reflect.c and walkClass.
+	 */
+	struct HArrayOfObject*	reflect_methods;
+	struct HArrayOfObject*	reflect_constructors;
+	struct HArrayOfObject*	reflect_fields;
+	/* the collection the reflection cache was last used in */
+	uint32			reflect_used;
+
 	/* misc other stuff */
 	void*			gcjPeer;	/* only needed if GCJ_SUPPORT */
 #ifdef KAFFE_VMDEBUG
@@ -338,6 +356,7 @@ typedef struct _jmethodID {
 	Hjava_lang_Class*	class;
 	struct _lineNumbers*	lines;
 	struct _localVariables* lvars;
+	struct _stackMapTable*	stackmap;
 	struct _jexception*	exception_table;
 	int			ndeclared_exceptions;
 	union {
@@ -346,6 +365,8 @@ typedef struct _jmethodID {
 	} declared_exceptions_u;
 #define declared_exceptions declared_exceptions_u.local_exceptions
 	int			framesize;	/* JIT only: size of frame */
+	/* Interpreter only: call stub of a native method, see javacall.c */
+	void			(*callStub)(struct _callMethodInfo*);
 
 #if defined(KAFFE_PROFILER)
 	profiler_click_t	jitClicks;
@@ -419,6 +440,32 @@ typedef struct _jfieldID {
 				 && FIELD_TYPE(FLD) != PtrClass)
 #define FIELD_NAME(FLD)		((FLD)->name->data)
 
+/*
+ * Instance fields are laid out in groups: first the references the
+ * collector follows, then the other fields by falling size.  This
+ * wastes no padding and keeps the references of a class together.
+ * kaffeh writes the members of its structures in the same order.
+ */
+#define	FIELD_LAYOUT_GROUPS	5
+#define	FIELD_LAYOUT_GROUP(SIZE, COLLECTED)				\
+	((COLLECTED) ? 0 :						\
+	 (SIZE) >= 8 ? 1 : (SIZE) >= 4 ? 2 : (SIZE) >= 2 ? 3 : 4)
+
+/*
+ * Whether the collector follows the instance field fname with
+ * signature sig of class cname.  A kaffe.util.Ptr (PTRCLASSSIG) holds
+ * no object and the referent of a java.lang.ref.Reference is cleared by
+ * the collector.
+ */
+static inline bool
+fieldIsCollected(const char *cname, const char *fname, const char *sig)
+{
+	return ((sig[0] == 'L' || sig[0] == '[')
+		&& strcmp(sig, "Lorg/kaffe/util/Ptr;") != 0
+		&& (strcmp(cname, "java/lang/ref/Reference") != 0
+		    || strcmp(fname, "referent") != 0));
+}
+
 #define	CLASSMAXSIG		256
 
 struct _Code;
@@ -794,6 +841,7 @@ extern Utf8Const* void_signature;	/* "()V" */
 extern Utf8Const* Code_name;		/* "Code" */
 extern Utf8Const* LineNumberTable_name;	/* "LineNumberTable" */
 extern Utf8Const* LocalVariableTable_name;	/* "LocalVariableTable" */
+extern Utf8Const* StackMapTable_name;	/* "StackMapTable" */
 extern Utf8Const* ConstantValue_name;	/* "ConstantValue" */
 extern Utf8Const* Exceptions_name;	/* "Exceptions" */
 extern Utf8Const* SourceFile_name;	/* "SourceFile" */
@@ -816,4 +864,50 @@ static inline struct Hjava_lang_Class* getSuperclass(struct Hjava_lang_Class* cl
   return class->superclass;
 }
 
+/**
+ * get the state of a class without holding its lock.
+ *
+ * processClass stores a new state only after everything done to reach
+ * it, so a thread that reads a state here also sees what was done to get
+ * there, such as the stores of the static initializer once the class is
+ * CSTATE_COMPLETE.
+ *
+ * @param class the class
+ *
+ * @return state of class
+ */
+static inline class_state_t getClassState(struct Hjava_lang_Class* class)
+{
+  class_state_t state = *(volatile class_state_t *)&class->state;
+
+  atomic_read_barrier();
+  return state;
+}
+
+/**
+ * check whether a class is initialized, without taking its lock.
+ *
+ * @param class the class
+ *
+ * @return true if class is initialized
+ */
+static inline bool classIsInitialised(struct Hjava_lang_Class* class)
+{
+  return getClassState(class) == CSTATE_COMPLETE;
+}
+
+/**
+ * check whether processClass must be asked before a class is used.  It
+ * need not once the class is initialized, except while static
+ * initializers are being recorded, see clinitAhead.c.
+ *
+ * @param class the class
+ *
+ * @return true if the class has to go through processClass
+ */
+static inline bool classNeedsInit(struct Hjava_lang_Class* class)
+{
+  return clinitRecording || !classIsInitialised(class);
+}
+
 #endif
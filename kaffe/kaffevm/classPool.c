@@ -32,10 +32,8 @@
 #define	CLASSHASHSZ	256	/* Must be a power of two */
 static iStaticLock	classHashLock;
 static classEntry* classEntryPool[CLASSHASHSZ];
-#if defined(KAFFE_STATS)
-statobject classStats;
-void statClassPool(void);
-#endif
+static statobject classStats;
+static void statClassPool(void);
 
 /*
  * Lookup an entry for a given (name, loader) pair.
@@ -497,7 +495,6 @@ void KaffeVM_initClassPool()
   initStaticLock(&mappingLock);
 }
 
-#if defined(KAFFE_STATS) || defined(KAFFE_PROFILER) || defined(KAFFE_VMDEBUG)
 /**
  * Walk the class pool and invoke walker() for each classes
  */
@@ -519,13 +516,12 @@ walkClassPool(int (*walker)(Hjava_lang_Class *clazz, void *), void *param)
 		}
 	}
 }
-#endif
 
 
-#if defined(KAFFE_STATS)
-static void
-statClass(Hjava_lang_Class *clazz, int *total)
+static int
+statClass(Hjava_lang_Class *clazz, void *param)
 {
+	int *total = param;
 	Collector *c = main_collector;
 	int misc = 0;
 	int miscfixed = 0;
@@ -568,6 +564,7 @@ statClass(Hjava_lang_Class *clazz, int *total)
 		for (i = 0; i < n; m++, i++) {
 			miscfixed += SIZE_IFNONZERO(m->parsed_sig);
 			miscfixed += SIZE_IFNONZERO(m->lines);
+			miscfixed += SIZE_IFNONZERO(m->stackmap);
 			miscfixed += SIZE_IFNONZERO(m->declared_exceptions);
 			misc += SIZE_IFNONZERO(m->exception_table);
 			/* bytecode or jitted code */
@@ -592,9 +589,10 @@ statClass(Hjava_lang_Class *clazz, int *total)
 	total[1] += miscfixed;
 	total[2] += jitmem;
 	total[3] += bytecodemem;
+	return 0;
 }
 
-void
+static void
 statClassPool(void)
 {
 	int total[20];
@@ -611,5 +609,4 @@ statClassPool(void)
 		total[3]/1024.0);
 	fflush(stderr);
 }
-#endif
 
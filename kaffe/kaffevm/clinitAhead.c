@@ -0,0 +1,343 @@
+/*
+ * clinitAhead.c
+ * Running static initializers ahead of their first use.
+ *
+ * A run with a record file notes, for each class of the bootstrap class
+ * loader whose static initializer completed, whether the initializer
+ * asked for another class to be initialized while it ran, even one that
+ * already was.  Those which did not, the leaves, are written out at exit
+ * in the order they finished.  While recording, the checks that skip
+ * processClass for initialized classes are off and translated code asks
+ * for the class of every static call, see classNeedsInit, so every
+ * class an initializer uses is seen.
+ *
+ * A later run given that file as its order starts a few daemon threads
+ * once the virtual machine is up.  They go through the classes in order
+ * and initialize each one nobody has started on yet, so that the threads
+ * which use them later find the work done.  The initialization itself is
+ * left to processClass, so a class used while one of our threads is in
+ * its initializer is waited for as the language wants, and one already
+ * being initialized elsewhere is skipped.  A class whose superclass isn't
+ * initialized yet is skipped too: its initializer is not a leaf then.
+ *
+ * This is speculative and only for when the recorded run is like this
+ * one.  An initializer that throws leaves its class erroneous as usual,
+ * and one that depends on which thread runs it should not be recorded.
+ * A leaf starts no other initialization, so the threads running ahead
+ * never wait for another class.  That holds for this run only as far as
+ * it is like the recorded one, and a leaf that takes a monitor can still
+ * wait for a thread that is itself waiting for the initializer.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include "config.h"
+#include "config-std.h"
+#include "config-mem.h"
+#include "jni_md.h"
+#include "gtypes.h"
+#include "classMethod.h"
+#include "jthread.h"
+#include "thread.h"
+#include "locks.h"
+#include "errors.h"
+#include "utf8const.h"
+#include "debug.h"
+#include "clinitAhead.h"
+
+/* Threads recorded at once, initializers on later ones aren't recorded */
+#define	CLINITAHEAD_RECORD_THREADS	64
+
+/* Initializers running on one thread while recording */
+typedef struct _recordThread {
+	jthread_t	thread;
+	int		depth;
+	bool		leaf[CLINITAHEAD_DEPTH];
+	Hjava_lang_Class *class[CLINITAHEAD_DEPTH];
+} recordThread;
+
+bool clinitRecording;
+
+static const char *recordFile;
+static const char *orderFile;
+
+static iStaticLock aheadLock;
+
+static recordThread recordThreads[CLINITAHEAD_RECORD_THREADS];
+static int nrecordThreads;
+
+/* Class names, recorded or to initialize */
+static char **names;
+static int nnames;
+static int maxnames;
+
+/* The next of names to initialize */
+static int nextName;
+
+static bool
+addName(const char *name)
+{
+	char **n;
+	char *s;
+
+	if (nnames == maxnames) {
+		maxnames = maxnames == 0 ? 256 : maxnames * 2;
+		n = realloc(names, maxnames * sizeof(char *));
+		if (n == NULL) {
+			return (false);
+		}
+		names = n;
+	}
+	s = strdup(name);
+	if (s == NULL) {
+		return (false);
+	}
+	names[nnames++] = s;
+	return (true);
+}
+
+/*
+ * The initializers running on the current thread.  Called with the lock
+ * held.
+ */
+static recordThread *
+currentRecordThread(void)
+{
+	jthread_t cur = KTHREAD(current)();
+	int i;
+
+	for (i = 0; i < nrecordThreads; i++) {
+		if (recordThreads[i].thread == cur) {
+			return (&recordThreads[i]);
+		}
+	}
+	if (nrecordThreads < CLINITAHEAD_RECORD_THREADS) {
+		recordThreads[nrecordThreads].thread = cur;
+		recordThreads[nrecordThreads].depth = 0;
+		return (&recordThreads[nrecordThreads++]);
+	}
+	return (NULL);
+}
+
+/*
+ * Class is wanted initialized on this thread.  The static initializer
+ * running on it, if any and if it isn't the one of class, is not a leaf.
+ */
+void
+clinitRecordTouch(Hjava_lang_Class *class)
+{
+	recordThread *rt;
+
+	lockStaticMutex(&aheadLock);
+	rt = currentRecordThread();
+	if (rt != NULL && rt->depth > 0 && rt->depth <= CLINITAHEAD_DEPTH
+	    && rt->class[rt->depth - 1] != class) {
+		rt->leaf[rt->depth - 1] = false;
+	}
+	unlockStaticMutex(&aheadLock);
+}
+
+/*
+ * The static initializer of class is about to run on this thread.
+ */
+void
+clinitRecordBegin(Hjava_lang_Class *class)
+{
+	recordThread *rt;
+
+	lockStaticMutex(&aheadLock);
+	rt = currentRecordThread();
+	if (rt != NULL) {
+		if (rt->depth < CLINITAHEAD_DEPTH) {
+			rt->leaf[rt->depth] = true;
+			rt->class[rt->depth] = class;
+		}
+		rt->depth++;
+	}
+	unlockStaticMutex(&aheadLock);
+}
+
+/*
+ * The static initializer of class has finished, successfully if ok.
+ */
+void
+clinitRecordEnd(Hjava_lang_Class *class, bool ok)
+{
+	recordThread *rt;
+
+	lockStaticMutex(&aheadLock);
+	rt = currentRecordThread();
+	if (rt != NULL && rt->depth > 0) {
+		rt->depth--;
+		if (ok && rt->depth < CLINITAHEAD_DEPTH
+		    && rt->leaf[rt->depth] && class->loader == NULL) {
+			addName(CLASS_CNAME(class));
+		}
+	}
+	unlockStaticMutex(&aheadLock);
+}
+
+static void
+clinitRecordWrite(void)
+{
+	FILE *fp;
+	int i;
+
+	fp = fopen(recordFile, "w");
+	if (fp == NULL) {
+		dprintf("Unable to write initialization order %s\n",
+			recordFile);
+		return;
+	}
+	lockStaticMutex(&aheadLock);
+	for (i = 0; i < nnames; i++) {
+		fprintf(fp, "%s\n", names[i]);
+	}
+	unlockStaticMutex(&aheadLock);
+	fclose(fp);
+}
+
+/*
+ * Read the classes to initialize, one name per line.  Lines that are
+ * empty or start with '#' are skipped.
+ */
+static bool
+clinitReadOrder(void)
+{
+	char line[1024];
+	FILE *fp;
+	size_t len;
+
+	fp = fopen(orderFile, "r");
+	if (fp == NULL) {
+		dprintf("Unable to read initialization order %s\n",
+			orderFile);
+		return (false);
+	}
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		len = strlen(line);
+		while (len > 0 && (line[len - 1] == '\n'
+				   || line[len - 1] == '\r')) {
+			line[--len] = '\0';
+		}
+		if (len == 0 || line[0] == '#') {
+			continue;
+		}
+		if (!addName(line)) {
+			break;
+		}
+	}
+	fclose(fp);
+	return (nnames > 0);
+}
+
+/*
+ * Initialize the class called name, unless someone got to it first or
+ * it isn't a leaf now.
+ */
+static void
+clinitAheadRun(const char *name)
+{
+	Hjava_lang_Class *class;
+	Utf8Const *utf8;
+	errorInfo info;
+
+	utf8 = utf8ConstFromString(name);
+	if (utf8 == NULL) {
+		return;
+	}
+	class = loadClass(utf8, NULL, &info);
+	utf8ConstRelease(utf8);
+	if (class == NULL) {
+		discardErrorInfo(&info);
+		return;
+	}
+
+	if (getClassState(class) >= CSTATE_DOING_INIT
+	    || (class->superclass != NULL
+		&& !classIsInitialised(class->superclass))) {
+		return;
+	}
+	if (processClass(class, CSTATE_COMPLETE, &info) == false) {
+		discardErrorInfo(&info);
+	}
+}
+
+static void
+clinitAheadWorker(void *arg UNUSED)
+{
+	int i;
+
+	for (;;) {
+		lockStaticMutex(&aheadLock);
+		i = nextName < nnames ? nextName++ : -1;
+		unlockStaticMutex(&aheadLock);
+		if (i < 0) {
+			break;
+		}
+		clinitAheadRun(names[i]);
+	}
+}
+
+/*
+ * Write the order static initializers finished in to file at exit.
+ */
+void
+clinitAheadSetRecordFile(const char *file)
+{
+	recordFile = file;
+}
+
+/*
+ * Initialize the classes in file ahead once the virtual machine is up.
+ */
+void
+clinitAheadSetOrderFile(const char *file)
+{
+	orderFile = file;
+}
+
+/*
+ * The locking system is up, start recording if asked to.
+ */
+void
+clinitAheadInit(void)
+{
+	if (recordFile == NULL && orderFile == NULL) {
+		return;
+	}
+	initStaticLock(&aheadLock);
+	if (recordFile != NULL) {
+		/* The names read are the ones recorded otherwise */
+		orderFile = NULL;
+		clinitRecording = true;
+		atexit(clinitRecordWrite);
+	}
+}
+
+/*
+ * The virtual machine is up, start the threads initializing classes
+ * ahead if asked to.
+ */
+void
+clinitAheadStart(void)
+{
+	errorInfo info;
+	int i;
+
+	if (orderFile == NULL || !clinitReadOrder()) {
+		return;
+	}
+	for (i = 0; i < CLINITAHEAD_THREADS; i++) {
+		if (createDaemon(&clinitAheadWorker, "clinit", NULL,
+				 java_lang_Thread_NORM_PRIORITY,
+				 THREADSTACKSIZE, &info) == NULL) {
+			discardErrorInfo(&info);
+			return;
+		}
+	}
+}
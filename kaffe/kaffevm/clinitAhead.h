@@ -0,0 +1,33 @@
+/*
+ * clinitAhead.h
+ * Running static initializers ahead of their first use.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#ifndef __kaffevm_clinitAhead_h
+#define __kaffevm_clinitAhead_h
+
+/* Threads running static initializers ahead */
+#define	CLINITAHEAD_THREADS	2
+
+/* Nested static initializers followed on each thread while recording */
+#define	CLINITAHEAD_DEPTH	32
+
+struct Hjava_lang_Class;
+
+extern bool clinitRecording;
+
+extern void clinitAheadSetRecordFile(const char *file);
+extern void clinitAheadSetOrderFile(const char *file);
+extern void clinitAheadInit(void);
+extern void clinitAheadStart(void);
+extern void clinitRecordTouch(struct Hjava_lang_Class *class);
+extern void clinitRecordBegin(struct Hjava_lang_Class *class);
+extern void clinitRecordEnd(struct Hjava_lang_Class *class, bool ok);
+
+#endif /* __kaffevm_clinitAhead_h */
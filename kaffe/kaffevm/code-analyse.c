@@ -69,12 +69,8 @@ analyzeBasicBlock(codeinfo* codeInfo, Method* meth, uint32 pc, errorInfo *einfo)
 	/* Get stack pointer */
 	sp = STACKPOINTER(pc);
 
-	/* Allocate frame to hold type data */
-	activeFrame = ALLOCFRAME();
-	if (activeFrame == 0) {
-		postOutOfMemory(einfo);
-		return true;
-	}
+	/* The frame to hold type data is the same for each block */
+	activeFrame = codeInfo->activeFrame;
 
 	SET_DONEVERIFY(pc);
 
@@ -1681,9 +1677,6 @@ IDBG(		dprintf("%d: %d\n", pc, INSN(pc));		)
 	}
 
 done:
-	/* Discard active frame */
-	KFREE(activeFrame);
-
 	return (failed);
 
 done_fail:
@@ -1708,6 +1701,7 @@ analyzeMethod(Method* meth, codeinfo **pcodeinfo, errorInfo *einfo)
 	bool wide;
 	codeinfo *codeInfo;
 	localUse* localuse;
+	arena mem;
 
 DBG(CODEANALYSE,
 	dprintf("%s %p: %s.%s\n", __FUNCTION__, THREAD_NATIVE(), 
@@ -1723,19 +1717,23 @@ DBG(CODEANALYSE,
 		return false;
 	}
 
-	codeInfo = gc_malloc(sizeof(codeinfo) + meth->c.bcode.codelen*sizeof(perPCInfo),
-			     KGC_ALLOC_CODEANALYSE);
+	/* Everything we allocate lives until tidyAnalyzeMethod */
+	arenaInit(&mem);
+	codeInfo = arenaAlloc(&mem, sizeof(codeinfo) + meth->c.bcode.codelen*sizeof(perPCInfo));
 	*pcodeinfo = codeInfo;
 	if (!codeInfo) {
+		arenaRelease(&mem);
 		postOutOfMemory(einfo);
 		return false;
 	}
+	codeInfo->mem = mem;
+
 	/* Allocate space for local register info - we add in an extra one
 	 * to avoid mallocing 0 bytes.
 	 */
-	localuse = gc_malloc(sizeof(localUse) * (meth->localsz+1), KGC_ALLOC_CODEANALYSE);
+	localuse = arenaAlloc(&codeInfo->mem, sizeof(localUse) * (meth->localsz+1));
 	if (!localuse) {
-		KFREE(codeInfo);
+		tidyAnalyzeMethod(pcodeinfo);
 		postOutOfMemory(einfo);
 		return false;
 	}
@@ -1762,6 +1760,14 @@ DBG(CODEANALYSE,
 	codeInfo->stacksz = meth->stacksz;
 	codeInfo->codelen = meth->c.bcode.codelen;
 
+	codeInfo->activeFrame = ALLOCFRAME();
+	if (codeInfo->activeFrame == 0) {
+		meth->kFlags &= ~KFLAG_VERIFIED;
+		tidyAnalyzeMethod(pcodeinfo);
+		postOutOfMemory(einfo);
+		return false;
+	}
+
 	/* First basic block becomes head of block chain */
 	SET_NEEDVERIFY(0);
 	bhead = &codeInfo->perPC[0];
@@ -2046,19 +2052,14 @@ mergeFrame(codeinfo* codeInfo, int pc, int sp, frameElement* from, Method* meth)
 void
 tidyAnalyzeMethod(codeinfo** codeInfo)
 {
-	int pc;
+	arena mem;
 
-	/* Free the old data */
+	/* Free the old data, codeInfo itself included */
 	if (!*codeInfo) {
 		return;
 	}
-	for (pc = 0; pc < (*codeInfo)->codelen; pc++) {
-		if ((*codeInfo)->perPC[pc].frame != 0) {
-			KFREE((*codeInfo)->perPC[pc].frame);
-		}
-	}
-	KFREE((*codeInfo)->localuse);
-	KFREE(*codeInfo);
+	mem = (*codeInfo)->mem;
+	arenaRelease(&mem);
 	*codeInfo = NULL;
 DBG(CODEANALYSE,
 	dprintf("%s %p: clearing codeInfo %p\n",__FUNCTION__, 
@@ -12,6 +12,7 @@
 #define __code_analyse_h
 
 #include "classMethod.h"
+#include "arena.h"
 
 typedef	struct {
 	Hjava_lang_Class*	type;
@@ -42,6 +43,8 @@ typedef struct codeinfo {
 	uint16			stacksz;
 	uint16			localsz;
 	localUse*		localuse;
+	frameElement*		activeFrame;	/* see analyzeBasicBlock */
+	arena			mem;		/* all of the above is from here */
 	perPCInfo		perPC[1];
 } codeinfo;
 
@@ -153,7 +156,7 @@ typedef struct codeinfo {
 					  IS_STARTOFEXCEPTION(pc)) && \
 					  !IS_DONEVERIFY(pc))
 
-#define	ALLOCFRAME()			gc_malloc((codeInfo->stacksz+codeInfo->localsz+1) * sizeof(frameElement), KGC_ALLOC_CODEANALYSE)
+#define	ALLOCFRAME()			arenaAlloc(&codeInfo->mem, (codeInfo->stacksz+codeInfo->localsz+1) * sizeof(frameElement))
 
 #define	ATTACH_NEW_BASICBLOCK(DPC)				\
 	if ((DPC) != 0 && !IS_STARTOFBASICBLOCK(DPC) &&		\
@@ -250,6 +250,51 @@ addLocalVariables(Method *m, size_t len UNUSED, classFile *fp, errorInfo *info)
 	return true;
 }
 
+/*
+ * Read in the stack map frames of a method.  They are only decoded
+ * when the method is verified, see verifier/verify-stackmap.c.
+ */
+bool
+addStackMapTable(Method *m, size_t len, classFile *fp, errorInfo *info)
+{
+	stackMapTable *smt;
+	u2 nr;
+
+	/* no checkBufSize, done in caller (readAttributes) */
+
+	if (len < 2) {
+		postExceptionMessage(info,
+				     JAVA_LANG(ClassFormatError),
+				     "%s (Method \"%s\" has a truncated "
+				     "StackMapTable)",
+				     CLASS_CNAME(m->class), m->name->data);
+		return false;
+	}
+	if (m->stackmap != NULL) {
+		postExceptionMessage(info,
+				     JAVA_LANG(ClassFormatError),
+				     "%s (Method \"%s\" has more than one "
+				     "StackMapTable)",
+				     CLASS_CNAME(m->class), m->name->data);
+		return false;
+	}
+
+	readu2(&nr, fp);
+	len -= 2;
+
+	smt = gc_malloc(sizeof(stackMapTable) + len, KGC_ALLOC_STACKMAPTABLE);
+	if (smt == NULL) {
+		postOutOfMemory(info);
+		return false;
+	}
+	smt->nframes = nr;
+	smt->length = len;
+	readm(smt->data, len, sizeof(u1), fp);
+
+	m->stackmap = smt;
+	return true;
+}
+
 /*
  * Read in (checked) exceptions declared for a method
  */
@@ -49,6 +49,12 @@ typedef struct _localVariables {
 	localVariableEntry entry[1];
 } localVariables;
 
+typedef struct _stackMapTable {
+	uint32 nframes;
+	uint32 length;		/* of data */
+	u1 data[1];		/* the frames as the class file has them */
+} stackMapTable;
+
 struct _jmethodID;
 struct classFile;
 
@@ -58,6 +64,8 @@ bool	addLineNumbers(struct _jmethodID*, size_t, struct classFile*,
 		       errorInfo *info);
 bool	addLocalVariables(struct _jmethodID*, size_t, struct classFile *,
 			  errorInfo *info);
+bool	addStackMapTable(struct _jmethodID*, size_t, struct classFile *,
+			 errorInfo *info);
 bool	addCheckedExceptions(struct _jmethodID*, size_t,
 			     struct classFile*, errorInfo *info);
 
@@ -0,0 +1,378 @@
+/*
+ * cpuProfile.c
+ * Sampled CPU profiling.
+ *
+ * A profiling timer interrupts whichever thread is using the CPU every
+ * interval.  The signal handler records the frames on that thread's
+ * stack in a ring of samples, without locking or allocating.  A daemon
+ * thread empties the ring into a table of sites, each a stack of Java
+ * methods with the number of times it was seen.  Under the JIT finding
+ * the method of a frame takes the collector's lock, so the handler only
+ * records pcs and the daemon names their methods.  The table is written out at
+ * exit in the collapsed stack format read by flame graph tools.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include "config.h"
+#include "config-std.h"
+#include "config-mem.h"
+#include "config-signal.h"
+#include <sys/time.h>
+#include "jni_md.h"
+#include "gtypes.h"
+#include "classMethod.h"
+#include "jthread.h"
+#include "jsignal.h"
+#include "thread.h"
+#include "threadData.h"
+#include "locks.h"
+#include "errors.h"
+#include "md.h"
+#include "stackTrace.h"
+#include "debug.h"
+#include "cpuProfile.h"
+#if defined(TRANSLATOR)
+#include "jit-md.h"
+#endif
+
+#if defined(SIGPROF) && defined(HAVE_SETITIMER)
+#define	CPUPROFILE_SUPPORTED
+#endif
+
+/* Samples the handler can be ahead of the daemon, a power of two */
+#define	CPUPROFILE_RING		1024
+
+/* Size of the site table, a power of two */
+#define	CPUPROFILE_SITES	4096
+
+/* How often the daemon empties the ring, in milliseconds */
+#define	CPUPROFILE_DRAIN	100
+
+/* States of a ring slot */
+#define	SAMPLE_FREE		0
+#define	SAMPLE_WRITING		1
+#define	SAMPLE_FULL		2
+
+typedef struct _cpuSample {
+	volatile int	state;
+	int		depth;
+	uintp		frames[CPUPROFILE_DEPTH];	/* see stackTraceRawFrames */
+} cpuSample;
+
+typedef struct _cpuSite {
+	uint32		hash;
+	int		depth;
+	Method		*meths[CPUPROFILE_DEPTH];
+	char		*stack;		/* collapsed, see cpuSiteName */
+	jlong		samples;
+} cpuSite;
+
+static const char *profileFile;
+static int sampleInterval = CPUPROFILE_DEFAULT_INTERVAL;
+static bool profiling;
+
+static cpuSample ring[CPUPROFILE_RING];
+static volatile int ringNext;
+static volatile int droppedSamples;
+
+static iStaticLock siteLock;
+static cpuSite *sites;
+static int nsites;
+static jlong lostSamples;
+
+#if defined(CPUPROFILE_SUPPORTED)
+/*
+ * The profiling timer went off.  Take a sample of the current thread
+ * if there is room in the ring.
+ */
+static void
+cpuProfileTick(SIGNAL_ARGS(sig UNUSED, ctx UNUSED))
+{
+	struct _exceptionFrame *base = NULL;
+	threadData *thread_data;
+	cpuSample *sample;
+	jthread_t cur;
+	int idx;
+#if defined(TRANSLATOR)
+	exceptionFrame frame;
+
+	/* Start at the interrupted frame so the method running is seen */
+	EXCEPTIONFRAME(frame, ctx);
+	base = &frame;
+#endif
+
+	cur = KTHREAD(current)();
+	if (cur == NULL) {
+		return;
+	}
+	thread_data = KTHREAD(get_data)(cur);
+	if (!THREAD_DATA_INITIALIZED(thread_data)) {
+		return;
+	}
+
+	do {
+		idx = ringNext;
+	} while (!COMPARE_AND_EXCHANGE(&ringNext, idx, idx + 1));
+
+	sample = &ring[idx & (CPUPROFILE_RING - 1)];
+	if (!COMPARE_AND_EXCHANGE(&sample->state, SAMPLE_FREE, SAMPLE_WRITING)) {
+		droppedSamples++;
+		return;
+	}
+	sample->depth = stackTraceRawFrames(base, sample->frames,
+					    CPUPROFILE_DEPTH);
+	(void)COMPARE_AND_EXCHANGE(&sample->state, SAMPLE_WRITING, SAMPLE_FULL);
+}
+#endif
+
+static uint32
+cpuSiteHash(Method **meths, int depth)
+{
+	uint32 h = (uint32)depth;
+	int i;
+
+	for (i = 0; i < depth; i++) {
+		h = h * 31 + (uint32)((uintp)meths[i] >> 2);
+	}
+	return (h ^ (h >> 16));
+}
+
+/*
+ * Build the collapsed name of a site, outermost frame first.  Samples
+ * taken outside of Java code are charged to "[vm]".
+ */
+static char *
+cpuSiteName(Method **meths, int depth)
+{
+	size_t len;
+	char *name;
+	char *p;
+	int i;
+
+	len = 5;
+	for (i = 0; i < depth; i++) {
+		len += strlen(CLASS_CNAME(meths[i]->class))
+			+ strlen(meths[i]->name->data) + 2;
+	}
+
+	name = malloc(len);
+	if (name == NULL) {
+		return (NULL);
+	}
+
+	if (depth == 0) {
+		strcpy(name, "[vm]");
+		return (name);
+	}
+
+	p = name;
+	for (i = depth - 1; i >= 0; i--) {
+		p += sprintf(p, "%s.%s%s", CLASS_CNAME(meths[i]->class),
+			     meths[i]->name->data, i > 0 ? ";" : "");
+	}
+
+	for (p = name; *p != '\0'; p++) {
+		if (*p == '/') {
+			*p = '.';
+		}
+		else if (*p == ' ') {
+			*p = '_';
+		}
+	}
+	return (name);
+}
+
+/*
+ * Add a sample to the site table.  Called with siteLock held.
+ */
+static void
+cpuProfileRecord(Method **meths, int depth)
+{
+	uint32 hash = cpuSiteHash(meths, depth);
+	cpuSite *site;
+	uint32 i;
+
+	for (i = hash;; i++) {
+		site = &sites[i & (CPUPROFILE_SITES - 1)];
+		if (site->stack == NULL) {
+			/* Keep the table at most three quarters full */
+			if (nsites * 4 >= CPUPROFILE_SITES * 3) {
+				lostSamples++;
+				return;
+			}
+			site->stack = cpuSiteName(meths, depth);
+			if (site->stack == NULL) {
+				lostSamples++;
+				return;
+			}
+			site->hash = hash;
+			site->depth = depth;
+			memcpy(site->meths, meths, depth * sizeof(Method *));
+			nsites++;
+			break;
+		}
+		if (site->hash == hash && site->depth == depth
+		    && memcmp(site->meths, meths, depth * sizeof(Method *)) == 0) {
+			break;
+		}
+	}
+	site->samples++;
+}
+
+/*
+ * Move the samples in the ring to the site table, keeping the frames
+ * of Java methods.  Called with siteLock held.
+ */
+static void
+cpuProfileDrain(void)
+{
+	Method *meths[CPUPROFILE_DEPTH];
+	cpuSample *sample;
+	int depth;
+	int i, j;
+
+	for (i = 0; i < CPUPROFILE_RING; i++) {
+		sample = &ring[i];
+		if (sample->state == SAMPLE_FULL) {
+			depth = 0;
+			for (j = 0; j < sample->depth; j++) {
+				meths[depth] = stackTraceFrameMethod(sample->frames[j]);
+				if (meths[depth] != NULL) {
+					depth++;
+				}
+			}
+			cpuProfileRecord(meths, depth);
+			(void)COMPARE_AND_EXCHANGE(&sample->state, SAMPLE_FULL,
+						   SAMPLE_FREE);
+		}
+	}
+}
+
+static void
+cpuProfileDaemon(void *arg UNUSED)
+{
+	lockStaticMutex(&siteLock);
+	for (;;) {
+		waitStaticCond(&siteLock, (jlong)CPUPROFILE_DRAIN);
+		cpuProfileDrain();
+	}
+}
+
+/*
+ * Write all sites in the collapsed stack format, with their number of
+ * samples.
+ */
+void
+cpuProfileDump(FILE *fp)
+{
+	int i;
+
+	if (!profiling) {
+		return;
+	}
+
+	lockStaticMutex(&siteLock);
+	cpuProfileDrain();
+	for (i = 0; i < CPUPROFILE_SITES; i++) {
+		if (sites[i].stack != NULL) {
+			fprintf(fp, "%s %lld\n", sites[i].stack,
+				(long long)sites[i].samples);
+		}
+	}
+	if (droppedSamples + lostSamples > 0) {
+		fprintf(fp, "[dropped] %lld\n",
+			(long long)(droppedSamples + lostSamples));
+	}
+	unlockStaticMutex(&siteLock);
+}
+
+static void
+cpuProfileSetTimer(int usecs)
+{
+#if defined(CPUPROFILE_SUPPORTED)
+	struct itimerval timer;
+
+	timer.it_interval.tv_sec = usecs / 1000000;
+	timer.it_interval.tv_usec = usecs % 1000000;
+	timer.it_value = timer.it_interval;
+	setitimer(ITIMER_PROF, &timer, NULL);
+#endif
+}
+
+static void
+cpuProfileWrite(void)
+{
+	FILE *fp;
+
+	cpuProfileSetTimer(0);
+
+	fp = fopen(profileFile, "w");
+	if (fp == NULL) {
+		dprintf("Unable to write CPU profile %s\n", profileFile);
+		return;
+	}
+	cpuProfileDump(fp);
+	fclose(fp);
+}
+
+/*
+ * Ask for a CPU profile to be written to file at exit.
+ */
+void
+cpuProfileSetFile(const char *file)
+{
+	profileFile = file;
+}
+
+/*
+ * Set the CPU time between samples, in microseconds.
+ */
+void
+cpuProfileSetInterval(const char *interval)
+{
+	long i = strtol(interval, NULL, 0);
+
+	sampleInterval = i > 0 ? (int)i : CPUPROFILE_DEFAULT_INTERVAL;
+}
+
+/*
+ * Start sampling once the threading system is up, if a profile was
+ * asked for.
+ */
+void
+cpuProfileInit(void)
+{
+	errorInfo info;
+
+	if (profileFile == NULL) {
+		return;
+	}
+#if !defined(CPUPROFILE_SUPPORTED)
+	dprintf("CPU profiling is not supported on this platform\n");
+	return;
+#endif
+
+	sites = calloc(CPUPROFILE_SITES, sizeof(cpuSite));
+	if (sites == NULL) {
+		return;
+	}
+	initStaticLock(&siteLock);
+	if (createDaemon(&cpuProfileDaemon, "cpuprof", NULL,
+			 java_lang_Thread_NORM_PRIORITY,
+			 THREADSTACKSIZE, &info) == NULL) {
+		discardErrorInfo(&info);
+		return;
+	}
+
+	profiling = true;
+	atexit(cpuProfileWrite);
+#if defined(CPUPROFILE_SUPPORTED)
+	registerAsyncSignalHandler(SIGPROF, cpuProfileTick);
+#endif
+	cpuProfileSetTimer(sampleInterval);
+}
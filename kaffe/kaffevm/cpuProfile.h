@@ -0,0 +1,26 @@
+/*
+ * cpuProfile.h
+ * Sampled CPU profiling.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#ifndef __kaffevm_cpuProfile_h
+#define __kaffevm_cpuProfile_h
+
+/* Frames recorded for each sample, with the JIT also those of native code */
+#define	CPUPROFILE_DEPTH	16
+
+/* Default CPU time between two samples, in microseconds */
+#define	CPUPROFILE_DEFAULT_INTERVAL	10000
+
+extern void cpuProfileSetFile(const char *file);
+extern void cpuProfileSetInterval(const char *interval);
+extern void cpuProfileInit(void);
+extern void cpuProfileDump(FILE *fp);
+
+#endif /* __kaffevm_cpuProfile_h */
@@ -41,6 +41,7 @@
 #include "jsignal.h"
 #include "stats.h"
 #include "locks.h"
+#include "hashtab.h"
 #if defined(KAFFE_FEEDBACK)
 #include "feedback.h"
 #endif
@@ -63,6 +64,13 @@
 #define LIBRARYSUFFIX ""
 #endif
 
+/* Name of kaffeNativeBindings in the symbol table of the loaded library */
+#if defined(HAVE_DYN_UNDERSCORE) && !defined(NO_SHARED_LIBRARIES)
+#define NATIVE_BINDINGS_SYM "_kaffeNativeBindings"
+#else
+#define NATIVE_BINDINGS_SYM "kaffeNativeBindings"
+#endif
+
 static struct _libHandle {
 	LIBRARYHANDLE	desc;
 	char*		name;
@@ -72,6 +80,103 @@ static struct _libHandle {
 static iStaticLock	libraryLock; /* mutex on all intern operations */
 static char *libraryPath = NULL;
 
+/*
+ * Cache of resolved native symbols, keyed by the name passed to
+ * loadNativeLibrarySym().  A NULL func records a failed lookup; it
+ * stays valid only until the next library is loaded.  Entries bound
+ * through addNativeBindings() belong to no library (lib == -1) and
+ * are never dropped.
+ */
+typedef struct _nativeSym {
+	struct _nativeSym*	next;
+	void*			func;
+	int			lib;
+	int			generation;
+	char			name[1];
+} nativeSym;
+
+static hashtab_t	nativeSymTable;
+static nativeSym*	nativeSymList;
+static int		libraryGeneration;
+
+static int
+nativeSymHash(const void *p)
+{
+	const unsigned char* s = (const unsigned char*)((const nativeSym*)p)->name;
+	unsigned int h = 0;
+
+	for (; *s != 0; s++) {
+		h = h * 31 + *s;
+	}
+	return (int)(h & 0x7fffffff);
+}
+
+static int
+nativeSymComp(const void *p1, const void *p2)
+{
+	return strcmp(((const nativeSym*)p1)->name, ((const nativeSym*)p2)->name);
+}
+
+/*
+ * Find or create the cache entry for name.  Assumes libraryLock is held.
+ */
+static nativeSym*
+nativeSymEntry(const char* name, bool create)
+{
+	char buf[sizeof(nativeSym) + MAXSTUBLEN];
+	nativeSym* key = (nativeSym*)buf;
+	nativeSym* sym;
+	size_t len;
+
+	len = strlen(name);
+	if (len >= MAXSTUBLEN) {
+		return (NULL);
+	}
+	strcpy(key->name, name);
+	sym = hashFind(nativeSymTable, key);
+	if (sym != NULL || !create) {
+		return (sym);
+	}
+
+	sym = KMALLOC(sizeof(nativeSym) + len);
+	if (sym == NULL) {
+		return (NULL);
+	}
+	strcpy(sym->name, name);
+	sym->func = NULL;
+	sym->lib = -1;
+	sym->generation = libraryGeneration;
+	if (hashAdd(nativeSymTable, sym) != sym) {
+		KFREE(sym);
+		return (NULL);
+	}
+	sym->next = nativeSymList;
+	nativeSymList = sym;
+	return (sym);
+}
+
+/*
+ * Drop every cache entry resolved from library libIndex, together with
+ * all failed lookups.  Assumes libraryLock is held.
+ */
+static void
+purgeNativeSyms(int libIndex)
+{
+	nativeSym** symp;
+	nativeSym* sym;
+
+	for (symp = &nativeSymList; (sym = *symp) != NULL; ) {
+		if (sym->lib == libIndex || (sym->func == NULL && sym->lib != -1)) {
+			*symp = sym->next;
+			hashRemove(nativeSymTable, sym);
+			KFREE(sym);
+		}
+		else {
+			symp = &sym->next;
+		}
+	}
+}
+
 void
 initNative(void)
 {
@@ -80,10 +185,12 @@ initNative(void)
 	char* nptr;
 	char* ptr;
 	unsigned int len;
+	const nativeBinding* const* bindings;
 
 	DBG(INIT, dprintf("initNative()\n"); );
 
 	initStaticLock(&libraryLock);
+	nativeSymTable = hashInit(nativeSymHash, nativeSymComp, NULL, NULL);
 
 	lpath = (const char*)Kaffe_JavaVMArgs.libraryhome;
 	if (lpath == NULL) {
@@ -145,6 +252,17 @@ initNative(void)
 	       	DBG(INIT, dprintf("trying to load %s\n", lib); );
 
 		if (loadNativeLibrary(lib, NULL, NULL, 0) >= 0) {
+			/* libkaffevm is loaded as a module, so its binding
+			 * table has to be looked up rather than linked to. */
+			bindings = loadNativeLibrarySym(NATIVE_BINDINGS_SYM);
+			if (bindings == NULL) {
+				dprintf("Native library \"%s\" lacks %s.\n",
+					lib, NATIVE_BINDINGS_SYM);
+				dprintf("Aborting.\n");
+				fflush(stderr);
+				KAFFEVM_EXIT(1);
+			}
+			addNativeBindings(bindings);
 			DBG(INIT, dprintf("initNative() done\n"); );
 			return;
 		}
@@ -266,6 +384,9 @@ DBG(NATIVELIB,
 	lib->loader = loader;
 	addToCounter(&ltmem, "vmmem-libltdl", 1, GCSIZEOF(lib->name));
 
+	/* Failed lookups may succeed in the new library */
+	libraryGeneration++;
+
 	unlockStaticMutex(&libraryLock);
 
 DBG(NATIVELIB,
@@ -288,6 +409,19 @@ DBG(NATIVELIB,
 	return libIndex;
 }
 
+/*
+ * Get pointer to symbol from symbol name, looking only in the library
+ * loadNativeLibrary() returned libIndex for.
+ */
+void*
+loadNativeLibrarySymFromIndex(int libIndex, const char* name)
+{
+	assert(libIndex >= 0 && libIndex < MAXLIBS);
+	assert(libHandle[libIndex].desc != NULL);
+
+	return (loadNativeLibrarySymFromLib(&libHandle[libIndex], name));
+}
+
 /*
  * Unlink a native library. Assumes synchronization.
  * Note that libnative is always at index zero and should
@@ -318,6 +452,7 @@ DBG(NATIVELIB,
 	    lib->name, lib->desc, libIndex, lib->loader);
     );
 
+		purgeNativeSyms(libIndex);
 		KaffeLib_Unload(lib->desc);
 		KFREE(lib->name);
 		lib->desc = NULL;
@@ -332,17 +467,99 @@ DBG(NATIVELIB,
 void*
 loadNativeLibrarySym(const char* name)
 {
-  int i = 0;
+  int i;
   void* func = NULL;
+  nativeSym* sym;
+
+  lockStaticMutex(&libraryLock);
 
-  while (!func && i < MAXLIBS && libHandle[i].desc!=NULL) {
+  sym = nativeSymEntry(name, false);
+  if (sym != NULL
+      && (sym->func != NULL || sym->generation == libraryGeneration)) {
+    func = sym->func;
+    unlockStaticMutex(&libraryLock);
+    return func;
+  }
+
+  for (i = 0; !func && i < MAXLIBS && libHandle[i].desc!=NULL; i++) {
     func = loadNativeLibrarySymFromLib(&libHandle[i], name);
-    ++i;
   }
 
+  if (sym == NULL) {
+    sym = nativeSymEntry(name, true);
+  }
+  if (sym != NULL) {
+    sym->func = func;
+    sym->lib = (func != NULL) ? i - 1 : -2;
+    sym->generation = libraryGeneration;
+  }
+
+  unlockStaticMutex(&libraryLock);
+
   return func;
 }
 
+/*
+ * Build the name a native method is looked up under, see native()
+ * and Kaffe_JNI_native().
+ */
+static void
+nativeBindingName(char* to, const char* name)
+{
+	if (strncmp(name, "Java_", 5) == 0) {
+#if defined(HAVE_DYN_UNDERSCORE) && !defined(NO_SHARED_LIBRARIES)
+		strcpy(to, "_");
+#else
+		to[0] = 0;
+#endif
+		strcat(to, name);
+	}
+	else {
+		strcpy(to, STUB_PREFIX);
+		strcat(to, name);
+		strcat(to, STUB_POSTFIX);
+	}
+}
+
+/*
+ * Bind a native function by name without searching the loaded
+ * libraries for it.
+ */
+void
+addNativeFunc(const char* name, void* func)
+{
+	char stub[MAXSTUBLEN];
+	nativeSym* sym;
+
+	if (strlen(name) + strlen(STUB_PREFIX) + strlen(STUB_POSTFIX) >= MAXSTUBLEN) {
+		return;
+	}
+	nativeBindingName(stub, name);
+
+	lockStaticMutex(&libraryLock);
+	sym = nativeSymEntry(stub, true);
+	if (sym != NULL) {
+		sym->func = func;
+		sym->lib = -1;
+	}
+	unlockStaticMutex(&libraryLock);
+}
+
+/*
+ * Bind all natives of a NULL terminated array of binding tables, much
+ * like JNI RegisterNatives does for a single class.
+ */
+void
+addNativeBindings(const nativeBinding* const* tables)
+{
+	const nativeBinding* b;
+
+	for (; *tables != NULL; tables++) {
+		for (b = *tables; b->name != NULL; b++) {
+			addNativeFunc(b->name, b->func);
+		}
+	}
+}
 
 static void
 strcatJNI(char* to, const char* from)
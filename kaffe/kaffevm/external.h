@@ -28,12 +28,29 @@
 struct _jmethodID;
 struct _errorInfo;
 
+/*
+ * A table of natives bound in bulk by addNativeBindings(), terminated
+ * by NATIVE_BINDING_END.  Names are the undecorated C function names.
+ */
+typedef struct _nativeBinding {
+	const char*	name;
+	void*		func;
+} nativeBinding;
+
+#define	NATIVE_BINDING(FUNC)	{ #FUNC, (void*)FUNC }
+#define	NATIVE_BINDING_END	{ NULL, NULL }
+
+/* The VM's own natives, see libraries/clib/native/Natives.c */
+extern const nativeBinding* const kaffeNativeBindings[];
+
 void	initNative(void);
 int	loadNativeLibrary(const char*, struct Hjava_lang_ClassLoader*, char*, size_t);
 void	unloadNativeLibraries(struct Hjava_lang_ClassLoader*);
 void*	loadNativeLibrarySym(const char*);
+void*	loadNativeLibrarySymFromIndex(int, const char*);
 nativecode*	native(struct _jmethodID*, struct _errorInfo*);
-void	addNativeFunc(char*, void*);
+void	addNativeFunc(const char*, void*);
+void	addNativeBindings(const nativeBinding* const*);
 char*	getLibraryPath(void);
 
 #endif
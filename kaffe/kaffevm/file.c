@@ -45,6 +45,7 @@ classFileInit(classFile* cf,
 	cf->base = cf->cur = buf;
 	cf->size = len;
 	cf->type = cft;
+	cf->major_version = 0;
 }
 
 /*
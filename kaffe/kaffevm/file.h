@@ -37,6 +37,7 @@ typedef struct classFile {
 	const unsigned char* cur;
 	size_t	        size;
 	ClassFileType	type;
+	u2		major_version;	/* once read by readClass */
 } classFile;
 
 /*
@@ -33,6 +33,7 @@
 #include "classpath.h"
 #include "stringSupport.h"
 #include "stats.h"
+#include "startupTrace.h"
 #include "access.h"
 #include "gcj/gcj.h"
 #include "defs.h"
@@ -83,6 +84,7 @@ findClass(classEntry* centry, errorInfo *einfo)
 	classFile hand;
 	const char* cname;
 	Hjava_lang_Class* class = NULL;
+	statTime traceStart = STARTUP_TRACE_START();
 
 	cname = centry->name->data;
 
@@ -152,14 +154,13 @@ DBG(CLASSLOOKUP,
 		class = readClass(class, &hand, NULL, einfo);
 
 		if (hand.base != NULL) {
-#if defined(KAFFE_STATS)
 			if (hand.type == CP_ZIPFILE) {
 				addToCounter(&jarmem, "vmmem-jar files", 1,
 					-(jlong)GCSIZEOF(hand.base));
 			}
-#endif
 			KFREE(hand.mem);
 		}
+		STARTUP_TRACE_END(traceStart, "read", cname, NULL);
 		return (class);
 
 	case CP_INVALID:
@@ -197,6 +198,8 @@ findClassInJar(char* cname, classFile* hand, errorInfo *einfo)
 	char *buf;
 	int fp;
 	classpathEntry* ptr;
+	classpathEntry* searched = NULL;
+	statTime searchStart = 0;
 	int i;
 	int rc;
 
@@ -210,6 +213,15 @@ DBG(CLASSLOOKUP,  dprintf("Scanning for element %s\n", cname); );
 
 	for (ptr = classpath; ptr != 0; ptr = ptr->next) {
 DBG(CLASSLOOKUP,dprintf("Processing classpath entry '%s'\n", ptr->path); );
+		/* Charge the time up to here to the entry searched last */
+		if (startupTracing) {
+			if (searched != NULL) {
+				startupTraceClasspath(searched->path,
+						      searchStart, false);
+			}
+			searched = ptr;
+			searchStart = statsNow();
+		}
 		switch (ptr->type) {
 		case CP_ZIPFILE:
 		{
@@ -344,6 +356,10 @@ DBG(CLASSLOOKUP,	dprintf("Opening java file %s for %s\n", buf, cname); );
 	}
 	/* If we call out the loop then we didn't find anything */
 	assert (hand->type == CP_INVALID);
+	if (searched != NULL) {
+		startupTraceClasspath(searched->path, searchStart, false);
+		searched = NULL;
+	}
 
 	/* cut off the ".class" suffix for the exception msg */
 	cname[strlen(cname) - strlen(".class")] = '\0';
@@ -357,6 +373,10 @@ DBG(CLASSLOOKUP,	dprintf("Opening java file %s for %s\n", buf, cname); );
 			     cname);
 
 	done:;
+	if (searched != NULL) {
+		startupTraceClasspath(searched->path, searchStart,
+				      hand->type != CP_INVALID);
+	}
 	unlockStaticMutex(&jarlock);
 }
 
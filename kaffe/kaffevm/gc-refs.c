@@ -52,10 +52,28 @@ typedef struct _weakRefTable {
   weakRefObject*               hash[REFOBJHASHSZ];
 } weakRefTable;
 
+/*
+ * Global references handed out through JNI live in a table of their
+ * own.  The table is a list of fixed size segments; a reference is the
+ * address of its slot, so adding and deleting one never searches.  Free
+ * slots are chained together and tagged with the low bit, which real
+ * objects never have set.
+ */
+#define	GLOBALREFSEGSZ	256
+#define	GLOBALREF_FREE	((uintp)1)
+
+typedef struct _globalRefSegment {
+  struct _globalRefSegment*	next;
+  void*				slots[GLOBALREFSEGSZ];
+} globalRefSegment;
+
 static strongRefTable			strongRefObjects;
 static weakRefTable                     weakRefObjects;
+static globalRefSegment*		globalRefSegments;
+static void**				globalRefFree;
 static iStaticLock                      strongRefLock;
 static iStaticLock                      weakRefLock;
+static iStaticLock                      globalRefLock;
 
 /* This is a bit homemade.  We need a 7-bit hash from the address here */
 #define	REFOBJHASH(V)	((((uintp)(V) >> 2) ^ ((uintp)(V) >> 9))%REFOBJHASHSZ)
@@ -131,6 +149,62 @@ KaffeGC_rmRef(Collector *collector, void* mem)
   return false;
 }
 
+/*
+ * Add a global reference to an object and return the slot holding it.
+ */
+void**
+KaffeGC_addGlobalRef(Collector *collector, const void* mem)
+{
+  void** slot;
+  globalRefSegment* seg;
+  int i;
+
+  DBG(REFERENCE, dprintf("Adding global reference for object %p\n",
+                 mem); );
+
+  lockStaticMutex(&globalRefLock);
+  while (globalRefFree == NULL) {
+    unlockStaticMutex(&globalRefLock);
+    seg = (globalRefSegment*)KGC_malloc(collector, sizeof(globalRefSegment), KGC_ALLOC_REF);
+    if (seg == NULL)
+      return NULL;
+
+    /* Chain the slots up before the segment becomes visible to the
+     * collector, which walks the table without taking the lock. */
+    for (i = 0; i < GLOBALREFSEGSZ - 1; i++) {
+      seg->slots[i] = (void*)((uintp)&seg->slots[i+1] | GLOBALREF_FREE);
+    }
+    lockStaticMutex(&globalRefLock);
+    seg->slots[GLOBALREFSEGSZ - 1] = (void*)((uintp)globalRefFree | GLOBALREF_FREE);
+    globalRefFree = &seg->slots[0];
+    seg->next = globalRefSegments;
+    globalRefSegments = seg;
+  }
+
+  slot = globalRefFree;
+  globalRefFree = (void**)((uintp)*slot & ~GLOBALREF_FREE);
+  *slot = (void*)mem;
+  unlockStaticMutex(&globalRefLock);
+
+  return slot;
+}
+
+/*
+ * Release a slot obtained from KaffeGC_addGlobalRef.
+ */
+void
+KaffeGC_rmGlobalRef(Collector *collector UNUSED, void** slot)
+{
+  DBG(REFERENCE, dprintf("Removing global reference for object %p\n",
+                 *slot); );
+
+  lockStaticMutex(&globalRefLock);
+  assert(((uintp)*slot & GLOBALREF_FREE) == 0);
+  *slot = (void*)((uintp)globalRefFree | GLOBALREF_FREE);
+  globalRefFree = slot;
+  unlockStaticMutex(&globalRefLock);
+}
+
 /**
  * Grow the weak reference list for a weakly referenced object.
  * Assert: weakRefLock is held by the calling thread.
@@ -399,6 +473,7 @@ void KaffeGC_initRefs()
 {
   initStaticLock(&strongRefLock);
   initStaticLock(&weakRefLock);
+  initStaticLock(&globalRefLock);
 }
 
 void
@@ -406,6 +481,7 @@ KaffeGC_markAllRefs(Collector* collector)
 {
   int i;
   strongRefObject* robj;
+  globalRefSegment* seg;
   
   /* Walk the referenced objects */
   for (i = 0; i < REFOBJHASHSZ; i++) {
@@ -413,4 +489,13 @@ KaffeGC_markAllRefs(Collector* collector)
       KGC_markObject(collector, NULL, robj->mem);
     }
   }
+
+  /* Walk the global references, skipping the free slots */
+  for (seg = globalRefSegments; seg != NULL; seg = seg->next) {
+    for (i = 0; i < GLOBALREFSEGSZ; i++) {
+      if (((uintp)seg->slots[i] & GLOBALREF_FREE) == 0) {
+	KGC_markObject(collector, NULL, seg->slots[i]);
+      }
+    }
+  }
 }
@@ -21,6 +21,8 @@
 struct _Collector;
 bool KaffeGC_addRef(struct _Collector *collector, const void* mem);
 bool KaffeGC_rmRef(struct _Collector *collector, void* mem);
+void** KaffeGC_addGlobalRef(struct _Collector *collector, const void* mem);
+void KaffeGC_rmGlobalRef(struct _Collector *collector, void** slot);
 void KaffeGC_markAllRefs(struct _Collector* collector);
 bool KaffeGC_addWeakRef(struct _Collector *collector, void *mem, void **obj);
 bool KaffeGC_rmWeakRef(struct _Collector *collector, void *mem, void **obj);
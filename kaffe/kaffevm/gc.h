@@ -47,6 +47,9 @@ typedef struct _Collector Collector;
 typedef void (*walk_func_t)(struct _Collector* collector, void* gc_info, void* obj, uint32 size);
 typedef void (*final_func_t)(struct _Collector* collector, void* obj);
 typedef void (*destroy_func_t)(struct _Collector* collector, void* obj);
+/* Receives the Java objects a collection found live, roots first */
+typedef void (*heap_snapshot_func_t)(struct _Collector* collector,
+		void** objs, int nobjs, int nroots, void* arg);
 
 #define	KGC_OBJECT_NORMAL	  ((final_func_t)0)
 #define	KGC_OBJECT_FIXED	  ((final_func_t)1)
@@ -89,6 +92,7 @@ typedef enum {
 	KGC_ALLOC_INTERFACE,
 	KGC_ALLOC_LINENRTABLE,
 	KGC_ALLOC_LOCALVARTABLE,
+	KGC_ALLOC_STACKMAPTABLE,
 	KGC_ALLOC_DECLAREDEXC,
 	KGC_ALLOC_INTERFACE_TABLE,
 	KGC_ALLOC_CLASSMISC,
@@ -159,6 +163,13 @@ struct GarbageCollectorInterface_Ops {
         bool    (*rmRef)(Collector *, void *ref);
         bool    (*addWeakRef)(Collector *, void *mem, void **ref);
         bool    (*rmWeakRef)(Collector *, void *mem, void **ref);
+        void**  (*addGlobalRef)(Collector *, const void *mem);
+        void    (*rmGlobalRef)(Collector *, void **slot);
+
+        bool    (*snapshotHeap)(Collector *, heap_snapshot_func_t func, void *arg);
+	int	(*mallocMany)(Collector *, size_t size, gc_alloc_type_t type,
+			      void **objs, int n);
+	uint32	(*getCollections)(Collector *);
 };
 
 Collector* createGC(void);
@@ -168,6 +179,8 @@ Collector* createGC(void);
  */
 #define KGC_malloc(G, size, type)	\
     ((G)->ops->malloc)((Collector*)(G), (size), (type))
+#define KGC_mallocMany(G, size, type, objs, n)	\
+    ((G)->ops->mallocMany)((Collector*)(G), (size), (type), (objs), (n))
 #define KGC_realloc(G, addr, size, type)	\
     ((G)->ops->realloc)((Collector*)(G), (addr), (size), (type))
 #define KGC_free(G, addr)		\
@@ -192,6 +205,12 @@ Collector* createGC(void);
     ((G)->ops->addWeakRef((Collector *)(G), (addr), (ref)))
 #define KGC_rmWeakRef(G, addr, ref) \
     ((G)->ops->rmWeakRef((Collector *)(G), (addr), (ref)))
+#define KGC_addGlobalRef(G, addr) \
+    ((G)->ops->addGlobalRef((Collector *)(G), (addr)))
+#define KGC_rmGlobalRef(G, slot) \
+    ((G)->ops->rmGlobalRef((Collector *)(G), (slot)))
+#define KGC_snapshotHeap(G, func, arg) \
+    ((G)->ops->snapshotHeap((Collector *)(G), (func), (arg)))
 
 #if !defined(KAFFEH)
 static inline void KGC_markObject(void *g, void *gc_info, const void *addr)
@@ -228,6 +247,8 @@ static inline void KGC_markObject(void *g, void *gc_info, const void *addr)
     ((G)->ops->getHeapTotal)((Collector *)(G));
 #define KGC_getCollectorName(G) \
     ((G)->ops->getCollectorName)((Collector *)(G));
+#define KGC_getCollections(G) \
+    ((G)->ops->getCollections)((Collector *)(G))
 #define KGC_WRITE(a, b)
 
 /*
@@ -237,6 +258,7 @@ extern Collector* main_collector;
 extern Collector* KGC_getMainCollector(void);
 
 #define	gc_malloc(A,B)	    KGC_malloc(KGC_getMainCollector(),A,B)
+#define	gc_malloc_many(A,B,C,D)	KGC_mallocMany(KGC_getMainCollector(),A,B,C,D)
 #define	gc_calloc(A,B,C)    KGC_malloc(KGC_getMainCollector(),(A)*(B),C)
 #define	gc_realloc(A,B,C)   KGC_realloc(KGC_getMainCollector(),(A),(B),C)
 #define	gc_free(A)	    KGC_free(KGC_getMainCollector(),(A))
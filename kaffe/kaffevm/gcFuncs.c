@@ -19,6 +19,7 @@
 #include "debug.h"
 #include "config-std.h"
 #include "config-mem.h"
+#include "config-hacks.h"
 #include "defs.h"
 #include "gtypes.h"
 #include "slots.h"
@@ -48,6 +49,7 @@
 #include "thread.h"
 #include "jvmpi_kaffe.h"
 #include "methodcalls.h"
+#include "reflect.h"
 
 /*****************************************************************************
  * Class-related functions
@@ -144,6 +146,7 @@ DBG(CLASSGC,
                         KFREE(METHOD_PSIG(m));
                         KFREE(m->lines);
 			KFREE(m->lvars);
+			KFREE(m->stackmap);
 			if( m->ndeclared_exceptions != -1 )
 			  KFREE(m->declared_exceptions);
                         KFREE(m->exception_table);
@@ -465,6 +468,21 @@ DBG(GCPRECISE,
         if (!CLASS_IS_PRIMITIVE(class) && !CLASS_IS_ARRAY(class) && Kaffe_get_class_methods(class) != 0) {
                 walkMethods(collector, gc_info, Kaffe_get_class_methods(class), CLASS_NMETHODS(class));
         }
+	/* The reflection cache is only softly reachable: keep it while
+	 * it is being used and drop it once it has been idle for a few
+	 * collections (see reflect.c).
+	 */
+	if (KGC_getCollections(collector) - class->reflect_used
+	    < REFLECT_CACHE_MAX_AGE) {
+		KGC_markObject(collector, gc_info, class->reflect_methods);
+		KGC_markObject(collector, gc_info, class->reflect_constructors);
+		KGC_markObject(collector, gc_info, class->reflect_fields);
+	} else {
+		class->reflect_methods = NULL;
+		class->reflect_constructors = NULL;
+		class->reflect_fields = NULL;
+	}
+
         KGC_markObject(collector, gc_info, class->loader);
 	KGC_markObject(collector, gc_info, class->signers);
 	KGC_markObject(collector, gc_info, class->protectionDomain);
@@ -474,6 +492,31 @@ DBG(GCPRECISE,
 /*****************************************************************************
  * various walk functions functions
  */
+/*
+ * Mark the count references starting at mem.  The colour of an object
+ * lives in the info of its block, not in the object, but kaffe-gc moves
+ * each newly greyed object onto the grey list through the gc_unit just
+ * in front of it, and it is walked soon after.  So the referents a few
+ * slots ahead are fetched for writing while the current one is marked.
+ */
+#define	WALK_PREFETCH_DISTANCE	4
+
+static inline void
+walkRefRange(Collector* collector, void *gc_info, void** mem, uint32 count)
+{
+	uint32 i;
+
+	for (i = 0; i < count && i < WALK_PREFETCH_DISTANCE; i++) {
+		__builtin_prefetch(mem[i], 1, 3);
+	}
+	for (i = 0; i < count; i++) {
+		if (i + WALK_PREFETCH_DISTANCE < count) {
+			__builtin_prefetch(mem[i + WALK_PREFETCH_DISTANCE], 1, 3);
+		}
+		KGC_markObject(collector, gc_info, mem[i]);
+	}
+}
+
 /*
  * Walk an array object objects.
  */
@@ -482,7 +525,6 @@ void
 walkRefArray(Collector* collector, void *gc_info, void* base, uint32 size UNUSED)
 {
         Hjava_lang_Object* arr;
-        int i;
 	iLock *lk;
         Hjava_lang_Object** ptr;
 
@@ -506,14 +548,11 @@ DBG(GCPRECISE,
                 KGC_markObject(collector, gc_info, arr->vtable->class);
         }
 
-        for (i = ARRAY_SIZE(arr); i > 0; i--) {
-                Hjava_lang_Object* el = *ptr++;
-		/*
-		 * NB: This would break if some objects (i.e. class objects)
-		 * are not gc-allocated.
-		 */
-		KGC_markObject(collector, gc_info, el);
-        }
+	/*
+	 * NB: This would break if some objects (i.e. class objects)
+	 * are not gc-allocated.
+	 */
+	walkRefRange(collector, gc_info, (void **)ptr, ARRAY_SIZE(arr));
 }
 
 /*
@@ -525,10 +564,9 @@ walkObject(Collector* collector, void *gc_info, void* base, uint32 size)
 {
         Hjava_lang_Object *obj = (Hjava_lang_Object*)base;
         Hjava_lang_Class *clazz;
-        int *layout;
-        int8* mem;
-        unsigned int i;
-	int l, nbits;
+        gcRefRange *range;
+        void** mem;
+	int n;
 	iLock *lk;
 
         /*
@@ -552,47 +590,42 @@ walkObject(Collector* collector, void *gc_info, void* base, uint32 size)
 	if (lk != NULL && KGC_getObjectIndex(collector, lk) == KGC_ALLOC_LOCK)
 	  KGC_markObject(collector, gc_info, lk);
 
-        layout = clazz->gc_layout;
-        nbits = CLASS_FSIZE(clazz)/ALIGNMENTOF_VOIDP;
-
 DBG(GCPRECISE,
-        dprintf("walkObject `%s' ", CLASS_CNAME(clazz));
-        BITMAP_DUMP(layout, nbits)
-        dprintf(" (nbits=%d) %p-%p\n", nbits, base, ((char *)base) + size);
+        dprintf("walkObject `%s' (nranges=%d) %p-%p\n", CLASS_CNAME(clazz),
+		clazz->gc_nranges, base, ((char *)base) + size);
     );
 
         assert(CLASS_FSIZE(clazz) > 0);
         assert(size > 0);
 
-        mem = (int8 *)base;
-
-        /* optimize this! */
-        while (nbits > 0) {
-                /* get next integer from bitmap */
-                l = *layout++;
-                i = 0;
-                while (i < BITMAP_BPI) {
-                        /* skip the rest if no refs left */
-                        if (l == 0) {
-                                mem += (BITMAP_BPI - i) * ALIGNMENTOF_VOIDP;
-                                break;
-                        }
-
-                        if (l < 0) {
-                                /* we know this pointer points to gc'ed memory
-                                 * there is no need to check - go ahead and
-                                 * mark it.  Note that p may or may not point
-                                 * to a "real" Java object.
-                                 */
-				void *p = *(void **)mem;
-				KGC_markObject(collector, gc_info, p);
-                        }
-                        i++;
-                        l <<= 1;
-                        mem += ALIGNMENTOF_VOIDP;
-                }
-                nbits -= BITMAP_BPI;
-        }
+	/*
+	 * The references of each class in the hierarchy lie together.
+	 * We know these pointers point to gc'ed memory, there is no need
+	 * to check - go ahead and mark them.  Note that they may or may
+	 * not point to "real" Java objects.
+	 */
+	range = clazz->gc_layout;
+	switch (clazz->gc_nranges) {
+	case 0:
+		/* Nothing but primitive fields */
+		break;
+	case 1:
+		mem = (void **)base + range->start;
+		if (range->count == 1) {
+			KGC_markObject(collector, gc_info, *mem);
+		}
+		else {
+			walkRefRange(collector, gc_info, mem, range->count);
+		}
+		break;
+	default:
+		for (n = clazz->gc_nranges; n > 0; n--, range++) {
+			walkRefRange(collector, gc_info,
+				     (void **)base + range->start,
+				     range->count);
+		}
+		break;
+	}
 }
 
 /*
@@ -691,8 +724,11 @@ initCollector(void)
 	    stringWalk, stringDestroy, NULL, "j.l.String");
 	KGC_registerGcTypeByIndex(gc, KGC_ALLOC_NOWALK,
 	    NULL, KGC_OBJECT_NORMAL, NULL, "other-nowalk");
+	/* Objects without finalize() still get finalizeObject, which
+	 * enqueues the references to them.
+	 */
 	KGC_registerGcTypeByIndex(gc, KGC_ALLOC_NORMALOBJECT,
-	    walkObject, KGC_OBJECT_NORMAL, NULL, "obj-no-final");
+	    walkObject, finalizeObject, NULL, "obj-no-final");
 	KGC_registerGcTypeByIndex(gc, KGC_ALLOC_PRIMARRAY,
 	    NULL, finalizeObject, NULL, "prim-arrays");
 	KGC_registerGcTypeByIndex(gc, KGC_ALLOC_REFARRAY,
@@ -735,6 +771,7 @@ initCollector(void)
 	KGC_registerFixedTypeByIndex(gc, KGC_ALLOC_CLASSPOOL, "class-pool");
 	KGC_registerFixedTypeByIndex(gc, KGC_ALLOC_LINENRTABLE, "linenr-table");
 	KGC_registerFixedTypeByIndex(gc, KGC_ALLOC_LOCALVARTABLE, "lvar-table");
+	KGC_registerFixedTypeByIndex(gc, KGC_ALLOC_STACKMAPTABLE, "stackmap-table");
 	KGC_registerFixedTypeByIndex(gc, KGC_ALLOC_DECLAREDEXC, "declared-exc");
 	KGC_registerFixedTypeByIndex(gc, KGC_ALLOC_CLASSMISC, "class-misc");
 	KGC_registerFixedTypeByIndex(gc, KGC_ALLOC_VERIFIER, "verifier");
@@ -0,0 +1,752 @@
+/*
+ * heapDump.c
+ * Heap histograms and heap dumps.
+ *
+ * Both take a snapshot of the heap from the collector:  a list of the
+ * Java objects found live by a collection, roots first.  The histogram
+ * adds the objects up per class.  The dump writes them in the HPROF
+ * binary format (version 1.0.2) read by heap analysers.  The objects
+ * are walked while the mutators run, so the field values in a dump are
+ * not a consistent picture of the heap; the set of objects is.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include "config.h"
+#include "config-std.h"
+#include "config-mem.h"
+#include "jni_md.h"
+#include "gtypes.h"
+#include "classMethod.h"
+#include "baseClasses.h"
+#include "object.h"
+#include "gc.h"
+#include "support.h"
+#include "debug.h"
+#include "heapDump.h"
+
+/*
+ * A growable hash table keyed by pointer, used for the classes seen
+ * and for the names already written.
+ */
+typedef struct _heapEntry {
+	void		*key;
+	jlong		count;
+	jlong		bytes;
+} heapEntry;
+
+typedef struct _heapTable {
+	heapEntry	*entries;
+	int		size;		/* a power of two */
+	int		used;
+	bool		failed;
+} heapTable;
+
+static uint32
+heapHash(void *key)
+{
+	uintp h = (uintp)key >> 3;
+
+	return ((uint32)(h ^ (h >> 15)));
+}
+
+static bool
+heapTableGrow(heapTable *tab)
+{
+	heapEntry *old = tab->entries;
+	int oldsize = tab->size;
+	int size = oldsize == 0 ? 256 : oldsize * 2;
+	int i;
+
+	tab->entries = calloc(size, sizeof(heapEntry));
+	if (tab->entries == NULL) {
+		tab->entries = old;
+		tab->failed = true;
+		return (false);
+	}
+	tab->size = size;
+	for (i = 0; i < oldsize; i++) {
+		if (old[i].key != NULL) {
+			uint32 h = heapHash(old[i].key);
+
+			while (tab->entries[h & (size - 1)].key != NULL) {
+				h++;
+			}
+			tab->entries[h & (size - 1)] = old[i];
+		}
+	}
+	free(old);
+	return (true);
+}
+
+/*
+ * Find the entry for key, adding it if it is not there.  *added tells
+ * which.  Returns NULL if the table could not be grown.
+ */
+static heapEntry *
+heapTableFind(heapTable *tab, void *key, bool *added)
+{
+	heapEntry *e;
+	uint32 h;
+
+	*added = false;
+	if (tab->used * 2 >= tab->size && !heapTableGrow(tab)) {
+		return (NULL);
+	}
+
+	for (h = heapHash(key);; h++) {
+		e = &tab->entries[h & (tab->size - 1)];
+		if (e->key == key) {
+			return (e);
+		}
+		if (e->key == NULL) {
+			e->key = key;
+			tab->used++;
+			*added = true;
+			return (e);
+		}
+	}
+}
+
+static void
+heapTableFree(heapTable *tab)
+{
+	free(tab->entries);
+	tab->entries = NULL;
+	tab->size = 0;
+	tab->used = 0;
+}
+
+/*
+ * Whether obj, as found by the collector, is a complete Java object.  A
+ * thread may have been stopped between allocating it and storing its
+ * dispatch table.
+ */
+static inline bool
+heapIsObject(Hjava_lang_Object *obj)
+{
+	return (obj->vtable != NULL);
+}
+
+static inline bool
+heapIsClass(Collector *collector, void *obj)
+{
+	return (KGC_getObjectIndex(collector, obj) == KGC_ALLOC_CLASSOBJECT);
+}
+
+/* ------------------------------------------------------------------ */
+/* Histogram */
+
+typedef struct _heapHistogram {
+	FILE		*fp;
+	bool		ok;
+} heapHistogram;
+
+static int
+heapCompareBytes(const void *a, const void *b)
+{
+	const heapEntry *ea = *(const heapEntry * const *)a;
+	const heapEntry *eb = *(const heapEntry * const *)b;
+
+	if (ea->bytes != eb->bytes) {
+		return (ea->bytes < eb->bytes ? 1 : -1);
+	}
+	return (strcmp(CLASS_CNAME((Hjava_lang_Class *)ea->key),
+		       CLASS_CNAME((Hjava_lang_Class *)eb->key)));
+}
+
+static void
+heapPrintClassName(FILE *fp, Hjava_lang_Class *cl)
+{
+	const char *p;
+
+	for (p = CLASS_CNAME(cl); *p != '\0'; p++) {
+		putc(*p == '/' ? '.' : *p, fp);
+	}
+}
+
+static void
+heapHistogramWrite(Collector *collector, void **objs, int nobjs,
+		   int nroots UNUSED, void *arg)
+{
+	heapHistogram *hist = arg;
+	heapTable classes;
+	heapEntry **sorted;
+	heapEntry *e;
+	jlong count = 0;
+	jlong bytes = 0;
+	bool added;
+	int i;
+	int n;
+
+	memset(&classes, 0, sizeof(classes));
+	for (i = 0; i < nobjs; i++) {
+		Hjava_lang_Object *obj = objs[i];
+
+		if (!heapIsObject(obj)) {
+			continue;
+		}
+		e = heapTableFind(&classes, OBJECT_CLASS(obj), &added);
+		if (e == NULL) {
+			break;
+		}
+		e->count++;
+		e->bytes += KGC_getObjectSize(collector, obj);
+	}
+
+	sorted = malloc(classes.used * sizeof(heapEntry *));
+	if (classes.failed || sorted == NULL) {
+		free(sorted);
+		heapTableFree(&classes);
+		return;
+	}
+	n = 0;
+	for (i = 0; i < classes.size; i++) {
+		if (classes.entries[i].key != NULL) {
+			sorted[n++] = &classes.entries[i];
+		}
+	}
+	qsort(sorted, n, sizeof(heapEntry *), heapCompareBytes);
+
+	fprintf(hist->fp, " num     #instances         #bytes  class name\n");
+	fprintf(hist->fp, "----------------------------------------------\n");
+	for (i = 0; i < n; i++) {
+		fprintf(hist->fp, "%4d: %14lld %14lld  ", i + 1,
+			(long long)sorted[i]->count,
+			(long long)sorted[i]->bytes);
+		heapPrintClassName(hist->fp, sorted[i]->key);
+		putc('\n', hist->fp);
+		count += sorted[i]->count;
+		bytes += sorted[i]->bytes;
+	}
+	fprintf(hist->fp, "Total %14lld %14lld\n",
+		(long long)count, (long long)bytes);
+
+	free(sorted);
+	heapTableFree(&classes);
+	hist->ok = true;
+}
+
+/*
+ * Write the number of live instances and the bytes they take up for
+ * every class, largest first.
+ */
+bool
+heapWriteHistogram(const char *file)
+{
+	heapHistogram hist;
+
+	hist.fp = fopen(file, "w");
+	if (hist.fp == NULL) {
+		return (false);
+	}
+	hist.ok = false;
+	if (!KGC_snapshotHeap(main_collector, heapHistogramWrite, &hist)) {
+		hist.ok = false;
+	}
+	if (fclose(hist.fp) != 0) {
+		hist.ok = false;
+	}
+	return (hist.ok);
+}
+
+/* ------------------------------------------------------------------ */
+/* HPROF dump */
+
+/* Record tags */
+#define	HPROF_UTF8			0x01
+#define	HPROF_LOAD_CLASS		0x02
+#define	HPROF_STACK_TRACE		0x05
+#define	HPROF_HEAP_DUMP_SEGMENT		0x1C
+#define	HPROF_HEAP_DUMP_END		0x2C
+
+/* Heap dump sub-record tags */
+#define	HPROF_ROOT_UNKNOWN		0xFF
+#define	HPROF_ROOT_STICKY_CLASS		0x05
+#define	HPROF_CLASS_DUMP		0x20
+#define	HPROF_INSTANCE_DUMP		0x21
+#define	HPROF_OBJ_ARRAY_DUMP		0x22
+#define	HPROF_PRIM_ARRAY_DUMP		0x23
+
+/* Basic types */
+#define	HPROF_OBJECT			2
+#define	HPROF_BOOLEAN			4
+#define	HPROF_CHAR			5
+#define	HPROF_FLOAT			6
+#define	HPROF_DOUBLE			7
+#define	HPROF_BYTE			8
+#define	HPROF_SHORT			9
+#define	HPROF_INT			10
+#define	HPROF_LONG			11
+
+/* The only stack trace we write; it has no frames */
+#define	HPROF_TRACE_SERIAL		1
+
+/* Flush a heap dump segment once it gets this big */
+#define	HPROF_SEGMENT_SIZE		(1024 * 1024)
+
+typedef struct _hprofWriter {
+	FILE		*fp;
+	uint8		*buf;		/* the current heap dump segment */
+	size_t		len;
+	size_t		size;
+	bool		ok;
+} hprofWriter;
+
+static void
+hprofReserve(hprofWriter *w, size_t n)
+{
+	uint8 *nbuf;
+	size_t size;
+
+	if (w->len + n <= w->size) {
+		return;
+	}
+	size = w->size == 0 ? HPROF_SEGMENT_SIZE : w->size;
+	while (size < w->len + n) {
+		size *= 2;
+	}
+	nbuf = realloc(w->buf, size);
+	if (nbuf == NULL) {
+		w->ok = false;
+		return;
+	}
+	w->buf = nbuf;
+	w->size = size;
+}
+
+/* Append n bytes of v, most significant first */
+static void
+hprofPut(hprofWriter *w, uint64 v, int n)
+{
+	hprofReserve(w, n);
+	if (!w->ok) {
+		return;
+	}
+	while (n-- > 0) {
+		w->buf[w->len++] = (uint8)(v >> (n * 8));
+	}
+}
+
+#define	hprofU1(W, V)	hprofPut((W), (uint64)(V), 1)
+#define	hprofU2(W, V)	hprofPut((W), (uint64)(V), 2)
+#define	hprofU4(W, V)	hprofPut((W), (uint64)(V), 4)
+#define	hprofID(W, P)	hprofPut((W), (uint64)(uintp)(P), sizeof(void *))
+
+static void
+hprofBytes(hprofWriter *w, const void *data, size_t n)
+{
+	hprofReserve(w, n);
+	if (!w->ok) {
+		return;
+	}
+	memcpy(w->buf + w->len, data, n);
+	w->len += n;
+}
+
+/*
+ * Write the buffer out as one record with tag.
+ */
+static void
+hprofRecord(hprofWriter *w, int tag)
+{
+	uint8 head[9];
+	size_t len = w->len;
+	int i;
+
+	head[0] = (uint8)tag;
+	for (i = 0; i < 4; i++) {
+		head[1 + i] = 0;	/* microseconds since the header */
+		head[5 + i] = (uint8)(len >> ((3 - i) * 8));
+	}
+	if (w->ok && (fwrite(head, sizeof(head), 1, w->fp) != 1
+		      || (len > 0 && fwrite(w->buf, len, 1, w->fp) != 1))) {
+		w->ok = false;
+	}
+	w->len = 0;
+}
+
+static void
+hprofFlushSegment(hprofWriter *w, bool force)
+{
+	if (w->len >= HPROF_SEGMENT_SIZE || (force && w->len > 0)) {
+		hprofRecord(w, HPROF_HEAP_DUMP_SEGMENT);
+	}
+}
+
+static void
+hprofUtf8(hprofWriter *w, heapTable *names, Utf8Const *name)
+{
+	bool added;
+
+	if (heapTableFind(names, name, &added) == NULL || !added) {
+		return;
+	}
+	hprofID(w, name);
+	hprofBytes(w, name->data, strlen(name->data));
+	hprofRecord(w, HPROF_UTF8);
+}
+
+/*
+ * The HPROF type of a field, and the number of bytes its value takes
+ * in the dump.
+ */
+static int
+hprofFieldType(Field *fld, int *size)
+{
+	Hjava_lang_Class *type;
+
+	if (!FIELD_RESOLVED(fld)) {
+		*size = sizeof(void *);
+		return (HPROF_OBJECT);
+	}
+	type = FIELD_TYPE(fld);
+	if (type == PtrClass) {
+		*size = sizeof(void *);
+		return (sizeof(void *) == 8 ? HPROF_LONG : HPROF_INT);
+	}
+	if (!CLASS_IS_PRIMITIVE(type)) {
+		*size = sizeof(void *);
+		return (HPROF_OBJECT);
+	}
+	switch (CLASS_PRIM_SIG(type)) {
+	case 'Z': *size = 1; return (HPROF_BOOLEAN);
+	case 'B': *size = 1; return (HPROF_BYTE);
+	case 'C': *size = 2; return (HPROF_CHAR);
+	case 'S': *size = 2; return (HPROF_SHORT);
+	case 'I': *size = 4; return (HPROF_INT);
+	case 'F': *size = 4; return (HPROF_FLOAT);
+	case 'J': *size = 8; return (HPROF_LONG);
+	case 'D': *size = 8; return (HPROF_DOUBLE);
+	default:  *size = 4; return (HPROF_INT);
+	}
+}
+
+/*
+ * Append the value at addr, which is laid out as fld is in the VM.
+ */
+static void
+hprofFieldValue(hprofWriter *w, Field *fld, const void *addr)
+{
+	uint64 v;
+	int size;
+
+	hprofFieldType(fld, &size);
+	switch (FIELD_SIZE(fld)) {
+	case 1:  v = *(const uint8 *)addr; break;
+	case 2:  v = *(const uint16 *)addr; break;
+	case 4:  v = *(const uint32 *)addr; break;
+	default: v = *(const uint64 *)addr; break;
+	}
+	hprofPut(w, v, size);
+}
+
+/* Classes whose layout can be read */
+static inline bool
+hprofClassPrepared(Hjava_lang_Class *cl)
+{
+	return (!CLASS_IS_PRIMITIVE(cl) && cl->state >= CSTATE_PREPARED);
+}
+
+static void
+hprofLoadClass(hprofWriter *w, heapTable *names, Hjava_lang_Class *cl,
+	       int serial)
+{
+	int i;
+
+	hprofUtf8(w, names, cl->name);
+	if (hprofClassPrepared(cl)) {
+		for (i = 0; i < CLASS_NFIELDS(cl); i++) {
+			hprofUtf8(w, names, CLASS_FIELDS(cl)[i].name);
+		}
+	}
+
+	hprofU4(w, serial);
+	hprofID(w, cl);
+	hprofU4(w, HPROF_TRACE_SERIAL);
+	hprofID(w, cl->name);
+	hprofRecord(w, HPROF_LOAD_CLASS);
+}
+
+static void
+hprofClassDump(hprofWriter *w, Hjava_lang_Class *cl)
+{
+	Field *fld;
+	int size;
+	int i;
+
+	hprofU1(w, HPROF_CLASS_DUMP);
+	hprofID(w, cl);
+	hprofU4(w, HPROF_TRACE_SERIAL);
+	if (!hprofClassPrepared(cl)) {
+		hprofID(w, NULL);	/* superclass */
+		hprofID(w, NULL);	/* loader */
+		hprofID(w, NULL);	/* signers */
+		hprofID(w, NULL);	/* protection domain */
+		hprofID(w, NULL);	/* reserved */
+		hprofID(w, NULL);
+		hprofU4(w, 0);		/* instance size */
+		hprofU2(w, 0);		/* constant pool */
+		hprofU2(w, 0);		/* static fields */
+		hprofU2(w, 0);		/* instance fields */
+		return;
+	}
+
+	hprofID(w, cl->superclass);
+	hprofID(w, cl->loader);
+	hprofID(w, cl->signers);
+	hprofID(w, cl->protectionDomain);
+	hprofID(w, NULL);
+	hprofID(w, NULL);
+	hprofU4(w, CLASS_IS_ARRAY(cl) ? 0 : CLASS_FSIZE(cl));
+	hprofU2(w, 0);
+
+	hprofU2(w, CLASS_NSFIELDS(cl));
+	for (i = 0; i < CLASS_NSFIELDS(cl); i++) {
+		fld = &CLASS_SFIELDS(cl)[i];
+		hprofID(w, fld->name);
+		hprofU1(w, hprofFieldType(fld, &size));
+		hprofFieldValue(w, fld, FIELD_ADDRESS(fld));
+	}
+
+	hprofU2(w, CLASS_NIFIELDS(cl));
+	for (i = 0; i < CLASS_NIFIELDS(cl); i++) {
+		fld = &CLASS_IFIELDS(cl)[i];
+		hprofID(w, fld->name);
+		hprofU1(w, hprofFieldType(fld, &size));
+	}
+}
+
+static void
+hprofInstanceDump(hprofWriter *w, Hjava_lang_Object *obj)
+{
+	Hjava_lang_Class *cl;
+	size_t lenpos;
+	size_t len;
+	int i;
+
+	hprofU1(w, HPROF_INSTANCE_DUMP);
+	hprofID(w, obj);
+	hprofU4(w, HPROF_TRACE_SERIAL);
+	hprofID(w, OBJECT_CLASS(obj));
+	lenpos = w->len;
+	hprofU4(w, 0);
+
+	/* Fields of the class first, then of each superclass */
+	for (cl = OBJECT_CLASS(obj); cl != NULL; cl = cl->superclass) {
+		for (i = 0; i < CLASS_NIFIELDS(cl); i++) {
+			Field *fld = &CLASS_IFIELDS(cl)[i];
+
+			hprofFieldValue(w, fld,
+					(uint8 *)obj + FIELD_BOFFSET(fld));
+		}
+	}
+
+	if (w->ok) {
+		len = w->len - lenpos - 4;
+		for (i = 0; i < 4; i++) {
+			w->buf[lenpos + i] = (uint8)(len >> ((3 - i) * 8));
+		}
+	}
+}
+
+static void
+hprofArrayDump(hprofWriter *w, Hjava_lang_Object *obj)
+{
+	Hjava_lang_Class *cl = OBJECT_CLASS(obj);
+	Hjava_lang_Class *etype = Kaffe_get_array_element_type(cl);
+	jint n = ARRAY_SIZE(obj);
+	int type;
+	int size;
+	int esize;
+	jint i;
+
+	if (!CLASS_IS_PRIMITIVE(etype)) {
+		Hjava_lang_Object **data = OBJARRAY_DATA(obj);
+
+		hprofU1(w, HPROF_OBJ_ARRAY_DUMP);
+		hprofID(w, obj);
+		hprofU4(w, HPROF_TRACE_SERIAL);
+		hprofU4(w, n);
+		hprofID(w, cl);
+		for (i = 0; i < n; i++) {
+			hprofID(w, data[i]);
+		}
+		return;
+	}
+
+	switch (CLASS_PRIM_SIG(etype)) {
+	case 'Z': type = HPROF_BOOLEAN; size = 1; break;
+	case 'B': type = HPROF_BYTE; size = 1; break;
+	case 'C': type = HPROF_CHAR; size = 2; break;
+	case 'S': type = HPROF_SHORT; size = 2; break;
+	case 'I': type = HPROF_INT; size = 4; break;
+	case 'F': type = HPROF_FLOAT; size = 4; break;
+	case 'J': type = HPROF_LONG; size = 8; break;
+	case 'D': type = HPROF_DOUBLE; size = 8; break;
+	default: return;
+	}
+	esize = TYPE_PRIM_SIZE(etype);
+
+	hprofU1(w, HPROF_PRIM_ARRAY_DUMP);
+	hprofID(w, obj);
+	hprofU4(w, HPROF_TRACE_SERIAL);
+	hprofU4(w, n);
+	hprofU1(w, type);
+	if (size == 1 && esize == 1) {
+		hprofBytes(w, ARRAY_DATA(obj), n);
+		return;
+	}
+	for (i = 0; i < n; i++) {
+		const uint8 *p = (const uint8 *)ARRAY_DATA(obj) + i * esize;
+		uint64 v;
+
+		switch (esize) {
+		case 1:  v = *p; break;
+		case 2:  v = *(const uint16 *)p; break;
+		case 4:  v = *(const uint32 *)p; break;
+		default: v = *(const uint64 *)p; break;
+		}
+		hprofPut(w, v, size);
+	}
+}
+
+/*
+ * Add cl and its superclasses to the classes to dump.
+ */
+static void
+hprofAddClass(heapTable *classes, Hjava_lang_Class *cl)
+{
+	bool added;
+
+	while (cl != NULL) {
+		if (heapTableFind(classes, cl, &added) == NULL || !added) {
+			return;
+		}
+		if (!hprofClassPrepared(cl)) {
+			return;
+		}
+		cl = cl->superclass;
+	}
+}
+
+static void
+hprofWriteHeap(Collector *collector, void **objs, int nobjs, int nroots,
+	       void *arg)
+{
+	hprofWriter *w = arg;
+	heapTable classes;
+	heapTable names;
+	Hjava_lang_Class *cl;
+	int serial = 0;
+	int i;
+
+	memset(&classes, 0, sizeof(classes));
+	memset(&names, 0, sizeof(names));
+
+	/* The classes, with their names and the names of their fields */
+	for (i = 0; i < nobjs; i++) {
+		Hjava_lang_Object *obj = objs[i];
+
+		if (heapIsClass(collector, obj)) {
+			hprofAddClass(&classes, (Hjava_lang_Class *)obj);
+		}
+		else if (heapIsObject(obj)) {
+			hprofAddClass(&classes, OBJECT_CLASS(obj));
+		}
+	}
+	for (i = 0; i < classes.size && w->ok; i++) {
+		cl = classes.entries[i].key;
+		if (cl != NULL && cl->name != NULL) {
+			hprofLoadClass(w, &names, cl, ++serial);
+		}
+	}
+
+	hprofU4(w, HPROF_TRACE_SERIAL);
+	hprofU4(w, 0);		/* thread */
+	hprofU4(w, 0);		/* frames */
+	hprofRecord(w, HPROF_STACK_TRACE);
+
+	/* The heap itself */
+	for (i = 0; i < nroots; i++) {
+		hprofU1(w, HPROF_ROOT_UNKNOWN);
+		hprofID(w, objs[i]);
+		hprofFlushSegment(w, false);
+	}
+	for (i = 0; i < classes.size && w->ok; i++) {
+		cl = classes.entries[i].key;
+		if (cl == NULL || cl->name == NULL) {
+			continue;
+		}
+		if (cl->loader == NULL) {
+			hprofU1(w, HPROF_ROOT_STICKY_CLASS);
+			hprofID(w, cl);
+		}
+		hprofClassDump(w, cl);
+		hprofFlushSegment(w, false);
+	}
+	for (i = 0; i < nobjs && w->ok; i++) {
+		Hjava_lang_Object *obj = objs[i];
+
+		if (heapIsClass(collector, obj) || !heapIsObject(obj)) {
+			continue;
+		}
+		if (CLASS_IS_ARRAY(OBJECT_CLASS(obj))) {
+			hprofArrayDump(w, obj);
+		}
+		else {
+			hprofInstanceDump(w, obj);
+		}
+		hprofFlushSegment(w, false);
+	}
+	hprofFlushSegment(w, true);
+	hprofRecord(w, HPROF_HEAP_DUMP_END);
+
+	if (classes.failed || names.failed) {
+		w->ok = false;
+	}
+	heapTableFree(&classes);
+	heapTableFree(&names);
+}
+
+/*
+ * Write the live heap to file in the HPROF binary format.
+ */
+bool
+heapWriteDump(const char *file)
+{
+	static const char magic[] = "JAVA PROFILE 1.0.2";
+	hprofWriter w;
+	bool snapped;
+	jlong now;
+
+	memset(&w, 0, sizeof(w));
+	w.fp = fopen(file, "wb");
+	if (w.fp == NULL) {
+		return (false);
+	}
+	w.ok = true;
+
+	/* The header:  the magic with its nul, identifier size, time */
+	now = currentTime();
+	hprofBytes(&w, magic, sizeof(magic));
+	hprofU4(&w, sizeof(void *));
+	hprofU4(&w, (uint64)now >> 32);
+	hprofU4(&w, (uint64)now & 0xFFFFFFFF);
+	if (w.ok && fwrite(w.buf, w.len, 1, w.fp) != 1) {
+		w.ok = false;
+	}
+	w.len = 0;
+
+	snapped = KGC_snapshotHeap(main_collector, hprofWriteHeap, &w);
+
+	free(w.buf);
+	if (fclose(w.fp) != 0) {
+		w.ok = false;
+	}
+	return (snapped && w.ok);
+}
@@ -0,0 +1,23 @@
+/*
+ * heapDump.h
+ * Heap histograms and heap dumps.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#ifndef __kaffevm_heapDump_h
+#define __kaffevm_heapDump_h
+
+/*
+ * Both collect the heap and write what was found live to file.  They
+ * return false if the file cannot be written or the collector cannot
+ * enumerate live objects.
+ */
+extern bool heapWriteHistogram(const char *file);
+extern bool heapWriteDump(const char *file);
+
+#endif /* __kaffevm_heapDump_h */
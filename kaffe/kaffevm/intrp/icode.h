@@ -291,7 +291,7 @@ static const uintptr_t UNINITIALIZED_STACK_SLOT = 0x00c0ffee;
 #define	softcall_anewarray(r, s, t)		(r)->v.taddr = soft_anewarray(t, (s)->v.tint)
 #define	softcall_athrow(s)			soft_athrow((s)[0].v.taddr)
 #define	softcall_checkcast(n, o, t)		soft_checkcast(t, (o)->v.taddr)
-#define softcall_initialise_class(cl)		soft_initialise_class(cl)
+#define softcall_initialise_class(cl)		do { if (classNeedsInit(cl)) soft_initialise_class(cl); } while (0)
 #define	softcall_instanceof(r, o, t)		(r)->v.tint = soft_instanceof(t, (o)->v.taddr)
 
 /* Thread.stop() knows how to back out of java frames, so we do not
@@ -272,7 +272,7 @@ NDBG(		dprintf("Call to native %s.%s%s.\n", meth->class->name->data, meth->name-
 			mobj = (Hjava_lang_Object*)lcl[0].v.taddr;
 		}
 		/* this lock is safe for Thread.stop() */
-		locks_internal_lockMutex(&mobj->lock, 0);
+		lockObject(mobj);
 
 		/*
 		 * We must store the object on which we synchronized
@@ -32,6 +32,15 @@
 #include <alloca.h>
 #endif
 
+/*
+ * Fallback for natives without a call stub of their own.
+ */
+static void
+sysdepCallStub(callMethodInfo *call)
+{
+	sysdepCallMethod(call);
+}
+
 void *
 engine_buildTrampoline (Method *meth, void **where, errorInfo *einfo UNUSED)
 {
@@ -204,8 +213,15 @@ engine_callMethod (callMethodInfo *call)
 			startJNIcall();
 		}
 
-		/* Make the call - system dependent */
-		sysdepCallMethod(call);
+		/* Make the call through the stub for its signature, which
+		 * only depends on the method and is picked on the first call.
+		 */
+		if (meth->callStub == NULL) {
+			callMethodStub stub = KaffeVM_findCallStub(call);
+
+			meth->callStub = (stub != NULL) ? stub : sysdepCallStub;
+		}
+		meth->callStub(call);
 
 		if (syncobj != 0) {
 			unlockObject(syncobj);
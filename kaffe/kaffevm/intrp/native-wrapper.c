@@ -21,4 +21,6 @@ void
 engine_create_wrapper (Method *meth, void *func)
 {
 	setMethodCodeStart(meth, func);
+	/* The method may have turned into a JNI one */
+	meth->callStub = NULL;
 }
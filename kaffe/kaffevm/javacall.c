@@ -460,3 +460,206 @@ int KaffeVM_countRealNumberOfArgs(parsed_signature_t *sig)
   
   return size;
 }
+
+/*
+ * Call stubs specialised by signature.
+ *
+ * Each stub passes the arguments of one particular call shape directly
+ * to the native function, so that the C compiler rather than the generic
+ * sysdepCallMethod loop decides how they travel.  The shape is the
+ * sequence of calltypes with Z, B, C and S folded into I and the holes
+ * after 64 bit values dropped.  The return type is handled inside each
+ * stub.
+ *
+ * The ALIGN_AT_64bits padding cannot be told from a real argument, so
+ * there are no stubs on such ports.
+ */
+#if !defined(ALIGN_AT_64bits)
+
+/* Number of args entries taken by a jlong or a jdouble */
+#define W		(NO_HOLES ? 1 : 2)
+
+#define A_L(N)		(call->args[N].l)
+#define A_I(N)		((jint)call->args[N].PROM_i)
+#define A_J(N)		(call->args[N].j)
+#define A_F(N)		(call->args[N].f)
+#define A_D(N)		(call->args[N].d)
+
+#define CALL_STUB(SHAPE, PARAMS, ARGS)					\
+static void								\
+callStub_##SHAPE(callMethodInfo* call)					\
+{									\
+	void* f = call->function;					\
+									\
+	switch (call->rettype) {					\
+	case 'V':							\
+		((void (*)PARAMS)f)ARGS;				\
+		break;							\
+	case 'Z':							\
+		call->ret->i = ((jboolean (*)PARAMS)f)ARGS;		\
+		break;							\
+	case 'B':							\
+		call->ret->i = ((jbyte (*)PARAMS)f)ARGS;		\
+		break;							\
+	case 'C':							\
+		call->ret->i = ((jchar (*)PARAMS)f)ARGS;		\
+		break;							\
+	case 'S':							\
+		call->ret->i = ((jshort (*)PARAMS)f)ARGS;		\
+		break;							\
+	case 'I':							\
+		call->ret->i = ((jint (*)PARAMS)f)ARGS;			\
+		break;							\
+	case 'J':							\
+		call->ret->j = ((jlong (*)PARAMS)f)ARGS;		\
+		break;							\
+	case 'F':							\
+		call->ret->f = ((jfloat (*)PARAMS)f)ARGS;		\
+		break;							\
+	case 'D':							\
+		call->ret->d = ((jdouble (*)PARAMS)f)ARGS;		\
+		break;							\
+	default:							\
+		call->ret->l = ((void* (*)PARAMS)f)ARGS;		\
+		break;							\
+	}								\
+}
+
+CALL_STUB(none, (void), ())
+CALL_STUB(L, (void*), (A_L(0)))
+CALL_STUB(I, (jint), (A_I(0)))
+CALL_STUB(J, (jlong), (A_J(0)))
+CALL_STUB(F, (jfloat), (A_F(0)))
+CALL_STUB(D, (jdouble), (A_D(0)))
+CALL_STUB(LL, (void*, void*), (A_L(0), A_L(1)))
+CALL_STUB(LI, (void*, jint), (A_L(0), A_I(1)))
+CALL_STUB(II, (jint, jint), (A_I(0), A_I(1)))
+CALL_STUB(LJ, (void*, jlong), (A_L(0), A_J(1)))
+CALL_STUB(LF, (void*, jfloat), (A_L(0), A_F(1)))
+CALL_STUB(LD, (void*, jdouble), (A_L(0), A_D(1)))
+CALL_STUB(LLL, (void*, void*, void*), (A_L(0), A_L(1), A_L(2)))
+CALL_STUB(LLI, (void*, void*, jint), (A_L(0), A_L(1), A_I(2)))
+CALL_STUB(LIL, (void*, jint, void*), (A_L(0), A_I(1), A_L(2)))
+CALL_STUB(LII, (void*, jint, jint), (A_L(0), A_I(1), A_I(2)))
+CALL_STUB(LLJ, (void*, void*, jlong), (A_L(0), A_L(1), A_J(2)))
+CALL_STUB(LLF, (void*, void*, jfloat), (A_L(0), A_L(1), A_F(2)))
+CALL_STUB(LLD, (void*, void*, jdouble), (A_L(0), A_L(1), A_D(2)))
+CALL_STUB(LLLL, (void*, void*, void*, void*), (A_L(0), A_L(1), A_L(2), A_L(3)))
+CALL_STUB(LLLI, (void*, void*, void*, jint), (A_L(0), A_L(1), A_L(2), A_I(3)))
+CALL_STUB(LLIL, (void*, void*, jint, void*), (A_L(0), A_L(1), A_I(2), A_L(3)))
+CALL_STUB(LLII, (void*, void*, jint, jint), (A_L(0), A_L(1), A_I(2), A_I(3)))
+CALL_STUB(LIII, (void*, jint, jint, jint), (A_L(0), A_I(1), A_I(2), A_I(3)))
+CALL_STUB(LLLJ, (void*, void*, void*, jlong), (A_L(0), A_L(1), A_L(2), A_J(3)))
+CALL_STUB(LLJI, (void*, void*, jlong, jint), (A_L(0), A_L(1), A_J(2), A_I(2+W)))
+CALL_STUB(LLJJ, (void*, void*, jlong, jlong), (A_L(0), A_L(1), A_J(2), A_J(2+W)))
+CALL_STUB(LLDD, (void*, void*, jdouble, jdouble), (A_L(0), A_L(1), A_D(2), A_D(2+W)))
+CALL_STUB(LLLLL, (void*, void*, void*, void*, void*), (A_L(0), A_L(1), A_L(2), A_L(3), A_L(4)))
+CALL_STUB(LLLLI, (void*, void*, void*, void*, jint), (A_L(0), A_L(1), A_L(2), A_L(3), A_I(4)))
+CALL_STUB(LLLIL, (void*, void*, void*, jint, void*), (A_L(0), A_L(1), A_L(2), A_I(3), A_L(4)))
+CALL_STUB(LLLII, (void*, void*, void*, jint, jint), (A_L(0), A_L(1), A_L(2), A_I(3), A_I(4)))
+CALL_STUB(LLIII, (void*, void*, jint, jint, jint), (A_L(0), A_L(1), A_I(2), A_I(3), A_I(4)))
+CALL_STUB(LLILI, (void*, void*, jint, void*, jint), (A_L(0), A_L(1), A_I(2), A_L(3), A_I(4)))
+CALL_STUB(LLIIL, (void*, void*, jint, jint, void*), (A_L(0), A_L(1), A_I(2), A_I(3), A_L(4)))
+CALL_STUB(LLLLLL, (void*, void*, void*, void*, void*, void*), (A_L(0), A_L(1), A_L(2), A_L(3), A_L(4), A_L(5)))
+CALL_STUB(LLLLII, (void*, void*, void*, void*, jint, jint), (A_L(0), A_L(1), A_L(2), A_L(3), A_I(4), A_I(5)))
+CALL_STUB(LLLIII, (void*, void*, void*, jint, jint, jint), (A_L(0), A_L(1), A_L(2), A_I(3), A_I(4), A_I(5)))
+CALL_STUB(LLLILI, (void*, void*, void*, jint, void*, jint), (A_L(0), A_L(1), A_L(2), A_I(3), A_L(4), A_I(5)))
+CALL_STUB(LLIIII, (void*, void*, jint, jint, jint, jint), (A_L(0), A_L(1), A_I(2), A_I(3), A_I(4), A_I(5)))
+
+#define CALL_STUB_ENTRY(SHAPE)	{ #SHAPE, callStub_##SHAPE }
+
+static const struct {
+	const char*	shape;
+	callMethodStub	stub;
+} callStubs[] = {
+	{ "", callStub_none },
+	CALL_STUB_ENTRY(L),
+	CALL_STUB_ENTRY(I),
+	CALL_STUB_ENTRY(J),
+	CALL_STUB_ENTRY(F),
+	CALL_STUB_ENTRY(D),
+	CALL_STUB_ENTRY(LL),
+	CALL_STUB_ENTRY(LI),
+	CALL_STUB_ENTRY(II),
+	CALL_STUB_ENTRY(LJ),
+	CALL_STUB_ENTRY(LF),
+	CALL_STUB_ENTRY(LD),
+	CALL_STUB_ENTRY(LLL),
+	CALL_STUB_ENTRY(LLI),
+	CALL_STUB_ENTRY(LIL),
+	CALL_STUB_ENTRY(LII),
+	CALL_STUB_ENTRY(LLJ),
+	CALL_STUB_ENTRY(LLF),
+	CALL_STUB_ENTRY(LLD),
+	CALL_STUB_ENTRY(LLLL),
+	CALL_STUB_ENTRY(LLLI),
+	CALL_STUB_ENTRY(LLIL),
+	CALL_STUB_ENTRY(LLII),
+	CALL_STUB_ENTRY(LIII),
+	CALL_STUB_ENTRY(LLLJ),
+	CALL_STUB_ENTRY(LLJI),
+	CALL_STUB_ENTRY(LLJJ),
+	CALL_STUB_ENTRY(LLDD),
+	CALL_STUB_ENTRY(LLLLL),
+	CALL_STUB_ENTRY(LLLLI),
+	CALL_STUB_ENTRY(LLLIL),
+	CALL_STUB_ENTRY(LLLII),
+	CALL_STUB_ENTRY(LLIII),
+	CALL_STUB_ENTRY(LLILI),
+	CALL_STUB_ENTRY(LLIIL),
+	CALL_STUB_ENTRY(LLLLLL),
+	CALL_STUB_ENTRY(LLLLII),
+	CALL_STUB_ENTRY(LLLIII),
+	CALL_STUB_ENTRY(LLLILI),
+	CALL_STUB_ENTRY(LLIIII),
+	{ NULL, NULL }
+};
+
+#endif /* !defined(ALIGN_AT_64bits) */
+
+/**
+ * Find a call stub specialised for the shape of a call.
+ *
+ * @param call a call set up for sysdepCallMethod
+ * @return the stub, or NULL if the call has to go through sysdepCallMethod
+ */
+callMethodStub
+KaffeVM_findCallStub(const callMethodInfo* call)
+{
+#if !defined(ALIGN_AT_64bits)
+	char shape[8];
+	int i;
+	int n;
+
+	for (i = 0, n = 0; i < call->nrargs; i++) {
+		char type = call->calltype[i];
+
+		if (call->callsize[i] == 0) {
+			continue;
+		}
+		if (n == (int)sizeof(shape) - 1) {
+			return (NULL);
+		}
+		switch (type) {
+		case 'Z':
+		case 'B':
+		case 'C':
+		case 'S':
+			type = 'I';
+			break;
+		case '[':
+			type = 'L';
+			break;
+		}
+		shape[n++] = type;
+	}
+	shape[n] = '\0';
+
+	for (i = 0; callStubs[i].shape != NULL; i++) {
+		if (strcmp(callStubs[i].shape, shape) == 0) {
+			return (callStubs[i].stub);
+		}
+	}
+#endif
+	return (NULL);
+}
@@ -311,9 +311,9 @@ Kaffe_wrapper(Method* xmeth, void* func, bool use_JNI)
 		        slot_alloctmp(tmp2);
 		  
 #if SIZEOF_VOID_P == SIZEOF_INT
-			and_int_const(tmp2, tmp, 1);
+			and_int_const(tmp2, tmp, JNIREF_TAGS);
 #elif SIZEOF_VOID_P == SIZEOF_LONG
-			and_long_const(tmp2, tmp, 1);
+			and_long_const(tmp2, tmp, JNIREF_TAGS);
 #else
 #error "Unsupported size of pointer"
 #endif
@@ -324,9 +324,9 @@ Kaffe_wrapper(Method* xmeth, void* func, bool use_JNI)
 			
 			start_sub_block();
 #if SIZEOF_VOID_P == SIZEOF_INT
-			and_int_const(tmp2, tmp, ~(uintp)1);
+			and_int_const(tmp2, tmp, ~JNIREF_TAGS);
 #elif SIZEOF_VOID_P == SIZEOF_LONG
-			and_long_const(tmp2, tmp, ~(uintp)1);
+			and_long_const(tmp2, tmp, ~JNIREF_TAGS);
 #else
 #error "Unsupported size of pointer"
 #endif
@@ -5115,16 +5115,47 @@ softcall_instanceof(SlotInfo* dst, SlotInfo* obj, Hjava_lang_Class* class)
 	return_int(dst);
 }
 
+/*
+ * Initialise class c if it wasn't when we translated.  Where loads are
+ * kept in order the state is tested in line, so once c is initialised
+ * the code goes past the call and the static initializer's stores are
+ * seen, see getClassState.  While static initializers are recorded the
+ * call is always made, see classNeedsInit.
+ */
 void
 softcall_initialise_class(Hjava_lang_Class* c)
 {
-	if (c != 0 && c->state != CSTATE_COMPLETE) {
-		begin_func_sync();
-		pusharg_class_const(c, 0);
-		call_soft(soft_initialise_class);
-		popargs();
-		end_func_sync();
+#if defined(HAVE_load_addr_int) && defined(MD_LOADS_ORDERED)
+	SlotInfo* tmp;
+	bool guard = !clinitRecording;
+#endif
+
+	if (c == 0 || !classNeedsInit(c)) {
+		return;
 	}
+
+#if defined(HAVE_load_addr_int) && defined(MD_LOADS_ORDERED)
+	if (guard) {
+		end_sub_block();
+		slot_alloctmp(tmp);
+		load_addr_int(tmp, &c->state);
+		cbranch_int_const_eq(tmp, CSTATE_COMPLETE, reference_label(1, 1));
+		slot_freetmp(tmp);
+	}
+#endif
+
+	begin_func_sync();
+	pusharg_class_const(c, 0);
+	call_soft(soft_initialise_class);
+	popargs();
+	end_func_sync();
+
+#if defined(HAVE_load_addr_int) && defined(MD_LOADS_ORDERED)
+	if (guard) {
+		start_sub_block();
+		set_label(1, 1);
+	}
+#endif
 }
 
 void
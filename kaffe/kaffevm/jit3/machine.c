@@ -63,6 +63,10 @@
 #include "kaffe_jni.h"
 #include "native-wrapper.h"
 #include "stats.h"
+#include "jitProfile.h"
+#include "jvmti_kaffe.h"
+#include "startupTrace.h"
+#include "bulkArray.h"
 
 const char* engine_name = "Just-in-time v3";
 
@@ -112,6 +116,7 @@ struct {
 } jitStats;
 
 static jboolean generateInsnSequence(errorInfo*);
+static void noteCompilation(Method*, nativeCodeInfo*, statTime, statTime);
 
 /**
  * Look for exception handlers that enclose the given PC in the given method.
@@ -222,9 +227,13 @@ translate(Method* xmeth, errorInfo* einfo)
 	codeinfo* mycodeInfo;
 
 	nativeCodeInfo ncode;
+	void *func;
 
 	int64 tms = 0;
 	int64 tme;
+	statTime waitStart;
+	statTime compileStart;
+	bool installed = false;
 
 	static bool reinvoke = false;
 
@@ -238,7 +247,7 @@ translate(Method* xmeth, errorInfo* einfo)
 
 	/* If this code block is native, then just set it up and return */
 	if (methodIsNative(xmeth)) {
-		void *func = native(xmeth, einfo);
+		func = native(xmeth, einfo);
 		if (func != NULL) {
 			engine_create_wrapper(xmeth, func);
 			KAFFEJIT_TO_NATIVE(xmeth);
@@ -248,6 +257,14 @@ translate(Method* xmeth, errorInfo* einfo)
 		goto done3;
 	}
 
+	/* Some methods of java.util.Arrays are done by the bulk array code */
+	func = bulkArrayIntrinsic(xmeth);
+	if (func != NULL) {
+		engine_create_wrapper(xmeth, func);
+		KAFFEJIT_TO_NATIVE(xmeth);
+		goto done3;
+	}
+
 	/* Scan the code and determine the basic blocks */
 	success = analyzeMethod(xmeth, &mycodeInfo, einfo);
 	if (success == false) {
@@ -266,7 +283,9 @@ translate(Method* xmeth, errorInfo* einfo)
 	/* Only one in the translator at once. Must check the translation
 	 * hasn't been done by someone else once we get it.
 	 */
+	waitStart = statsNow();
 	enterTranslator();
+	compileStart = statsNow();
 
 	startTiming(&fulljit, "JIT translation");
 
@@ -447,6 +466,8 @@ SCHK(			sanityCheck();				)
 	if( finishInsnSequence(NULL, &ncode, einfo) )
 	{
 		installMethodCode(NULL, xmeth, &ncode);
+		noteCompilation(xmeth, &ncode, waitStart, compileStart);
+		installed = true;
 	}
 	else
 	{
@@ -511,10 +532,37 @@ done3:;
 	    jvmpiPostEvent(&ev);
 	  }
 #endif
+	if (installed && JVMTI_EVENT_ISENABLED(JVMTI_EVENT_COMPILED_METHOD_LOAD)) {
+		jvmtiPostCompiledMethodLoad(xmeth, METHOD_NATIVECODE(xmeth),
+			(uintp)xmeth->c.ncode.ncode_end
+			- (uintp)METHOD_NATIVECODE(xmeth));
+	}
 
 	return (success);
 }
 
+/*
+ * Tell the JIT telemetry about a method just installed.
+ */
+static void
+noteCompilation(Method* meth, nativeCodeInfo* code, statTime waitStart,
+		statTime compileStart)
+{
+	jitCompileInfo info;
+
+	info.bytecodeLen = METHOD_BYTECODE_LEN(meth);
+	info.codeLen = code->codelen;
+	info.memLen = code->memlen;
+	info.constants = KaffeJIT3_getNumberOfConstants();
+	info.spills = spillsGenerated;
+	info.reloads = reloadsGenerated;
+	info.waited = compileStart - waitStart;
+	info.compiled = statsNow() - compileStart;
+	jitProfileRecord(meth, &info);
+	STARTUP_TRACE_END(startupTracing ? compileStart : 0, "jit",
+			  meth->name->data, CLASS_CNAME(meth->class));
+}
+
 void
 KaffeJIT3_cleanupInsnSequence()
 {
@@ -53,6 +53,12 @@ kregs reginfo[] = {
  */
 int enable_readonce = Rreadonce;
 
+/**
+ * Spills and reloads generated for the method being translated.
+ */
+uint32 spillsGenerated;
+uint32 reloadsGenerated;
+
 /**
  * Number of register assignments done so far.
  * 
@@ -77,6 +83,8 @@ initRegisters(void)
 		reginfo[i].refs = 0;
 		reginfo[i].type &= ~Rglobal;
 	}
+	spillsGenerated = 0;
+	reloadsGenerated = 0;
 }
 
 /**
@@ -106,6 +114,7 @@ static
 void
 spill(SlotData* s)
 {
+	spillsGenerated++;
 #if defined(HAVE_spill_long)
 	if (reginfo[s->regno].ctype & Rlong) {
 		spill_long(s);
@@ -149,6 +158,7 @@ spill(SlotData* s)
 void
 reload(SlotData* s)
 {
+	reloadsGenerated++;
 #if defined(HAVE_reload_long)
 	if (reginfo[s->regno].ctype & Rlong) {
 		reload_long(s);
@@ -50,6 +50,8 @@ typedef struct _kregs {
 
 extern kregs reginfo[];
 extern int enable_readonce;
+extern uint32 spillsGenerated;
+extern uint32 reloadsGenerated;
 
 #define	MAXREG			NR_REGISTERS
 #define	NOREG			MAXREG
@@ -0,0 +1,197 @@
+/*
+ * jitProfile.c
+ * Records of the methods the translator compiled.
+ *
+ * The translator reports each method it compiles: the size of its
+ * bytecode and of the code generated for it, the constants and spill
+ * code that went with it, and how long compiling it took.  The last
+ * JITPROFILE_RECORDS reports are kept in a ring and can be written out
+ * as CSV or JSON.  Totals go to the statistics counters, so they are
+ * printed and exported along with the others.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include "config.h"
+#include "config-std.h"
+#include "config-mem.h"
+#include "jni_md.h"
+#include "gtypes.h"
+#include "classMethod.h"
+#include "locks.h"
+#include "utf8const.h"
+#include "stats.h"
+#include "jitProfile.h"
+
+/* Compilations kept, a power of two */
+#define	JITPROFILE_RECORDS	4096
+
+typedef struct _jitCompilation {
+	Utf8Const	*className;	/* NULL while the slot is unused */
+	Utf8Const	*name;
+	Utf8Const	*signature;
+	jitCompileInfo	info;
+} jitCompilation;
+
+static counter jitcode;
+static counter jitbytecode;
+static counter jitspills;
+static counter jitreloads;
+static timespent jitcompile;
+static timespent jitwait;
+
+static iStaticLock recordLock;
+static jitCompilation records[JITPROFILE_RECORDS];
+static jlong ncompiled;
+
+void
+jitProfileInit(void)
+{
+	initStaticLock(&recordLock);
+}
+
+/*
+ * The translator compiled meth.  Called with the translator lock held.
+ */
+void
+jitProfileRecord(Method *meth, const jitCompileInfo *info)
+{
+	jitCompilation *rec;
+
+	addToCounter(&jitcode, "jitmem-code", 1, (jlong)info->memLen);
+	addToCounter(&jitbytecode, "jit-bytecode", 1, (jlong)info->bytecodeLen);
+	addToCounter(&jitspills, "jit-spills", 1, (jlong)info->spills);
+	addToCounter(&jitreloads, "jit-reloads", 1, (jlong)info->reloads);
+	recordTiming(&jitcompile, "jittime-compile", info->compiled);
+	recordTiming(&jitwait, "jittime-wait", info->waited);
+
+	/* Keep the names, the method may be gone by the time we print */
+	utf8ConstAddRef(meth->class->name);
+	utf8ConstAddRef(meth->name);
+	utf8ConstAddRef(METHOD_SIG(meth));
+
+	lockStaticMutex(&recordLock);
+	rec = &records[ncompiled & (JITPROFILE_RECORDS - 1)];
+	ncompiled++;
+	if (rec->className != NULL) {
+		utf8ConstRelease(rec->className);
+		utf8ConstRelease(rec->name);
+		utf8ConstRelease(rec->signature);
+	}
+	rec->className = meth->class->name;
+	rec->name = meth->name;
+	rec->signature = METHOD_SIG(meth);
+	rec->info = *info;
+	unlockStaticMutex(&recordLock);
+}
+
+/*
+ * Print a name as a quoted CSV field or JSON string.  Class names are
+ * printed with dots.
+ */
+static void
+jitPrintName(FILE *fp, const char *s, bool dots, bool json)
+{
+	putc('"', fp);
+	for (; *s != '\0'; s++) {
+		if (*s == '/' && dots) {
+			putc('.', fp);
+		}
+		else if (*s == '"') {
+			fputs(json ? "\\\"" : "\"\"", fp);
+		}
+		else if (*s == '\\' && json) {
+			fputs("\\\\", fp);
+		}
+		else {
+			putc(*s, fp);
+		}
+	}
+	putc('"', fp);
+}
+
+/*
+ * Print the compilations kept, oldest first, as CSV with a header line
+ * or as a JSON object.
+ */
+void
+jitProfileDump(FILE *fp, bool json)
+{
+	jitCompilation *rec;
+	jlong first;
+	jlong i;
+
+	lockStaticMutex(&recordLock);
+	first = ncompiled > JITPROFILE_RECORDS
+		? ncompiled - JITPROFILE_RECORDS : 0;
+
+	if (json) {
+		fprintf(fp, "{\"compiled\": %lld, \"methods\": [",
+			(long long)ncompiled);
+	}
+	else {
+		fprintf(fp, "class,method,signature,bytecode,code,memory,"
+			"constants,spills,reloads,wait_ns,compile_ns\n");
+	}
+
+	for (i = first; i < ncompiled; i++) {
+		rec = &records[i & (JITPROFILE_RECORDS - 1)];
+		if (json) {
+			fprintf(fp, "%s\n  {\"class\": ", i > first ? "," : "");
+			jitPrintName(fp, rec->className->data, true, true);
+			fprintf(fp, ", \"method\": ");
+			jitPrintName(fp, rec->name->data, false, true);
+			fprintf(fp, ", \"signature\": ");
+			jitPrintName(fp, rec->signature->data, false, true);
+			fprintf(fp, ", \"bytecode\": %u, \"code\": %u,"
+				" \"memory\": %u, \"constants\": %u,"
+				" \"spills\": %u, \"reloads\": %u,"
+				" \"wait_ns\": %lld, \"compile_ns\": %lld}",
+				rec->info.bytecodeLen, rec->info.codeLen,
+				rec->info.memLen, rec->info.constants,
+				rec->info.spills, rec->info.reloads,
+				(long long)rec->info.waited,
+				(long long)rec->info.compiled);
+		}
+		else {
+			jitPrintName(fp, rec->className->data, true, false);
+			putc(',', fp);
+			jitPrintName(fp, rec->name->data, false, false);
+			putc(',', fp);
+			jitPrintName(fp, rec->signature->data, false, false);
+			fprintf(fp, ",%u,%u,%u,%u,%u,%u,%lld,%lld\n",
+				rec->info.bytecodeLen, rec->info.codeLen,
+				rec->info.memLen, rec->info.constants,
+				rec->info.spills, rec->info.reloads,
+				(long long)rec->info.waited,
+				(long long)rec->info.compiled);
+		}
+	}
+
+	if (json) {
+		fprintf(fp, "\n]}\n");
+	}
+	unlockStaticMutex(&recordLock);
+}
+
+/*
+ * Write the compilations kept to file, as JSON if its name ends in
+ * ".json" and as CSV otherwise.
+ */
+bool
+jitProfileWrite(const char *file)
+{
+	size_t len = strlen(file);
+	FILE *fp;
+
+	fp = fopen(file, "w");
+	if (fp == NULL) {
+		return (false);
+	}
+	jitProfileDump(fp, len >= 5 && strcmp(file + len - 5, ".json") == 0);
+	return (fclose(fp) == 0);
+}
@@ -0,0 +1,37 @@
+/*
+ * jitProfile.h
+ * Records of the methods the translator compiled.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#ifndef __kaffevm_jitProfile_h
+#define __kaffevm_jitProfile_h
+
+#include "stats.h"
+
+struct _jmethodID;
+
+/* What the translator reports about one compilation */
+typedef struct _jitCompileInfo {
+	uint32		bytecodeLen;
+	uint32		codeLen;	/* native instructions */
+	uint32		memLen;		/* instructions and constant pool */
+	uint32		constants;
+	uint32		spills;
+	uint32		reloads;
+	statTime	waited;		/* for the translator, in ns */
+	statTime	compiled;	/* in ns */
+} jitCompileInfo;
+
+extern void jitProfileInit(void);
+extern void jitProfileRecord(struct _jmethodID *meth,
+			     const jitCompileInfo *info);
+extern void jitProfileDump(FILE *fp, bool json);
+extern bool jitProfileWrite(const char *file);
+
+#endif /* __kaffevm_jitProfile_h */
@@ -25,6 +25,61 @@
 #include "jnirefs.h"
 #include "exception.h"
 #include "object.h"
+#include "thread.h"
+#include "gc.h"
+
+/*
+ * JNI critical regions.
+ *
+ * While a thread is inside a critical region the collector is disabled,
+ * so no collection can start and, in particular, no collector can move
+ * the arrays handed out.  A collection that is already running delays
+ * the start of the region instead.  The arrays are also recorded on the
+ * thread as pinned, for a collector that would rather keep running and
+ * only leave those in place.
+ */
+static void
+enterCriticalRegion(threadData* thread_data, void* arr)
+{
+  if (thread_data->criticalDepth < JNI_CRITICAL_PINS) {
+    thread_data->criticalPins[thread_data->criticalDepth] = arr;
+  }
+  if (thread_data->criticalDepth == 0) {
+    gc_disableGC();
+  }
+  thread_data->criticalDepth++;
+}
+
+static void
+leaveCriticalRegion(threadData* thread_data, void* arr)
+{
+  int i;
+  int pins;
+
+  /* Releasing an array that was never got is a bug in the caller */
+  if (thread_data->criticalDepth <= 0) {
+    return;
+  }
+
+  /* Regions are usually left in the reverse order, but need not be */
+  pins = thread_data->criticalDepth;
+  if (pins > JNI_CRITICAL_PINS) {
+    pins = JNI_CRITICAL_PINS;
+  }
+  for (i = pins - 1; i >= 0; i--) {
+    if (thread_data->criticalPins[i] == arr) {
+      for (; i < pins - 1; i++) {
+	thread_data->criticalPins[i] = thread_data->criticalPins[i + 1];
+      }
+      break;
+    }
+  }
+
+  thread_data->criticalDepth--;
+  if (thread_data->criticalDepth == 0) {
+    gc_enableGC();
+  }
+}
 
 jobject
 KaffeJNI_GetObjectArrayElement(JNIEnv* env UNUSED, jobjectArray arr, jsize elem)
@@ -235,9 +290,21 @@ KaffeJNI_GetByteArrayElements(JNIEnv* env UNUSED, jbyteArray arr, jboolean* isco
 }
 
 void*
-KaffeJNI_GetPrimitiveArrayCritical(JNIEnv* env, jarray arr, jboolean* iscopy)
+KaffeJNI_GetPrimitiveArrayCritical(JNIEnv* env UNUSED, jarray arr, jboolean* iscopy)
 {
-  return (KaffeJNI_GetByteArrayElements(env, (jbyteArray)arr, iscopy));
+  void* array;
+  jarray arr_local;
+  BEGIN_EXCEPTION_HANDLING(NULL);
+
+  arr_local = unveil(arr);
+  enterCriticalRegion(THREAD_DATA(), arr_local);
+  if (iscopy != NULL) {
+    *iscopy = JNI_FALSE;
+  }
+  array = ARRAY_DATA(arr_local);
+
+  END_EXCEPTION_HANDLING();
+  return (array);
 }
 
 jchar*
@@ -399,9 +466,16 @@ KaffeJNI_ReleaseByteArrayElements(JNIEnv* env UNUSED, jbyteArray arr, jbyte* ele
 }
 
 void
-KaffeJNI_ReleasePrimitiveArrayCritical(JNIEnv* env, jbyteArray arr, void* elems, jint mode)
+KaffeJNI_ReleasePrimitiveArrayCritical(JNIEnv* env UNUSED, jbyteArray arr, void* elems UNUSED, jint mode UNUSED)
 {
-  KaffeJNI_ReleaseByteArrayElements(env, (jbyteArray)arr, (jbyte*)elems, mode);
+  jbyteArray arr_local;
+  BEGIN_EXCEPTION_HANDLING_VOID();
+
+  /* The array was never copied, so there is nothing to write back */
+  arr_local = unveil(arr);
+  leaveCriticalRegion(THREAD_DATA(), arr_local);
+
+  END_EXCEPTION_HANDLING();
 }
 
 void
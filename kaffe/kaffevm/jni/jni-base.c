@@ -26,6 +26,7 @@
 #include "support.h"
 #include "classMethod.h"
 #include "jvmpi_kaffe.h"
+#include "jvmti_kaffe.h"
 #include "external.h"
 #include "system.h"
 
@@ -354,6 +355,14 @@ JNI_CreateJavaVM(JavaVM** vm, void** penv, void* args)
   startingThread = KTHREAD(current)();
   Kaffe_NumVM++;
 
+  if (Kaffe_JavaVMArgs.agentLibname != NULL
+      && !jvmtiLoadAgent(*vm, Kaffe_JavaVMArgs.agentLibname,
+			 Kaffe_JavaVMArgs.agentArguments))
+    exit(1);
+
+  if (JVMTI_EVENT_ISENABLED(JVMTI_EVENT_VM_INIT))
+    jvmtiPostVMInit();
+
 #if defined(ENABLE_JVMPI)
   if (Kaffe_JavaVMArgs.profilerLibname != NULL)
     {
@@ -71,7 +71,12 @@ KaffeJNI_removeJNIref(jref obj)
 void
 KaffeJNI_DeleteGlobalRef(JNIEnv* env UNUSED, jref obj)
 {
-  jref obj_local;
+	/* A global reference is the tagged address of its slot in the
+	 * collector's global reference table; see NewGlobalRef.  Anything
+	 * else is a bug in the caller.  */
+	if (((uintp)obj & JNIREF_TAGS) != JNIREF_GLOBAL) {
+		return;
+	}
 #if defined(ENABLE_JVMPI)
 	if( JVMPI_EVENT_ISENABLED(JVMPI_EVENT_JNI_GLOBALREF_FREE) )
 	{
@@ -83,9 +88,7 @@ KaffeJNI_DeleteGlobalRef(JNIEnv* env UNUSED, jref obj)
 	}
 #endif
 
-	obj_local = unveil(obj);
-
-	gc_rm_ref(obj_local);
+	KGC_rmGlobalRef(main_collector, (void **)((uintp)obj & ~JNIREF_TAGS));
 }
 
 void
@@ -101,7 +104,7 @@ KaffeJNI_DeleteLocalRef(JNIEnv* env UNUSED, jref obj)
 jboolean
 KaffeJNI_IsSameObject(JNIEnv* env UNUSED, jobject obj1, jobject obj2)
 {
-	if (obj1 == obj2) {
+	if (unveil(obj1) == unveil(obj2)) {
 		return (JNI_TRUE);
 	}
 	else {
@@ -113,14 +116,25 @@ jref
 KaffeJNI_NewGlobalRef(JNIEnv* env, jref obj)
 {
 	jref obj_local;
+	void **slot;
+	jref ref;
 	BEGIN_EXCEPTION_HANDLING(NULL);
 
 	obj_local = unveil(obj);
-
-	if (!gc_add_ref(obj_local)) {
-		errorInfo info;
-		postOutOfMemory(&info);
-		postError(env, &info);
+	ref = NULL;
+
+	/* Hand out the slot rather than the object itself, tagged so that
+	 * unveil() reads through it.  */
+	if (obj_local != NULL) {
+		slot = KGC_addGlobalRef(main_collector, obj_local);
+		if (slot == NULL) {
+			errorInfo info;
+			postOutOfMemory(&info);
+			postError(env, &info);
+		}
+		else {
+			ref = (jref)((uintp)slot | JNIREF_GLOBAL);
+		}
 	}
 #if defined(ENABLE_JVMPI)
 	if( JVMPI_EVENT_ISENABLED(JVMPI_EVENT_JNI_GLOBALREF_ALLOC) )
@@ -129,12 +143,12 @@ KaffeJNI_NewGlobalRef(JNIEnv* env, jref obj)
 
 		ev.event_type = JVMPI_EVENT_JNI_GLOBALREF_ALLOC;
 		ev.u.jni_globalref_alloc.obj_id = obj_local;
-		ev.u.jni_globalref_alloc.ref_id = obj_local;
+		ev.u.jni_globalref_alloc.ref_id = ref;
 		jvmpiPostEvent(&ev);
 	}
 #endif
 	END_EXCEPTION_HANDLING();
-	return obj_local;
+	return ref;
 }
 
 jint
@@ -263,7 +277,7 @@ jweak KaffeJNI_NewWeakGlobalRef(JNIEnv *env UNUSED, jobject obj)
   *((jobject *)ref) = obj_local;
   KGC_addWeakRef(main_collector, ref, obj_local);
 
-  ref = (jweak) ((uintp)ref | 1);
+  ref = (jweak) ((uintp)ref | JNIREF_WEAK);
 
 #if defined(ENABLE_JVMPI)
   if( JVMPI_EVENT_ISENABLED(JVMPI_EVENT_JNI_WEAK_GLOBALREF_ALLOC) )
@@ -284,7 +298,12 @@ jweak KaffeJNI_NewWeakGlobalRef(JNIEnv *env UNUSED, jobject obj)
 void KaffeJNI_DeleteWeakGlobalRef(JNIEnv *env UNUSED, jweak ref)
 {
   jobject obj;
-  void *ref2 = (void*)(((uintp)ref) & (~(uintp)1));
+  void *ref2 = (void*)(((uintp)ref) & ~JNIREF_TAGS);
+
+  /* Global references and local ones are not ours to delete */
+  if (((uintp)ref & JNIREF_TAGS) != JNIREF_WEAK) {
+    return;
+  }
 
   BEGIN_EXCEPTION_HANDLING_VOID();
 
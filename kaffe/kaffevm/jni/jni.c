@@ -42,6 +42,7 @@
 #include "native-wrapper.h"
 #include "kaffe_jni.h"
 #include "stackTrace.h"
+#include "jvmti_kaffe.h"
 
 extern struct JNINativeInterface Kaffe_JNINativeInterface;
 extern KaffeVM_Arguments Kaffe_JavaVMInitArgs;
@@ -838,6 +839,14 @@ Kaffe_GetEnv(JavaVM* vm, void** penv, jint interface_id)
 		(*penv) = jvmpiCreateInterface(interface_id);
 		return (JNI_OK);
 #endif
+
+	case JVMTI_VERSION_1_0:
+	case JVMTI_VERSION_1_1:
+	case JVMTI_VERSION_1_2:
+	case JVMTI_VERSION_9:
+	case JVMTI_VERSION_11:
+		(*penv) = jvmtiGetEnvironment();
+		return (JNI_OK);
 		
 	default:
 		return (JNI_EVERSION);
@@ -1130,7 +1139,9 @@ KaffeVM_Arguments Kaffe_JavaVMInitArgs = {
 	NULL,		/* Class home */
 	NULL,		/* Library home */
 	NULL,           /* No profiler */
-	NULL            /* No arguments to profiler */
+	NULL,           /* No arguments to profiler */
+	NULL,           /* No agent */
+	NULL            /* No arguments to agent */
 };
 
 /*
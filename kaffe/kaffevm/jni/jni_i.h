@@ -23,12 +23,21 @@ void KaffeJNI_removeJNIref(jref);
 #define	ADD_REF(O)		KaffeJNI_addJNIref(O)
 #define	REMOVE_REF(O)		KaffeJNI_removeJNIref(O)
 
+/*
+ * Global and weak global references are the addresses of the slots
+ * holding their objects, tagged in the low bits so that unveil() reads
+ * through them and the two kinds can be told apart.
+ */
+#define	JNIREF_WEAK	((uintp)1)
+#define	JNIREF_GLOBAL	((uintp)2)
+#define	JNIREF_TAGS	(JNIREF_WEAK | JNIREF_GLOBAL)
+
 static inline jobject
 unveil(jref w)
 {
   uintp wp = (uintp) w;
 
-  return ( (wp & 1) ? *((jobject *)(wp & ~(uintp)1)) : w);
+  return ( (wp & JNIREF_TAGS) ? *((jobject *)(wp & ~JNIREF_TAGS)) : w);
 }
 
 /*
@@ -0,0 +1,771 @@
+/*
+ * jvmti_kaffe.c
+ * The JVM Tool Interface, for profiling agents.
+ *
+ * Kaffe implements the part of JVMTI sampling profilers need: stack
+ * traces and the list of threads, names of methods and classes, and the
+ * VMInit, VMDeath, VMObjectAlloc, CompiledMethodLoad,
+ * MonitorContendedEnter and GarbageCollectionStart/Finish events.
+ * There is one environment, shared by all agents.  The function table
+ * has the standard layout with NULL in the slots of everything else.
+ * Capabilities are kept for agents that ask, but everything implemented
+ * is always available.
+ *
+ * VMObjectAlloc is sampled: a thread posts it for the object that takes
+ * it past another sampling interval worth of allocations.  An interval
+ * of 0 posts it for every object.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include "config.h"
+#include "config-std.h"
+#include "config-mem.h"
+#include "jni_md.h"
+#include "gtypes.h"
+#include "classMethod.h"
+#include "object.h"
+#include "locks.h"
+#include "thread.h"
+#include "threadData.h"
+#include "jthread.h"
+#include "external.h"
+#include "stackTrace.h"
+#include "jni_i.h"
+#include "debug.h"
+#include "jvmti_kaffe.h"
+
+#include "java_lang_Thread.h"
+#include "java_lang_VMThread.h"
+
+/* Deepest stack GetStackTrace looks at */
+#define	JVMTI_MAX_FRAMES	4096
+
+volatile uint64 jvmtiEventFlags;
+
+static iStaticLock jvmtiLock;
+static uint64 enabledEvents;		/* by SetEventNotificationMode */
+static jvmtiEventCallbacks callbacks;
+static jint samplingInterval = JVMTI_DEFAULT_SAMPLING_INTERVAL;
+static jvmtiCapabilities capabilities;	/* added by the agents */
+
+static const struct jvmtiInterface_1_ Kaffe_JVMTIInterface;
+static jvmtiEnv jvmtiEnvironment = &Kaffe_JVMTIInterface;
+
+/*
+ * Recompute the flags event sites test.  Called with jvmtiLock held.
+ */
+static void
+jvmtiUpdateFlags(void)
+{
+	uint64 flags = 0;
+
+#define	HAS_CALLBACK(type, cb)					\
+	if (callbacks.cb != NULL) {				\
+		flags |= JVMTI_EVENT_BIT(type);			\
+	}
+	HAS_CALLBACK(JVMTI_EVENT_VM_INIT, VMInit);
+	HAS_CALLBACK(JVMTI_EVENT_VM_DEATH, VMDeath);
+	HAS_CALLBACK(JVMTI_EVENT_COMPILED_METHOD_LOAD, CompiledMethodLoad);
+	HAS_CALLBACK(JVMTI_EVENT_MONITOR_CONTENDED_ENTER,
+		     MonitorContendedEnter);
+	HAS_CALLBACK(JVMTI_EVENT_GARBAGE_COLLECTION_START,
+		     GarbageCollectionStart);
+	HAS_CALLBACK(JVMTI_EVENT_GARBAGE_COLLECTION_FINISH,
+		     GarbageCollectionFinish);
+	HAS_CALLBACK(JVMTI_EVENT_VM_OBJECT_ALLOC, VMObjectAlloc);
+#undef	HAS_CALLBACK
+
+	jvmtiEventFlags = flags & enabledEvents;
+}
+
+static jvmtiError JNICALL
+Kaffe_SetEventNotificationMode(jvmtiEnv *env UNUSED, jvmtiEventMode mode,
+			       jvmtiEvent event_type, jthread event_thread,
+			       ...)
+{
+	if (event_type < JVMTI_MIN_EVENT_TYPE_VAL
+	    || event_type > JVMTI_MAX_EVENT_TYPE_VAL) {
+		return (JVMTI_ERROR_INVALID_EVENT_TYPE);
+	}
+	if (mode != JVMTI_ENABLE && mode != JVMTI_DISABLE) {
+		return (JVMTI_ERROR_ILLEGAL_ARGUMENT);
+	}
+	/* Events are enabled for all threads or none */
+	if (unveil(event_thread) != NULL) {
+		return (JVMTI_ERROR_ILLEGAL_ARGUMENT);
+	}
+
+	lockStaticMutex(&jvmtiLock);
+	if (mode == JVMTI_ENABLE) {
+		enabledEvents |= JVMTI_EVENT_BIT(event_type);
+	}
+	else {
+		enabledEvents &= ~JVMTI_EVENT_BIT(event_type);
+	}
+	jvmtiUpdateFlags();
+	unlockStaticMutex(&jvmtiLock);
+
+	return (JVMTI_ERROR_NONE);
+}
+
+static jvmtiError JNICALL
+Kaffe_SetEventCallbacks(jvmtiEnv *env UNUSED,
+			const jvmtiEventCallbacks *cbs, jint size)
+{
+	if (size < 0) {
+		return (JVMTI_ERROR_ILLEGAL_ARGUMENT);
+	}
+	if ((size_t)size > sizeof(callbacks)) {
+		size = sizeof(callbacks);
+	}
+
+	lockStaticMutex(&jvmtiLock);
+	memset(&callbacks, 0, sizeof(callbacks));
+	if (cbs != NULL) {
+		memcpy(&callbacks, cbs, (size_t)size);
+	}
+	jvmtiUpdateFlags();
+	unlockStaticMutex(&jvmtiLock);
+
+	return (JVMTI_ERROR_NONE);
+}
+
+static jvmtiError JNICALL
+Kaffe_Allocate(jvmtiEnv *env UNUSED, jlong size, unsigned char **mem_ptr)
+{
+	if (mem_ptr == NULL) {
+		return (JVMTI_ERROR_NULL_POINTER);
+	}
+	if (size < 0) {
+		return (JVMTI_ERROR_ILLEGAL_ARGUMENT);
+	}
+	if (size == 0) {
+		*mem_ptr = NULL;
+		return (JVMTI_ERROR_NONE);
+	}
+	*mem_ptr = malloc((size_t)size);
+	if (*mem_ptr == NULL) {
+		return (JVMTI_ERROR_OUT_OF_MEMORY);
+	}
+	return (JVMTI_ERROR_NONE);
+}
+
+static jvmtiError JNICALL
+Kaffe_Deallocate(jvmtiEnv *env UNUSED, unsigned char *mem)
+{
+	free(mem);
+	return (JVMTI_ERROR_NONE);
+}
+
+static char *
+jvmtiStrdup(const char *s)
+{
+	char *d = malloc(strlen(s) + 1);
+
+	if (d != NULL) {
+		strcpy(d, s);
+	}
+	return (d);
+}
+
+typedef struct _threadList {
+	int		count;
+	int		size;
+	jthread		*threads;
+} threadList;
+
+static void
+jvmtiAddThread(jthread_t jtid, void *arg)
+{
+	threadList *list = arg;
+	Hjava_lang_VMThread *vmtid;
+	jthread *threads;
+
+	vmtid = (Hjava_lang_VMThread *)KTHREAD(get_data)(jtid)->jlThread;
+	if (vmtid == NULL || unhand(vmtid)->thread == NULL) {
+		return;
+	}
+	if (list->count == list->size) {
+		threads = realloc(list->threads,
+				  (list->size * 2 + 16) * sizeof(jthread));
+		if (threads == NULL) {
+			return;
+		}
+		list->threads = threads;
+		list->size = list->size * 2 + 16;
+	}
+	list->threads[list->count++] = unhand(vmtid)->thread;
+}
+
+static jvmtiError JNICALL
+Kaffe_GetAllThreads(jvmtiEnv *env UNUSED, jint *count_ptr,
+		    jthread **threads_ptr)
+{
+	threadList list;
+	int i;
+
+	if (count_ptr == NULL || threads_ptr == NULL) {
+		return (JVMTI_ERROR_NULL_POINTER);
+	}
+
+	list.count = 0;
+	list.size = 0;
+	list.threads = NULL;
+	KTHREAD(walkLiveThreads_r)(jvmtiAddThread, &list);
+
+	/* The threads are local references of the caller */
+	for (i = 0; i < list.count; i++) {
+		ADD_REF(list.threads[i]);
+	}
+
+	*count_ptr = list.count;
+	*threads_ptr = list.threads;
+	return (JVMTI_ERROR_NONE);
+}
+
+/*
+ * Only the stack of the current thread can be walked.  Locations are
+ * bytecode indices in the interpreter; compiled code keeps no map from
+ * native code back to the bytecode, so there they are -1.
+ */
+static jvmtiError JNICALL
+Kaffe_GetStackTrace(jvmtiEnv *env UNUSED, jthread thread, jint start_depth,
+		    jint max_frame_count, jvmtiFrameInfo *frame_buffer,
+		    jint *count_ptr)
+{
+	Method **meths;
+	uintp *pcs;
+	int depth;
+	int first;
+	int i;
+
+	thread = unveil(thread);
+	if (frame_buffer == NULL || count_ptr == NULL) {
+		return (JVMTI_ERROR_NULL_POINTER);
+	}
+	if (max_frame_count < 0) {
+		return (JVMTI_ERROR_ILLEGAL_ARGUMENT);
+	}
+	if (thread != NULL && thread != (jthread)getCurrentThread()) {
+		return (JVMTI_ERROR_NOT_AVAILABLE);
+	}
+
+	meths = malloc(JVMTI_MAX_FRAMES * (sizeof(Method *) + sizeof(uintp)));
+	if (meths == NULL) {
+		return (JVMTI_ERROR_OUT_OF_MEMORY);
+	}
+	pcs = (uintp *)(meths + JVMTI_MAX_FRAMES);
+	depth = stackTraceFrames(NULL, meths, pcs, JVMTI_MAX_FRAMES);
+
+	/* A negative start depth counts from the outermost frame */
+	first = start_depth >= 0 ? start_depth : depth + start_depth;
+	if (first < 0 || (first >= depth && first > 0)) {
+		free(meths);
+		return (JVMTI_ERROR_ILLEGAL_ARGUMENT);
+	}
+
+	for (i = 0; i < max_frame_count && first + i < depth; i++) {
+		frame_buffer[i].method = meths[first + i];
+#if defined(TRANSLATOR)
+		frame_buffer[i].location = -1;
+#else
+		frame_buffer[i].location = (jlocation)pcs[first + i];
+#endif
+	}
+	*count_ptr = i;
+
+	free(meths);
+	return (JVMTI_ERROR_NONE);
+}
+
+static jvmtiError JNICALL
+Kaffe_GetMethodName(jvmtiEnv *env UNUSED, jmethodID method, char **name_ptr,
+		    char **signature_ptr, char **generic_ptr)
+{
+	Method *meth = (Method *)method;
+
+	if (meth == NULL) {
+		return (JVMTI_ERROR_INVALID_METHODID);
+	}
+	if (name_ptr != NULL) {
+		*name_ptr = jvmtiStrdup(meth->name->data);
+		if (*name_ptr == NULL) {
+			return (JVMTI_ERROR_OUT_OF_MEMORY);
+		}
+	}
+	if (signature_ptr != NULL) {
+		*signature_ptr = jvmtiStrdup(METHOD_SIGD(meth));
+		if (*signature_ptr == NULL) {
+			if (name_ptr != NULL) {
+				free(*name_ptr);
+			}
+			return (JVMTI_ERROR_OUT_OF_MEMORY);
+		}
+	}
+	if (generic_ptr != NULL) {
+		*generic_ptr = NULL;
+	}
+	return (JVMTI_ERROR_NONE);
+}
+
+static jvmtiError JNICALL
+Kaffe_GetMethodDeclaringClass(jvmtiEnv *env UNUSED, jmethodID method,
+			      jclass *declaring_class_ptr)
+{
+	Method *meth = (Method *)method;
+
+	if (meth == NULL) {
+		return (JVMTI_ERROR_INVALID_METHODID);
+	}
+	if (declaring_class_ptr == NULL) {
+		return (JVMTI_ERROR_NULL_POINTER);
+	}
+	*declaring_class_ptr = (jclass)meth->class;
+	return (JVMTI_ERROR_NONE);
+}
+
+static jvmtiError JNICALL
+Kaffe_GetClassSignature(jvmtiEnv *env UNUSED, jclass klass,
+			char **signature_ptr, char **generic_ptr)
+{
+	Hjava_lang_Class *cl = (Hjava_lang_Class *)unveil(klass);
+	char *sig;
+
+	if (cl == NULL) {
+		return (JVMTI_ERROR_INVALID_CLASS);
+	}
+	if (signature_ptr != NULL) {
+		if (CLASS_IS_PRIMITIVE(cl)) {
+			sig = malloc(2);
+			if (sig != NULL) {
+				sig[0] = CLASS_PRIM_SIG(cl);
+				sig[1] = '\0';
+			}
+		}
+		else if (CLASS_IS_ARRAY(cl)) {
+			sig = jvmtiStrdup(CLASS_CNAME(cl));
+		}
+		else {
+			sig = malloc(strlen(CLASS_CNAME(cl)) + 3);
+			if (sig != NULL) {
+				sprintf(sig, "L%s;", CLASS_CNAME(cl));
+			}
+		}
+		if (sig == NULL) {
+			return (JVMTI_ERROR_OUT_OF_MEMORY);
+		}
+		*signature_ptr = sig;
+	}
+	if (generic_ptr != NULL) {
+		*generic_ptr = NULL;
+	}
+	return (JVMTI_ERROR_NONE);
+}
+
+static jvmtiError JNICALL
+Kaffe_SetHeapSamplingInterval(jvmtiEnv *env UNUSED, jint interval)
+{
+	if (interval < 0) {
+		return (JVMTI_ERROR_ILLEGAL_ARGUMENT);
+	}
+	samplingInterval = interval;
+	return (JVMTI_ERROR_NONE);
+}
+
+static jvmtiError JNICALL
+Kaffe_GetVersionNumber(jvmtiEnv *env UNUSED, jint *version_ptr)
+{
+	if (version_ptr == NULL) {
+		return (JVMTI_ERROR_NULL_POINTER);
+	}
+	/* SetHeapSamplingInterval is new in 11 */
+	*version_ptr = JVMTI_VERSION_11;
+	return (JVMTI_ERROR_NONE);
+}
+
+/*
+ * The capabilities of the events Kaffe posts.  Events are posted
+ * whether an agent added them or not.
+ */
+static void
+jvmtiPotentialCapabilities(jvmtiCapabilities *caps)
+{
+	memset(caps, 0, sizeof(*caps));
+#if defined(TRANSLATOR)
+	caps->can_generate_compiled_method_load_events = 1;
+#endif
+	caps->can_generate_monitor_events = 1;
+	caps->can_generate_vm_object_alloc_events = 1;
+	caps->can_generate_garbage_collection_events = 1;
+}
+
+static jvmtiError JNICALL
+Kaffe_GetPotentialCapabilities(jvmtiEnv *env UNUSED, jvmtiCapabilities *caps)
+{
+	if (caps == NULL) {
+		return (JVMTI_ERROR_NULL_POINTER);
+	}
+	jvmtiPotentialCapabilities(caps);
+	return (JVMTI_ERROR_NONE);
+}
+
+static jvmtiError JNICALL
+Kaffe_AddCapabilities(jvmtiEnv *env UNUSED, const jvmtiCapabilities *caps)
+{
+	jvmtiCapabilities potential;
+	const unsigned char *want = (const unsigned char *)caps;
+	const unsigned char *can = (const unsigned char *)&potential;
+	unsigned char *have = (unsigned char *)&capabilities;
+	size_t i;
+
+	if (caps == NULL) {
+		return (JVMTI_ERROR_NULL_POINTER);
+	}
+	jvmtiPotentialCapabilities(&potential);
+	for (i = 0; i < sizeof(jvmtiCapabilities); i++) {
+		if ((want[i] & ~can[i]) != 0) {
+			return (JVMTI_ERROR_NOT_AVAILABLE);
+		}
+	}
+
+	lockStaticMutex(&jvmtiLock);
+	for (i = 0; i < sizeof(jvmtiCapabilities); i++) {
+		have[i] |= want[i];
+	}
+	unlockStaticMutex(&jvmtiLock);
+	return (JVMTI_ERROR_NONE);
+}
+
+static jvmtiError JNICALL
+Kaffe_RelinquishCapabilities(jvmtiEnv *env UNUSED,
+			     const jvmtiCapabilities *caps)
+{
+	const unsigned char *drop = (const unsigned char *)caps;
+	unsigned char *have = (unsigned char *)&capabilities;
+	size_t i;
+
+	if (caps == NULL) {
+		return (JVMTI_ERROR_NULL_POINTER);
+	}
+
+	lockStaticMutex(&jvmtiLock);
+	for (i = 0; i < sizeof(jvmtiCapabilities); i++) {
+		have[i] &= ~drop[i];
+	}
+	unlockStaticMutex(&jvmtiLock);
+	return (JVMTI_ERROR_NONE);
+}
+
+static jvmtiError JNICALL
+Kaffe_GetCapabilities(jvmtiEnv *env UNUSED, jvmtiCapabilities *caps)
+{
+	if (caps == NULL) {
+		return (JVMTI_ERROR_NULL_POINTER);
+	}
+	lockStaticMutex(&jvmtiLock);
+	*caps = capabilities;
+	unlockStaticMutex(&jvmtiLock);
+	return (JVMTI_ERROR_NONE);
+}
+
+static const struct jvmtiInterface_1_ Kaffe_JVMTIInterface = {
+	NULL,				/*   1 reserved1 */
+	Kaffe_SetEventNotificationMode,	/*   2 */
+	NULL,				/*   3 GetAllModules */
+	Kaffe_GetAllThreads,		/*   4 */
+	NULL,				/*   5 SuspendThread */
+	NULL,				/*   6 ResumeThread */
+	NULL,				/*   7 StopThread */
+	NULL,				/*   8 InterruptThread */
+	NULL,				/*   9 GetThreadInfo */
+	NULL,				/*  10 GetOwnedMonitorInfo */
+	NULL,				/*  11 GetCurrentContendedMonitor */
+	NULL,				/*  12 RunAgentThread */
+	NULL,				/*  13 GetTopThreadGroups */
+	NULL,				/*  14 GetThreadGroupInfo */
+	NULL,				/*  15 GetThreadGroupChildren */
+	NULL,				/*  16 GetFrameCount */
+	NULL,				/*  17 GetThreadState */
+	NULL,				/*  18 GetCurrentThread */
+	NULL,				/*  19 GetFrameLocation */
+	NULL,				/*  20 NotifyFramePop */
+	NULL,				/*  21 GetLocalObject */
+	NULL,				/*  22 GetLocalInt */
+	NULL,				/*  23 GetLocalLong */
+	NULL,				/*  24 GetLocalFloat */
+	NULL,				/*  25 GetLocalDouble */
+	NULL,				/*  26 SetLocalObject */
+	NULL,				/*  27 SetLocalInt */
+	NULL,				/*  28 SetLocalLong */
+	NULL,				/*  29 SetLocalFloat */
+	NULL,				/*  30 SetLocalDouble */
+	NULL,				/*  31 CreateRawMonitor */
+	NULL,				/*  32 DestroyRawMonitor */
+	NULL,				/*  33 RawMonitorEnter */
+	NULL,				/*  34 RawMonitorExit */
+	NULL,				/*  35 RawMonitorWait */
+	NULL,				/*  36 RawMonitorNotify */
+	NULL,				/*  37 RawMonitorNotifyAll */
+	NULL,				/*  38 SetBreakpoint */
+	NULL,				/*  39 ClearBreakpoint */
+	NULL,				/*  40 GetNamedModule */
+	NULL,				/*  41 SetFieldAccessWatch */
+	NULL,				/*  42 ClearFieldAccessWatch */
+	NULL,				/*  43 SetFieldModificationWatch */
+	NULL,				/*  44 ClearFieldModificationWatch */
+	NULL,				/*  45 IsModifiableClass */
+	Kaffe_Allocate,			/*  46 */
+	Kaffe_Deallocate,		/*  47 */
+	Kaffe_GetClassSignature,	/*  48 */
+	NULL,				/*  49 GetClassStatus */
+	NULL,				/*  50 GetSourceFileName */
+	NULL,				/*  51 GetClassModifiers */
+	NULL,				/*  52 GetClassMethods */
+	NULL,				/*  53 GetClassFields */
+	NULL,				/*  54 GetImplementedInterfaces */
+	NULL,				/*  55 IsInterface */
+	NULL,				/*  56 IsArrayClass */
+	NULL,				/*  57 GetClassLoader */
+	NULL,				/*  58 GetObjectHashCode */
+	NULL,				/*  59 GetObjectMonitorUsage */
+	NULL,				/*  60 GetFieldName */
+	NULL,				/*  61 GetFieldDeclaringClass */
+	NULL,				/*  62 GetFieldModifiers */
+	NULL,				/*  63 IsFieldSynthetic */
+	Kaffe_GetMethodName,		/*  64 */
+	Kaffe_GetMethodDeclaringClass,	/*  65 */
+	NULL,				/*  66 GetMethodModifiers */
+	NULL,				/*  67 reserved67 */
+	NULL,				/*  68 GetMaxLocals */
+	NULL,				/*  69 GetArgumentsSize */
+	NULL,				/*  70 GetLineNumberTable */
+	NULL,				/*  71 GetMethodLocation */
+	NULL,				/*  72 GetLocalVariableTable */
+	NULL,				/*  73 SetNativeMethodPrefix */
+	NULL,				/*  74 SetNativeMethodPrefixes */
+	NULL,				/*  75 GetBytecodes */
+	NULL,				/*  76 IsMethodNative */
+	NULL,				/*  77 IsMethodSynthetic */
+	NULL,				/*  78 GetLoadedClasses */
+	NULL,				/*  79 GetClassLoaderClasses */
+	NULL,				/*  80 PopFrame */
+	NULL,				/*  81 ForceEarlyReturnObject */
+	NULL,				/*  82 ForceEarlyReturnInt */
+	NULL,				/*  83 ForceEarlyReturnLong */
+	NULL,				/*  84 ForceEarlyReturnFloat */
+	NULL,				/*  85 ForceEarlyReturnDouble */
+	NULL,				/*  86 ForceEarlyReturnVoid */
+	NULL,				/*  87 RedefineClasses */
+	Kaffe_GetVersionNumber,		/*  88 */
+	Kaffe_GetCapabilities,		/*  89 */
+	NULL,				/*  90 GetSourceDebugExtension */
+	NULL,				/*  91 IsMethodObsolete */
+	NULL,				/*  92 SuspendThreadList */
+	NULL,				/*  93 ResumeThreadList */
+	NULL,				/*  94 AddModuleReads */
+	NULL,				/*  95 AddModuleExports */
+	NULL,				/*  96 AddModuleOpens */
+	NULL,				/*  97 AddModuleUses */
+	NULL,				/*  98 AddModuleProvides */
+	NULL,				/*  99 IsModifiableModule */
+	NULL,				/* 100 GetAllStackTraces */
+	NULL,				/* 101 GetThreadListStackTraces */
+	NULL,				/* 102 GetThreadLocalStorage */
+	NULL,				/* 103 SetThreadLocalStorage */
+	Kaffe_GetStackTrace,		/* 104 */
+	NULL,				/* 105 reserved105 */
+	NULL,				/* 106 GetTag */
+	NULL,				/* 107 SetTag */
+	NULL,				/* 108 ForceGarbageCollection */
+	NULL,				/* 109 IterateOverObjectsReachableFromObject */
+	NULL,				/* 110 IterateOverReachableObjects */
+	NULL,				/* 111 IterateOverHeap */
+	NULL,				/* 112 IterateOverInstancesOfClass */
+	NULL,				/* 113 reserved113 */
+	NULL,				/* 114 GetObjectsWithTags */
+	NULL,				/* 115 FollowReferences */
+	NULL,				/* 116 IterateThroughHeap */
+	NULL,				/* 117 reserved117 */
+	NULL,				/* 118 reserved118 */
+	NULL,				/* 119 reserved119 */
+	NULL,				/* 120 SetJNIFunctionTable */
+	NULL,				/* 121 GetJNIFunctionTable */
+	Kaffe_SetEventCallbacks,	/* 122 */
+	NULL,				/* 123 GenerateEvents */
+	NULL,				/* 124 GetExtensionFunctions */
+	NULL,				/* 125 GetExtensionEvents */
+	NULL,				/* 126 SetExtensionEventCallback */
+	NULL,				/* 127 DisposeEnvironment */
+	NULL,				/* 128 GetErrorName */
+	NULL,				/* 129 GetJLocationFormat */
+	NULL,				/* 130 GetSystemProperties */
+	NULL,				/* 131 GetSystemProperty */
+	NULL,				/* 132 SetSystemProperty */
+	NULL,				/* 133 GetPhase */
+	NULL,				/* 134 GetCurrentThreadCpuTimerInfo */
+	NULL,				/* 135 GetCurrentThreadCpuTime */
+	NULL,				/* 136 GetThreadCpuTimerInfo */
+	NULL,				/* 137 GetThreadCpuTime */
+	NULL,				/* 138 GetTimerInfo */
+	NULL,				/* 139 GetTime */
+	Kaffe_GetPotentialCapabilities,	/* 140 */
+	NULL,				/* 141 reserved141 */
+	Kaffe_AddCapabilities,		/* 142 */
+	Kaffe_RelinquishCapabilities,	/* 143 */
+	NULL,				/* 144 GetAvailableProcessors */
+	NULL,				/* 145 GetClassVersionNumbers */
+	NULL,				/* 146 GetConstantPool */
+	NULL,				/* 147 GetEnvironmentLocalStorage */
+	NULL,				/* 148 SetEnvironmentLocalStorage */
+	NULL,				/* 149 AddToBootstrapClassLoaderSearch */
+	NULL,				/* 150 SetVerboseFlag */
+	NULL,				/* 151 AddToSystemClassLoaderSearch */
+	NULL,				/* 152 RetransformClasses */
+	NULL,				/* 153 GetOwnedMonitorStackDepthInfo */
+	NULL,				/* 154 GetObjectSize */
+	NULL,				/* 155 GetLocalInstance */
+	Kaffe_SetHeapSamplingInterval	/* 156 */
+};
+
+void
+jvmtiInit(void)
+{
+	initStaticLock(&jvmtiLock);
+}
+
+/*
+ * Return the environment handed out by GetEnv.
+ */
+jvmtiEnv *
+jvmtiGetEnvironment(void)
+{
+	return (&jvmtiEnvironment);
+}
+
+/*
+ * Load the agent library path and call its Agent_OnLoad with options.
+ */
+bool
+jvmtiLoadAgent(JavaVM *vm, const char *path, const char *options)
+{
+	jint (JNICALL *onLoad)(JavaVM *, char *, void *);
+	char errbuf[256];
+	int libIndex;
+
+	libIndex = loadNativeLibrary(path, NULL, errbuf, sizeof(errbuf));
+	if (libIndex < 0) {
+		fprintf(stderr, "Unable to load agent %s: %s\n", path, errbuf);
+		return (false);
+	}
+
+	/* Not some other library's Agent_OnLoad */
+	onLoad = (jint (JNICALL *)(JavaVM *, char *, void *))
+		loadNativeLibrarySymFromIndex(libIndex, "Agent_OnLoad");
+	if (onLoad == NULL) {
+		fprintf(stderr, "Agent %s has no Agent_OnLoad\n", path);
+		return (false);
+	}
+	if (onLoad(vm, (char *)(options != NULL ? options : ""), NULL) != 0) {
+		fprintf(stderr, "Agent %s failed to initialise\n", path);
+		return (false);
+	}
+	return (true);
+}
+
+void
+jvmtiPostVMInit(void)
+{
+	jvmtiEventVMInit cb = callbacks.VMInit;
+
+	if (cb != NULL) {
+		cb(&jvmtiEnvironment, THREAD_JNIENV(),
+		   (jthread)getCurrentThread());
+	}
+}
+
+void
+jvmtiPostVMDeath(void)
+{
+	jvmtiEventVMDeath cb = callbacks.VMDeath;
+
+	if (cb != NULL) {
+		cb(&jvmtiEnvironment, THREAD_JNIENV());
+	}
+}
+
+void
+jvmtiPostCompiledMethodLoad(Method *meth, const void *code, size_t size)
+{
+	jvmtiEventCompiledMethodLoad cb = callbacks.CompiledMethodLoad;
+
+	if (cb != NULL) {
+		cb(&jvmtiEnvironment, meth, (jint)size, code, 0, NULL, NULL);
+	}
+}
+
+/*
+ * The current thread is about to wait for the monitor of obj.
+ */
+void
+jvmtiPostMonitorContendedEnter(Hjava_lang_Object *obj)
+{
+	jvmtiEventMonitorContendedEnter cb = callbacks.MonitorContendedEnter;
+
+	if (cb != NULL) {
+		cb(&jvmtiEnvironment, THREAD_JNIENV(),
+		   (jthread)getCurrentThread(), obj);
+	}
+}
+
+/*
+ * Called by the collector with the world stopped: the agent may not
+ * use JNI.
+ */
+void
+jvmtiPostGarbageCollectionStart(void)
+{
+	jvmtiEventGarbageCollectionStart cb = callbacks.GarbageCollectionStart;
+
+	if (cb != NULL) {
+		cb(&jvmtiEnvironment);
+	}
+}
+
+void
+jvmtiPostGarbageCollectionFinish(void)
+{
+	jvmtiEventGarbageCollectionFinish cb =
+		callbacks.GarbageCollectionFinish;
+
+	if (cb != NULL) {
+		cb(&jvmtiEnvironment);
+	}
+}
+
+/*
+ * The current thread allocated obj, of size bytes.  Post VMObjectAlloc
+ * if that takes the thread past its next sample.
+ */
+void
+jvmtiSampleObjectAlloc(Hjava_lang_Object *obj, size_t size)
+{
+	jvmtiEventVMObjectAlloc cb = callbacks.VMObjectAlloc;
+	threadData *thread_data = THREAD_DATA();
+
+	thread_data->jvmtiAllocLeft -= (jlong)size;
+	if (thread_data->jvmtiAllocLeft > 0) {
+		return;
+	}
+	thread_data->jvmtiAllocLeft = samplingInterval;
+
+	if (cb != NULL) {
+		cb(&jvmtiEnvironment, THREAD_JNIENV(),
+		   (jthread)getCurrentThread(), obj,
+		   (jclass)OBJECT_CLASS(obj), (jlong)size);
+	}
+}
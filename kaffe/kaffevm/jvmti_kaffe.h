@@ -0,0 +1,50 @@
+/*
+ * jvmti_kaffe.h
+ * The JVM Tool Interface, for profiling agents.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#ifndef __kaffevm_jvmti_kaffe_h
+#define __kaffevm_jvmti_kaffe_h
+
+#include <jvmti.h>
+
+struct _jmethodID;
+struct Hjava_lang_Object;
+
+/* Bytes a thread allocates between two VMObjectAlloc events by default */
+#define	JVMTI_DEFAULT_SAMPLING_INTERVAL	(512 * 1024)
+
+/*
+ * The events that are enabled and have a callback, one bit each.  Event
+ * sites test it before doing anything else, so a disabled event costs a
+ * load and a branch.
+ */
+extern volatile uint64 jvmtiEventFlags;
+
+#define	JVMTI_EVENT_BIT(type) \
+	((uint64)1 << ((type) - JVMTI_MIN_EVENT_TYPE_VAL))
+
+#define	JVMTI_EVENT_ISENABLED(type) \
+	((jvmtiEventFlags & JVMTI_EVENT_BIT(type)) != 0)
+
+extern void jvmtiInit(void);
+extern jvmtiEnv *jvmtiGetEnvironment(void);
+extern bool jvmtiLoadAgent(JavaVM *vm, const char *path, const char *options);
+
+extern void jvmtiPostVMInit(void);
+extern void jvmtiPostVMDeath(void);
+extern void jvmtiPostCompiledMethodLoad(struct _jmethodID *meth,
+					const void *code, size_t size);
+extern void jvmtiPostMonitorContendedEnter(struct Hjava_lang_Object *obj);
+extern void jvmtiPostGarbageCollectionStart(void);
+extern void jvmtiPostGarbageCollectionFinish(void);
+extern void jvmtiSampleObjectAlloc(struct Hjava_lang_Object *obj,
+				   size_t size);
+
+#endif /* __kaffevm_jvmti_kaffe_h */
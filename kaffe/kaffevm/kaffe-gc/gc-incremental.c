@@ -29,10 +29,12 @@
 #include "errors.h"
 #include "md.h"
 #include "stats.h"
+#include "allocProfile.h"
 #include "classMethod.h"
 #include "gc-incremental.h"
 #include "gc-refs.h"
 #include "jvmpi_kaffe.h"
+#include "jvmti_kaffe.h"
 
 #if defined(HAVE_SYS_TYPES_H)
 #include <sys/types.h>
@@ -51,6 +53,43 @@ static struct _gcStats {
         uint32  finalmem;
 } gcStats;
 
+/* Freed memory is reported in power-of-two size classes from 16 bytes */
+#define	GC_SIZE_CLASSES		14
+
+/*
+ * What happened during the current collection cycle, for -verbosegc.
+ * Times are in nanoseconds.
+ */
+static struct _gcCycle {
+	uint32		number;
+	statTime	pauseStart;
+	statTime	markStart;
+	statTime	pause;		/* mutators stopped */
+	statTime	mark;		/* marking, a part of the pause */
+	statTime	sweep;		/* sweeping, concurrent with mutators */
+	uint32		deferred;	/* collections skipped to grow instead */
+	uint32		grown;		/* bytes the heap grew since last cycle */
+	uint32		growths;
+	uint32		freedmem[GC_SIZE_CLASSES];
+} gcCycle;
+
+/*
+ * A heap snapshot asked for by gcSnapshotHeap.  The next collection
+ * records every Java object it marks, and hands the list to func once
+ * the world has been resumed.
+ */
+static struct _gcSnapshot {
+	heap_snapshot_func_t	func;
+	void			*arg;
+	void			**objs;
+	int			nobjs;
+	int			maxobjs;
+	int			nroots;
+	bool			taken;		/* by the running collection */
+	bool			done;
+	bool			ok;
+} gcSnapshot;
+
 /* Avoid recursively allocating OutOfMemoryError */
 #define OOM_ALLOCATING		((void *) -1)
 
@@ -83,12 +122,11 @@ static volatile int gcDisabled = 0;
 static volatile int gcRunning = -1;
 static volatile bool finalRunning = false;
 static volatile bool finaliserStarted = false;
-#if defined(KAFFE_STATS)
 static timespent gc_time;
+static timespent gc_pause;
 static timespent sweep_time;
 static counter gcgcablemem;
 static counter gcfixedmem;
-#endif /* KAFFE_STATS */
 
 /* Is this pointer within our managed heap? */
 #define IS_A_HEAP_POINTER(from) \
@@ -181,6 +219,7 @@ static iStaticLock	finman;
 static iStaticLock	gcmanend;
 static iStaticLock	finmanend;
 static iStaticLock	gc_lock;	/* allocator mutex */
+static iStaticLock	gcsnap;		/* one heap snapshot at a time */
 
 static void gcFree(Collector* gcif, void* mem);
 
@@ -258,6 +297,27 @@ gc_heap_isobject(gc_block *info, gc_unit *unit)
 	return 0;
 }
 
+static inline void
+gcSnapshotRecord(gc_unit *unit, gc_block *info, uintp idx)
+{
+	switch (KGC_GET_FUNCS(info, idx)) {
+	case KGC_ALLOC_JAVASTRING:
+	case KGC_ALLOC_NORMALOBJECT:
+	case KGC_ALLOC_PRIMARRAY:
+	case KGC_ALLOC_REFARRAY:
+	case KGC_ALLOC_FINALIZEOBJECT:
+	case KGC_ALLOC_JAVALOADER:
+	case KGC_ALLOC_VMWEAKREF:
+	case KGC_ALLOC_CLASSOBJECT:
+		if (gcSnapshot.nobjs < gcSnapshot.maxobjs) {
+			gcSnapshot.objs[gcSnapshot.nobjs++] = UTOMEM(unit);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
 static void
 markObjectDontCheck(gc_unit *unit, gc_block *info, uintp idx)
 {
@@ -265,6 +325,10 @@ markObjectDontCheck(gc_unit *unit, gc_block *info, uintp idx)
 	if (KGC_GET_COLOUR(info, idx) != KGC_COLOUR_WHITE) {
 		return;
 	}
+
+	if (gcSnapshot.objs != NULL) {
+		gcSnapshotRecord(unit, info, idx);
+	}
 DBG(GCWALK,	
 	dprintf("  marking @%p: %s\n", UTOMEM(unit),
 			describeObject(UTOMEM(unit)));
@@ -501,6 +565,74 @@ gcDumpCounts(Hjava_lang_Class *c, void *_ UNUSED)
 }
 #endif /* !(defined(NDEBUG) || !defined(KAFFE_VMDEBUG)) */
 
+static int
+gcSizeClass(size_t sz)
+{
+	int c;
+
+	for (c = 0; sz > 16 && c < GC_SIZE_CLASSES - 1; c++) {
+		sz = (sz + 1) >> 1;
+	}
+	return (c);
+}
+
+/*
+ * Print one line describing the collection that just finished.  The
+ * line is a list of key=value pairs so that it can be parsed by tools;
+ * times are in milliseconds and sizes in kilobytes, except for the
+ * freed bytes per size class, which are given as <up to>:<bytes>.
+ */
+static void
+gcLogCycle(void)
+{
+	uint32 grown;
+	uint32 growths;
+	const char *sep = "";
+	int c;
+
+	lockStaticMutex(&gc_lock);
+	grown = gcCycle.grown;
+	growths = gcCycle.growths;
+	gcCycle.grown = 0;
+	gcCycle.growths = 0;
+	unlockStaticMutex(&gc_lock);
+
+	dprintf("<GC #%u pause=%.3f mark=%.3f sweep=%.3f"
+		" heap=%uK before=%uK after=%uK live=%uK"
+		" alloc=%uK/%u freed=%uK/%u finalize=%u/%uK"
+		" grown=%uK/%u deferred=%u freed-by-size=",
+		gcCycle.number,
+		gcCycle.pause / 1e6,
+		gcCycle.mark / 1e6,
+		gcCycle.sweep / 1e6,
+		(unsigned int)(gc_get_heap_total()/1024),
+		gcStats.totalmem/1024,
+		(gcStats.totalmem-gcStats.freedmem)/1024,
+		gcStats.markedmem/1024,
+		gcStats.allocmem/1024,
+		gcStats.allocobj,
+		gcStats.freedmem/1024,
+		gcStats.freedobj,
+		gcStats.finalobj,
+		gcStats.finalmem/1024,
+		grown/1024,
+		growths,
+		gcCycle.deferred);
+	for (c = 0; c < GC_SIZE_CLASSES; c++) {
+		if (gcCycle.freedmem[c] == 0) {
+			continue;
+		}
+		if (c == GC_SIZE_CLASSES - 1) {
+			dprintf("%sbig:%u", sep, gcCycle.freedmem[c]);
+		}
+		else {
+			dprintf("%s%u:%u", sep, 16u << c, gcCycle.freedmem[c]);
+		}
+		sep = ",";
+	}
+	dprintf(">\n");
+}
+
 /*
  * The Garbage Collector sits in a loop starting a collection, waiting
  * until it's finished incrementally, then tidying up before starting
@@ -519,7 +651,8 @@ gcMan(void* arg)
 	/* Wake up anyone waiting for the GC to finish every time we're done */
 	for (;;) {
 
-		while (gcRunning == 0) {
+		/* A disabled collector must not start, see gcDisableGC */
+		while (gcRunning == 0 || gcDisabled) {
 			waitStaticCond(&gcman, (jlong)0);
 		}
 		/* We have observed that gcRunning went from 0 to 1 or 2 
@@ -582,12 +715,14 @@ DBG(GCSTAT,
 				gcStats.totalmem/1024,
 				gcStats.allocmem/(double)gcStats.totalmem);
     );
+			gcCycle.deferred++;
 			goto gcend;
 		}
 
 		DBG(GCSTAT, walkClassPool(gcClearCounts, NULL));
 		    
 		startGC(gcif);
+		gcSnapshot.nroots = gcSnapshot.nobjs;
 
 		/* process any objects found by walking the root references */
 		while (gclists[grey].cnext != &gclists[grey]) {
@@ -632,35 +767,33 @@ DBG(GCSTAT,
 		startFinalizer();
 
 		if (Kaffe_JavaVMArgs.enableVerboseGC > 0) {
-			/* print out all the info you ever wanted to know */
-			dprintf(
-			    "<GC: heap %dK, total before %dK,"
-			    " after %dK (%d/%d objs)\n %2.1f%% free,"
-			    " allocated %dK (#%d), marked %dK, "
-			    "swept %dK (#%d)\n"
-			    " %d objs (%dK) awaiting finalization>\n",
-			(int)(gc_get_heap_total()/1024), 
-			gcStats.totalmem/1024, 
-			(gcStats.totalmem-gcStats.freedmem)/1024, 
-			gcStats.totalobj,
-			gcStats.totalobj-gcStats.freedobj,
-			(1.0 - (((float)gcStats.totalmem-gcStats.freedmem)/
-				gc_get_heap_total())) * 100.0,
-			gcStats.allocmem/1024,
-			gcStats.allocobj,
-			gcStats.markedmem/1024, 
-			gcStats.freedmem/1024,
-			gcStats.freedobj,
-			gcStats.finalobj,
-			gcStats.finalmem/1024);
+			gcLogCycle();
 		}
 		if (Kaffe_JavaVMArgs.enableVerboseGC > 1) {
 			OBJECTSTATSPRINT();
 		}
+
+		/* Nothing marked can be freed until we go round again */
+		if (gcSnapshot.taken) {
+			if (gcSnapshot.objs != NULL) {
+				gcSnapshot.func(gcif, gcSnapshot.objs,
+						gcSnapshot.nobjs,
+						gcSnapshot.nroots,
+						gcSnapshot.arg);
+				free(gcSnapshot.objs);
+				gcSnapshot.objs = NULL;
+				gcSnapshot.ok = true;
+			}
+			gcSnapshot.func = NULL;
+			gcSnapshot.taken = false;
+			gcSnapshot.done = true;
+		}
 		gcStats.totalmem -= gcStats.freedmem;
 		gcStats.totalobj -= gcStats.freedobj;
 		gcStats.allocobj = 0;
 		gcStats.allocmem = 0;
+		memset(gcCycle.freedmem, 0, sizeof(gcCycle.freedmem));
+		gcCycle.deferred = 0;
 
 gcend:;
 		/* now signal any waiters */
@@ -697,15 +830,32 @@ startGC(Collector *gcif)
 		jvmpiPostEvent(&ev);
 	}
 #endif
+	if (JVMTI_EVENT_ISENABLED(JVMTI_EVENT_GARBAGE_COLLECTION_START)) {
+		jvmtiPostGarbageCollectionStart();
+	}
+
+	gcCycle.number++;
+	gcCycle.pauseStart = statsNow();
 
 	KTHREAD(lockGC)();
 	lockStaticMutex(&gc_lock);
+
+	/* No object can be allocated from here on, so totalobj bounds
+	 * the number of objects the snapshot may see.  The list must be
+	 * allocated before the world stops.
+	 */
+	if (gcSnapshot.func != NULL) {
+		gcSnapshot.taken = true;
+		gcSnapshot.nobjs = 0;
+		gcSnapshot.maxobjs = gcStats.totalobj;
+		gcSnapshot.objs = malloc(gcSnapshot.maxobjs * sizeof(void*));
+	}
 	
 	/* disable the mutator to protect colour lists */
 	STOPWORLD();
 
 	/* measure time */
-	startTiming(&gc_time, "gctime-scan");
+	gcCycle.markStart = statsNow();
 
 	/*
 	 * Since objects whose finaliser has to be run need to
@@ -749,6 +899,7 @@ finishGC(Collector *gcif)
 	int idx;
 	gcList   toRemove;
 	int i;
+	statTime sweepStart;
 
 	/* There shouldn't be any grey objects at this point */
 	assert(gclists[grey].cnext == &gclists[grey]);
@@ -765,9 +916,13 @@ finishGC(Collector *gcif)
 		URESETLIST(toRemove);
 	}	
 
-	stopTiming(&gc_time);
+	gcCycle.mark = statsNow() - gcCycle.markStart;
 	
 	RESUMEWORLD();
+
+	gcCycle.pause = statsNow() - gcCycle.pauseStart;
+	recordTiming(&gc_time, "gctime-scan", gcCycle.mark);
+	recordTiming(&gc_pause, "gctime-pause", gcCycle.pause);
 	
 	/* 
 	 * Now move the black objects back to the white queue for next time.
@@ -791,7 +946,7 @@ finishGC(Collector *gcif)
 	KTHREAD(unlockGC)();
 	unlockStaticMutex(&gc_lock);
 
-	startTiming(&sweep_time, "gctime-sweep");
+	sweepStart = statsNow();
 
 	while (toRemove.cnext != &toRemove) {
 		destroy_func_t destroy;
@@ -802,6 +957,7 @@ finishGC(Collector *gcif)
 
 		gcStats.freedmem += GCBLOCKSIZE(info);
 		gcStats.freedobj += 1;
+		gcCycle.freedmem[gcSizeClass(GCBLOCKSIZE(info))] += GCBLOCKSIZE(info);
 		OBJECTSTATSREMOVE(unit);
 
 #if defined(ENABLE_JVMPI)
@@ -846,8 +1002,12 @@ finishGC(Collector *gcif)
 		jvmpiPostEvent(&ev);
 	}
 #endif
+	if (JVMTI_EVENT_ISENABLED(JVMTI_EVENT_GARBAGE_COLLECTION_FINISH)) {
+		jvmtiPostGarbageCollectionFinish();
+	}
 
-	stopTiming(&sweep_time);
+	gcCycle.sweep = statsNow() - sweepStart;
+	recordTiming(&sweep_time, "gctime-sweep", gcCycle.sweep);
 }
 
 static
@@ -988,6 +1148,12 @@ gcEnableGC(Collector* gcif UNUSED)
 	unlockStaticMutex(&gcman);
 }
 
+/*
+ * Keep the collector from starting until gcEnableGC is called as many
+ * times.  Used by JNI critical regions.  gcMan holds gcman for the
+ * whole of a collection and only lets go of it while it waits for the
+ * next one, so taking it here waits for a running collection to finish.
+ */
 static
 void
 gcDisableGC(Collector* gcif UNUSED)
@@ -998,6 +1164,14 @@ gcDisableGC(Collector* gcif UNUSED)
 	unlockStaticMutex(&gcman);
 }
 
+static bool
+inCriticalRegion(void)
+{
+	jthread_t cur = KTHREAD(current)();
+
+	return (cur != NULL && KTHREAD(get_data)(cur)->criticalDepth > 0);
+}
+
 /*
  * Explicity invoke the garbage collector and wait for it to complete.
  */
@@ -1016,6 +1190,15 @@ gcInvokeGC(Collector* gcif UNUSED, int mustgc)
 			signalStaticCond(&gcman);
 	}
 
+	/* A thread inside a JNI critical region keeps the collector
+	 * disabled, so waiting would dead lock.  Its allocations grow
+	 * the heap instead.
+	 */
+	if (gcDisabled && inCriticalRegion()) {
+		unlockStaticMutex(&gcman);
+		return;
+	}
+
 	lockStaticMutex(&gcmanend);
 	unlockStaticMutex(&gcman);
 
@@ -1025,6 +1208,37 @@ gcInvokeGC(Collector* gcif UNUSED, int mustgc)
 	unlockStaticMutex(&gcmanend);
 }
 
+/*
+ * Collect, and call func with the Java objects found live.  func runs
+ * on the collector thread after the world has been resumed; until it
+ * returns, no collection can run, so the objects stay valid while
+ * mutators keep changing them.
+ */
+static bool
+gcSnapshotHeap(Collector* gcif, heap_snapshot_func_t func, void *arg)
+{
+	bool ok;
+
+	if (garbageman == NULL || inCriticalRegion()) {
+		return (false);
+	}
+
+	lockStaticMutex(&gcsnap);
+	gcSnapshot.arg = arg;
+	gcSnapshot.done = false;
+	gcSnapshot.ok = false;
+	gcSnapshot.func = func;
+
+	/* A collection that had already started does not take it */
+	while (!gcSnapshot.done) {
+		gcInvokeGC(gcif, 1);
+	}
+	ok = gcSnapshot.ok;
+	unlockStaticMutex(&gcsnap);
+
+	return (ok);
+}
+
 /*
  * GC and invoke the finalizer.  Used to run finalizers on exit.
  */
@@ -1052,6 +1266,72 @@ gcInvokeFinalizer(Collector* gcif)
   unlockStaticMutex(&finmanend);
 }
 
+/*
+ * Account for the object just allocated in unit and attach it to the
+ * list its type calls for.  Called with gc_lock held.  Returns the size
+ * of the block.
+ */
+static size_t
+gcAddUnit(gc_unit* unit, size_t size, gc_alloc_type_t fidx)
+{
+	gc_block* info;
+	int i;
+	size_t bsz;
+
+	info = gc_mem2block(unit);
+	i = GCMEM2IDX(info, unit);
+
+	bsz = GCBLOCKSIZE(info);
+	gcStats.totalmem += bsz;
+	gcStats.totalobj += 1;
+	gcStats.allocmem += bsz;
+	gcStats.allocobj += 1;
+
+	KGC_SET_FUNCS(info, i, fidx);
+
+	OBJECTSTATSADD(unit);
+	OBJECTSIZESADD(size);
+
+	/* Determine whether we need to finalise or not */
+	if (gcFunctions[fidx].final == KGC_OBJECT_NORMAL ||
+	    gcFunctions[fidx].final == KGC_OBJECT_FIXED) {
+		KGC_SET_STATE(info, i, KGC_STATE_NORMAL);
+	}
+	else {
+		KGC_SET_STATE(info, i, KGC_STATE_NEEDFINALIZE);
+	}
+
+	/* If object is fixed, we give it the fixed colour and do not
+	 * attach it to any lists.  This object is not part of the GC
+	 * regime and must be freed explicitly.
+	 */
+	if (gcFunctions[fidx].final == KGC_OBJECT_FIXED) {
+		addToCounter(&gcfixedmem, "gcmem-fixed objects", 1, bsz);
+		KGC_SET_COLOUR(info, i, KGC_COLOUR_FIXED);
+	}
+	else {
+		addToCounter(&gcgcablemem, "gcmem-gcable objects", 1, bsz);
+		/*
+		 * Note that as soon as we put the object on the white list,
+		 * the gc might come along and free the object if it can't
+		 * find any references to it.  This is why we need to keep
+		 * a reference in `mem'.  Note that keeping a reference in
+		 * `unit' will not do because markObject performs a UTOUNIT()!
+		 * In addition, on some architectures (SGI), we must tell the
+		 * compiler to not delay computing mem by defining it volatile.
+		 */
+		KGC_SET_COLOUR(info, i, KGC_COLOUR_WHITE);
+
+		if (KGC_GET_STATE(info, i) == KGC_STATE_NEEDFINALIZE) {
+			UAPPENDLIST(gclists[fin_white], unit);
+		} else {
+			UAPPENDLIST(gclists[nofin_white], unit);
+		}
+	}
+
+	return (bsz);
+}
+
 /*
  * Allocate a new object.  The object is attached to the white queue.
  * After allocation, if incremental collection is active we peform
@@ -1065,11 +1345,10 @@ static
 void*
 gcMalloc(Collector* gcif, size_t size, gc_alloc_type_t fidx)
 {
-	gc_block* info;
 	gc_unit* unit;
-	void * volatile mem;	/* needed on SGI, see comment below */
-	int i;
+	void * volatile mem;	/* needed on SGI, see comment in gcAddUnit */
 	size_t bsz;
+	uintp heapBefore;
 	int times = 0;
 
 	assert(gc_init != 0);
@@ -1104,7 +1383,10 @@ gcMalloc(Collector* gcif, size_t size, gc_alloc_type_t fidx)
 							  (unsigned int)size, gcFunctions[fidx].description,
 							  (1.0 - ((double)gcStats.totalmem / gc_get_heap_total())) * 100.0); );
 				
+				heapBefore = gc_get_heap_total();
 				gc_heap_grow(size);
+				gcCycle.grown += gc_get_heap_total() - heapBefore;
+				gcCycle.growths++;
 				break;
 
 			default:
@@ -1124,56 +1406,7 @@ gcMalloc(Collector* gcif, size_t size, gc_alloc_type_t fidx)
 		}
 	}
 
-	info = gc_mem2block(mem);
-	i = GCMEM2IDX(info, unit);
-
-	bsz = GCBLOCKSIZE(info);
-	gcStats.totalmem += bsz;
-	gcStats.totalobj += 1;
-	gcStats.allocmem += bsz;
-	gcStats.allocobj += 1;
-
-	KGC_SET_FUNCS(info, i, fidx);
-
-	OBJECTSTATSADD(unit);
-	OBJECTSIZESADD(size);
-
-	/* Determine whether we need to finalise or not */
-	if (gcFunctions[fidx].final == KGC_OBJECT_NORMAL ||
-	    gcFunctions[fidx].final == KGC_OBJECT_FIXED) {
-		KGC_SET_STATE(info, i, KGC_STATE_NORMAL);
-	}
-	else {
-		KGC_SET_STATE(info, i, KGC_STATE_NEEDFINALIZE);
-	}
-
-	/* If object is fixed, we give it the fixed colour and do not
-	 * attach it to any lists.  This object is not part of the GC
-	 * regime and must be freed explicitly.
-	 */
-	if (gcFunctions[fidx].final == KGC_OBJECT_FIXED) {
-		addToCounter(&gcfixedmem, "gcmem-fixed objects", 1, bsz);
-		KGC_SET_COLOUR(info, i, KGC_COLOUR_FIXED);
-	}
-	else {
-		addToCounter(&gcgcablemem, "gcmem-gcable objects", 1, bsz);
-		/*
-		 * Note that as soon as we put the object on the white list,
-		 * the gc might come along and free the object if it can't
-		 * find any references to it.  This is why we need to keep
-		 * a reference in `mem'.  Note that keeping a reference in
-		 * `unit' will not do because markObject performs a UTOUNIT()!
-		 * In addition, on some architectures (SGI), we must tell the
-		 * compiler to not delay computing mem by defining it volatile.
-		 */
-		KGC_SET_COLOUR(info, i, KGC_COLOUR_WHITE);
-
-		if (KGC_GET_STATE(info, i) == KGC_STATE_NEEDFINALIZE) {
-			UAPPENDLIST(gclists[fin_white], unit);
-		} else {
-			UAPPENDLIST(gclists[nofin_white], unit);
-		}
-	}
+	bsz = gcAddUnit(unit, size, fidx);
 
 	/* It is not safe to allocate java objects the first time
 	 * gcMalloc is called, but it should be safe after gcEnable
@@ -1185,6 +1418,8 @@ gcMalloc(Collector* gcif, size_t size, gc_alloc_type_t fidx)
 
 	unlockStaticMutex(&gc_lock);
 
+	ALLOCPROFILE(bsz, gcFunctions[fidx].description);
+
 	/* KTHREAD(current)() will be null in some window before we
 	 * should try allocating java objects
 	 */
@@ -1198,6 +1433,47 @@ gcMalloc(Collector* gcif, size_t size, gc_alloc_type_t fidx)
 	return (mem);
 }
 
+/*
+ * Allocate up to n objects of the same size and type while holding the
+ * allocator lock once, storing them in objs.  Nothing is collected and
+ * the heap is not grown for them, so fewer may be returned; allocate
+ * the rest with gcMalloc.  Returns the number of objects allocated.
+ */
+static int
+gcMallocMany(Collector* gcif UNUSED, size_t size, gc_alloc_type_t fidx,
+	     void** objs, int n)
+{
+	gc_unit* unit;
+	size_t bsz;
+	size_t total;
+	int cnt;
+
+	assert(gc_init != 0);
+	assert(gcFunctions[fidx].description != NULL);
+	assert(size > 0);
+
+	size += sizeof(gc_unit);
+	total = 0;
+
+	lockStaticMutex(&gc_lock);
+	for (cnt = 0; cnt < n; cnt++) {
+		unit = gc_heap_malloc(size);
+		if (unit == NULL) {
+			break;
+		}
+		/* objs is where the caller keeps them reachable */
+		objs[cnt] = UTOMEM(unit);
+		bsz = gcAddUnit(unit, size, fidx);
+		total += bsz;
+	}
+	unlockStaticMutex(&gc_lock);
+
+	if (cnt > 0) {
+		ALLOCPROFILE(total, gcFunctions[fidx].description);
+	}
+	return (cnt);
+}
+
 static
 struct Hjava_lang_Throwable *
 gcThrowOOM(Collector *gcif UNUSED)
@@ -1474,6 +1750,15 @@ gcGetHeapFree(Collector *gcif)
 }
 
 
+/*
+ * Number of collections started so far.
+ */
+static uint32
+gcGetCollections(Collector *gcif UNUSED)
+{
+  return gcCycle.number;
+}
+
 static const char *
 gcGetName(UNUSED Collector *gcif)
 {
@@ -1511,7 +1796,12 @@ static struct GarbageCollectorInterface_Ops KGC_Ops = {
 	KaffeGC_addRef,
 	KaffeGC_rmRef,
 	KaffeGC_addWeakRef,
-	KaffeGC_rmWeakRef
+	KaffeGC_rmWeakRef,
+	KaffeGC_addGlobalRef,
+	KaffeGC_rmGlobalRef,
+	gcSnapshotHeap,
+	gcMallocMany,
+	gcGetCollections
 };
 
 /*
@@ -1525,6 +1815,7 @@ createGC(void)
   initStaticLock(&finman);
   initStaticLock(&finmanend);
   initStaticLock(&gc_lock);
+  initStaticLock(&gcsnap);
 
   KaffeGC_initRefs();
 
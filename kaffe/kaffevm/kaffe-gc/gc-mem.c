@@ -44,9 +44,7 @@ static gc_block *gc_first_block;
 static gc_block *gc_reserve_pages;
 static iStaticLock	gc_heap_lock;
 
-#if defined(KAFFE_STATS)
 static counter gcpages;
-#endif
 static gc_block* gc_small_block(size_t);
 static gc_block* gc_large_block(size_t);
 
@@ -372,12 +370,12 @@ gc_heap_malloc(size_t sz)
 	gc_block** mptr;
 	gc_block* blk;
 	size_t nsz;
-#if defined(KAFFE_STATS)
 	static timespent heap_alloc_time;
-#endif
 
 	lockStaticMutex(&gc_heap_lock);
-	startTiming(&heap_alloc_time, "gc_heap_malloc");
+	if (statsEnabled) {
+		startTiming(&heap_alloc_time, "gc_heap_malloc");
+	}
 
 DBG(SLACKANAL,
 	if (KGC_SMALL_OBJECT(sz)) {
@@ -458,7 +456,9 @@ DBG(GCALLOC,	dprintf("gc_heap_malloc: large block %ld at %p\n",
 	assert(KGC_OBJECT_SIZE(mem) >= sz);
 
 	out:
-	stopTiming(&heap_alloc_time);
+	if (statsEnabled) {
+		stopTiming(&heap_alloc_time);
+	}
 	unlockStaticMutex(&gc_heap_lock);
 
 	return (mem);
@@ -475,9 +475,7 @@ gc_heap_free(void* mem)
 	int lnr;
 	int msz;
 	int idx;
-#if defined(KAFFE_STATS)
 	static timespent heap_free_time;
-#endif
 
 	info = gc_mem2block(mem);
 	idx = GCMEM2IDX(info, mem);
@@ -493,7 +491,9 @@ DBG(GCFREE,
 	dprintf("gc_heap_free: memory %p size %d\n", mem, info->size);	);
 
 	lockStaticMutex(&gc_heap_lock);
-	startTiming(&heap_free_time, "gc_heap_free");
+	if (statsEnabled) {
+		startTiming(&heap_free_time, "gc_heap_free");
+	}
 
 	if (KGC_SMALL_OBJECT(info->size)) {
 		lnr = sztable[info->size].list;
@@ -550,7 +550,9 @@ DBG(GCFREE,
 		gc_primitive_free(info);
 	}
 
-	stopTiming(&heap_free_time);
+	if (statsEnabled) {
+		stopTiming(&heap_free_time);
+	}
 	unlockStaticMutex(&gc_heap_lock);
 
 DBG(GCDIAG,
@@ -1133,9 +1135,7 @@ gc_block_alloc(size_t size)
 		char * old_blocks = gc_block_base;
 		int onb = gc_num_blocks;
 		unsigned int min_nb;	/* minimum size of array to hold heap_addr */
-#if defined(KAFFE_STATS)
 		static timespent growtime;
-#endif
 
 		startTiming(&growtime, "gctime-blockrealloc");
 		/* Pick a new size for the gc_block array.  Remember,
@@ -0,0 +1,338 @@
+/*
+ * lockProfile.c
+ * Monitor contention statistics.
+ *
+ * When a thread has to wait for a Java monitor, the heavy lock of the
+ * monitor gets a record of how often threads waited for it, for how
+ * long, and from where.  The places are the innermost Java frames of
+ * the waiting threads; each record keeps the ones seen most often.
+ * Only the contended path pays for any of this.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include "config.h"
+#include "config-std.h"
+#include "config-mem.h"
+#include "jni_md.h"
+#include "gtypes.h"
+#include "object.h"
+#include "classMethod.h"
+#include "gc.h"
+#include "locks.h"
+#include "stackTrace.h"
+#include "debug.h"
+#include "lockProfile.h"
+
+/* Java frames that make up a call site */
+#define	LOCKPROFILE_DEPTH	4
+
+/* Call sites kept for each monitor */
+#define	LOCKPROFILE_SITES	4
+
+/* Most monitors that get a record */
+#define	LOCKPROFILE_MONITORS	1024
+
+typedef struct _lockSite {
+	int		depth;
+	Method		*meths[LOCKPROFILE_DEPTH];
+	char		*stack;		/* collapsed, innermost last */
+	jlong		count;
+} lockSite;
+
+typedef struct _lockContention {
+	struct _lockContention *next;
+	iLock		*lock;		/* NULL once the monitor is gone */
+	void		*object;
+	char		*className;
+	jlong		contended;	/* times a thread had to wait */
+	jlong		waited;		/* nanoseconds, in total */
+	jlong		maxWaited;
+	lockSite	sites[LOCKPROFILE_SITES];
+} lockContention;
+
+static iStaticLock profLock;
+static lockContention *monitors;
+static int nmonitors;
+static jlong untracked;
+
+static char *
+lockSiteName(Method **meths, int depth)
+{
+	size_t len = 1;
+	char *name;
+	char *p;
+	int i;
+
+	for (i = 0; i < depth; i++) {
+		len += strlen(CLASS_CNAME(meths[i]->class))
+			+ strlen(meths[i]->name->data) + 2;
+	}
+
+	name = malloc(len);
+	if (name == NULL) {
+		return (NULL);
+	}
+
+	p = name;
+	*p = '\0';
+	for (i = depth - 1; i >= 0; i--) {
+		p += sprintf(p, "%s.%s%s", CLASS_CNAME(meths[i]->class),
+			     meths[i]->name->data, i > 0 ? ";" : "");
+	}
+	for (p = name; *p != '\0'; p++) {
+		if (*p == '/') {
+			*p = '.';
+		}
+	}
+	return (name);
+}
+
+/*
+ * Count a wait at the call site of the current thread.  Once all slots
+ * are taken, a new site replaces the least seen one and inherits its
+ * count, so sites seen often keep their place.
+ */
+static void
+lockProfileSite(lockContention *rec)
+{
+	Method *meths[LOCKPROFILE_DEPTH];
+	lockSite *site;
+	lockSite *least;
+	char *stack;
+	int depth;
+	int i;
+
+	depth = stackTraceMethods(NULL, meths, LOCKPROFILE_DEPTH);
+
+	least = &rec->sites[0];
+	for (i = 0; i < LOCKPROFILE_SITES; i++) {
+		site = &rec->sites[i];
+		if (site->stack != NULL && site->depth == depth
+		    && memcmp(site->meths, meths, depth * sizeof(Method *)) == 0) {
+			site->count++;
+			return;
+		}
+		if (site->count < least->count) {
+			least = site;
+		}
+	}
+
+	stack = lockSiteName(meths, depth);
+	if (stack == NULL) {
+		return;
+	}
+	free(least->stack);
+	least->stack = stack;
+	least->depth = depth;
+	memcpy(least->meths, meths, depth * sizeof(Method *));
+	least->count++;
+}
+
+static char *
+lockOwnerName(Hjava_lang_Object *obj)
+{
+	Hjava_lang_Class *cl;
+	const char *prefix = "";
+	char *name;
+	char *p;
+
+	/* For a class, its own name tells more than java.lang.Class */
+	if (KGC_getObjectIndex(main_collector, obj) == KGC_ALLOC_CLASSOBJECT) {
+		cl = (Hjava_lang_Class *)obj;
+		prefix = "class ";
+	}
+	else {
+		cl = OBJECT_CLASS(obj);
+	}
+
+	name = malloc(strlen(prefix) + strlen(CLASS_CNAME(cl)) + 1);
+	if (name == NULL) {
+		return (NULL);
+	}
+	sprintf(name, "%s%s", prefix, CLASS_CNAME(cl));
+	for (p = name; *p != '\0'; p++) {
+		if (*p == '/') {
+			*p = '.';
+		}
+	}
+	return (name);
+}
+
+void
+lockProfileInit(void)
+{
+	initStaticLock(&profLock);
+}
+
+/*
+ * The current thread is about to wait for the monitor of obj, whose
+ * heavy lock is lk.
+ */
+void
+lockProfileContended(iLock *lk, Hjava_lang_Object *obj)
+{
+	lockContention *rec;
+
+	lockStaticMutex(&profLock);
+	rec = lk->contention;
+	if (rec == NULL) {
+		if (nmonitors >= LOCKPROFILE_MONITORS) {
+			untracked++;
+			unlockStaticMutex(&profLock);
+			return;
+		}
+		rec = calloc(1, sizeof(lockContention));
+		if (rec == NULL) {
+			untracked++;
+			unlockStaticMutex(&profLock);
+			return;
+		}
+		rec->lock = lk;
+		rec->object = obj;
+		rec->className = lockOwnerName(obj);
+		rec->next = monitors;
+		monitors = rec;
+		nmonitors++;
+		lk->contention = rec;
+	}
+	rec->contended++;
+	lockProfileSite(rec);
+	unlockStaticMutex(&profLock);
+}
+
+/*
+ * The current thread got the monitor whose heavy lock is lk after
+ * waiting for waited nanoseconds.
+ */
+void
+lockProfileAcquired(iLock *lk, jlong waited)
+{
+	lockContention *rec;
+
+	lockStaticMutex(&profLock);
+	rec = lk->contention;
+	if (rec != NULL) {
+		rec->waited += waited;
+		if (waited > rec->maxWaited) {
+			rec->maxWaited = waited;
+		}
+	}
+	unlockStaticMutex(&profLock);
+}
+
+/*
+ * The heavy lock lk is being freed along with its object.  Its record
+ * stays, so that monitors of short lived objects still show up.
+ */
+void
+lockProfileDestroyed(iLock *lk)
+{
+	if (lk->contention != NULL) {
+		lk->contention->lock = NULL;
+	}
+}
+
+static int
+lockCompareWaited(const void *a, const void *b)
+{
+	const lockContention *ra = *(const lockContention * const *)a;
+	const lockContention *rb = *(const lockContention * const *)b;
+
+	if (ra->waited != rb->waited) {
+		return (ra->waited < rb->waited ? 1 : -1);
+	}
+	if (ra->contended != rb->contended) {
+		return (ra->contended < rb->contended ? 1 : -1);
+	}
+	return (0);
+}
+
+static int
+lockCompareSites(const void *a, const void *b)
+{
+	const lockSite *sa = a;
+	const lockSite *sb = b;
+
+	if (sa->count != sb->count) {
+		return (sa->count < sb->count ? 1 : -1);
+	}
+	return (0);
+}
+
+/*
+ * Print the max monitors threads waited for longest, with the places
+ * they waited from.
+ */
+void
+lockProfileDump(FILE *fp, int max)
+{
+	lockContention **sorted;
+	lockContention *rec;
+	lockSite sites[LOCKPROFILE_SITES];
+	int n;
+	int i;
+	int j;
+
+	lockStaticMutex(&profLock);
+	sorted = malloc((nmonitors + 1) * sizeof(lockContention *));
+	if (sorted == NULL) {
+		unlockStaticMutex(&profLock);
+		return;
+	}
+	n = 0;
+	for (rec = monitors; rec != NULL; rec = rec->next) {
+		sorted[n++] = rec;
+	}
+	qsort(sorted, n, sizeof(lockContention *), lockCompareWaited);
+
+	fprintf(fp, "Contended monitors, longest waited for first:\n");
+	for (i = 0; i < n && i < max; i++) {
+		rec = sorted[i];
+		fprintf(fp, "%4d: %s@%p%s: %lld waits, %.3f ms waited,"
+			" %.3f ms at most\n", i + 1,
+			rec->className != NULL ? rec->className : "?",
+			rec->object, rec->lock == NULL ? " (collected)" : "",
+			(long long)rec->contended, rec->waited / 1e6,
+			rec->maxWaited / 1e6);
+
+		memcpy(sites, rec->sites, sizeof(sites));
+		qsort(sites, LOCKPROFILE_SITES, sizeof(lockSite),
+		      lockCompareSites);
+		for (j = 0; j < LOCKPROFILE_SITES; j++) {
+			if (sites[j].stack != NULL) {
+				fprintf(fp, "      %10lld  %s\n",
+					(long long)sites[j].count,
+					sites[j].depth > 0 ? sites[j].stack
+							   : "[vm]");
+			}
+		}
+	}
+	if (untracked > 0) {
+		fprintf(fp, "Waits for monitors without a record: %lld\n",
+			(long long)untracked);
+	}
+	unlockStaticMutex(&profLock);
+
+	free(sorted);
+}
+
+/*
+ * Write the contended monitors to file.
+ */
+bool
+lockProfileWrite(const char *file)
+{
+	FILE *fp;
+
+	fp = fopen(file, "w");
+	if (fp == NULL) {
+		return (false);
+	}
+	lockProfileDump(fp, LOCKPROFILE_MONITORS);
+	return (fclose(fp) == 0);
+}
@@ -0,0 +1,27 @@
+/*
+ * lockProfile.h
+ * Monitor contention statistics.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#ifndef __kaffevm_lockProfile_h
+#define __kaffevm_lockProfile_h
+
+struct _iLock;
+struct Hjava_lang_Object;
+
+extern void lockProfileInit(void);
+extern void lockProfileContended(struct _iLock *lk,
+				 struct Hjava_lang_Object *obj);
+/* waited is in nanoseconds */
+extern void lockProfileAcquired(struct _iLock *lk, jlong waited);
+extern void lockProfileDestroyed(struct _iLock *lk);
+extern void lockProfileDump(FILE *fp, int max);
+extern bool lockProfileWrite(const char *file);
+
+#endif /* __kaffevm_lockProfile_h */
@@ -25,6 +25,8 @@
 #include "gc.h"
 #include "jvmpi_kaffe.h"
 #include "stats.h"
+#include "lockProfile.h"
+#include "jvmti_kaffe.h"
 
 /*
  * If we don't have an atomic compare and exchange defined then make
@@ -57,12 +59,10 @@
 void
 initLocking(void)
 {
+	lockProfileInit();
 }
 
-#if defined(KAFFE_STATS)
 static timespent heavyLockTime;
-static timespent locksTime;
-#endif
 
 /*
  * Get a heavy lock for the object and hold it.  If the object doesn't
@@ -176,6 +176,7 @@ void initStaticLock(iStaticLock *slock)
   slock->heavyLock.cv = NULL;
   slock->heavyLock.in_progress = 0;
   slock->heavyLock.holder = NULL;
+  slock->heavyLock.contention = NULL;
   KSEM(init)(&slock->heavyLock.sem);
 }
 
@@ -210,14 +211,16 @@ putHeavyLock(iLock* lk)
 
 /*
  * Slowly lock a mutex.  We get the heavy lock and lock that instead.
- * If we can't lock it we suspend until we can.
+ * If we can't lock it we suspend until we can.  Waits for the monitor
+ * of obj, if given, are recorded by the lock profiler.
  */
 static void
-slowLockMutex(iLock** lkp, iLock *heavyLock)
+slowLockMutex(iLock** lkp, iLock *heavyLock, Hjava_lang_Object *obj)
 {
   iLock* lk;
   jthread_t cur = KTHREAD(current) ();
   threadData *tdata;
+  statTime waitStart = 0;
   int r;
 
 DBG(SLOWLOCKS,
@@ -249,10 +252,27 @@ DBG(SLOWLOCKS,
      lk->holder = cur;
      lk->lockCount++;
      putHeavyLock(lk);
+     if (waitStart != 0) {
+       lockProfileAcquired(lk, statsNow() - waitStart);
+     }
      KTHREAD(enable_stop)();
      return;
    }
    
+   /* Record the wait before joining the queue: the profiler and
+    * agents take locks of their own, which would need our queue link
+    * and semaphore.
+    */
+   if (obj != NULL && waitStart == 0) {
+     putHeavyLock(lk);
+     lockProfileContended(lk, obj);
+     if (JVMTI_EVENT_ISENABLED(JVMTI_EVENT_MONITOR_CONTENDED_ENTER)) {
+       jvmtiPostMonitorContendedEnter(obj);
+     }
+     waitStart = statsNow();
+     continue;
+   }
+
    /* Otherwise wait for holder to release it */
    tdata->nextlk = lk->mux;
    lk->mux = cur;
@@ -423,7 +443,7 @@ locks_internal_waitCond(iLock** lkp, iLock *heavyLock, jlong timeout)
     putHeavyLock(lk);
   }
   
-  slowLockMutex(lkp, heavyLock);
+  slowLockMutex(lkp, heavyLock, NULL);
   /* This is safe as no other thread touches the lockcount if it is not
    * owning the lock.
    */
@@ -504,7 +524,7 @@ void
 locks_internal_lockMutex(iLock** lkp, iLock *heavyLock)
 {  
   if (!COMPARE_AND_EXCHANGE(lkp, LOCKFREE, (iLock *)KTHREAD(current)()))
-      slowLockMutex(lkp, heavyLock);
+      slowLockMutex(lkp, heavyLock, NULL);
 }
 
 /*
@@ -522,7 +542,8 @@ locks_internal_unlockMutex(iLock** lkp, iLock *heavyLock)
 void
 lockObject(Hjava_lang_Object* obj)
 {
-  locks_internal_lockMutex(&obj->lock, NULL);
+  if (!COMPARE_AND_EXCHANGE(&obj->lock, LOCKFREE, (iLock *)KTHREAD(current)()))
+      slowLockMutex(&obj->lock, NULL, obj);
 }
 
 void
@@ -561,7 +582,7 @@ slowLockObject(Hjava_lang_Object* obj)
 	}
     }
 #endif
-  slowLockMutex(&obj->lock, NULL);
+  slowLockMutex(&obj->lock, NULL, obj);
 #if defined(ENABLE_JVMPI)
   if( JVMPI_EVENT_ISENABLED(JVMPI_EVENT_MONITOR_CONTENDED_ENTERED) && isContention)
     {
@@ -603,6 +624,7 @@ void KaffeLock_destroyLock(Collector *gcif UNUSED, void *l)
 {
   iLock *lock = (iLock *)l;
 
+  lockProfileDestroyed(lock);
   assert(lock->lockCount == 0);
   assert(lock->num_wait == 0);
   assert(lock->in_progress == 0);
@@ -53,6 +53,7 @@ typedef struct _iLock {
   Ksem          	sem;
   uint32        	lockCount;
   void*			hlockHolder;
+  struct _lockContention* contention;	/* see lockProfile.c */
 } iLock;
 
 typedef struct _iStaticLock {
@@ -37,6 +37,7 @@
 #include "gc.h"
 #include "thread.h"
 #include "jvmpi_kaffe.h"
+#include "jvmti_kaffe.h"
 
 Hjava_lang_Object*
 newObjectChecked(Hjava_lang_Class* class, errorInfo *info)
@@ -69,6 +70,9 @@ newObjectChecked(Hjava_lang_Class* class, errorInfo *info)
 		    jvmpiPostEvent(&ev);
 	    }
 #endif
+	    if (JVMTI_EVENT_ISENABLED(JVMTI_EVENT_VM_OBJECT_ALLOC)) {
+		    jvmtiSampleObjectAlloc(obj, CLASS_FSIZE(class));
+	    }
 	    
 	}
 DBG(NEWOBJECT,
@@ -131,6 +135,58 @@ DBG(NEWOBJECT,
         return (cls);
 }
 
+/*
+ * The number of bytes to allocate for an array of count elements of
+ * elclass, and in type the allocation type to use.  Returns 0 if the
+ * array would be too large.
+ */
+static size_t
+arrayAllocSize(Hjava_lang_Class* elclass, jsize count,
+	       gc_alloc_type_t* type)
+{
+	const size_t MAX_MEM = KGC_MAX_MALLOC_TYPE - ARRAY_DATA_OFFSET;
+
+	if (CLASS_IS_PRIMITIVE(elclass) || elclass == PtrClass) {
+		if ((MAX_MEM / TYPE_SIZE(elclass)) < (size_t) count) {
+			return (0);
+		}
+		*type = KGC_ALLOC_PRIMARRAY;
+		return ((TYPE_SIZE(elclass) * count) + ARRAY_DATA_OFFSET);
+	}
+	else {
+		if ((MAX_MEM / PTR_TYPE_SIZE) < (size_t) count) {
+			return (0);
+		}
+		*type = KGC_ALLOC_REFARRAY;
+		return ((PTR_TYPE_SIZE * count) + ARRAY_DATA_OFFSET);
+	}
+}
+
+/*
+ * Fill in a freshly allocated array of class and tell the profilers.
+ */
+static void
+initArray(Hjava_lang_Object* obj, Hjava_lang_Class* class, jsize count,
+	  size_t total_count)
+{
+	KaffeVM_setFinalizer(obj, KGC_DEFAULT_FINALIZER);
+	obj->vtable = class->vtable;
+	ARRAY_SIZE(obj) = count;
+
+#if defined(ENABLE_JVMPI)
+	if( JVMPI_EVENT_ISENABLED(JVMPI_EVENT_OBJECT_ALLOC) )
+	{
+		JVMPI_Event ev;
+
+		jvmpiFillObjectAlloc(&ev, obj);
+		jvmpiPostEvent(&ev);
+	}
+#endif
+	if (JVMTI_EVENT_ISENABLED(JVMTI_EVENT_VM_OBJECT_ALLOC)) {
+		jvmtiSampleObjectAlloc(obj, total_count);
+	}
+}
+
 /*
  * Allocate a new array, of whatever types.
  */
@@ -139,56 +195,18 @@ newArrayChecked(Hjava_lang_Class* elclass, jsize count, errorInfo *info)
 {
 	Hjava_lang_Class* class = NULL;
 	Hjava_lang_Object* obj = NULL;
+	gc_alloc_type_t type;
+	size_t total_count;
 
 	assert(count >= 0);
 
 	if ((class = lookupArray(elclass, info)) != NULL) {
-		size_t total_count;
-		const size_t MAX_MEM = KGC_MAX_MALLOC_TYPE - ARRAY_DATA_OFFSET;
-
-		if (CLASS_IS_PRIMITIVE(elclass) || elclass == PtrClass) {
-
-			if ((MAX_MEM / TYPE_SIZE(elclass)) < (size_t) count)
-			  {
-			    postOutOfMemory(info);
-			  }
-			else
-			  {
-			    total_count = (TYPE_SIZE(elclass) * count) +
-			      ARRAY_DATA_OFFSET;
-			    obj = gc_malloc(total_count,
-					    KGC_ALLOC_PRIMARRAY);
-			  }
-		}
-		else {
-			if ((MAX_MEM / PTR_TYPE_SIZE) < (size_t) count)
-			  {
-			    postOutOfMemory(info);
-			  }
-			else
-			  {
-			    total_count = (PTR_TYPE_SIZE * count) +
-			      ARRAY_DATA_OFFSET;
-			    
-			    obj = gc_malloc(total_count,
-					    KGC_ALLOC_REFARRAY);
-			  }
+		total_count = arrayAllocSize(elclass, count, &type);
+		if (total_count != 0) {
+			obj = gc_malloc(total_count, type);
 		}
 		if (obj != NULL) {
-		        KaffeVM_setFinalizer(obj, KGC_DEFAULT_FINALIZER);
-			obj->vtable = class->vtable;
-			ARRAY_SIZE(obj) = count;
-
-#if defined(ENABLE_JVMPI)
-			if( JVMPI_EVENT_ISENABLED(JVMPI_EVENT_OBJECT_ALLOC) )
-			{
-				JVMPI_Event ev;
-
-				jvmpiFillObjectAlloc(&ev, obj);
-				jvmpiPostEvent(&ev);
-			}
-#endif
-			
+			initArray(obj, class, count, total_count);
 		} else {
 			postOutOfMemory(info);
 		}
@@ -200,6 +218,57 @@ DBG(NEWOBJECT,
 	return (obj);
 }
 
+/*
+ * Allocate n arrays of count elements of elclass and store them in
+ * arrays, which must be somewhere the collector looks.  They are taken
+ * from the collector as many at a time as it can give.
+ */
+bool
+newArraysChecked(Hjava_lang_Class* elclass, jsize count,
+		 Hjava_lang_Object** arrays, int n, errorInfo *info)
+{
+	Hjava_lang_Class* class;
+	gc_alloc_type_t type;
+	size_t total_count;
+	int done;
+	int got;
+	int i;
+
+	assert(count >= 0);
+
+	class = lookupArray(elclass, info);
+	if (class == NULL) {
+		return (false);
+	}
+	total_count = arrayAllocSize(elclass, count, &type);
+	if (total_count == 0) {
+		postOutOfMemory(info);
+		return (false);
+	}
+
+	for (done = 0; done < n; done += got) {
+		got = gc_malloc_many(total_count, type,
+				     (void**)&arrays[done], n - done);
+		if (got == 0) {
+			/* let the collector collect or grow the heap */
+			arrays[done] = gc_malloc(total_count, type);
+			if (arrays[done] == NULL) {
+				postOutOfMemory(info);
+				return (false);
+			}
+			got = 1;
+		}
+		for (i = done; i < done + got; i++) {
+			initArray(arrays[i], class, count, total_count);
+		}
+	}
+DBG(NEWOBJECT,
+	dprintf("newArrays %d class %s count %d\n", n, class->name->data,
+		count);
+    );
+	return (true);
+}
+
 /*
  * Allocate a new array, of whatever types.
  */
@@ -217,63 +286,53 @@ newArray(Hjava_lang_Class* elclass, jsize count)
 }
 
 /*
- * Allocate a new multi-dimensional array.
+ * Fill array, whose elements are arrays of rowclass, with new arrays of
+ * dims[0] elements, and those in turn as dims + 1 says.
  */
-Hjava_lang_Object*
-newMultiArrayChecked(Hjava_lang_Class* clazz, int* dims, errorInfo *einfo)
+static bool
+newMultiArrayRows(Hjava_lang_Object* array, Hjava_lang_Class* rowclass,
+		  int* dims, errorInfo *einfo)
 {
-  Hjava_lang_Object* obj;
-  Hjava_lang_Object** stack;
-  Hjava_lang_Class* prevclazz;
-  Hjava_lang_Object** array;
-  int i, j, k, ndims, fullsize;
-  int stacksize, stackptr;
-
-  for (i=0,fullsize=1;dims[i+1] >= 0; i++)
-    fullsize += fullsize*dims[i];
-  ndims = i+1;
-
-  stack = (Hjava_lang_Object **)
-    KMALLOC(fullsize * sizeof(Hjava_lang_Object *));
-  if (stack == NULL)
-    {
-      postOutOfMemory(einfo);
-      return NULL;
-    }
-  
-  obj = newArrayChecked(Kaffe_get_array_element_type(clazz), (jsize)dims[0], einfo);
-  if (!obj)
-    return NULL;
-  
-  stack[0] = obj;
-  stackptr = 0;
-  stacksize = 1;
-  for (j=0;j<ndims-1;j++)
-    {
-      int localdim = dims[j];
-      
-      prevclazz = Kaffe_get_array_element_type(clazz);
-      for (i=0;i<stacksize;i++)
-	{
-	  int localptr = stackptr + stacksize + i*localdim;
-
-	  array = OBJARRAY_DATA(stack[stackptr+i]);
-	  for (k=0;k<localdim;k++)
-	  {
-	    stack[localptr+k] = array[k] = 
-	      newArrayChecked(Kaffe_get_array_element_type(prevclazz), (jsize)dims[j+1], einfo);
-	    if (array[k] == NULL)
-	      return NULL;
-	  }
+	Hjava_lang_Class* elclass;
+	Hjava_lang_Object** rows;
+	jsize i;
+
+	elclass = Kaffe_get_array_element_type(rowclass);
+	rows = OBJARRAY_DATA(array);
+	if (!newArraysChecked(elclass, (jsize)dims[0], rows,
+			      ARRAY_SIZE(array), einfo)) {
+		return (false);
+	}
+	if (dims[1] >= 0) {
+		for (i = 0; i < ARRAY_SIZE(array); i++) {
+			if (!newMultiArrayRows(rows[i], elclass, dims + 1,
+					       einfo)) {
+				return (false);
+			}
+		}
 	}
-      clazz = prevclazz;
-      stackptr += stacksize;
-      stacksize *= dims[j];
-    }
+	return (true);
+}
 
-  KFREE(stack);
+/*
+ * Allocate a new multi-dimensional array.  The arrays of each row are
+ * allocated together.
+ */
+Hjava_lang_Object*
+newMultiArrayChecked(Hjava_lang_Class* clazz, int* dims, errorInfo *einfo)
+{
+	Hjava_lang_Object* obj;
+	Hjava_lang_Class* elclass;
 
-  return obj;
+	elclass = Kaffe_get_array_element_type(clazz);
+	obj = newArrayChecked(elclass, (jsize)dims[0], einfo);
+	if (obj == NULL) {
+		return (NULL);
+	}
+	if (dims[1] >= 0 && !newMultiArrayRows(obj, elclass, dims + 1, einfo)) {
+		return (NULL);
+	}
+	return (obj);
 }
 
 /*
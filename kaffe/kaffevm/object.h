@@ -46,6 +46,9 @@ struct Hjava_lang_Class* newClass(void);
 Hjava_lang_Object*	newArrayChecked(struct Hjava_lang_Class*, jsize,
 					struct _errorInfo *);
 Hjava_lang_Object*	newArray(struct Hjava_lang_Class*, jsize);
+bool			newArraysChecked(struct Hjava_lang_Class*, jsize,
+					 Hjava_lang_Object**, int,
+					 struct _errorInfo *);
 Hjava_lang_Object*	newMultiArrayChecked(struct Hjava_lang_Class*, int*,
 					     struct _errorInfo *);
 Hjava_lang_Object*	newMultiArray(struct Hjava_lang_Class*, int*);
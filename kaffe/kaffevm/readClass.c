@@ -51,6 +51,7 @@ readClass(Hjava_lang_Class* classThis, classFile* fp, struct Hjava_lang_ClassLoa
 	}
 	readu2(&minor_version, fp);
 	readu2(&major_version, fp);
+	fp->major_version = major_version;
 
 	/* Note, can't print CLASS_CNAME(classThis), as name isn't initialized yet... */
 
@@ -354,6 +355,16 @@ readAttributes(classFile* fp, Hjava_lang_Class* this,
 				}
 			}
 #if !defined(KAFFEH)
+			/* Older class files are verified by inference, and
+			 * any StackMapTable in them is ignored */
+			else if (utf8ConstEqual(name, StackMapTable_name)
+				 && (thingType == READATTR_METHOD)
+				 && fp->major_version >= MAJOR_VERSION_V1_6) {
+				if (!addStackMapTable((Method*)thing,
+						      (size_t) len, fp, einfo)) {
+					return false;
+				}
+			}
 			else if (utf8ConstEqual(name, EnclosingMethod_name) && thingType == READATTR_CLASS) {
 			  if (!readEnclosingMethodAttribute(fp, len, (struct Hjava_lang_Class*)thing, einfo))
 			    return false;
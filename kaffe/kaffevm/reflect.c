@@ -162,3 +162,283 @@ KaffeVM_makeReflectField(struct Hjava_lang_Class* clazz, int slot)
 	unhand(field)->name = checkPtr(utf8Const2Java(fld->name));
 	return (field);
 }
+
+/*
+ * Reflection cache.
+ *
+ * java.lang.VMClass asks for the declared methods, constructors and
+ * fields of a class over and over again (think of bean introspection
+ * or serialization).  Building the reflection objects means parsing
+ * signatures, resolving classes and converting names, so we build one
+ * set of root objects per class and only hand out copies of them:
+ * the reflection objects are mutable (setAccessible) and must not be
+ * shared between callers.
+ *
+ * The root arrays are only softly reachable.  walkClass keeps them
+ * alive while they are in use and drops them once they have not been
+ * used for REFLECT_CACHE_MAX_AGE collections.  The collector counts
+ * its collections and the class remembers the one its cache was last
+ * used in, so a collector that walks a class several times in one
+ * collection (Boehm may) does not age the cache any faster.  Since
+ * walkClass runs with the world stopped, a thread that has just read
+ * the cache keeps the array alive through its stack.
+ */
+
+typedef HArrayOfObject* (*reflectBuildFunc)(struct Hjava_lang_Class*);
+typedef bool (*reflectPublicFunc)(struct Hjava_lang_Class*, Hjava_lang_Object*);
+typedef Hjava_lang_Object* (*reflectCopyFunc)(Hjava_lang_Object*);
+
+static
+HArrayOfObject*
+buildMethods(struct Hjava_lang_Class* clazz)
+{
+	int count;
+	Hjava_lang_reflect_Method** ptr;
+	HArrayOfObject* array;
+	int i;
+	Method *mth = Kaffe_get_class_methods(clazz);
+
+	count = 0;
+	for (i = CLASS_NMETHODS(clazz)-1; i >= 0; i--) {
+		if ((mth[i].kFlags & KFLAG_CONSTRUCTOR)!=0)
+			continue;
+
+		if (utf8ConstEqual(init_name, mth[i].name))
+			continue;
+
+		count++;
+	}
+
+	array = (HArrayOfObject*)
+	    AllocObjectArray(count, "Ljava/lang/reflect/Method;", NULL);
+	ptr = (Hjava_lang_reflect_Method**)&unhand_array(array)->body[0];
+
+	for (i = CLASS_NMETHODS(clazz)-1; i >= 0; i--) {
+		if ((mth[i].kFlags & KFLAG_CONSTRUCTOR)!=0)
+			continue;
+
+		if (utf8ConstEqual(init_name, mth[i].name))
+			continue;
+
+		*ptr = KaffeVM_makeReflectMethod(clazz, i);
+		ptr++;
+	}
+
+	return (array);
+}
+
+static
+HArrayOfObject*
+buildConstructors(struct Hjava_lang_Class* clazz)
+{
+	int count;
+	Hjava_lang_reflect_Constructor** ptr;
+	HArrayOfObject* array;
+	int i;
+	Method* mth = Kaffe_get_class_methods(clazz);
+
+	count = 0;
+	for (i = CLASS_NMETHODS(clazz)-1; i >= 0;  i--) {
+		if ((mth[i].kFlags & KFLAG_CONSTRUCTOR) == 0)
+			continue;
+
+		count++;
+	}
+	array = (HArrayOfObject*)
+	   AllocObjectArray(count, "Ljava/lang/reflect/Constructor;", NULL);
+	ptr = (Hjava_lang_reflect_Constructor**)&unhand_array(array)->body[0];
+
+	for (i = CLASS_NMETHODS(clazz)-1; i >= 0;  i--) {
+		if ((mth[i].kFlags & KFLAG_CONSTRUCTOR) == 0)
+			continue;
+
+		*ptr = KaffeVM_makeReflectConstructor(clazz, i);
+		ptr++;
+	}
+	return (array);
+}
+
+static
+HArrayOfObject*
+buildFields(struct Hjava_lang_Class* clazz)
+{
+	Hjava_lang_reflect_Field** ptr;
+	HArrayOfObject* array;
+	int i;
+
+	array = (HArrayOfObject*)
+	    AllocObjectArray(CLASS_NFIELDS(clazz), "Ljava/lang/reflect/Field;", NULL);
+	ptr = (Hjava_lang_reflect_Field**)&unhand_array(array)->body[0];
+
+	for (i = CLASS_NFIELDS(clazz)-1; i >= 0;  i--) {
+		*ptr = KaffeVM_makeReflectField(clazz, i);
+		ptr++;
+	}
+
+	return (array);
+}
+
+static
+bool
+isPublicMethod(struct Hjava_lang_Class* clazz, Hjava_lang_Object* obj)
+{
+	Hjava_lang_reflect_Method* meth = (Hjava_lang_reflect_Method*)obj;
+
+	return ((Kaffe_get_class_methods(clazz)[unhand(meth)->slot].accflags & ACC_PUBLIC) != 0);
+}
+
+static
+bool
+isPublicConstructor(struct Hjava_lang_Class* clazz, Hjava_lang_Object* obj)
+{
+	Hjava_lang_reflect_Constructor* meth = (Hjava_lang_reflect_Constructor*)obj;
+
+	return ((Kaffe_get_class_methods(clazz)[unhand(meth)->slot].accflags & ACC_PUBLIC) != 0);
+}
+
+static
+bool
+isPublicField(struct Hjava_lang_Class* clazz, Hjava_lang_Object* obj)
+{
+	Hjava_lang_reflect_Field* field = (Hjava_lang_reflect_Field*)obj;
+
+	return ((CLASS_FIELDS(clazz)[unhand(field)->slot].accflags & ACC_PUBLIC) != 0);
+}
+
+/*
+ * Shallow copy of an object array.
+ */
+static
+HArrayOfObject*
+copyObjectArray(HArrayOfObject* array)
+{
+	HArrayOfObject* copy;
+
+	copy = (HArrayOfObject*)newArray(
+		Kaffe_get_array_element_type(OBJECT_CLASS(&array->base)),
+		ARRAY_SIZE(array));
+	memcpy(ARRAY_DATA(copy), ARRAY_DATA(array),
+	       ARRAY_SIZE(array) * sizeof(Hjava_lang_Object*));
+	return (copy);
+}
+
+/*
+ * Copy a root reflection object.
+ */
+static
+Hjava_lang_Object*
+copyReflectObject(Hjava_lang_Object* root)
+{
+	Hjava_lang_Class* clazz = OBJECT_CLASS(root);
+	Hjava_lang_Object* copy;
+
+	copy = newObject(clazz);
+	memcpy(OBJECT_DATA(copy), OBJECT_DATA(root),
+	       CLASS_FSIZE(clazz) - sizeof(Hjava_lang_Object));
+	return (copy);
+}
+
+/*
+ * The type arrays of methods and constructors are returned as is by
+ * the java side, so each copy gets its own.
+ */
+static
+Hjava_lang_Object*
+copyMethod(Hjava_lang_Object* root)
+{
+	Hjava_lang_reflect_Method* meth;
+
+	meth = (Hjava_lang_reflect_Method*)copyReflectObject(root);
+	unhand(meth)->parameterTypes = copyObjectArray(unhand(meth)->parameterTypes);
+	unhand(meth)->exceptionTypes = copyObjectArray(unhand(meth)->exceptionTypes);
+	return (&meth->base);
+}
+
+static
+Hjava_lang_Object*
+copyConstructor(Hjava_lang_Object* root)
+{
+	Hjava_lang_reflect_Constructor* meth;
+
+	meth = (Hjava_lang_reflect_Constructor*)copyReflectObject(root);
+	unhand(meth)->parameterTypes = copyObjectArray(unhand(meth)->parameterTypes);
+	unhand(meth)->exceptionTypes = copyObjectArray(unhand(meth)->exceptionTypes);
+	return (&meth->base);
+}
+
+/*
+ * Return copies of the cached root reflection objects in `cache',
+ * building the cache first if it has been dropped by the collector.
+ */
+static
+HArrayOfObject*
+getReflectCache(struct Hjava_lang_Class* clazz, HArrayOfObject** cache,
+		reflectBuildFunc build, reflectPublicFunc isPublic,
+		reflectCopyFunc copy, jboolean publicOnly)
+{
+	HArrayOfObject* roots;
+	HArrayOfObject* array;
+	Hjava_lang_Object** src;
+	Hjava_lang_Object** dst;
+	int count;
+	int i;
+
+	roots = *cache;
+	if (roots == NULL) {
+		/* Two threads may race here, in which case one of the
+		 * arrays is simply dropped.
+		 */
+		roots = build(clazz);
+		*cache = roots;
+	}
+	clazz->reflect_used = KGC_getCollections(main_collector);
+
+	src = OBJARRAY_DATA(roots);
+	if (publicOnly) {
+		count = 0;
+		for (i = 0; i < ARRAY_SIZE(roots); i++) {
+			if (isPublic(clazz, src[i]))
+				count++;
+		}
+	} else {
+		count = ARRAY_SIZE(roots);
+	}
+
+	array = (HArrayOfObject*)newArray(
+		Kaffe_get_array_element_type(OBJECT_CLASS(&roots->base)),
+		count);
+	dst = OBJARRAY_DATA(array);
+
+	for (i = 0; i < ARRAY_SIZE(roots); i++) {
+		if (publicOnly && !isPublic(clazz, src[i]))
+			continue;
+
+		*dst++ = copy(src[i]);
+	}
+
+	return (array);
+}
+
+HArrayOfObject*
+KaffeVM_getDeclaredMethods(struct Hjava_lang_Class* clazz, jboolean publicOnly)
+{
+	return (getReflectCache(clazz, &clazz->reflect_methods,
+				buildMethods, isPublicMethod, copyMethod,
+				publicOnly));
+}
+
+HArrayOfObject*
+KaffeVM_getDeclaredConstructors(struct Hjava_lang_Class* clazz, jboolean publicOnly)
+{
+	return (getReflectCache(clazz, &clazz->reflect_constructors,
+				buildConstructors, isPublicConstructor,
+				copyConstructor, publicOnly));
+}
+
+HArrayOfObject*
+KaffeVM_getDeclaredFields(struct Hjava_lang_Class* clazz, jboolean publicOnly)
+{
+	return (getReflectCache(clazz, &clazz->reflect_fields,
+				buildFields, isPublicField, copyReflectObject,
+				publicOnly));
+}
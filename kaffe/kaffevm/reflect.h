@@ -21,4 +21,14 @@ Hjava_lang_reflect_Constructor*  KaffeVM_makeReflectConstructor(struct Hjava_lan
 Hjava_lang_reflect_Method*       KaffeVM_makeReflectMethod(struct Hjava_lang_Class* clazz, int slot);
 Hjava_lang_reflect_Field*        KaffeVM_makeReflectField(struct Hjava_lang_Class* clazz, int slot);
 
+/*
+ * Number of garbage collections an unused reflection cache survives
+ * before walkClass drops it.
+ */
+#define REFLECT_CACHE_MAX_AGE	4
+
+HArrayOfObject* KaffeVM_getDeclaredMethods(struct Hjava_lang_Class* clazz, jboolean publicOnly);
+HArrayOfObject* KaffeVM_getDeclaredConstructors(struct Hjava_lang_Class* clazz, jboolean publicOnly);
+HArrayOfObject* KaffeVM_getDeclaredFields(struct Hjava_lang_Class* clazz, jboolean publicOnly);
+
 #endif
@@ -56,7 +56,7 @@ soft_new(Hjava_lang_Class* c)
 	Hjava_lang_Object* obj;
 	errorInfo info;
 
-	if (c->state != CSTATE_COMPLETE && processClass(c, CSTATE_COMPLETE, &info) == false) {
+	if (classNeedsInit(c) && processClass(c, CSTATE_COMPLETE, &info) == false) {
 		goto bad;
 	}
 	obj = newObjectChecked(c, &info);
@@ -596,7 +596,7 @@ void
 soft_initialise_class(Hjava_lang_Class* c)
 {
 	/* We check this outside the processClass to save a subroutine call */
-	if (c->state != CSTATE_COMPLETE) {
+	if (classNeedsInit(c)) {
 		errorInfo info;
 		if (processClass(c, CSTATE_COMPLETE, &info) == false) {
 			throwError(&info);
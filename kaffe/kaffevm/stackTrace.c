@@ -117,6 +117,82 @@ buildStackTrace(struct _exceptionFrame* base)
 	return ((Hjava_lang_Object*)info);
 }
 
+/*
+ * Start walking the stack of the current thread at base, or at the
+ * caller if it is NULL.
+ */
+void
+stackTraceIterInit(stackTraceIterator* it, struct _exceptionFrame* base)
+{
+	(void) base;			/* avoid compiler warnings in intrp */
+	STACKTRACEINIT(it->trace, base, base, it->orig);
+	it->previous = NULL;
+	it->pc = 0;
+}
+
+/*
+ * Return the method of the next Java frame, or NULL at the end of the
+ * stack.  Frames of native code are skipped.
+ */
+Method*
+stackTraceIterNext(stackTraceIterator* it)
+{
+	Method* meth;
+	uintp pc;
+
+	/* stop when we leave the stack or start looping frames */
+	while (STACKTRACEFRAME(it->trace)
+	       && KTHREAD(on_current_stack) ((void *)STACKTRACEFP(it->trace))
+	       && it->previous != (void *)it->trace.frame) {
+		pc = STACKTRACEPC(it->trace);
+		meth = stacktraceFindMethod(STACKTRACEFP(it->trace), pc);
+		it->previous = it->trace.frame;
+		STACKTRACESTEP(it->trace);
+		if (meth != NULL) {
+			it->pc = pc;
+			return (meth);
+		}
+	}
+	return (NULL);
+}
+
+/*
+ * Record the methods of the innermost Java frames of the current thread,
+ * innermost first, and if pcs is not NULL the pc each frame is at,
+ * without allocating memory; safe to call from within the allocator.
+ * Under the JIT finding the method of a frame takes the collector's
+ * lock, so signal handlers use stackTraceRawFrames instead.  The walk
+ * starts at base, or here if it is NULL.  Returns the number of frames
+ * stored.
+ */
+int
+stackTraceFrames(struct _exceptionFrame* base, Method** meths, uintp* pcs,
+		 int max)
+{
+	stackTraceIterator it;
+	Method* meth;
+	int cnt;
+
+	stackTraceIterInit(&it, base);
+	for (cnt = 0; cnt < max && (meth = stackTraceIterNext(&it)) != NULL;
+	     cnt++) {
+		if (pcs != NULL) {
+			pcs[cnt] = it.pc;
+		}
+		meths[cnt] = meth;
+	}
+	return (cnt);
+}
+
+/*
+ * Like stackTraceFrames, without the pcs.
+ */
+int
+stackTraceMethods(struct _exceptionFrame* base, Method** meths, int max)
+{
+	return (stackTraceFrames(base, meths, NULL, max));
+}
+
 #if defined(TRANSLATOR)
 #include "machine.h"
 
@@ -143,6 +219,61 @@ stacktraceFindMethod(uintp fp, uintp pc UNUSED)
 }
 #endif
 
+/*
+ * Record where the innermost frames of the current thread are, innermost
+ * first, for stackTraceFrameMethod to name later.  Under the JIT these
+ * are the pcs of all frames, Java or not; the interpreter can name the
+ * method right away.  Takes no lock and allocates nothing, so this is
+ * safe to call from a signal handler.  The walk starts at base, or here
+ * if it is NULL.  Returns the number of frames stored.
+ */
+int
+stackTraceRawFrames(struct _exceptionFrame* base, uintp* frames, int max)
+{
+	stackTraceIterator it;
+	int cnt = 0;
+
+	stackTraceIterInit(&it, base);
+	while (cnt < max
+	       && STACKTRACEFRAME(it.trace)
+	       && KTHREAD(on_current_stack) ((void *)STACKTRACEFP(it.trace))
+	       && it.previous != (void *)it.trace.frame) {
+#if defined(TRANSLATOR)
+		frames[cnt++] = STACKTRACEPC(it.trace);
+#else
+		Method* meth = stacktraceFindMethod(STACKTRACEFP(it.trace), 0);
+
+		if (meth != NULL) {
+			frames[cnt++] = (uintp)meth;
+		}
+#endif
+		it.previous = it.trace.frame;
+		STACKTRACESTEP(it.trace);
+	}
+	return (cnt);
+}
+
+/*
+ * The method of a frame recorded by stackTraceRawFrames, or NULL if it
+ * is not a Java frame.  Under the JIT the code may have been freed since
+ * the frame was recorded, so make sure the pc still points into some.
+ */
+Method*
+stackTraceFrameMethod(uintp frame)
+{
+#if defined(TRANSLATOR)
+	void *pc_base = KGC_getObjectBase(main_collector, (void *)frame);
+
+	if (pc_base == NULL
+	    || KGC_getObjectIndex(main_collector, pc_base) != KGC_ALLOC_JITCODE) {
+		return (NULL);
+	}
+	return (((jitCodeHeader *)pc_base)->method);
+#else
+	return ((Method*)frame);
+#endif
+}
+
 static inline int32
 getLineNumber(Method* meth, uintp _pc)
 {
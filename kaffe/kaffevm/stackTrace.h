@@ -29,7 +29,25 @@ typedef struct _stackTraceInfo {
 
 #define ENDOFSTACK	((struct _jmethodID*)-1)
 
+/*
+ * Walks the Java frames of the current thread one at a time, innermost
+ * first, without allocating memory.  It must be started in the function
+ * that uses it, and not be used after that function returns.
+ */
+typedef struct _stackTraceIterator {
+	struct _stackTrace	trace;
+	struct _exceptionFrame	orig;
+	void*			previous;
+	uintp			pc;	/* of the frame last returned */
+} stackTraceIterator;
+
 Hjava_lang_Object*	buildStackTrace(struct _exceptionFrame*);
 void			printStackTrace(struct Hjava_lang_Throwable*, struct Hjava_lang_Object*, int);
+int			stackTraceMethods(struct _exceptionFrame*, struct _jmethodID**, int);
+int			stackTraceFrames(struct _exceptionFrame*, struct _jmethodID**, uintp*, int);
+int			stackTraceRawFrames(struct _exceptionFrame*, uintp*, int);
+struct _jmethodID*	stackTraceFrameMethod(uintp);
+void			stackTraceIterInit(stackTraceIterator*, struct _exceptionFrame*);
+struct _jmethodID*	stackTraceIterNext(stackTraceIterator*);
 
 #endif
@@ -0,0 +1,324 @@
+/*
+ * startupTrace.c
+ * Tracing of virtual machine startup.
+ *
+ * Once a trace file is given, the initialisation phases of the virtual
+ * machine, the reading, verifying, linking and static initialisation of
+ * each class and the methods the translator compiles are recorded with
+ * their start and duration.  Lookups in the class path are added up for
+ * each entry.  At exit everything is written out in the JSON format of
+ * the Chrome trace viewer: phases and classes as complete events on the
+ * thread that ran them, and the class path entries as a process of their
+ * own, one bar per entry as long as the time spent looking in it.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include "config.h"
+#include "config-std.h"
+#include "config-mem.h"
+#include "jni_md.h"
+#include "gtypes.h"
+#include "jthread.h"
+#include "locks.h"
+#include "debug.h"
+#include "startupTrace.h"
+
+/* Threads told apart, later ones share thread 0 */
+#define	STARTUPTRACE_THREADS	64
+
+/* Class path entries kept apart */
+#define	STARTUPTRACE_CLASSPATH	64
+
+typedef struct _traceEvent {
+	const char	*cat;		/* a literal */
+	char		*name;
+	char		*arg;		/* NULL if none */
+	statTime	start;
+	statTime	duration;	/* -1 for an instant */
+	int		tid;
+} traceEvent;
+
+typedef struct _traceClasspath {
+	const char	*path;
+	statTime	time;
+	jlong		lookups;
+	jlong		found;
+} traceClasspath;
+
+bool startupTracing;
+
+static const char *traceFile;
+static statTime traceBase;
+
+/* Before threads are up only the main thread records, without locking */
+static bool threadsReady;
+static iStaticLock traceLock;
+
+static traceEvent *events;
+static int nevents;
+static jlong droppedEvents;
+
+static jthread_t traceThreads[STARTUPTRACE_THREADS];
+static int nthreads;
+
+static traceClasspath entries[STARTUPTRACE_CLASSPATH];
+static int nentries;
+
+static void
+traceLockAcquire(void)
+{
+	if (threadsReady) {
+		lockStaticMutex(&traceLock);
+	}
+}
+
+static void
+traceLockRelease(void)
+{
+	if (threadsReady) {
+		unlockStaticMutex(&traceLock);
+	}
+}
+
+/*
+ * The number of the current thread in the trace.  The main thread is 1.
+ * Called with the trace lock held.
+ */
+static int
+traceThread(void)
+{
+	jthread_t cur;
+	int i;
+
+	if (!threadsReady) {
+		return (1);
+	}
+	cur = KTHREAD(current)();
+	for (i = 0; i < nthreads; i++) {
+		if (traceThreads[i] == cur) {
+			return (i + 1);
+		}
+	}
+	if (nthreads < STARTUPTRACE_THREADS) {
+		traceThreads[nthreads++] = cur;
+		return (nthreads);
+	}
+	return (0);
+}
+
+static void
+traceRecord(const char *cat, const char *name, const char *arg,
+	    statTime start, statTime duration)
+{
+	traceEvent *ev;
+	char *n;
+	char *a = NULL;
+
+	n = strdup(name);
+	if (arg != NULL) {
+		a = strdup(arg);
+	}
+
+	traceLockAcquire();
+	if (nevents == STARTUPTRACE_EVENTS || n == NULL
+	    || (arg != NULL && a == NULL)) {
+		droppedEvents++;
+		traceLockRelease();
+		free(n);
+		free(a);
+		return;
+	}
+	ev = &events[nevents++];
+	ev->cat = cat;
+	ev->name = n;
+	ev->arg = a;
+	ev->start = start;
+	ev->duration = duration;
+	ev->tid = traceThread();
+	traceLockRelease();
+}
+
+/*
+ * Record an event of category cat, such as "vm" or "clinit", which
+ * started at start and ends now.  arg, if not NULL, is shown with it.
+ */
+void
+startupTraceEvent(const char *cat, const char *name, const char *arg,
+		  statTime start)
+{
+	traceRecord(cat, name, arg, start, statsNow() - start);
+}
+
+/*
+ * Mark a moment, such as the call to main.
+ */
+void
+startupTraceInstant(const char *name)
+{
+	if (startupTracing) {
+		traceRecord("vm", name, NULL, statsNow(), -1);
+	}
+}
+
+/*
+ * Add the time since start to what was spent looking for classes in the
+ * class path entry path.
+ */
+void
+startupTraceClasspath(const char *path, statTime start, bool found)
+{
+	statTime t = statsNow() - start;
+	int i;
+
+	traceLockAcquire();
+	for (i = 0; i < nentries; i++) {
+		if (entries[i].path == path) {
+			break;
+		}
+	}
+	if (i == nentries && nentries < STARTUPTRACE_CLASSPATH) {
+		entries[nentries++].path = path;
+	}
+	if (i < nentries) {
+		entries[i].time += t;
+		entries[i].lookups++;
+		if (found) {
+			entries[i].found++;
+		}
+	}
+	traceLockRelease();
+}
+
+static void
+tracePrintString(FILE *fp, const char *s)
+{
+	putc('"', fp);
+	for (; *s != '\0'; s++) {
+		if (*s == '"' || *s == '\\') {
+			putc('\\', fp);
+		}
+		if ((unsigned char)*s >= ' ') {
+			putc(*s, fp);
+		}
+	}
+	putc('"', fp);
+}
+
+/* Nanoseconds as the microseconds the trace format wants */
+static double
+traceMicros(statTime t)
+{
+	return ((double)t / 1000.0);
+}
+
+/*
+ * Print the trace as a JSON object in the Chrome trace format.
+ */
+void
+startupTraceDump(FILE *fp)
+{
+	traceEvent *ev;
+	int i;
+
+	traceLockAcquire();
+	fprintf(fp, "{\"traceEvents\": [\n");
+	fprintf(fp, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1,"
+		" \"tid\": 1, \"args\": {\"name\": \"kaffe\"}},\n");
+	fprintf(fp, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1,"
+		" \"tid\": 1, \"args\": {\"name\": \"main\"}},\n");
+	fprintf(fp, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 2,"
+		" \"tid\": 1, \"args\": {\"name\": \"class path\"}}");
+
+	for (i = 0; i < nevents; i++) {
+		ev = &events[i];
+		fprintf(fp, ",\n{\"name\": ");
+		tracePrintString(fp, ev->name);
+		fprintf(fp, ", \"cat\": \"%s\", ", ev->cat);
+		if (ev->duration < 0) {
+			fprintf(fp, "\"ph\": \"i\", \"s\": \"g\", ");
+		}
+		else {
+			fprintf(fp, "\"ph\": \"X\", \"dur\": %.3f, ",
+				traceMicros(ev->duration));
+		}
+		fprintf(fp, "\"ts\": %.3f, \"pid\": 1, \"tid\": %d",
+			traceMicros(ev->start - traceBase), ev->tid);
+		if (ev->arg != NULL) {
+			fprintf(fp, ", \"args\": {\"detail\": ");
+			tracePrintString(fp, ev->arg);
+			putc('}', fp);
+		}
+		putc('}', fp);
+	}
+
+	/* One thread per class path entry, with its total as one event */
+	for (i = 0; i < nentries; i++) {
+		fprintf(fp, ",\n{\"name\": \"thread_name\", \"ph\": \"M\","
+			" \"pid\": 2, \"tid\": %d, \"args\": {\"name\": ", i + 1);
+		tracePrintString(fp, entries[i].path);
+		fprintf(fp, "}},\n{\"name\": ");
+		tracePrintString(fp, entries[i].path);
+		fprintf(fp, ", \"cat\": \"classpath\", \"ph\": \"X\", \"ts\": 0,"
+			" \"dur\": %.3f, \"pid\": 2, \"tid\": %d,"
+			" \"args\": {\"lookups\": %lld, \"found\": %lld}}",
+			traceMicros(entries[i].time), i + 1,
+			(long long)entries[i].lookups,
+			(long long)entries[i].found);
+	}
+
+	fprintf(fp, "\n],\n\"displayTimeUnit\": \"ms\",\n"
+		"\"otherData\": {\"dropped_events\": %lld}}\n",
+		(long long)droppedEvents);
+	traceLockRelease();
+}
+
+static void
+startupTraceWrite(void)
+{
+	FILE *fp;
+
+	fp = fopen(traceFile, "w");
+	if (fp == NULL) {
+		dprintf("Unable to write startup trace %s\n", traceFile);
+		return;
+	}
+	startupTraceDump(fp);
+	fclose(fp);
+}
+
+/*
+ * Start tracing, to be written to file at exit.  Times are taken from
+ * now, so call this as early as possible.
+ */
+void
+startupTraceSetFile(const char *file)
+{
+	events = malloc(STARTUPTRACE_EVENTS * sizeof(traceEvent));
+	if (events == NULL) {
+		return;
+	}
+	traceFile = file;
+	traceBase = statsNow();
+	startupTracing = true;
+	atexit(startupTraceWrite);
+}
+
+/*
+ * The locking system is up, from now on other threads may record.
+ */
+void
+startupTraceInit(void)
+{
+	if (!startupTracing) {
+		return;
+	}
+	initStaticLock(&traceLock);
+	traceThreads[0] = KTHREAD(current)();
+	nthreads = 1;
+	threadsReady = true;
+}
@@ -0,0 +1,50 @@
+/*
+ * startupTrace.h
+ * Tracing of virtual machine startup.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#ifndef __kaffevm_startupTrace_h
+#define __kaffevm_startupTrace_h
+
+#include "stats.h"
+
+/* Events kept, later ones are only counted */
+#define	STARTUPTRACE_EVENTS	65536
+
+extern bool startupTracing;
+
+extern void startupTraceSetFile(const char *file);
+extern void startupTraceInit(void);
+extern void startupTraceEvent(const char *cat, const char *name,
+			      const char *arg, statTime start);
+extern void startupTraceInstant(const char *name);
+extern void startupTraceClasspath(const char *path, statTime start,
+				  bool found);
+extern void startupTraceDump(FILE *fp);
+
+/* The start of an event, 0 if we are not tracing */
+#define	STARTUP_TRACE_START()	(startupTracing ? statsNow() : 0)
+
+/* Record an event started at START, if it was traced */
+#define	STARTUP_TRACE_END(START, CAT, NAME, ARG)			\
+	do {								\
+		if ((START) != 0) {					\
+			startupTraceEvent((CAT), (NAME), (ARG), (START)); \
+		}							\
+	} while (0)
+
+/* Run STMT as the startup phase NAME */
+#define	STARTUP_TRACE_PHASE(NAME, STMT)					\
+	do {								\
+		statTime _phaseStart = STARTUP_TRACE_START();		\
+		STMT;							\
+		STARTUP_TRACE_END(_phaseStart, "vm", (NAME), NULL);	\
+	} while (0)
+
+#endif /* __kaffevm_startupTrace_h */
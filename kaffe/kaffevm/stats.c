@@ -1,15 +1,15 @@
 /*
  * stats.c
- * Getrusage based execution timing and other statistics gathering.
+ * Execution timing and other statistics gathering.
  *
  * Copyright (c) 1999
  *	Archie Cobbs <archie@whistle.com>
  *
  * Copyright (c) 2004
  *      Kaffe.org contributors. See ChangeLog for details. All rights reserved.
- *   
- * See the file "license.terms" for information on usage and redistribution 
- * of this file. 
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
  */
 
 #include "config.h"
@@ -20,20 +20,21 @@
 #include <sys/time.h>
 #endif
 
-#if defined(HAVE_SYS_RESOURCE_H)
-#include <sys/resource.h>
-#endif
+#include <time.h>
+#include <ctype.h>
 
 #include "jni_md.h"
-#if !defined(KAFFEH)
+#include "gtypes.h"
 #include "jthread.h"
-#endif
+#include "thread.h"
+#include "threadData.h"
+#include "locks.h"
+#include "errors.h"
+#include "md.h"
 #include "support.h"
 #include "debug.h"
 #include "stats.h"
 
-#if defined(KAFFE_STATS)
-
 timespent fulljit;
 counter jitmem;
 counter jitcodeblock;
@@ -56,6 +57,40 @@ timespent jit_time;
  */
 static char *statMask = "none";
 
+/* Set once statistics are asked for, see statsSetMaskStr, statsSetExport */
+int statsEnabled;
+
+/*
+ * Counts for one thread.  Only the owning thread writes to a shard, so
+ * updates need no synchronization; readers sum all shards and accept
+ * that a count may be one sample behind.  Shards are never freed: when
+ * a thread goes away its shard is handed to the next thread, which
+ * keeps adding to the same totals.
+ */
+typedef struct _statShard {
+	struct _statShard *next;
+	int inUse;
+	jlong calls[STAT_MAX_COUNTERS];
+	jlong total[STAT_MAX_COUNTERS];
+	jlong max[STAT_MAX_COUNTERS];
+	statTime start[STAT_MAX_COUNTERS];
+	jlong histo[STAT_MAX_COUNTERS][STAT_HISTO_BUCKETS];
+} statShard;
+
+/* Used before the threading system is up, when there is only one thread */
+static statShard bootShard = { NULL, 1, { 0 }, { 0 }, { 0 }, { 0 }, { { 0 } } };
+static statShard *shards = &bootShard;
+
+/* Registered counters, by index.  Index 0 means "not registered yet". */
+static statobject *registered[STAT_MAX_COUNTERS];
+static int nregistered = 1;
+
+/* Periodic export, see statsSetExport */
+static char *exportFile;
+static int exportInterval = 10;
+static iStaticLock exportLock;
+static int exportDone;
+
 static
 int cmp_int(const void *_a, const void *_b)
 {
@@ -76,7 +111,160 @@ statsComputeSumMedian(int *v, int n, int *sum, int *med)
         *med = v[n/2];
 }
 
-static timespent *counters;	/* all timers that have been run */
+/*
+ * Read the monotonic clock.
+ */
+statTime
+statsNow(void)
+{
+#if defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((statTime)ts.tv_sec * 1000000000 + ts.tv_nsec);
+#elif defined(HAVE_GETTIMEOFDAY)
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return ((statTime)tv.tv_sec * 1000000000 + (statTime)tv.tv_usec * 1000);
+#else
+	return ((statTime)time(NULL) * 1000000000);
+#endif
+}
+
+/*
+ * Give a counter its slot in the shards.  Returns the slot, or -1 if
+ * this sample should be dropped: either another thread is registering
+ * the same counter right now or all slots are taken.
+ */
+static int
+registerCounter(statobject *counter, const char *name, int type)
+{
+	int idx;
+
+	if (!COMPARE_AND_EXCHANGE(&counter->index, 0, -1)) {
+		return (counter->index);
+	}
+
+	do {
+		idx = nregistered;
+		if (idx >= STAT_MAX_COUNTERS) {
+			/* counter->index stays -1, so we only say this once */
+			dprintf("stats: no room for counter `%s', "
+				"raise STAT_MAX_COUNTERS\n", name);
+			return (-1);
+		}
+	} while (!COMPARE_AND_EXCHANGE(&nregistered, idx, idx + 1));
+
+	counter->name = name;
+	counter->flags = type;
+	registered[idx] = counter;
+	counter->index = idx;
+	return (idx);
+}
+
+static inline int
+counterIndex(statobject *counter, const char *name, int type)
+{
+	if (counter->index != 0) {
+		return (counter->index);
+	}
+	return (registerCounter(counter, name, type));
+}
+
+/*
+ * Find a shard for a new thread, reusing one left by a dead thread if
+ * there is one.
+ */
+static statShard *
+claimShard(void)
+{
+	statShard *shard;
+
+	for (shard = shards; shard != NULL; shard = shard->next) {
+		if (shard->inUse == 0 && COMPARE_AND_EXCHANGE(&shard->inUse, 0, 1)) {
+			return (shard);
+		}
+	}
+
+	shard = calloc(1, sizeof(statShard));
+	if (shard == NULL) {
+		return (&bootShard);
+	}
+	shard->inUse = 1;
+	do {
+		shard->next = shards;
+	} while (!COMPARE_AND_EXCHANGE(&shards, shard->next, shard));
+	return (shard);
+}
+
+static statShard *
+currentShard(void)
+{
+	jthread_t cur;
+	threadData *thread_data;
+
+	cur = KTHREAD(current)();
+	if (cur == NULL) {
+		return (&bootShard);
+	}
+
+	thread_data = KTHREAD(get_data)(cur);
+	if (thread_data->statShard == NULL) {
+		thread_data->statShard = claimShard();
+	}
+	return (thread_data->statShard);
+}
+
+/*
+ * Called as a thread is torn down, so that the next thread can take
+ * over its shard.
+ */
+void
+statsReleaseThread(threadData *thread_data)
+{
+	statShard *shard = thread_data->statShard;
+
+	if (shard != NULL && shard != &bootShard) {
+		thread_data->statShard = NULL;
+		shard->inUse = 0;
+	}
+}
+
+static int
+histoBucket(statTime t)
+{
+	int b;
+
+	for (b = 0; t > 1 && b < STAT_HISTO_BUCKETS - 1; b++) {
+		t >>= 1;
+	}
+	return (b);
+}
+
+/*
+ * Sum all shards into one.
+ */
+static void
+sumShards(statShard *sum)
+{
+	statShard *shard;
+	int i, j;
+
+	memset(sum, 0, sizeof(*sum));
+	for (shard = shards; shard != NULL; shard = shard->next) {
+		for (i = 1; i < nregistered; i++) {
+			sum->calls[i] += shard->calls[i];
+			sum->total[i] += shard->total[i];
+			if (sum->max[i] < shard->max[i]) {
+				sum->max[i] = shard->max[i];
+			}
+			for (j = 0; j < STAT_HISTO_BUCKETS; j++) {
+				sum->histo[i][j] += shard->histo[i][j];
+			}
+		}
+	}
+}
 
 /*
  * determine whether counter with a given name should be reported
@@ -87,7 +275,7 @@ reportCounter(timespent *counter, int type)
 {
 	char *g, buf[256];
 
-	if (!(counter->flags & type)) {
+	if (counter == NULL || !(counter->flags & type)) {
 		return (0);
 	}
 
@@ -112,19 +300,19 @@ reportCounter(timespent *counter, int type)
 	return (0);
 }
 
-/* Print total user time, user time spent by each defined counter, along
- * with the number of passes each counter took.
+/* Print the time spent in each defined timer, along with the number of
+ * passes each timer took, and the values of all counters.
  */
 static void
 statsReport(void)
 {
+	static statShard sum;
 	timespent *p;
-	struct rusage tot_usage;
+	int i;
 	int ntimers = 0, ncounters = 0, ncumcounters = 0, nusercounters = 0;
 
-	getrusage(RUSAGE_SELF, &tot_usage);
-
-	for (p = counters; p; p = p->next) {
+	for (i = 1; i < nregistered; i++) {
+		p = registered[i];
 		if (reportCounter(p, STAT_TIMING)) {
 			ntimers++;
 		}
@@ -142,60 +330,64 @@ statsReport(void)
 		return;	/* user doesn't want to see any counters */
 	}
 
+	sumShards(&sum);
+
 	if (ntimers > 0) {
-		dprintf("#FACILITY\tUSER TIME\tSYSTEM TIME\tCALLS\n"
+		dprintf("#FACILITY\tTIME\t\tMAX\t\tCALLS\n"
 			"#--------------- --------------- "
 			"--------------- ---------------\n");
 	}
-	for (p = counters; p; p = p->next) {
+	for (i = 1; i < nregistered; i++) {
+		p = registered[i];
 		if (reportCounter(p, STAT_TIMING)) {
-			dprintf("%-15s %8d.%06d %8d.%06d %15d\n",
-				p->name, p->total.tv_sec, p->total.tv_usec,
-				p->stotal.tv_sec, p->stotal.tv_usec,
-				p->calls);
+			dprintf("%-15s %8d.%06d %8d.%06d %15ld\n",
+				p->name,
+				(int)(sum.total[i] / 1000000000),
+				(int)(sum.total[i] % 1000000000 / 1000),
+				(int)(sum.max[i] / 1000000000),
+				(int)(sum.max[i] % 1000000000 / 1000),
+				(long)sum.calls[i]);
 		}
 	}
-	if (ntimers > 0) {
-		dprintf("%-15s %8d.%06d %8d.%06d\n",
-			"TOTAL",
-			tot_usage.ru_utime.tv_sec, tot_usage.ru_utime.tv_usec,
-			tot_usage.ru_stime.tv_sec, tot_usage.ru_stime.tv_usec);
-	}
 
 	if (ncounters > 0) {
 		dprintf("#\n#HIT COUNTERS\n");
 		dprintf("%-30s %8s\n", "#FACILITY", "HITS");
-		dprintf("%-30s %8s\n", 
+		dprintf("%-30s %8s\n",
 			"#-----------------------------", "--------");
 	}
-	for (p = counters; p; p = p->next) {
+	for (i = 1; i < nregistered; i++) {
+		p = registered[i];
 		if (reportCounter(p, STAT_COUNT)) {
-			dprintf("%-30s %8d\n",
-				p->name, p->calls);
+			dprintf("%-30s %8ld\n",
+				p->name, (long)sum.calls[i]);
 		}
 	}
 
 	if (ncumcounters > 0) {
 		dprintf("#\n#CUMULATIVE COUNTERS\n");
-		dprintf("%-25s %-11s %-14s %-14s %-11s\n",
-			"#FACILITY", "VISITS", "FINAL", "MAX", "AVG PER HIT");
-		dprintf("%-25s %-11s %14s %14s %11s\n",
-			"#------------------------", "-----------", 
-			"--------------", "--------------", 
-			"-----------");
-	}
-	for (p = counters; p; p = p->next) {
+		dprintf("%-25s %-11s %-14s %-11s %-11s\n",
+			"#FACILITY", "VISITS", "FINAL", "AVG PER HIT",
+			"LARGEST HIT");
+		dprintf("%-25s %-11s %14s %11s %11s\n",
+			"#------------------------", "-----------",
+			"--------------", "-----------", "-----------");
+	}
+	for (i = 1; i < nregistered; i++) {
+		p = registered[i];
 		if (reportCounter(p, STAT_CUMULATE)) {
-			dprintf("%-25s %11d %14qd %14qd %11.2f\n",
-				p->name, p->calls, p->cumtotal, p->max,
-				p->cumtotal/(double)p->calls);
+			dprintf("%-25s %11ld %14ld %11.2f %11ld\n",
+				p->name, (long)sum.calls[i], (long)sum.total[i],
+				sum.calls[i] ? sum.total[i]/(double)sum.calls[i] : 0.0,
+				(long)sum.max[i]);
 		}
 	}
 
 	if (nusercounters > 0) {
 		dprintf("#\n#USER-DEFINED COUNTERS\n");
 	}
-	for (p = counters; p; p = p->next) {
+	for (i = 1; i < nregistered; i++) {
+		p = registered[i];
 		if (reportCounter(p, STAT_USER)) {
 			dprintf("#<------ BEGIN `%s' ------>\n", p->name);
 			p->userfunc();
@@ -204,105 +396,305 @@ statsReport(void)
 	}
 }
 
+/*
+ * Print a counter name as a metric name: "gctime-scan" becomes
+ * "kaffe_gctime_scan".
+ */
 static void
-registerCounter(timespent *counter, char *name, int type)
+printMetricName(FILE *fp, const char *name, const char *suffix)
 {
-	if (!counter->name) {
-		counter->name = name;
-		counter->next = counters;
-		counter->flags = type;
-		counters = counter;
+	const char *c;
+
+	fputs("kaffe_", fp);
+	for (c = name; *c != '\0'; c++) {
+		if (isalnum((unsigned char)*c)) {
+			fputc(tolower((unsigned char)*c), fp);
+		}
+		else {
+			fputc('_', fp);
+		}
 	}
+	fputs(suffix, fp);
 }
 
-/* Start timing some portion of JVM activity.
- * If we are called for the first time, install the exit function
- * to print timings.  If we are called for the first time on a counter,
- * initialize it and add it to the list of all counters.
- * Caller is responsible for synchronization.
+/*
+ * Write all counters and timers to fp in the Prometheus text exposition
+ * format.  Timers become histograms in seconds, hit counters become
+ * counters and cumulative counters become gauges, along with the
+ * largest single update they saw.
  */
 void
-startTiming(timespent *counter, char *name)
+statsSnapshot(FILE *fp)
 {
-	struct rusage ru;
-	
-	if (!counter->name) {
-		registerCounter(counter, name, STAT_TIMING);
+	static statShard sum;
+	statobject *p;
+	jlong cum;
+	int i, j;
+
+	sumShards(&sum);
+
+	for (i = 1; i < nregistered; i++) {
+		p = registered[i];
+		if (p == NULL) {
+			continue;
+		}
+		switch (p->flags) {
+		case STAT_TIMING:
+			fputs("# TYPE ", fp);
+			printMetricName(fp, p->name, "_seconds histogram\n");
+			cum = 0;
+			for (j = 0; j < STAT_HISTO_BUCKETS - 1; j++) {
+				cum += sum.histo[i][j];
+				printMetricName(fp, p->name, "_seconds_bucket");
+				fprintf(fp, "{le=\"%.9f\"} %ld\n",
+					(double)((jlong)2 << j) / 1e9, (long)cum);
+			}
+			printMetricName(fp, p->name, "_seconds_bucket");
+			fprintf(fp, "{le=\"+Inf\"} %ld\n", (long)sum.calls[i]);
+			printMetricName(fp, p->name, "_seconds_sum");
+			fprintf(fp, " %.9f\n", sum.total[i] / 1e9);
+			printMetricName(fp, p->name, "_seconds_count");
+			fprintf(fp, " %ld\n", (long)sum.calls[i]);
+			break;
+
+		case STAT_COUNT:
+			fputs("# TYPE ", fp);
+			printMetricName(fp, p->name, "_total counter\n");
+			printMetricName(fp, p->name, "_total");
+			fprintf(fp, " %ld\n", (long)sum.calls[i]);
+			break;
+
+		case STAT_CUMULATE:
+			fputs("# TYPE ", fp);
+			printMetricName(fp, p->name, " gauge\n");
+			printMetricName(fp, p->name, "");
+			fprintf(fp, " %ld\n", (long)sum.total[i]);
+			fputs("# TYPE ", fp);
+			printMetricName(fp, p->name, "_updates_total counter\n");
+			printMetricName(fp, p->name, "_updates_total");
+			fprintf(fp, " %ld\n", (long)sum.calls[i]);
+			fputs("# TYPE ", fp);
+			printMetricName(fp, p->name, "_largest_update gauge\n");
+			printMetricName(fp, p->name, "_largest_update");
+			fprintf(fp, " %ld\n", (long)sum.max[i]);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+/*
+ * Write a snapshot to the export file.  We go through a temporary file
+ * so that a reader never sees a partial snapshot.
+ */
+static void
+statsWriteExport(void)
+{
+	char tmp[1024];
+	FILE *fp;
+
+	snprintf(tmp, sizeof(tmp), "%s.tmp", exportFile);
+	fp = fopen(tmp, "w");
+	if (fp == NULL) {
+		return;
+	}
+	statsSnapshot(fp);
+	if (fclose(fp) == 0) {
+		rename(tmp, exportFile);
+	}
+}
+
+static void
+statsExporter(void *arg UNUSED)
+{
+	lockStaticMutex(&exportLock);
+	for (;;) {
+		waitStaticCond(&exportLock, (jlong)exportInterval * 1000);
+		if (!exportDone) {
+			statsWriteExport();
+		}
+	}
+}
+
+/*
+ * Write the final snapshot at exit.  Take the export lock so we do not
+ * race the exporter thread for the temporary file, and keep it from
+ * writing an older snapshot over ours afterwards.
+ */
+static void
+statsExportAtExit(void)
+{
+	lockStaticMutex(&exportLock);
+	exportDone = 1;
+	statsWriteExport();
+	unlockStaticMutex(&exportLock);
+}
+
+/*
+ * Set the export file and interval from a "file[,seconds]" string.
+ */
+void
+statsSetExport(char *arg)
+{
+	char *comma;
+
+	exportFile = arg;
+	statsEnabled = 1;
+	comma = strrchr(arg, ',');
+	if (comma != NULL) {
+		*comma = '\0';
+		exportInterval = atoi(comma + 1);
+		if (exportInterval <= 0) {
+			exportInterval = 10;
+		}
+	}
+}
+
+/*
+ * Start the thread writing out snapshots, if we were asked to.
+ */
+void
+statsStartExport(void)
+{
+	errorInfo info;
+
+	if (exportFile == NULL) {
+		return;
 	}
 
-	counter->calls++;
-	getrusage(RUSAGE_SELF, &ru);
-	counter->current = ru.ru_utime;
-	counter->scurrent = ru.ru_stime;
+	initStaticLock(&exportLock);
+	if (createDaemon(&statsExporter, "metrics", NULL,
+			 java_lang_Thread_NORM_PRIORITY,
+			 THREADSTACKSIZE, &info) == NULL) {
+		discardErrorInfo(&info);
+		return;
+	}
+	atexit(statsExportAtExit);
 }
 
-void 
-registerUserCounter(timespent *counter, char *name,
+void
+registerUserCounter(timespent *counter, const char *name,
         void (*userfunc)(void))
 {
-	registerCounter(counter, name, STAT_USER);
 	counter->userfunc = userfunc;
+	counterIndex(counter, name, STAT_USER);
 }
 
-void 
-hitCounter(timespent *counter, char *name)
+void
+hitCounter(timespent *counter, const char *name)
 {
-	if (!counter->name) {
-		registerCounter(counter, name, STAT_COUNT);
+	int idx;
+
+	if (!statsEnabled) {
+		return;
+	}
+
+	idx = counterIndex(counter, name, STAT_COUNT);
+	if (idx > 0) {
+		currentShard()->calls[idx]++;
 	}
-	counter->calls++;
 }
 
-void 
-addToCounter(timespent *counter, char *name, int n, jlong increment)
+void
+addToCounter(timespent *counter, const char *name, int n, jlong increment)
 {
-	if (!counter->name) {
-		registerCounter(counter, name, STAT_CUMULATE);
+	int idx;
+	statShard *shard;
+
+	if (!statsEnabled) {
+		return;
 	}
-	counter->calls += n;
-	counter->cumtotal += increment;
-	if (counter->max < counter->cumtotal) {
-		counter->max = counter->cumtotal;
+
+	idx = counterIndex(counter, name, STAT_CUMULATE);
+	if (idx > 0) {
+		shard = currentShard();
+		shard->calls[idx] += n;
+		shard->total[idx] += increment;
+		if (shard->max[idx] < increment) {
+			shard->max[idx] = increment;
+		}
 	}
 }
 
-/* timeval arithmetic macros */
-#define DECF(D, S)				\
-{						\
-	(D).tv_usec -= (S).tv_usec;		\
-	if ((D).tv_usec < 0) {			\
-		(D).tv_usec += 1000000;		\
-		(D).tv_sec -= 1;		\
-	}					\
-	(D).tv_sec -= (S).tv_sec;		\
+/* Start timing some portion of JVM activity.  The start time is kept
+ * in the calling thread's shard, so every thread can time the same
+ * activity at once.
+ */
+void
+startTiming(timespent *counter, const char *name)
+{
+	int idx;
+
+	if (!statsEnabled) {
+		return;
+	}
+
+	idx = counterIndex(counter, name, STAT_TIMING);
+	if (idx > 0) {
+		currentShard()->start[idx] = statsNow();
+	}
 }
 
-#define INCF(D,S)				\
-{						\
-	(D).tv_usec += (S).tv_usec;		\
-	if ((D).tv_usec > 1000000) {		\
-		(D).tv_usec -= 1000000;		\
-		(D).tv_sec += 1;		\
-	}					\
-	(D).tv_sec += (S).tv_sec;		\
+static void
+addTime(statShard *shard, int idx, statTime t)
+{
+	if (t < 0) {
+		t = 0;
+	}
+
+	shard->calls[idx]++;
+	shard->total[idx] += t;
+	if (shard->max[idx] < t) {
+		shard->max[idx] = t;
+	}
+	shard->histo[idx][histoBucket(t)]++;
 }
 
 /*
- * End a timing run.  Adjust total time for this counter.
+ * End a timing run.  Adjust total time and the histogram for this timer.
  */
 void
 stopTiming(timespent *counter)
 {
-	struct rusage ru;
+	int idx = counter->index;
+	statShard *shard;
+	statTime t;
+
+	if (!statsEnabled || idx <= 0) {
+		return;
+	}
 
-	getrusage(RUSAGE_SELF, &ru);
-	DECF(ru.ru_utime, counter->current);
-	INCF(counter->total, ru.ru_utime);
-	DECF(ru.ru_stime, counter->scurrent);
-	INCF(counter->stotal, ru.ru_stime);
+	shard = currentShard();
+	if (shard->start[idx] == 0) {
+		return;
+	}
+	t = statsNow() - shard->start[idx];
+	shard->start[idx] = 0;
+	addTime(shard, idx, t);
 }
 
-void 
+/*
+ * Add a sample measured by the caller, for intervals that do not start
+ * and end in the same place.
+ */
+void
+recordTiming(timespent *counter, const char *name, statTime t)
+{
+	int idx;
+
+	if (!statsEnabled) {
+		return;
+	}
+
+	idx = counterIndex(counter, name, STAT_TIMING);
+	if (idx > 0) {
+		addTime(currentShard(), idx, t);
+	}
+}
+
+void
 statsSetMaskStr(char *mask)
 {
 	static int once = 0;
@@ -310,6 +702,7 @@ statsSetMaskStr(char *mask)
 	if (!once) atexit(statsReport);
 	once = 1;
 	statMask = mask;
+	if (strcmp(mask, "none") != 0) {
+		statsEnabled = 1;
+	}
 }
-
-#endif /* KAFFE_STATS */
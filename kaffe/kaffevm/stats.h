@@ -6,22 +6,24 @@
  *
  * Copyright (c) 2004
  *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
- *   
- * See the file "license.terms" for information on usage and redistribution 
- * of this file. 
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
  */
 
 #ifndef __kaffevm_stats_h
 #define __kaffevm_stats_h
 
 /*
- * Structures and prototypes for getrusage based execution timing
- * and other statistics gathering.
- * 
+ * Structures and prototypes for execution timing and other statistics
+ * gathering.
+ *
  * We provide timers, hit counters, cumulative counters, and the possibility
- * for user-defined statistics routines to be invoked at exit 
+ * for user-defined statistics routines to be invoked at exit.  Counts are
+ * kept in per-thread shards, so recording never takes a lock; timers use
+ * a monotonic clock and keep a latency histogram.
  */
-#if defined(KAFFE_STATS) && !defined(KAFFEH)
+#if !defined(KAFFEH)
 
 /* various flags */
 #define	STAT_TIMING	1
@@ -30,6 +32,12 @@
 #define STAT_MINMAX	8
 #define STAT_USER	16
 
+/* Most counters and timers that can be registered */
+#define	STAT_MAX_COUNTERS	64
+
+/* Timer histogram buckets, bucket i holds samples of [2^i, 2^(i+1)) ns */
+#define	STAT_HISTO_BUCKETS	32
+
 /*
  * We use the same struct for all kinds of timers and counters
  * We a bunch of aliases to refer to it
@@ -38,41 +46,53 @@ typedef struct _statobject timespent;
 typedef struct _statobject counter;
 typedef struct _statobject statobject;
 
-/* This struct is used by all kinds of counters/timers */
+/*
+ * This struct is used by all kinds of counters/timers.  Besides the
+ * calls and the total, we keep the largest single sample: the longest
+ * run of a timer, the largest increment of a cumulative counter.
+ */
 struct _statobject {
-	char *name;
+	const char *name;
 	int flags;	/* describes kind of counter/timer, see STAT_ flags */
-	struct _statobject *next;
-	int calls;
-	struct timeval total;
-	struct timeval stotal;
-	struct timeval current;
-	struct timeval scurrent;
-	jlong cumtotal;
-	jlong max;
+	int index;	/* slot in the shards, 0 until registered */
 	void	(*userfunc)(void);
 };
 
-extern void registerUserCounter(counter *counter, char *name, 
+extern void registerUserCounter(counter *counter, const char *name,
 	void (*userfunc)(void));
-extern void hitCounter(counter *counter, char *name);
-extern void addToCounter(counter *counter, char *name, int n, jlong inc);
-extern void startTiming(timespent *counter, char *name);
+extern void hitCounter(counter *counter, const char *name);
+extern void addToCounter(counter *counter, const char *name, int n, jlong inc);
+extern void startTiming(timespent *counter, const char *name);
 extern void stopTiming(timespent *counter);
+
+/* Nanoseconds on a monotonic clock */
+typedef jlong statTime;
+
+extern void recordTiming(timespent *counter, const char *name, statTime t);
+extern statTime statsNow(void);
+extern void statsSnapshot(FILE *);
+extern void statsSetExport(char *);
+extern void statsStartExport(void);
+
+struct _threadData;
+extern void statsReleaseThread(struct _threadData *);
+
+/* Non-zero once -vmstats or -vmmetrics asked for statistics.  Counters
+   and timers return at once otherwise, and timers on hot paths check it
+   themselves so that they do not even read the clock. */
+extern int statsEnabled;
 #else
-/* We either can't or wont perform timing:  The first macro suppresses
+/* kaffeh does not gather statistics:  The first macro suppresses
    unused variable warnings. */
-/* NB: you can avoid getting these definitions by enclosing
- * the timer invocations in #ifdef KAFFE_STATS
- */
 typedef char timespent;
 typedef char statobject;
 typedef char counter;
 
 #define startTiming(C,N)
-#define hitCounter(C,N) 
+#define hitCounter(C,N)
 #define addToCounter(C,N,I0,I1)
 #define stopTiming(C)
+#define recordTiming(C,N,T)
 #define registerUserCounter(C,N,F)
 #endif
 
@@ -95,4 +115,3 @@ extern void statsSetMaskStr(char *);
 #define GCSIZEOF(x)	KGC_getObjectSize(main_collector, (x))
 
 #endif /* __kaffevm_stats_h */
-
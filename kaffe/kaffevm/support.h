@@ -102,7 +102,7 @@ struct _errorInfo;
  * calltype[i],  except they correspond to the return value.  The 
  * sysdepCallMethod must store the return value in the proper type at *ret.
  */
-typedef struct {
+typedef struct _callMethodInfo {
 	void*			function;  /* method information */
 	jvalue*			args; /* treated as an array of method arguments */
 	jvalue*			ret;
@@ -114,6 +114,9 @@ typedef struct {
 	char			*calltype;
 } callMethodInfo;
 
+/* A call stub takes the place of sysdepCallMethod for one call shape. */
+typedef void (*callMethodStub)(callMethodInfo*);
+
 struct Hjava_lang_String;
 struct Hjava_lang_Class;
 struct Hjava_lang_Object;
@@ -133,6 +136,7 @@ extern jlong		currentTime(void);
 
 extern void	KaffeVM_callMethodA(struct _jmethodID*, void*, void*, jvalue*, jvalue*, int);
 extern void	KaffeVM_callMethodV(struct _jmethodID*, void*, void*, va_list, jvalue*);
+extern callMethodStub	KaffeVM_findCallStub(const callMethodInfo*);
 extern void     KaffeVM_safeCallMethodA(struct _jmethodID*, void*, void*, jvalue*, jvalue*, int);
 extern void     KaffeVM_safeCallMethodV(struct _jmethodID*, void*, void*, va_list, jvalue*);
 extern Method*	lookupClassMethod(struct Hjava_lang_Class*, const char*, const char*, bool, struct _errorInfo*);
@@ -185,6 +185,9 @@ registerAsyncSignalHandler(int sig, void* handler)
 		|| (sig == SIGVTALRM) 
 #endif /* defined(SIGVTALRM) */
 		|| (sig == SIGIO)
+#if defined(SIGPROF)
+		|| (sig == SIGPROF)
+#endif
 		|| (sig == SIGUSR1)
 		|| (sig == SIGUSR2)
 		|| (sig == SIGCHLD);
@@ -204,6 +204,9 @@ registerAsyncSignalHandler(int sig, void* handler)
 		|| (sig == SIGVTALRM) 
 #endif
 		|| (sig == SIGIO)
+#if defined(SIGPROF)
+		|| (sig == SIGPROF)
+#endif
 		|| (sig == SIGUSR1)
 		|| (sig == SIGCHLD);
 
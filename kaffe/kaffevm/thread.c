@@ -52,6 +52,9 @@
 #include "jni.h"
 #include "md.h"
 #include "jvmpi_kaffe.h"
+#include "jvmti_kaffe.h"
+#include "stats.h"
+#include "arena.h"
 
 /* If not otherwise specified, assume at least 1MB for main thread */
 #ifndef MAINSTACKSIZE
@@ -120,6 +123,9 @@ KaffeVM_unlinkNativeAndJavaThread(void)
 
 	thread_data->jniEnv = NULL;
 
+	statsReleaseThread(thread_data);
+	arenaReleaseThread(thread_data);
+
 	KSEM(destroy) (&thread_data->sem);
 }
 
@@ -655,6 +661,9 @@ runfinalizer(void)
 		jvmpiPostEvent(&ev);
 	}
 #endif
+	if (JVMTI_EVENT_ISENABLED(JVMTI_EVENT_VM_DEATH)) {
+		jvmtiPostVMDeath();
+	}
 }
 
 /*
@@ -8,6 +8,9 @@
 #include "jni/jnirefs.h"
 #include "ksem.h"
 
+/* Number of critical arrays recorded per thread, see jni-arrays.c */
+#define	JNI_CRITICAL_PINS	8
+
 /*
  * Structure that defines any per-thread data needed by kaffe.
  */
@@ -18,6 +21,11 @@ typedef struct _threadData {
 	/* required by the jnireferences stuff */
 	jnirefs		*jnireferences;
 
+	/* JNI critical regions entered and not left yet, and the arrays
+	 * pinned by the outermost JNI_CRITICAL_PINS of them */
+	int		criticalDepth;
+	void		*criticalPins[JNI_CRITICAL_PINS];
+
 
 	/* things necessary for jvmpi */
 #ifdef ENABLE_JVMPI
@@ -34,6 +42,19 @@ typedef struct _threadData {
 	VmExceptHandler	*exceptPtr;
 	struct Hjava_lang_Throwable *exceptObj;
 	int		needOnStack;
+
+	/* this thread's statistics, see stats.c */
+	struct _statShard *statShard;
+
+	/* bytes left to allocate until the next sample, and the count they
+	 * were drawn as, see allocProfile.c */
+	jlong		allocProfileLeft;
+	jlong		allocProfileInterval;
+
+	/* likewise for VMObjectAlloc, see jvmti_kaffe.c */
+	jlong		jvmtiAllocLeft;
+	/* a chunk kept for the next arena, see arena.c */
+	struct _arenaChunk *arenaChunk;
 } threadData;
 
 #define THREAD_DATA_INITIALIZED(td) ((td)->jniEnv != NULL)
@@ -32,7 +32,6 @@
 #include "verify-block.h"
 #include "verify-debug.h"
 #include "verify-errors.h"
-#include "verify-sigstack.h"
 #include "verify-type.h"
 #include "verify-uninit.h"
 
@@ -45,18 +44,20 @@
  * allocate memory for a block info and fill in with default values
  */
 BlockInfo*
-createBlock(const Method* method)
+createBlock(Verifier* v)
 {
+	const Method* method = v->method;
 	int i;
 	
-	BlockInfo* binfo = checkPtr((BlockInfo*)gc_malloc(sizeof(BlockInfo), KGC_ALLOC_VERIFIER));
+	BlockInfo* binfo = checkPtr((BlockInfo*)arenaAlloc(&v->mem, sizeof(BlockInfo)));
 	
 	binfo->startAddr   = 0;
+	binfo->index       = 0;
 	binfo->status      = IS_INSTRUCTION | START_BLOCK;  /* not VISITED or CHANGED */
 	
 	/* allocate memory for locals */
 	if (method->localsz > 0) {
-		binfo->locals = checkPtr(gc_malloc(method->localsz * sizeof(Type), KGC_ALLOC_VERIFIER));
+		binfo->locals = checkPtr(arenaAlloc(&v->mem, method->localsz * sizeof(Type)));
 		
 		for (i = 0; i < method->localsz; i++) {
 			binfo->locals[i] = *getTUNSTABLE();
@@ -69,7 +70,7 @@ createBlock(const Method* method)
 	/* allocate memory for operand stack */
 	binfo->stacksz = 0;
 	if (method->stacksz > 0) {
-		binfo->opstack = checkPtr(gc_malloc(method->stacksz * sizeof(Type), KGC_ALLOC_VERIFIER));
+		binfo->opstack = checkPtr(arenaAlloc(&v->mem, method->stacksz * sizeof(Type)));
 		
 		for (i = 0; i < method->stacksz; i++) {
 			binfo->opstack[i] = *getTUNSTABLE();
@@ -81,22 +82,6 @@ createBlock(const Method* method)
 	return binfo;
 }
 
-/*
- * frees the memory of a basic block
- */
-void
-freeBlock(BlockInfo* binfo)
-{
-	if (binfo == NULL) return;
-	
-	if (binfo->locals != NULL)
-		gc_free(binfo->locals);
-	if (binfo->opstack != NULL)
-		gc_free(binfo->opstack);
-	
-	gc_free(binfo);
-}
-
 /*
  * copies information from one stack of basic blocks to another
  */
@@ -131,15 +116,22 @@ copyBlockState(const Method* method, BlockInfo* fromBlock, BlockInfo* toBlock)
 }
 
 /*
- * returns which block the given pc is in
+ * returns which block the given pc is in.  the blocks are in the order
+ * of their start addresses, so the last one starting at or before pc is
+ * found by halving.
  */
 BlockInfo*
 inWhichBlock(uint32 pc, BlockInfo** blocks, uint32 numBlocks)
 {
-	uint32 i;
-	for (i = 0; i < numBlocks; i++) {
-		if (pc < blocks[i]->startAddr) continue;
-		if (pc <= blocks[i]->lastAddr) return blocks[i];
+	uint32 lo = 0, hi = numBlocks, mid;
+	
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (blocks[mid]->startAddr <= pc) lo = mid + 1;
+		else                              hi = mid;
+	}
+	if (lo > 0 && pc <= blocks[lo - 1]->lastAddr) {
+		return blocks[lo - 1];
 	}
 	
 	/* shouldn't ever get here unless the specified PC is messed up */
@@ -1123,7 +1115,7 @@ verifyBasicBlock(Verifier* v, BlockInfo* block)
 				type->data.name = namestr;
 			}
 			
-			v->uninits = pushUninit(v->uninits, type);
+			v->uninits = pushUninit(&v->mem, v->uninits, type);
 			type->tinfo = TINFO_UNINIT;
 			type->data.uninit  = v->uninits;
 			
@@ -1152,12 +1144,10 @@ verifyBasicBlock(Verifier* v, BlockInfo* block)
 				
 				sig = CLASS_NAMED(idx, pool);
 				if (*sig == '[') {
-					namestr = checkPtr(gc_malloc(sizeof(char) * (strlen(sig) + 2), KGC_ALLOC_VERIFIER));
-					v->sigs = pushSig(v->sigs, namestr);
+					namestr = checkPtr(arenaAlloc(&v->mem, sizeof(char) * (strlen(sig) + 2)));
 					sprintf(namestr, "[%s", sig);
 				} else {
-					namestr = checkPtr(gc_malloc(sizeof(char) * (strlen(sig) + 4), KGC_ALLOC_VERIFIER));
-					v->sigs = pushSig(v->sigs, namestr);
+					namestr = checkPtr(arenaAlloc(&v->mem, sizeof(char) * (strlen(sig) + 4)));
 					sprintf(namestr, "[L%s;", sig);
 				}
 				
@@ -25,6 +25,9 @@ typedef struct BlockInfo
 	uint32 startAddr;
         uint32 lastAddr;  /* whether it be the address of a GOTO, etc. */
 	
+	/* position in the Verifier's blocks */
+	uint32 index;
+	
         /* status of block...
 	 * changed (needs to be re-evaluated), visited, etc. 
 	 */
@@ -57,12 +60,7 @@ typedef struct BlockInfo
 /*
  * allocate memory for a block info and fill in with default values
  */
-extern BlockInfo* createBlock(const Method* method);
-
-/*
- * frees the memory of a basic block
- */
-extern void freeBlock(BlockInfo* binfo);
+extern BlockInfo* createBlock(struct Verifier* v);
 
 /*
  * copies information from one stack of basic blocks to another
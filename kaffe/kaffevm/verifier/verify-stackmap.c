@@ -0,0 +1,764 @@
+/*
+ * verify-stackmap.c
+ *
+ * Copyright 2026
+ *   Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ *
+ * Type checking of methods that come with a StackMapTable.
+ *
+ * Newer compilers write down the types of the local variables and the
+ * operand stack at every branch target and exception handler.  With those
+ * there is nothing to infer: the code is checked once from start to end,
+ * the state after each instruction flowing into the next one, and every
+ * branch, fall through into a frame and instruction covered by an
+ * exception handler is checked against the frame it goes to.  After an
+ * unconditional branch the next instruction must have a frame, whose
+ * types are taken from then on.
+ *
+ * Runs of instructions between those points are checked by
+ * verifyBasicBlock, the same as blocks are in pass 3b.  Instructions an
+ * exception handler covers are checked one at a time, so that the state
+ * before each can be held against the handler's frame.
+ *
+ * Methods using jsr or ret cannot be checked like this.  If the check
+ * fails for any reason the caller infers the types as for older class
+ * files, as the specification allows for version 50 class files.
+ */
+
+#include "config.h"
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "bytecode.h"
+#include "baseClasses.h"
+#include "classMethod.h"
+#include "code.h"
+#include "constants.h"
+#include "debug.h"
+#include "errors.h"
+#include "exception.h"
+
+#include "verify.h"
+#include "verify-block.h"
+#include "verify-debug.h"
+#include "verify-errors.h"
+#include "verify-type.h"
+#include "verify-uninit.h"
+
+/* verification types in stack map frames */
+#define ITEM_Top                0
+#define ITEM_Integer            1
+#define ITEM_Float              2
+#define ITEM_Double             3
+#define ITEM_Long               4
+#define ITEM_Null               5
+#define ITEM_UninitializedThis  6
+#define ITEM_Object             7
+#define ITEM_Uninitialized      8
+
+/* kinds of stack map frames, by their first byte */
+#define SAME_FRAME_MAX                     63
+#define SAME_LOCALS_1_STACK_ITEM_MAX       127
+#define SAME_LOCALS_1_STACK_ITEM_EXTENDED  247
+#define CHOP_FRAME_MAX                     250
+#define SAME_FRAME_EXTENDED                251
+#define APPEND_FRAME_MAX                   254
+#define FULL_FRAME                         255
+
+/*
+ * the decoded frames of a method
+ */
+typedef struct StackMap
+{
+	/* the frame at each pc, NULL where there is none */
+	BlockInfo** frames;
+
+	/* the uninitialized types frames name, by the pc of their NEW */
+	UninitializedType** uninits;
+
+	/* whether an exception handler covers each pc */
+	uint8* covered;
+
+	/* the local variables of the last frame read, a long or double
+	 * being one entry as in the class file */
+	Type* list;
+	uint32 nlist;
+
+	/* the unread part of the StackMapTable */
+	const u1* p;
+	const u1* end;
+} StackMap;
+
+
+static
+bool
+readU1(Verifier* v, StackMap* sm, uint32* val)
+{
+	if (sm->end - sm->p < 1) {
+		return verifyError(v, "StackMapTable is truncated");
+	}
+	*val = sm->p[0];
+	sm->p += 1;
+	return true;
+}
+
+static
+bool
+readU2(Verifier* v, StackMap* sm, uint32* val)
+{
+	if (sm->end - sm->p < 2) {
+		return verifyError(v, "StackMapTable is truncated");
+	}
+	*val = (sm->p[0] << 8) | sm->p[1];
+	sm->p += 2;
+	return true;
+}
+
+static inline
+bool
+isWideType(const Type* t)
+{
+	return (t->tinfo == TINFO_PRIMITIVE &&
+		(t->data.class == getTLONG()->data.class ||
+		 t->data.class == getTDOUBLE()->data.class));
+}
+
+/*
+ * the type of the class at constant pool index idx, as the instructions
+ * that name classes have it.
+ */
+static
+bool
+classType(Verifier* v, uint32 idx, Type* t)
+{
+	const constants* pool = CLASS_CONSTANTS(v->class);
+	const char* namestr;
+
+	if (CONST_TAG(idx, pool) == CONSTANT_ResolvedClass) {
+		t->tinfo = TINFO_CLASS;
+		t->data.class = CLASS_CLASS(idx, pool);
+	}
+	else if (CONST_TAG(idx, pool) == CONSTANT_Class) {
+		namestr = CLASS_NAMED(idx, pool);
+		t->tinfo = (*namestr == '[') ? TINFO_SIG : TINFO_NAME;
+		t->data.sig = namestr;
+	}
+	else {
+		return verifyError(v, "stack map frame names a class by a constant that is not a class");
+	}
+	return true;
+}
+
+/*
+ * the uninitialized type of the object created by the NEW at pc.  all
+ * frames naming it share one, as all copies of an object made by one
+ * NEW share one in pass 3b.
+ */
+static
+bool
+uninitializedType(Verifier* v, StackMap* sm, uint32 pc, Type* t)
+{
+	const unsigned char* code = METHOD_BYTECODE_CODE(v->method);
+	Type created;
+
+	if (pc >= METHOD_BYTECODE_LEN(v->method) ||
+	    !(v->status[pc] & IS_INSTRUCTION) || code[pc] != NEW) {
+		return verifyError(v, "uninitialized type in a stack map frame does not refer to a new instruction");
+	}
+
+	if (sm->uninits[pc] == NULL) {
+		if (!classType(v, getWIdx(code, pc), &created)) {
+			return false;
+		}
+		v->uninits = pushUninit(&v->mem, v->uninits, &created);
+		sm->uninits[pc] = v->uninits;
+	}
+
+	t->tinfo = TINFO_UNINIT;
+	t->data.uninit = sm->uninits[pc];
+	return true;
+}
+
+/*
+ * reads one verification type into t.
+ */
+static
+bool
+readType(Verifier* v, StackMap* sm, Type* t)
+{
+	const Type* initialThis;
+	uint32 tag, n;
+
+	if (!readU1(v, sm, &tag)) {
+		return false;
+	}
+
+	switch (tag) {
+	case ITEM_Top:     *t = *getTUNSTABLE(); break;
+	case ITEM_Integer: *t = *getTINT();      break;
+	case ITEM_Float:   *t = *getTFLOAT();    break;
+	case ITEM_Double:  *t = *getTDOUBLE();   break;
+	case ITEM_Long:    *t = *getTLONG();     break;
+	case ITEM_Null:    *t = *getTNULL();     break;
+
+	case ITEM_UninitializedThis:
+		/* the one loadInitialArgs made for the receiver of <init> */
+		initialThis = (v->method->localsz > 0) ? &v->blocks[0]->locals[0] : NULL;
+		if (initialThis == NULL || initialThis->tinfo != TINFO_UNINIT_SUPER) {
+			return verifyError(v, "uninitializedThis in a stack map frame outside of a constructor");
+		}
+		*t = *initialThis;
+		break;
+
+	case ITEM_Object:
+		if (!readU2(v, sm, &n)) {
+			return false;
+		}
+		return classType(v, n, t);
+
+	case ITEM_Uninitialized:
+		if (!readU2(v, sm, &n)) {
+			return false;
+		}
+		return uninitializedType(v, sm, n, t);
+
+	default:
+		return verifyError(v, "unknown verification type in a stack map frame");
+	}
+	return true;
+}
+
+/*
+ * reads one verification type onto the operand stack of frame.
+ */
+static
+bool
+readStackItem(Verifier* v, StackMap* sm, BlockInfo* frame)
+{
+	Type t;
+	uint32 width;
+
+	if (!readType(v, sm, &t)) {
+		return false;
+	}
+	width = isWideType(&t) ? 2 : 1;
+	if (frame->stacksz + width > v->method->stacksz) {
+		return verifyError(v, "stack map frame holds more than the operand stack can");
+	}
+	frame->opstack[frame->stacksz++] = t;
+	if (width == 2) {
+		frame->opstack[frame->stacksz++] = *getTWIDE();
+	}
+	return true;
+}
+
+/*
+ * reads one verification type onto the end of the local variables.
+ */
+static
+bool
+readLocal(Verifier* v, StackMap* sm)
+{
+	if (sm->nlist >= v->method->localsz) {
+		return verifyError(v, "stack map frame holds more than the local variables can");
+	}
+	return readType(v, sm, &sm->list[sm->nlist++]);
+}
+
+/*
+ * lays the local variables of the last frame read out in frame, a long
+ * or double taking two.  those not listed are unusable.
+ */
+static
+bool
+expandLocals(Verifier* v, StackMap* sm, BlockInfo* frame)
+{
+	uint32 i, n;
+
+	for (i = 0, n = 0; i < sm->nlist; i++) {
+		if (n + (isWideType(&sm->list[i]) ? 2 : 1) > v->method->localsz) {
+			return verifyError(v, "stack map frame holds more than the local variables can");
+		}
+		frame->locals[n++] = sm->list[i];
+		if (isWideType(&sm->list[i])) {
+			frame->locals[n++] = *getTWIDE();
+		}
+	}
+	return true;
+}
+
+/*
+ * the local variables the method starts with, as a frame would list them.
+ */
+static
+void
+listInitialLocals(Verifier* v, StackMap* sm)
+{
+	const BlockInfo* initial = v->blocks[0];
+	uint32 n, last;
+
+	sm->nlist = 0;
+	for (last = v->method->localsz; last > 0; last--) {
+		if (!sameType(&initial->locals[last - 1], getTUNSTABLE())) {
+			break;
+		}
+	}
+	for (n = 0; n < last; n++) {
+		if (!isWide(&initial->locals[n])) {
+			sm->list[sm->nlist++] = initial->locals[n];
+		}
+	}
+}
+
+/*
+ * decodes the StackMapTable of the method into a frame for each pc that
+ * has one.
+ */
+static
+bool
+readStackMap(Verifier* v, StackMap* sm)
+{
+	const stackMapTable* smt = v->method->stackmap;
+	const uint32 codelen = METHOD_BYTECODE_LEN(v->method);
+	const jexception* handlers = v->method->exception_table;
+	BlockInfo* frame;
+	uint32 i, n, pc, type, delta, count;
+
+	sm->frames = checkPtr(arenaAlloc(&v->mem, codelen * sizeof(BlockInfo*)));
+	sm->uninits = checkPtr(arenaAlloc(&v->mem, codelen * sizeof(UninitializedType*)));
+	sm->covered = checkPtr(arenaAlloc(&v->mem, codelen * sizeof(uint8)));
+	sm->list = checkPtr(arenaAlloc(&v->mem, (v->method->localsz + 1) * sizeof(Type)));
+	sm->p = smt->data;
+	sm->end = smt->data + smt->length;
+
+	if (handlers != NULL) {
+		for (i = 0; i < handlers->length; i++) {
+			for (pc = handlers->entry[i].start_pc; pc < handlers->entry[i].end_pc; pc++) {
+				sm->covered[pc] = 1;
+			}
+		}
+	}
+
+	listInitialLocals(v, sm);
+
+	for (i = 0, pc = 0; i < smt->nframes; i++) {
+		frame = createBlock(v);
+
+		if (!readU1(v, sm, &type)) {
+			return false;
+		}
+		if (type <= SAME_FRAME_MAX) {
+			delta = type;
+		}
+		else if (type <= SAME_LOCALS_1_STACK_ITEM_MAX) {
+			delta = type - (SAME_FRAME_MAX + 1);
+			if (!readStackItem(v, sm, frame)) {
+				return false;
+			}
+		}
+		else if (type < SAME_LOCALS_1_STACK_ITEM_EXTENDED) {
+			return verifyError(v, "reserved stack map frame type");
+		}
+		else {
+			if (!readU2(v, sm, &delta)) {
+				return false;
+			}
+
+			if (type == SAME_LOCALS_1_STACK_ITEM_EXTENDED) {
+				if (!readStackItem(v, sm, frame)) {
+					return false;
+				}
+			}
+			else if (type <= CHOP_FRAME_MAX) {
+				count = SAME_FRAME_EXTENDED - type;
+				if (count > sm->nlist) {
+					return verifyError(v, "stack map frame chops more local variables than there are");
+				}
+				sm->nlist -= count;
+			}
+			else if (type <= APPEND_FRAME_MAX) {
+				for (count = type - SAME_FRAME_EXTENDED; count > 0; count--) {
+					if (!readLocal(v, sm)) {
+						return false;
+					}
+				}
+			}
+			else if (type == FULL_FRAME) {
+				if (!readU2(v, sm, &count)) {
+					return false;
+				}
+				for (sm->nlist = 0; count > 0; count--) {
+					if (!readLocal(v, sm)) {
+						return false;
+					}
+				}
+				if (!readU2(v, sm, &count)) {
+					return false;
+				}
+				for (; count > 0; count--) {
+					if (!readStackItem(v, sm, frame)) {
+						return false;
+					}
+				}
+			}
+		}
+
+		/* the first frame is at its delta, the others one past */
+		pc = (i == 0) ? delta : pc + delta + 1;
+		if (pc >= codelen || !(v->status[pc] & IS_INSTRUCTION)) {
+			return verifyError(v, "stack map frame is not at an instruction");
+		}
+		if (!expandLocals(v, sm, frame)) {
+			return false;
+		}
+
+		frame->startAddr = pc;
+		sm->frames[pc] = frame;
+
+		DBG(VERIFY3,
+		    dprintf("        stack map frame at %d:\n", pc);
+		    printBlock(v->method, frame, "                 ");
+		    );
+	}
+
+	if (sm->p != sm->end) {
+		return verifyError(v, "StackMapTable has bytes after its last frame");
+	}
+
+	/* every exception handler must have a frame */
+	if (handlers != NULL) {
+		for (n = 0; n < handlers->length; n++) {
+			if (sm->frames[handlers->entry[n].handler_pc] == NULL) {
+				return verifyError(v, "exception handler has no stack map frame");
+			}
+		}
+	}
+	return true;
+}
+
+
+/*
+ * whether a value of type actual may be where a frame has expected.
+ */
+static
+bool
+frameAccepts(Verifier* v, Type* expected, Type* actual)
+{
+	if (sameType(expected, getTUNSTABLE())) {
+		/* an unusable slot takes anything */
+		return true;
+	}
+	else if (expected->tinfo == TINFO_SYSTEM || IS_PRIMITIVE_TYPE(expected)) {
+		return sameType(expected, actual);
+	}
+	else if (expected->tinfo & TINFO_UNINIT) {
+		return (actual->tinfo == expected->tinfo && sameType(expected, actual));
+	}
+	else if (isNull(expected)) {
+		return isNull(actual);
+	}
+	else if (!isReference(actual) || actual->tinfo & TINFO_UNINIT) {
+		return false;
+	}
+	else if (isNull(actual)) {
+		return true;
+	}
+
+	/* any reference may be where an interface is expected, as the
+	 * language has the check made when the interface is used */
+	resolveType(v, expected);
+	if (expected->data.class == NULL) {
+		return false;
+	}
+	if (CLASS_IS_INTERFACE(expected->data.class)) {
+		return true;
+	}
+	return typecheck(v, expected, actual);
+}
+
+/*
+ * whether the state of block may flow into frame.
+ */
+static
+bool
+frameAcceptsBlock(Verifier* v, BlockInfo* frame, BlockInfo* block)
+{
+	uint32 n;
+
+	if (frame->stacksz != block->stacksz) {
+		return verifyError(v, "operand stack size does not match the stack map frame");
+	}
+	for (n = 0; n < v->method->localsz; n++) {
+		if (!frameAccepts(v, &frame->locals[n], &block->locals[n])) {
+			return verifyError(v, "local variable does not match the stack map frame");
+		}
+	}
+	for (n = 0; n < block->stacksz; n++) {
+		if (!frameAccepts(v, &frame->opstack[n], &block->opstack[n])) {
+			return verifyError(v, "operand stack does not match the stack map frame");
+		}
+	}
+	return true;
+}
+
+static
+bool
+checkBranch(Verifier* v, StackMap* sm, BlockInfo* block, uint32 target)
+{
+	if (sm->frames[target] == NULL) {
+		return verifyError(v, "branch target has no stack map frame");
+	}
+	return frameAcceptsBlock(v, sm->frames[target], block);
+}
+
+/*
+ * checks the state before the instruction at pc against the frames of
+ * the exception handlers covering it.  the operand stack of a handler
+ * holds the exception alone.
+ */
+static
+bool
+checkHandlers(Verifier* v, StackMap* sm, BlockInfo* block, uint32 pc)
+{
+	const jexception* handlers = v->method->exception_table;
+	const jexceptionEntry* entry;
+	BlockInfo* frame;
+	Type caught;
+	uint32 i, n;
+
+	for (i = 0; i < handlers->length; i++) {
+		entry = &handlers->entry[i];
+		if (pc < entry->start_pc || pc >= entry->end_pc) {
+			continue;
+		}
+
+		frame = sm->frames[entry->handler_pc];
+		if (frame->stacksz != 1) {
+			return verifyError(v, "stack map frame of an exception handler must hold the exception alone");
+		}
+
+		if (entry->catch_idx == 0) {
+			caught.tinfo = TINFO_NAME;
+			caught.data.name = "java/lang/Throwable";
+		}
+		else if (!classType(v, entry->catch_idx, &caught)) {
+			return false;
+		}
+		if (!frameAccepts(v, &frame->opstack[0], &caught)) {
+			return verifyError(v, "stack map frame of an exception handler does not take its exceptions");
+		}
+
+		for (n = 0; n < v->method->localsz; n++) {
+			if (!frameAccepts(v, &frame->locals[n], &block->locals[n])) {
+				return verifyError(v, "local variable does not match the stack map frame of an exception handler");
+			}
+		}
+	}
+	return true;
+}
+
+/*
+ * the pc of the opcode of the instruction starting at pc, which is past
+ * the WIDE that modifies it if there is one.
+ */
+static inline
+uint32
+opcodeAt(const unsigned char* code, uint32 pc)
+{
+	return (code[pc] == WIDE) ? pc + 1 : pc;
+}
+
+static
+uint32
+nextInstruction(const Verifier* v, uint32 pc)
+{
+	const uint32 codelen = METHOD_BYTECODE_LEN(v->method);
+
+	for (pc++; pc < codelen; pc++) {
+		if (v->status[pc] & IS_INSTRUCTION) break;
+	}
+	return pc;
+}
+
+/*
+ * the opcode of the last instruction to check along with the one at pc:
+ * the run ends at a branch, before a frame, and at or before an
+ * instruction an exception handler covers.
+ */
+static
+uint32
+runEnd(const Verifier* v, const StackMap* sm, uint32 pc)
+{
+	const uint32 codelen = METHOD_BYTECODE_LEN(v->method);
+	const unsigned char* code = METHOD_BYTECODE_CODE(v->method);
+	uint32 next;
+
+	for (;;) {
+		next = nextInstruction(v, pc);
+		if (next >= codelen || v->status[pc] & END_BLOCK ||
+		    sm->covered[pc] || sm->covered[next] || sm->frames[next] != NULL) {
+			return opcodeAt(code, pc);
+		}
+		pc = next;
+	}
+}
+
+/*
+ * checks the branches of the instruction whose opcode is at pc, and
+ * records whether execution may go on to the next one.
+ */
+static
+bool
+checkSuccessors(Verifier* v, StackMap* sm, BlockInfo* block, uint32 pc, bool* fallsThrough)
+{
+	const unsigned char* code = METHOD_BYTECODE_CODE(v->method);
+	uint32 n, newpc;
+	int32 low, high;
+
+	*fallsThrough = false;
+
+	switch (code[pc]) {
+	case GOTO:
+		return checkBranch(v, sm, block, pc + getWord(code, pc + 1));
+
+	case GOTO_W:
+		return checkBranch(v, sm, block, pc + getDWord(code, pc + 1));
+
+	case JSR:
+	case JSR_W:
+	case RET:
+		return verifyError(v, "jsr and ret cannot be type checked with stack map frames");
+
+	case IF_ACMPEQ:  case IFNONNULL:
+	case IF_ACMPNE:  case IFNULL:
+	case IF_ICMPEQ:  case IFEQ:
+	case IF_ICMPNE:	 case IFNE:
+	case IF_ICMPGT:	 case IFGT:
+	case IF_ICMPGE:	 case IFGE:
+	case IF_ICMPLT:	 case IFLT:
+	case IF_ICMPLE:	 case IFLE:
+		*fallsThrough = true;
+		return checkBranch(v, sm, block, pc + getWord(code, pc + 1));
+
+	case LOOKUPSWITCH:
+	        /* default branch...between 0 and 3 bytes of padding are added so that the
+		 * default branch is at an address that is divisible by 4
+		 */
+		n = (pc + 1) % 4;
+		if (n) n = pc + 5 - n;
+		else   n = pc + 1;
+		if (!checkBranch(v, sm, block, pc + getDWord(code, n))) {
+			return false;
+		}
+
+		n += 4;
+		low = getDWord(code, n);
+		for (n += 4, high = n + 8*low; n < (uint32)high; n += 8) {
+			if (!checkBranch(v, sm, block, pc + getDWord(code, n + 4))) {
+				return false;
+			}
+		}
+		return true;
+
+	case TABLESWITCH:
+		n = (pc + 1) % 4;
+		if (n) n = pc + 5 - n;
+		else   n = pc + 1;
+		newpc = pc + getDWord(code, n);
+		if (!checkBranch(v, sm, block, newpc)) {
+			return false;
+		}
+
+		low  = getDWord(code, n + 4);
+		high = getDWord(code, n + 8);
+		n += 12;
+		for (high = n + 4*(high - low + 1); n < (uint32)high; n += 4) {
+			if (!checkBranch(v, sm, block, pc + getDWord(code, n))) {
+				return false;
+			}
+		}
+		return true;
+
+	case RETURN:
+	case ARETURN:
+	case IRETURN:
+	case FRETURN:
+	case LRETURN:
+	case DRETURN:
+	case ATHROW:
+		return true;
+
+	default:
+		*fallsThrough = true;
+		return true;
+	}
+}
+
+/*
+ * verifyMethodStackMap()
+ *    Type checks the method of v against its StackMapTable in one pass.
+ *    Pass 3a must have been run and the initial arguments loaded.
+ */
+bool
+verifyMethodStackMap(Verifier* v)
+{
+	const uint32 codelen = METHOD_BYTECODE_LEN(v->method);
+	StackMap sm;
+	BlockInfo* block;
+	uint32 pc, last;
+	bool fallsThrough;
+
+	DBG(VERIFY3, dprintf("    Verifier Pass 3b: Type Checking with the StackMapTable...\n"); );
+
+	if (!readStackMap(v, &sm)) {
+		return false;
+	}
+
+	block = createBlock(v);
+	copyBlockState(v->method, v->blocks[0], block);
+	fallsThrough = true;
+
+	for (pc = 0; pc < codelen; pc = nextInstruction(v, last)) {
+		if (sm.frames[pc] != NULL) {
+			if (fallsThrough && !frameAcceptsBlock(v, sm.frames[pc], block)) {
+				return false;
+			}
+			copyBlockState(v->method, sm.frames[pc], block);
+		}
+		else if (!fallsThrough) {
+			return verifyError(v, "instruction after an unconditional branch has no stack map frame");
+		}
+
+		if (sm.covered[pc] && !checkHandlers(v, &sm, block, pc)) {
+			return false;
+		}
+
+		last = runEnd(v, &sm, pc);
+		block->startAddr = pc;
+		block->lastAddr  = last;
+
+		DBG(VERIFY3,
+		    dprintf("      checking pc %d to %d from:\n", pc, last);
+		    printBlock(v->method, block, "                 ");
+		    );
+
+		if (!verifyBasicBlock(v, block)) {
+			return verifyError(v, "failure to verify basic block");
+		}
+		if (!checkSuccessors(v, &sm, block, last, &fallsThrough)) {
+			return false;
+		}
+	}
+
+	if (fallsThrough) {
+		return verifyError(v, "execution falls off the end of the code");
+	}
+
+	DBG(VERIFY3, dprintf("    Verifier Pass 3b: Complete\n"); );
+	return true;
+}
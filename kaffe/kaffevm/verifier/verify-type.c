@@ -262,34 +262,215 @@ initVerifierPrimTypes(void)
 }
 
 
+/*
+ * The types met while verifying a method are interned: each class named
+ * by a signature or name is resolved once, and the outcome of merging a
+ * pair of resolved types is remembered.  Loops merge the same types into
+ * the same blocks each time round, and the same classes are named all
+ * through a method, so both are looked up here before asking the class
+ * loader or walking the class hierarchies again.  The tables are open
+ * addressed, live in the Verifier's arena and go away with it.
+ */
+#define TYPECACHE_MIN 64
+
+typedef struct InternedClass
+{
+	const char* name;	/* as CLASS_CNAME has it, not a signature */
+	uint32 len;
+	uint32 hash;
+	Hjava_lang_Class* class;
+} InternedClass;
+
+typedef struct MergedTypes
+{
+	const void* from;	/* the class or supertype set merged... */
+	const void* into;	/* ...into this one */
+	Type result;
+	bool changed;
+} MergedTypes;
+
+typedef struct TypeCache
+{
+	uint32 nclasses;
+	uint32 classesSize;	/* a power of two */
+	InternedClass* classes;
+	
+	uint32 nmerges;
+	uint32 mergesSize;	/* a power of two */
+	MergedTypes* merges;
+} TypeCache;
+
+static
+TypeCache*
+getTypeCache(Verifier* v)
+{
+	if (v->types == NULL) {
+		v->types = checkPtr(arenaAlloc(&v->mem, sizeof(TypeCache)));
+	}
+	return v->types;
+}
+
+static
+uint32
+hashName(const char* name, uint32 len)
+{
+	uint32 h = 2166136261U;
+	uint32 i;
+	
+	for (i = 0; i < len; i++) {
+		h = (h ^ (unsigned char)name[i]) * 16777619U;
+	}
+	return h;
+}
+
+static
+uint32
+hashPair(const void* a, const void* b)
+{
+	return (uint32)(((uintp)a >> 3) * 31 + ((uintp)b >> 3));
+}
+
+/*
+ * returns the slot for name in tc's classes: the one holding it, or the
+ * empty one it would go into.  there is always an empty slot.
+ */
+static
+InternedClass*
+findInterned(TypeCache* tc, const char* name, uint32 len, uint32 hash)
+{
+	uint32 mask = tc->classesSize - 1;
+	uint32 i;
+	InternedClass* ic;
+	
+	for (i = hash & mask; ; i = (i + 1) & mask) {
+		ic = &tc->classes[i];
+		if (ic->name == NULL ||
+		    (ic->hash == hash && ic->len == len && !memcmp(ic->name, name, len))) {
+			return ic;
+		}
+	}
+}
+
+static
+MergedTypes*
+findMerge(TypeCache* tc, const void* from, const void* into)
+{
+	uint32 mask = tc->mergesSize - 1;
+	uint32 i;
+	MergedTypes* m;
+	
+	for (i = hashPair(from, into) & mask; ; i = (i + 1) & mask) {
+		m = &tc->merges[i];
+		if (m->from == NULL || (m->from == from && m->into == into)) {
+			return m;
+		}
+	}
+}
+
+/*
+ * makes room for one more class or merger, keeping the tables at most
+ * three quarters full.
+ */
+static
+void
+growClasses(Verifier* v, TypeCache* tc)
+{
+	InternedClass* old = tc->classes;
+	uint32 oldSize = tc->classesSize;
+	uint32 i;
+	
+	if (4 * (tc->nclasses + 1) <= 3 * tc->classesSize) {
+		return;
+	}
+	tc->classesSize = (oldSize == 0) ? TYPECACHE_MIN : 2 * oldSize;
+	tc->classes = checkPtr(arenaAlloc(&v->mem, tc->classesSize * sizeof(InternedClass)));
+	for (i = 0; i < oldSize; i++) {
+		if (old[i].name != NULL) {
+			*findInterned(tc, old[i].name, old[i].len, old[i].hash) = old[i];
+		}
+	}
+}
+
+static
+void
+growMerges(Verifier* v, TypeCache* tc)
+{
+	MergedTypes* old = tc->merges;
+	uint32 oldSize = tc->mergesSize;
+	uint32 i;
+	
+	if (4 * (tc->nmerges + 1) <= 3 * tc->mergesSize) {
+		return;
+	}
+	tc->mergesSize = (oldSize == 0) ? TYPECACHE_MIN : 2 * oldSize;
+	tc->merges = checkPtr(arenaAlloc(&v->mem, tc->mergesSize * sizeof(MergedTypes)));
+	for (i = 0; i < oldSize; i++) {
+		if (old[i].from != NULL) {
+			*findMerge(tc, old[i].from, old[i].into) = old[i];
+		}
+	}
+}
+
 /**
  *  If the given type is a simply a signature or class name, we
  *  resolve it to be a pointer to an actual Class object in memory.
+ *  Each class is only asked of the class loader once per method.
  */
 void
 resolveType(Verifier* v, Type *t)
 {
-	if (t->tinfo & TINFO_SIG ||
-	    *t->data.name == '[') {
-		
+	TypeCache* tc;
+	InternedClass* ic;
+	const char* name;
+	const char* sig;
+	char* tmp;
+	uint32 len, hash;
+	
+	if (!(t->tinfo & (TINFO_SIG | TINFO_NAME))) {
+		return;
+	}
+	
+	/* "Ljava/lang/String;" and "java/lang/String" are interned alike,
+	 * array signatures such as "[I" are names as well */
+	sig = name = t->data.sig;
+	len = strlen(name);
+	if (t->tinfo & TINFO_SIG && *name == 'L') {
+		name++;
+		len -= 2;
+	}
+	hash = hashName(name, len);
+	
+	tc = getTypeCache(v);
+	growClasses(v, tc);
+	ic = findInterned(tc, name, len, hash);
+	if (ic->name != NULL) {
 		t->tinfo = TINFO_CLASS;
-		t->data.class = getClassFromSignature(t->data.sig, v->class->loader, v->einfo);	    
+		t->data.class = ic->class;
+		return;
 	}
-	else if (t->tinfo & TINFO_NAME) {
-		char* tmp = NULL;
-		const char* sig = t->data.name;
-		
-		tmp = checkPtr(gc_malloc((strlen(sig) + 3) * sizeof(char), KGC_ALLOC_VERIFIER));
-		sprintf(tmp, "L%s;", sig);
+	
+	if (t->tinfo & TINFO_NAME && *name != '[') {
+		tmp = checkPtr(arenaAlloc(&v->mem, (len + 3) * sizeof(char)));
+		sprintf(tmp, "L%s;", name);
 		sig = tmp;
 		
 		DBG(VERIFY3, dprintf("%s    converted name to sig \"%s\" and about to load...\n", indent, sig); );
-		t->tinfo = TINFO_CLASS;
-		t->data.class = getClassFromSignature(sig, v->class->loader, v->einfo);
-		
-		if (tmp) {
-			gc_free(tmp);
-		}
+	}
+	t->tinfo = TINFO_CLASS;
+	t->data.class = getClassFromSignature(sig, v->class->loader, v->einfo);
+	
+	/* failures are not remembered, the verification ends with them.
+	 * The name may live in a constant pool entry or a buffer of the
+	 * caller, so the key is a copy that lasts as long as the cache. */
+	if (t->data.class != NULL) {
+		tmp = checkPtr(arenaAlloc(&v->mem, (len + 1) * sizeof(char)));
+		memcpy(tmp, name, len);
+		tmp[len] = '\0';
+		ic->name = tmp;
+		ic->len = len;
+		ic->hash = hash;
+		ic->class = t->data.class;
+		tc->nclasses++;
 	}
 }
 
@@ -309,12 +490,12 @@ createSupertypeSet(Verifier* v,
 		   Hjava_lang_Class** interfaces_b)
 {
 	uint32 i, j;
-	SupertypeSet* set = checkPtr(gc_malloc(sizeof(SupertypeSet), KGC_ALLOC_VERIFIER));
+	SupertypeSet* set = checkPtr(arenaAlloc(&v->mem, sizeof(SupertypeSet)));
 	
 	(num_interfaces_a > num_interfaces_b) ?
 		(i = num_interfaces_a + 1) :
 		(i = num_interfaces_b + 1) ;
-	set->list = checkPtr(gc_malloc(i * sizeof(Hjava_lang_Class*), KGC_ALLOC_VERIFIER));
+	set->list = checkPtr(arenaAlloc(&v->mem, i * sizeof(Hjava_lang_Class*)));
 	
 	set->list[0] = getCommonSuperclass(class_a, class_b);
 	set->count = 1;
@@ -373,22 +554,62 @@ mergeSupersets(Verifier* v, Type* t1, Type* t2)
 	
 }
 
-/**
- * Frees all the memory allocated during the creation of the
- * given SupertypeSet.
- *
- * @param supertypes The supertype list to be deallocated.
- * @deffunc void freeSupertypes (SupertypeSet* supertypes)
+/*
+ * the class or supertype set a resolved reference type stands for
+ */
+static inline
+const void*
+typeKey(const Type* t)
+{
+	if (t->tinfo & TINFO_SUPERTYPES) {
+		return t->data.supertypes;
+	}
+	return t->data.class;
+}
+
+/*
+ * works out what merging t1 into t2 gives and whether it is a change.
+ * both are TINFO_CLASS or TINFO_SUPERTYPES.
  */
+static
 void
-freeSupertypes(SupertypeSet* supertypes)
+mergeRefTypes(Verifier* v, Type* t1, Type* t2, MergedTypes* m)
 {
-	SupertypeSet* l;
-	while (supertypes) {
-		l = supertypes->next;
-		gc_free(supertypes->list);
-		gc_free(supertypes);
-		supertypes = l;
+	m->changed = true;
+	
+	if (t1->tinfo & TINFO_SUPERTYPES) {
+		if (t2->tinfo & TINFO_SUPERTYPES)
+			mergeSupersets(v, t1, t2);
+		else
+			mergeClassAndSuperset(v, t2, t1);
+	}
+	else if (t2->tinfo & TINFO_SUPERTYPES) {
+		mergeClassAndSuperset(v, t1, t2);
+	}
+	else {
+		/* both are TINFO_CLASS */
+		if (instanceof(t1->data.class, t2->data.class)) {
+			m->result = *t1;
+			return;
+		}
+		else if (instanceof(t2->data.class, t1->data.class)) {
+			m->result = *t2;
+			m->changed = false;
+			return;
+		}
+		else {
+			DBG(VERIFY3, dprintf("HERE\n"); );
+			mergeClassesIntoSuperset(v, t1, t2);
+		}
+	}
+	
+	if (v->supertypes->count == 1) {
+		m->result.tinfo = TINFO_CLASS;
+		m->result.data.class = v->supertypes->list[0];
+	}
+	else {
+		m->result.tinfo = TINFO_SUPERTYPES;
+		m->result.data.supertypes = v->supertypes;
 	}
 }
 
@@ -402,6 +623,9 @@ freeSupertypes(SupertypeSet* supertypes)
 bool
 mergeTypes(Verifier* v, Type* t1, Type* t2)
 {
+	TypeCache* tc;
+	MergedTypes* m;
+	
 	if (IS_ADDRESS(t1) || IS_ADDRESS(t2)) {
 	        /* if one of the types is TADDR, the other one must also be TADDR */
 		if (t1->tinfo != t2->tinfo) {
@@ -433,40 +657,21 @@ mergeTypes(Verifier* v, Type* t1, Type* t2)
 	
 	
 	/* at this point, t1 and t2 are either TINFO_CLASS or
-	 * TINFO_SUPERTYPES */
-	if (t1->tinfo & TINFO_SUPERTYPES) {
-		if (t2->tinfo & TINFO_SUPERTYPES)
-			mergeSupersets(v, t1, t2);
-		else
-			mergeClassAndSuperset(v, t2, t1);
-	}
-	else if (t2->tinfo & TINFO_SUPERTYPES) {
-		mergeClassAndSuperset(v, t1, t2);
-	}
-	else {
-		/* both are TINFO_CLASS */
-		if (instanceof(t1->data.class, t2->data.class)) {
-			*t2 = *t1;
-			return true;
-		}
-		else if (instanceof(t2->data.class, t1->data.class)) {
-			return false;
-		}
-		else {
-			DBG(VERIFY3, dprintf("HERE\n"); );
-			mergeClassesIntoSuperset(v, t1, t2);
-		}
+	 * TINFO_SUPERTYPES, and each is known by its class or set */
+	tc = getTypeCache(v);
+	growMerges(v, tc);
+	m = findMerge(tc, typeKey(t1), typeKey(t2));
+	if (m->from == NULL) {
+		m->from = typeKey(t1);
+		m->into = typeKey(t2);
+		mergeRefTypes(v, t1, t2, m);
+		tc->nmerges++;
 	}
 	
-	if (v->supertypes->count == 1) {
-		t2->tinfo = TINFO_CLASS;
-		t2->data.class = v->supertypes->list[0];
-	}
-	else {
-		t2->tinfo = TINFO_SUPERTYPES;
-		t2->data.supertypes = v->supertypes;
+	if (m->changed) {
+		*t2 = m->result;
 	}
-	return true;
+	return m->changed;
 }
 
 /*
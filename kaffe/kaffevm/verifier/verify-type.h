@@ -150,7 +150,6 @@ extern void createSupertypeSet(struct Verifier* v,
 			       Hjava_lang_Class* class_b,
 			       uint32 num_interfaces_b,
 			       Hjava_lang_Class** interfaces_b);
-extern void freeSupertypes(SupertypeSet* supertypes);
 
 
 #endif /* !defined(VERIFY_TYPE_H) */
@@ -46,9 +46,9 @@ checkUninit(Hjava_lang_Class* this, Type* type)
  *    uninits is the front of the list to be added onto.
  */
 UninitializedType*
-pushUninit(UninitializedType* uninits, const Type* type)
+pushUninit(arena* mem, UninitializedType* uninits, const Type* type)
 {
-	UninitializedType* uninit = checkPtr(gc_malloc(sizeof(UninitializedType), KGC_ALLOC_VERIFIER));
+	UninitializedType* uninit = checkPtr(arenaAlloc(mem, sizeof(UninitializedType)));
 	uninit->type = *type;
 	uninit->prev = NULL;
 	
@@ -92,21 +92,4 @@ popUninit(const Method* method, UninitializedType* uninit, BlockInfo* binfo)
 	if (uninit->next) {
 		uninit->next->prev = uninit->prev;
 	}
-	
-	gc_free(uninit);
-}
-
-/*
- * freeUninits
- *    frees a list of unitialized types
- */
-void
-freeUninits(UninitializedType* uninits)
-{
-	UninitializedType* tmp;
-	while (uninits) {
-		tmp = uninits->next;
-		gc_free(uninits);
-		uninits = tmp;
-	}
 }
@@ -15,6 +15,7 @@
 
 #include "verify-type.h"
 #include "verify-block.h"
+#include "arena.h"
 
 /*
  * holds the list of uninitialized items.  that way, if we DUP some uninitialized
@@ -45,7 +46,7 @@ extern bool checkUninit(Hjava_lang_Class* this, Type* type);
  *
  *    uninits is the front of the list to be added onto.
  */
-extern UninitializedType* pushUninit(UninitializedType* uninits, const Type* type);
+extern UninitializedType* pushUninit(arena* mem, UninitializedType* uninits, const Type* type);
 
 /*
  * popUninit()
@@ -53,11 +54,4 @@ extern UninitializedType* pushUninit(UninitializedType* uninits, const Type* typ
  */
 extern void popUninit(const Method* method, UninitializedType* uninit, BlockInfo* binfo);
 
-/*
- * freeUninits
- *    frees a list of unitialized types
- */
-
-extern void freeUninits(UninitializedType* uninits);
-
 #endif /* !defined(VERIFY_UNINIT_H) */
@@ -37,12 +37,12 @@
 #include "errors.h"
 #include "itypes.h"
 #include "lookup.h"
+#include "stats.h"
 #include "utf8const.h"
 
 #include "verify.h"
 #include "verify-block.h"
 #include "verify-debug.h"
-#include "verify-sigstack.h"
 #include "verify-type.h"
 #include "verify-uninit.h"
 #include "verify-errors.h"
@@ -232,6 +232,7 @@ const uint8 insnLen[256] = {
  ***********************************************************************************/
 static bool               verifyMethod(errorInfo* einfo,
 				       Method* method);
+static bool               prepareVerifier(Verifier* v);
 static bool               loadInitialArgs(Verifier* v);
 
 
@@ -334,16 +335,14 @@ void
 freeVerifierData(Verifier* v)
 {
 	DBG(VERIFY3, dprintf("    cleaning up..."); );
-	gc_free(v->status);
-	if (v->blocks != NULL) {
-		while (v->numBlocks > 0) {
-			freeBlock(v->blocks[--v->numBlocks]);
-		}
-		gc_free(v->blocks);
-	}
-        freeSigStack(v->sigs);
-        freeUninits(v->uninits);
-	freeSupertypes(v->supertypes);
+	arenaRelease(&v->mem);
+	v->status = NULL;
+	v->blocks = NULL;
+	v->changed = NULL;
+	v->numBlocks = 0;
+	v->uninits = NULL;
+	v->supertypes = NULL;
+	v->types = NULL;
         DBG(VERIFY3, dprintf(" done\n"); );
 }
 
@@ -362,44 +361,29 @@ failInVerifyMethod(Verifier* v)
 }
 
 /*
- * Controls the verification of a single method.  It allocates most of the memory needed for
- * verification (when encountering JSRs, more memory will need to be allocated later),
- * loads the initial arguments, calls pass3a, then calls pass3b and cleans up.
+ * Finds the basic blocks of the method and loads its initial arguments,
+ * ready for type checking.
  */
 static
 bool
-verifyMethod(errorInfo *einfo, Method* method)
+prepareVerifier(Verifier* v)
 {
-        /* to save some typing, etc. */
-	int codelen  = METHOD_BYTECODE_LEN(method);
-	
-	Verifier v;
-	v.einfo = einfo;
-	v.class = method->class;
-	v.method = method;
-	v.numBlocks = 0;
-	v.status = NULL;
-	v.blocks = NULL;
-	v.sigs = NULL;
-	v.uninits = NULL;
-	v.supertypes = NULL;
-	v.uninits = NULL;
-	
+	int codelen = METHOD_BYTECODE_LEN(v->method);
 	
 	/**************************************************************************************************
 	 * Memory Allocation
 	 **************************************************************************************************/
 	DBG(VERIFY3, dprintf("        allocating memory for verification (codelen = %d)...\n", codelen); );
 	
-        v.status = checkPtr((uint32*)gc_malloc(codelen * sizeof(uint32), KGC_ALLOC_VERIFIER));
+        v->status = checkPtr((uint32*)arenaAlloc(&v->mem, codelen * sizeof(uint32)));
 	
 	/* find basic blocks and allocate memory for them */
-	verifyMethod3a(&v);
-	if (!v.blocks) {
+	verifyMethod3a(v);
+	if (!v->blocks) {
 		DBG(VERIFY3, dprintf("        some kinda error finding the basic blocks in pass 3a\n"); );
 		
 		/* propagate error */
-		return failInVerifyMethod(&v);
+		return(false);
 	}
 	
 	DBG(VERIFY3, dprintf("        done allocating memory\n"); );
@@ -409,20 +393,72 @@ verifyMethod(errorInfo *einfo, Method* method)
 	
 	/* load initial arguments into local variable array */
 	DBG(VERIFY3, dprintf("    about to load initial args...\n"); );
-	if (!loadInitialArgs(&v)) {
+	if (!loadInitialArgs(v)) {
 	        /* propagate error */
-		return failInVerifyMethod(&v);
+		return(false);
 	}
 	DBG(VERIFY3, {
 	        /* print out the local arguments */
 		int n;
-		for(n = 0; n < v.method->localsz; n++) {
+		for(n = 0; n < v->method->localsz; n++) {
 			dprintf("        local %d: ", n);
-			printType(&(v.blocks[0]->locals[n]));
+			printType(&(v->blocks[0]->locals[n]));
 			dprintf("\n");
 		}
 	} );
 	
+	return(true);
+}
+
+/*
+ * Controls the verification of a single method.  It allocates most of the memory needed for
+ * verification (when encountering JSRs, more memory will need to be allocated later),
+ * loads the initial arguments, calls pass3a, then calls pass3b and cleans up.
+ *
+ * A method with a StackMapTable is checked against it in one pass instead.  Should that
+ * fail, the types are inferred as for a method without one, which the specification
+ * allows for version 50 class files.  The verify statistics count how
+ * often either happened.
+ */
+static
+bool
+verifyMethod(errorInfo *einfo, Method* method)
+{
+	static counter stackmapPassed, stackmapFailed;
+	Verifier v;
+	v.einfo = einfo;
+	v.class = method->class;
+	v.method = method;
+	v.numBlocks = 0;
+	v.status = NULL;
+	v.blocks = NULL;
+	v.changed = NULL;
+	v.uninits = NULL;
+	v.supertypes = NULL;
+	v.types = NULL;
+	arenaInit(&v.mem);
+	
+	if (!prepareVerifier(&v)) {
+		return failInVerifyMethod(&v);
+	}
+	
+	if (method->stackmap != NULL) {
+		if (verifyMethodStackMap(&v)) {
+			hitCounter(&stackmapPassed, "verify-stackmap");
+			freeVerifierData(&v);
+			DBG(VERIFY3, dprintf("    Verify Method 3b: done\n"); );
+			return(true);
+		}
+		
+		DBG(VERIFY3, dprintf("    StackMapTable check failed, inferring types instead\n"); );
+		hitCounter(&stackmapFailed, "verify-fallback");
+		discardErrorInfo(einfo);
+		einfo->type = 0;
+		freeVerifierData(&v);
+		if (!prepareVerifier(&v)) {
+			return failInVerifyMethod(&v);
+		}
+	}
 	
 	if (!verifyMethod3b(&v)) {
 		return failInVerifyMethod(&v);
@@ -495,14 +531,12 @@ countSizeOfArgsInSignature(const char* sig)
 static inline
 bool
 verifyErrorInCheckMethodCall(Verifier* v,
-			     char* argbuf,
 			     uint32 pc,
 			     const uint32 idx,
 			     const constants* pool,
 			     const char* methSig,
 			     const char* msg)
 {
-	gc_free(argbuf);
 	DBG(VERIFY3,
 	    dprintf("                error with method invocation, pc = %d, method = %s%s\n",
 		    pc,
@@ -518,13 +552,12 @@ verifyErrorInCheckMethodCall(Verifier* v,
 static inline
 bool
 typeErrorInCheckMethodCall(Verifier* v,
-			   char* argbuf,
 			   uint32 pc,
 			   const uint32 idx,
 			   const constants* pool,
 			   const char* methSig)
 {
-	return verifyErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig,
+	return verifyErrorInCheckMethodCall(v, pc, idx, pool, methSig,
 					    "parameters fail type checking in method invocation");
 }
 
@@ -562,27 +595,27 @@ checkMethodCall(Verifier* v,
 	uint32 nargs                     = countSizeOfArgsInSignature(sig);
 	
 	uint32 paramIndex                = 0;
-	char* argbuf                     = checkPtr(gc_malloc(strlen(sig) * sizeof(char), KGC_ALLOC_VERIFIER));
+	char* argbuf                     = checkPtr(arenaAlloc(&v->mem, strlen(sig) * sizeof(char)));
 	
 	
 	DBG(VERIFY3, dprintf("%scalling method %s%s\n", indent, METHODREF_NAMED(idx, pool), sig); );
 	
 	
 	if (nargs > binfo->stacksz) {
-		return verifyErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig, "not enough stuff on opstack for method invocation");
+		return verifyErrorInCheckMethodCall(v, pc, idx, pool, methSig, "not enough stuff on opstack for method invocation");
 	}
 	
 	
 	/* make sure that the receiver is type compatible with the class being invoked */
 	if (opcode != INVOKESTATIC) {
 		if (nargs == binfo->stacksz) {
-			return verifyErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig, "not enough stuff on opstack for method invocation");
+			return verifyErrorInCheckMethodCall(v, pc, idx, pool, methSig, "not enough stuff on opstack for method invocation");
 		}
 		
 		
 		receiver = &binfo->opstack[binfo->stacksz - (nargs + 1)];
 		if (!(receiver->tinfo & TINFO_UNINIT) && !isReference(receiver)) {
-			return verifyErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig, "invoking a method on something that is not a reference");
+			return verifyErrorInCheckMethodCall(v, pc, idx, pool, methSig, "invoking a method on something that is not a reference");
 		}
 		
 		if (pool->tags[classIdx] == CONSTANT_Class) {
@@ -606,13 +639,13 @@ checkMethodCall(Verifier* v,
 					if (!sameType(methodRefClass, &uninit->type) &&
 					    uninit->type.data.class != getTOBJ()->data.class &&
 					    !sameType(methodRefClass, &t_uninit_super)) {
-						return verifyErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig, "incompatible receiving type for superclass constructor call");
+						return verifyErrorInCheckMethodCall(v, pc, idx, pool, methSig, "incompatible receiving type for superclass constructor call");
 					}
 				} else if (!sameType(methodRefClass, &uninit->type)) {
 					DBG(VERIFY3,
 					    dprintf("%smethodRefClass: ", indent); printType(methodRefClass);
 					    dprintf("\n%sreceiver: ", indent); printType(&uninit->type); dprintf("\n"); );
-					return verifyErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig, "incompatible receiving type for constructor call");
+					return verifyErrorInCheckMethodCall(v, pc, idx, pool, methSig, "incompatible receiving type for constructor call");
 				}
 				
 				/* fix front of list, if necessary */
@@ -627,12 +660,12 @@ checkMethodCall(Verifier* v,
 				popUninit(v->method, uninit, binfo);
 			}
 			else if (!sameType(methodRefClass, receiver)) {
-				return verifyErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig, "incompatible receiving type for constructor call");
+				return verifyErrorInCheckMethodCall(v, pc, idx, pool, methSig, "incompatible receiving type for constructor call");
 			}
 		}
 		else if (!typecheck(v, methodRefClass, receiver)) {
 			if (receiver->tinfo & TINFO_UNINIT) {
-				return verifyErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig, "invoking a method on an uninitialized object reference");
+				return verifyErrorInCheckMethodCall(v, pc, idx, pool, methSig, "invoking a method on an uninitialized object reference");
 			}
 			
 			DBG(VERIFY3,
@@ -642,7 +675,7 @@ checkMethodCall(Verifier* v,
 			    printType(receiver);
 			    dprintf("\n");
 			    );
-			return verifyErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig, "expected method receiver does not typecheck with object on operand stack");
+			return verifyErrorInCheckMethodCall(v, pc, idx, pool, methSig, "expected method receiver does not typecheck with object on operand stack");
 		}
 	}
 	
@@ -656,8 +689,7 @@ checkMethodCall(Verifier* v,
 	for (sig = getNextArg(sig + 1, argbuf); *argbuf != ')'; sig = getNextArg(sig, argbuf)) {
 		
 		if (paramIndex >= binfo->stacksz) {
-			gc_free(argbuf);
-			return verifyErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig, "error: not enough parameters on stack for method invocation");
+			return verifyErrorInCheckMethodCall(v, pc, idx, pool, methSig, "error: not enough parameters on stack for method invocation");
 		}
 		
 		
@@ -668,7 +700,7 @@ checkMethodCall(Verifier* v,
 			t->data.sig = argbuf;
 			
 			if (!typecheck(v, t, &binfo->opstack[paramIndex])) {
-				return typeErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig);
+				return typeErrorInCheckMethodCall(v, pc, idx, pool, methSig);
 			}
 			
 			binfo->opstack[paramIndex] = *getTUNSTABLE();
@@ -678,7 +710,7 @@ checkMethodCall(Verifier* v,
 		case 'Z': case 'S': case 'B': case 'C':
 		case 'I':
 			if (binfo->opstack[paramIndex].data.class != getTINT()->data.class) {
-				return typeErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig);
+				return typeErrorInCheckMethodCall(v, pc, idx, pool, methSig);
 			}
 			
 			binfo->opstack[paramIndex] = *getTUNSTABLE();
@@ -687,7 +719,7 @@ checkMethodCall(Verifier* v,
 			
 		case 'F':
 			if (binfo->opstack[paramIndex].data.class != getTFLOAT()->data.class) {
-				return typeErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig);
+				return typeErrorInCheckMethodCall(v, pc, idx, pool, methSig);
 			}
 			
 			binfo->opstack[paramIndex] = *getTUNSTABLE();
@@ -697,7 +729,7 @@ checkMethodCall(Verifier* v,
 		case 'J':
 			if (binfo->opstack[paramIndex].data.class != getTLONG()->data.class ||
 			    !isWide(&binfo->opstack[paramIndex + 1])) {
-				return typeErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig);
+				return typeErrorInCheckMethodCall(v, pc, idx, pool, methSig);
 			}
 			
 			binfo->opstack[paramIndex]    = *getTUNSTABLE();
@@ -708,7 +740,7 @@ checkMethodCall(Verifier* v,
 		case 'D':
 			if (binfo->opstack[paramIndex].data.class != getTDOUBLE()->data.class ||
 			    !isWide(&binfo->opstack[paramIndex + 1])) {
-				return typeErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig);
+				return typeErrorInCheckMethodCall(v, pc, idx, pool, methSig);
 			}
 			
 			binfo->opstack[paramIndex]     = *getTUNSTABLE();
@@ -717,7 +749,7 @@ checkMethodCall(Verifier* v,
 			break;
 			
 		default:
-			return typeErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig);
+			return typeErrorInCheckMethodCall(v, pc, idx, pool, methSig);
 		}
 	}
 	binfo->stacksz -= nargs;
@@ -738,12 +770,12 @@ checkMethodCall(Verifier* v,
 	
 	if (*argbuf == 'J' || *argbuf == 'D') {
 		if (v->method->stacksz < binfo->stacksz + 2) {
-			return verifyErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig, "not enough room on operand stack for method call's return value");
+			return verifyErrorInCheckMethodCall(v, pc, idx, pool, methSig, "not enough room on operand stack for method call's return value");
 		}
 	}
 	else if (*argbuf != 'V') {
 		if (v->method->stacksz < binfo->stacksz + 1) {
-			return verifyErrorInCheckMethodCall(v, argbuf, pc, idx, pool, methSig, "not enough room on operand stack for method call's return value");
+			return verifyErrorInCheckMethodCall(v, pc, idx, pool, methSig, "not enough room on operand stack for method call's return value");
 		}
 	}
 	
@@ -774,40 +806,27 @@ checkMethodCall(Verifier* v,
 		
 	case '[':
 	case 'L':
-		v->sigs = pushSig(v->sigs, argbuf);
-		
 		binfo->opstack[binfo->stacksz].data.class = (Hjava_lang_Class*)argbuf;
 		binfo->opstack[binfo->stacksz].tinfo = TINFO_SIG;
 		binfo->stacksz++;
-		
-		/* no freeing of the argbuf here... */
 		return(true);
 		
 	default:
 	        /* shouldn't get here because of parsing during pass 2... */
 		DBG(VERIFY3, dprintf("                unrecognized return type signature: %s\n", argbuf); );
-		gc_free(argbuf);
 		postExceptionMessage(v->einfo, JAVA_LANG(InternalError),
 				     "unrecognized return type signature");
 		return(false);
 	}
 	
-	gc_free(argbuf);
 	return(true);
 }
 
 
 static inline
 bool
-verifyErrorInLoadInitialArgs(Verifier* v, const char* msg, char* argbuf) {
-	gc_free(argbuf);
-	return verifyError(v, msg);
-}
-
-static inline
-bool
-localOverflowErrorInLoadInitialArgs(Verifier* v, char* argbuf) {
-	return verifyErrorInLoadInitialArgs(v, "method arguments cannot fit into local variables", argbuf);
+localOverflowErrorInLoadInitialArgs(Verifier* v) {
+	return verifyError(v, "method arguments cannot fit into local variables");
 }
 
 /*
@@ -821,7 +840,7 @@ loadInitialArgs(Verifier* v)
 	
 	/* the +1 skips the initial '(' */
 	const char* sig = METHOD_SIGD(v->method) + 1;
-	char* argbuf    = checkPtr(gc_malloc((strlen(sig)+1) * sizeof(char), KGC_ALLOC_VERIFIER));
+	char* argbuf    = checkPtr(arenaAlloc(&v->mem, (strlen(sig)+1) * sizeof(char)));
 	char* newsig    = NULL;
 	
 	/* load the initial argument into the first basic block.
@@ -835,7 +854,7 @@ loadInitialArgs(Verifier* v)
 	/* must have at least 1 local variable for the object reference	*/
 	if (!METHOD_IS_STATIC(v->method)) {
 		if (v->method->localsz <= 0) {
-			return verifyErrorInLoadInitialArgs(v, "number of locals in non-static method must be > 0", argbuf);
+			return verifyError(v, "number of locals in non-static method must be > 0");
 		}
 		
 		/* the first local variable in every method is the class to which it belongs */
@@ -844,7 +863,7 @@ loadInitialArgs(Verifier* v)
 		paramCount++;
 		if (!strcmp(METHOD_NAMED(v->method), constructor_name->data)) {
 		        /* the local reference in a constructor is uninitialized */
-			v->uninits = pushUninit(v->uninits, &locals[0]);
+			v->uninits = pushUninit(&v->mem, v->uninits, &locals[0]);
 			locals[0].tinfo = TINFO_UNINIT_SUPER;
 			locals[0].data.uninit = v->uninits;
 		}
@@ -852,7 +871,7 @@ loadInitialArgs(Verifier* v)
 	
 	for (sig = getNextArg(sig, argbuf); *argbuf != ')'; sig = getNextArg(sig, argbuf)) {
 		if (paramCount > v->method->localsz) {
-			return localOverflowErrorInLoadInitialArgs(v, argbuf);
+			return localOverflowErrorInLoadInitialArgs(v);
 		}
 		
 		switch (*argbuf) {
@@ -862,7 +881,7 @@ loadInitialArgs(Verifier* v)
 			
 		case 'J':
 			if (paramCount + 1 > v->method->localsz) {
-				return localOverflowErrorInLoadInitialArgs(v, argbuf);
+				return localOverflowErrorInLoadInitialArgs(v);
 			}
 			locals[paramCount] = *getTLONG();
 			locals[paramCount+1] = *getTWIDE();
@@ -871,7 +890,7 @@ loadInitialArgs(Verifier* v)
 			
 		case 'D':
 			if (paramCount + 1 > v->method->localsz) {
-				return localOverflowErrorInLoadInitialArgs(v, argbuf);
+				return localOverflowErrorInLoadInitialArgs(v);
 			}
 			locals[paramCount] = *getTDOUBLE();
 			locals[paramCount+1] = *getTWIDE();
@@ -880,8 +899,7 @@ loadInitialArgs(Verifier* v)
 			
 		case '[':
 		case 'L':
-			newsig = checkPtr(gc_malloc((strlen(argbuf) + 1) * sizeof(char), KGC_ALLOC_VERIFIER));
-			v->sigs = pushSig(v->sigs, newsig);
+			newsig = checkPtr(arenaAlloc(&v->mem, (strlen(argbuf) + 1) * sizeof(char)));
 			sprintf(newsig, "%s", argbuf);
 			locals[paramCount].tinfo = TINFO_SIG;
 			locals[paramCount].data.sig = newsig;
@@ -895,13 +913,12 @@ loadInitialArgs(Verifier* v)
 			    dprintf("        the rest of argbuf: %s\n", argbuf);
 			    );
 			
-			return verifyErrorInLoadInitialArgs(v, "unrecognized first character in parameter type descriptor", argbuf);
+			return verifyError(v, "unrecognized first character in parameter type descriptor");
 		}
 	}
 	
 	
 	/* success! */
-	gc_free(argbuf);
 	return(true);
 
 #undef LOCAL_OVERFLOW_ERROR
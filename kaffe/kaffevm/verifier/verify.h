@@ -11,6 +11,7 @@
 #define __verify_h
 
 #include "classMethod.h"
+#include "arena.h"
 #include "errors.h"
 #include "gtypes.h"
 
@@ -85,11 +86,15 @@ typedef struct Verifier
 	uint32             numBlocks;
 	uint32*            status;
 	struct BlockInfo** blocks;
+	uint32*            changed;   /* bitset of the blocks to evaluate again */
 	
 	/* memory allocated for type checking */
-	struct SigStack*          sigs;
 	struct UninitializedType* uninits;
 	struct SupertypeSet*      supertypes;
+	struct TypeCache*         types;  /* see verify-type.c */
+	
+	/* everything above is allocated from here */
+	arena                     mem;
 } Verifier;
 
 /* frees the data allocated and stored in a Verifier */
@@ -118,6 +123,7 @@ extern bool verify3(Hjava_lang_Class* class,
 		    errorInfo *einfo);
 extern void verifyMethod3a(struct Verifier* v);
 extern bool verifyMethod3b(struct Verifier* v);
+extern bool verifyMethodStackMap(struct Verifier* v);
 extern bool verifyBasicBlock(struct Verifier* v,
 			     struct BlockInfo*);
 
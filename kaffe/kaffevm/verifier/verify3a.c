@@ -777,12 +777,13 @@ verifyMethod3a(Verifier* v)
 	
 	DBG(VERIFY3, dprintf("    Verifier Pass 3a: third pass to allocate memory for basic blocks...\n"); );
 	
-	blocks = checkPtr((BlockInfo**)gc_malloc(blockCount * sizeof(BlockInfo*), KGC_ALLOC_VERIFIER));
+	blocks = checkPtr((BlockInfo**)arenaAlloc(&v->mem, blockCount * sizeof(BlockInfo*)));
 	
 	for (inABlock = true, n = 0, pc = 0; pc < codelen; pc++) {
 		if (v->status[pc] & START_BLOCK) {
-			blocks[n] = createBlock(v->method);
+			blocks[n] = createBlock(v);
 			blocks[n]->startAddr = pc;
+			blocks[n]->index = n;
 			n++;
 			
 			inABlock = true;
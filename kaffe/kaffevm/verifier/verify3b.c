@@ -25,25 +25,78 @@
 #include "verify-type.h"
 
 
-static inline bool verifyErrorInVerifyMethod3b(Verifier* v,
-					       BlockInfo* curBlock,
-					       const char * msg);
 static        bool mergeBasicBlocks(Verifier* v,
 				    BlockInfo* fromBlock,
 				    BlockInfo* toBlock);
 
 
-/**
- * Helper function for error reporting in verifyMethod3b
+/*
+ * the "changed" bits of the blocks are kept in a bitset as well as in
+ * their status, so that the next block to evaluate is found a word at
+ * a time rather than by looking at every block after each one.
  */
-static inline 
-bool
-verifyErrorInVerifyMethod3b(Verifier* v, BlockInfo* curBlock, const char * msg)
+static inline
+void
+markChanged(Verifier* v, BlockInfo* block)
+{
+	block->status |= CHANGED;
+	v->changed[block->index / 32] |= (uint32)1 << (block->index % 32);
+}
+
+static inline
+void
+unmarkChanged(Verifier* v, BlockInfo* block)
+{
+	block->status &= ~CHANGED;
+	v->changed[block->index / 32] &= ~((uint32)1 << (block->index % 32));
+}
+
+/*
+ * returns the first changed block from index from up to index to, or to
+ * if there is none.
+ */
+static
+uint32
+findChanged(const Verifier* v, uint32 from, uint32 to)
 {
-        gc_free(curBlock);
-	return verifyError(v, msg);
+	uint32 bits;
+	
+	while (from < to) {
+		bits = v->changed[from / 32] >> (from % 32);
+		if (bits == 0) {
+			from = (from / 32 + 1) * 32;
+			continue;
+		}
+		while (!(bits & 1)) {
+			bits >>= 1;
+			from++;
+		}
+		return (from < to ? from : to);
+	}
+	return to;
 }
 
+/*
+ * returns the next changed block, looking from index from to the end and
+ * then from the start, or numBlocks if no block is changed.
+ */
+static
+uint32
+nextChanged(const Verifier* v, uint32 from)
+{
+	uint32 i;
+	
+	i = findChanged(v, from, v->numBlocks);
+	if (i == v->numBlocks && from > 0) {
+		i = findChanged(v, 0, from);
+		if (i == from) {
+			i = v->numBlocks;
+		}
+	}
+	return i;
+}
+
+
 /*
  * verifyMethod3b()
  *    The Data-flow Analyzer
@@ -112,13 +165,16 @@ verifyMethod3b(Verifier* v)
 	
 	DBG(VERIFY3, dprintf("    Verifier Pass 3b: Data Flow Analysis and Type Checking...\n"); );
 	DBG(VERIFY3, dprintf("        memory allocation...\n"); );
-	curBlock = createBlock(v->method);
+	curBlock = createBlock(v);
+	
+	
+	v->changed = checkPtr(arenaAlloc(&v->mem, ((v->numBlocks + 31) / 32) * sizeof(uint32)));
 	
 	
 	DBG(VERIFY3, dprintf("        doing the dirty data flow analysis...\n"); );
-	blocks[0]->status |= CHANGED;
+	markChanged(v, blocks[0]);
 	curIndex = 0;
-	while(curIndex < v->numBlocks) {
+	while((curIndex = nextChanged(v, curIndex)) < v->numBlocks) {
 		DBG(VERIFY3,
 		    dprintf("      blockNum/first pc/changed/stksz = %d / %d / %d / %d\n",
 			    curIndex,
@@ -129,23 +185,17 @@ verifyMethod3b(Verifier* v)
 		    printBlock(v->method, blocks[curIndex], "                 ");
 		    );
 		
-		if (!(blocks[curIndex]->status & CHANGED)) {
-			DBG(VERIFY3, dprintf("        not changed...skipping\n"); );
-			curIndex++;
-			continue;
-		}
-		
-		blocks[curIndex]->status ^= CHANGED; /* unset CHANGED bit */
+		unmarkChanged(v, blocks[curIndex]);
 		blocks[curIndex]->status |= VISITED; /* make sure we've visited it...important for merging */
 		copyBlockData(v->method, blocks[curIndex], curBlock);
 		
 		if (curBlock->status & EXCEPTION_HANDLER && curBlock->stacksz > 0) {
-			return verifyErrorInVerifyMethod3b(v, curBlock, "it's possible to reach an exception handler with a nonempty stack");
+			return verifyError(v, "it's possible to reach an exception handler with a nonempty stack");
 		}
 		
 		
 		if (!verifyBasicBlock(v, curBlock)) {
-			return verifyErrorInVerifyMethod3b(v, curBlock, "failure to verify basic block");
+			return verifyError(v, "failure to verify basic block");
 		}
 		
 		
@@ -166,7 +216,7 @@ verifyMethod3b(Verifier* v)
 				nextBlock = inWhichBlock(newpc, blocks, v->numBlocks);
 				
 				if (!mergeBasicBlocks(v, curBlock, nextBlock)) {
-					return verifyErrorInVerifyMethod3b(v, curBlock, "error merging operand stacks");
+					return verifyError(v, "error merging operand stacks");
 				}
 				break;
 				
@@ -176,7 +226,7 @@ verifyMethod3b(Verifier* v)
 				nextBlock = inWhichBlock(newpc, blocks, v->numBlocks);
 				
 				if (!mergeBasicBlocks(v, curBlock, nextBlock)) {
-					return verifyErrorInVerifyMethod3b(v, curBlock, "error merging operand stacks");
+					return verifyError(v, "error merging operand stacks");
 				}
 				break;
 					
@@ -191,14 +241,13 @@ verifyMethod3b(Verifier* v)
 				nextBlock = inWhichBlock(newpc, blocks, v->numBlocks);
 				
 				if (!mergeBasicBlocks(v, curBlock, nextBlock)) {
-					return verifyErrorInVerifyMethod3b(v, curBlock, "jsr: error merging operand stacks");
+					return verifyError(v, "jsr: error merging operand stacks");
 				}
 	
 				/* TODO:
 				 * args, we need to verify the RET block first ...
 				 */
-				for (;curIndex < v->numBlocks && blocks[curIndex] != nextBlock; curIndex++);
-				assert (curIndex < v->numBlocks);
+				curIndex = nextBlock->index;
 				continue;
 				
 			case RET:
@@ -210,7 +259,7 @@ verifyMethod3b(Verifier* v)
 				}
 				
 				if (!IS_ADDRESS(&curBlock->locals[n])) {
-					return verifyErrorInVerifyMethod3b(v, curBlock, "ret instruction does not refer to a variable with type returnAddress");
+					return verifyError(v, "ret instruction does not refer to a variable with type returnAddress");
 				}
 				
 				newpc = curBlock->locals[n].tinfo;
@@ -220,7 +269,7 @@ verifyMethod3b(Verifier* v)
 				
 				nextBlock = inWhichBlock(newpc, blocks, v->numBlocks);
 				if (!mergeBasicBlocks(v, curBlock, nextBlock)) {
-					return verifyErrorInVerifyMethod3b(v, curBlock, "error merging opstacks when returning from a subroutine");
+					return verifyError(v, "error merging opstacks when returning from a subroutine");
 				}
 
 				/* 
@@ -243,16 +292,16 @@ verifyMethod3b(Verifier* v)
 				nextBlock = inWhichBlock(newpc, blocks, v->numBlocks);
 				
 				if (!mergeBasicBlocks(v, curBlock, nextBlock)) {
-					return verifyErrorInVerifyMethod3b(v, curBlock, "error merging operand stacks");
+					return verifyError(v, "error merging operand stacks");
 				}
 				
 				/* if the condition is false, then the next block is the one that will be executed */
 				curIndex++;
 				if (curIndex >= v->numBlocks) {
-					return verifyErrorInVerifyMethod3b(v, curBlock, "execution falls off the end of a basic block");
+					return verifyError(v, "execution falls off the end of a basic block");
 				}
 				else if (!mergeBasicBlocks(v, curBlock, blocks[curIndex])) {
-					return verifyErrorInVerifyMethod3b(v, curBlock, "error merging operand stacks");
+					return verifyError(v, "error merging operand stacks");
 				}
 				break;
 				
@@ -267,7 +316,7 @@ verifyMethod3b(Verifier* v)
 				newpc = pc + getDWord(code, n);
 				nextBlock = inWhichBlock(newpc, blocks, v->numBlocks);
 				if (!mergeBasicBlocks(v, curBlock, nextBlock)) {
-					return verifyErrorInVerifyMethod3b(v, curBlock, "error merging into the default branch of a lookupswitch instruction");
+					return verifyError(v, "error merging into the default branch of a lookupswitch instruction");
 				}
 				
 				/* get number of key/target pairs */
@@ -280,7 +329,7 @@ verifyMethod3b(Verifier* v)
 					newpc = pc + getDWord(code, n+4);
 					nextBlock = inWhichBlock(newpc, blocks, v->numBlocks);
 					if (!mergeBasicBlocks(v, curBlock, nextBlock)) {
-						return verifyErrorInVerifyMethod3b(v, curBlock, "error merging into a branch of a lookupswitch instruction");
+						return verifyError(v, "error merging into a branch of a lookupswitch instruction");
 					}
 				}
 				
@@ -309,7 +358,7 @@ verifyMethod3b(Verifier* v)
 					newpc = pc + getDWord(code, n);
 					nextBlock = inWhichBlock(newpc, blocks, v->numBlocks);
 					if (!mergeBasicBlocks(v, curBlock, nextBlock)) {
-						return verifyErrorInVerifyMethod3b(v, curBlock, "error merging into a branch of a tableswitch instruction");
+						return verifyError(v, "error merging into a branch of a tableswitch instruction");
 					}
 				}
 				break;
@@ -323,7 +372,6 @@ verifyMethod3b(Verifier* v)
 			case LRETURN:
 			case DRETURN:
 			case ATHROW:
-				curIndex++;
 				continue;
 				
 			default:
@@ -331,23 +379,19 @@ verifyMethod3b(Verifier* v)
 					if (v->status[n] & IS_INSTRUCTION) break;
 				}
 				if (n == codelen) {
-					return verifyErrorInVerifyMethod3b(v, curBlock, "execution falls off the end of a code block");
+					return verifyError(v, "execution falls off the end of a code block");
 				}
 				else if (!mergeBasicBlocks(v, curBlock, blocks[curIndex+1])) {
-					return verifyErrorInVerifyMethod3b(v, curBlock, "error merging operand stacks");
+					return verifyError(v, "error merging operand stacks");
 				}
 			}
 		
 		
-		for (curIndex = 0; curIndex < v->numBlocks; curIndex++) {
-			if (blocks[curIndex]->status & CHANGED)
-				break;
-		}
+		curIndex = 0;
 	}
 	
 	
 	DBG(VERIFY3, dprintf("    Verifier Pass 3b: Complete\n"); );
-	gc_free(curBlock);
 	return(true);
 }
 
@@ -410,7 +454,7 @@ mergeBasicBlocks(Verifier* v,
 				     toBlock->startAddr); );
 		
 		copyBlockState(v->method, fromBlock, toBlock);
-		toBlock->status |= CHANGED;
+		markChanged(v, toBlock);
 		return(true);
 	}
 	
@@ -432,7 +476,7 @@ mergeBasicBlocks(Verifier* v,
 	/* merge the local variable arrays */
 	for (n = 0; n < v->method->localsz; n++) {
 		if (mergeTypes(v, &fromBlock->locals[n], &toBlock->locals[n])) {
-			toBlock->status |= CHANGED;
+			markChanged(v, toBlock);
 		}
 	}
 	
@@ -443,7 +487,7 @@ mergeBasicBlocks(Verifier* v,
 		 * for instance.
 		 */
 		if (mergeTypes(v, &fromBlock->opstack[n], &toBlock->opstack[n])) {
-			toBlock->status |= CHANGED;
+			markChanged(v, toBlock);
 		}
 	}
 	
@@ -34,6 +34,7 @@ Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
 #include "stackTrace.h"
 #include "support.h"
 #include "stringSupport.h"
+#include "external.h"
 
 /*
  * Returns the call stack of the current thread as a pair of arrays: the
@@ -41,48 +42,89 @@ Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
  *
  * This method is based on kaffe_lang_ThreadStack, but returns the
  * method names along with the classes.
+ *
+ * VMAccessController.getContext looks no further than the frame that
+ * called AccessController.doPrivileged, so neither do we.
+ */
+
+/* Names of methods converted, looked up by the hash of their name */
+#define	STACK_NAME_CACHE	32
+
+static bool
+isDoPrivileged (Method *meth)
+{
+  return (strcmp (meth->name->data, "doPrivileged") == 0
+	  && strcmp (CLASS_CNAME (meth->class), "java/security/AccessController") == 0);
+}
+
+/*
+ * Walk the frames getContext uses, storing them if classes is not NULL.
+ * Returns the number of frames.
  */
+static int
+walkStack (HArrayOfObject *classes, HArrayOfObject *meths)
+{
+  stackTraceIterator it;
+  Method *meth;
+  Utf8Const *names[STACK_NAME_CACHE];
+  Hjava_lang_String *strings[STACK_NAME_CACHE];
+  bool privileged;
+  int cnt;
+  int h;
+
+  memset (names, 0, sizeof (names));
+  privileged = false;
+  cnt = 0;
+  stackTraceIterInit (&it, NULL);
+  while ((meth = stackTraceIterNext (&it)) != NULL)
+    {
+      if (meth->class == NULL)
+	continue;
+      if (classes != NULL)
+	{
+	  if (cnt == ARRAY_SIZE (classes))
+	    break;
+	  unhand_array(classes)->body[cnt] = (Hjava_lang_Object *) meth->class;
+	  /* the same few method names keep coming back, convert each once */
+	  h = (uint32) meth->name->hash % STACK_NAME_CACHE;
+	  if (names[h] != meth->name)
+	    {
+	      strings[h] = utf8Const2Java (meth->name);
+	      names[h] = meth->name;
+	    }
+	  unhand_array(meths)->body[cnt] = (Hjava_lang_Object *) strings[h];
+	}
+      cnt++;
+      /* the caller of doPrivileged is the last frame looked at */
+      if (privileged)
+	break;
+      privileged = isDoPrivileged (meth);
+    }
+  return cnt;
+}
+
 HArrayOfArray *
 java_security_VMAccessController_getStack (void)
 {
-  stackTraceInfo *info;
-  errorInfo einfo;
   int cnt;
-  int i;
   HArrayOfObject *classes;
   HArrayOfObject *meths;
   HArrayOfArray *array;
 
-  info = (stackTraceInfo *) buildStackTrace(NULL);
-  if (info == NULL)
-    {
-      postOutOfMemory (&einfo);
-      throwError (&einfo);
-    }
-
-  cnt = 0;
-  for (i = 0; info[i].meth != ENDOFSTACK; i++)
-    {
-      if (info[i].meth != NULL && info[i].meth->class != NULL)
-	cnt++;
-    }
+  cnt = walkStack (NULL, NULL);
 
   array = (HArrayOfArray *) AllocObjectArray (2, "[Ljava/lang/Object;", NULL);
   classes = (HArrayOfObject *) AllocObjectArray (cnt, "Ljava/lang/Class;", NULL);
   meths = (HArrayOfObject *) AllocObjectArray (cnt, "Ljava/lang/String;", NULL);
 
-  cnt = 0;
-  for (i = 0; info[i].meth != ENDOFSTACK; i++)
-    {
-      if (info[i].meth != NULL && info[i].meth->class != NULL)
-	{
-	  unhand_array(classes)->body[cnt] = (Hjava_lang_Object *) info[i].meth->class;
-	  unhand_array(meths)->body[cnt] = (Hjava_lang_Object *) utf8Const2Java (info[i].meth->name);
-	  cnt++;
-	}      
-    }
+  walkStack (classes, meths);
 
   unhand_array(array)->body[0] = (Hjava_lang_Object *) classes;
   unhand_array(array)->body[1] = (Hjava_lang_Object *) meths;
   return array;
 }
+
+const nativeBinding kaffeNativesVMAccessController[] = {
+	NATIVE_BINDING(java_security_VMAccessController_getStack),
+	NATIVE_BINDING_END
+};
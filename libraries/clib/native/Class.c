@@ -34,6 +34,7 @@
 #include "java_lang_VMClass.h"
 
 #include "defs.h"
+#include "external.h"
 
 /*
  * Convert string name to class object.
@@ -307,81 +308,13 @@ java_lang_VMClass_getModifiers(struct Hjava_lang_Class* this,
 HArrayOfObject*
 java_lang_VMClass_getDeclaredMethods(struct Hjava_lang_Class* clazz, jboolean publicOnly)
 {
-	int count;
-	Hjava_lang_reflect_Method** ptr;
-	HArrayOfObject* array;
-	int i;
-	Method *mth = Kaffe_get_class_methods(clazz);
-
-	count = 0;
-	for (i = CLASS_NMETHODS(clazz)-1; i >= 0; i--) {
-		if (publicOnly && ((mth[i].accflags&ACC_PUBLIC)==0))
-			continue;
-		
-		if ((mth[i].kFlags & KFLAG_CONSTRUCTOR)!=0)
-			continue;
-
-		if (utf8ConstEqual(init_name, mth[i].name))
-			continue;
-
-		count++;
-	}
-
-	array = (HArrayOfObject*)
-	    AllocObjectArray(count, "Ljava/lang/reflect/Method;", NULL);
-	ptr = (Hjava_lang_reflect_Method**)&unhand_array(array)->body[0];
-
-	for (i = CLASS_NMETHODS(clazz)-1; i >= 0; i--) {
-		if (publicOnly && ((mth[i].accflags&ACC_PUBLIC)==0))
-			continue;
-
-		if ((mth[i].kFlags & KFLAG_CONSTRUCTOR)!=0)
-			continue;
-
-		if (utf8ConstEqual(init_name, mth[i].name))
-			continue;
-
-		*ptr = KaffeVM_makeReflectMethod(clazz, i);
-		ptr++;
-	}
-
-	return (array);
+	return (KaffeVM_getDeclaredMethods(clazz, publicOnly));
 }
 
 HArrayOfObject*
 java_lang_VMClass_getDeclaredConstructors(struct Hjava_lang_Class* clas, jboolean publicOnly)
 {
-	int count;
-	Hjava_lang_reflect_Constructor** ptr;
-	HArrayOfObject* array;
-	int i;
-	Method* mth = Kaffe_get_class_methods(clas);
-
-	count = 0;
-	for (i = CLASS_NMETHODS(clas)-1; i >= 0;  i--) {
-		if ((mth[i].kFlags & KFLAG_CONSTRUCTOR) == 0)
-			continue;
-
-		if (publicOnly && ((mth[i].accflags&ACC_PUBLIC)==0))
-			continue;
-		
-		count++;
-	}
-	array = (HArrayOfObject*)
-	   AllocObjectArray(count, "Ljava/lang/reflect/Constructor;", NULL);
-	ptr = (Hjava_lang_reflect_Constructor**)&unhand_array(array)->body[0];
-
-	for (i = CLASS_NMETHODS(clas)-1; i >= 0;  i--) {
-		if ((mth[i].kFlags & KFLAG_CONSTRUCTOR) == 0)
-			continue;
-
-		if (publicOnly && ((mth[i].accflags&ACC_PUBLIC)==0))
-			continue;
-
-		*ptr = KaffeVM_makeReflectConstructor(clas, i);
-		ptr++;
-	}
-	return (array);
+	return (KaffeVM_getDeclaredConstructors(clas, publicOnly));
 }
 
 /*
@@ -396,38 +329,7 @@ java_lang_VMClass_getDeclaredConstructors(struct Hjava_lang_Class* clas, jboolea
 HArrayOfObject*
 java_lang_VMClass_getDeclaredFields(struct Hjava_lang_Class* clazz, jboolean publicOnly)
 {
-	int count;
-	Hjava_lang_reflect_Field** ptr;
-	HArrayOfObject* array;
-	int i;
-	Field *fld = CLASS_FIELDS(clazz);
-
-	if (publicOnly) {
-		count = 0;
-		for (i = CLASS_NFIELDS(clazz)-1; i >= 0; i--) {
-			if (publicOnly && ((fld[i].accflags&ACC_PUBLIC)==0))
-				continue;
-			
-			count++;
-		}
-	} else {
-		count = CLASS_NFIELDS(clazz);
-	}
-
-	array = (HArrayOfObject*)
-	    AllocObjectArray(count, "Ljava/lang/reflect/Field;", NULL);
-	ptr = (Hjava_lang_reflect_Field**)&unhand_array(array)->body[0];
-
-	for (i = CLASS_NFIELDS(clazz)-1; i >= 0;  i--) {
-		if (publicOnly && ((fld[i].accflags & ACC_PUBLIC)==0))
-			continue;
-
-		
-		*ptr = KaffeVM_makeReflectField(clazz, i);
-		ptr++;
-	}
-
-	return (array);
+	return (KaffeVM_getDeclaredFields(clazz, publicOnly));
 }
 
 Hjava_lang_Class*
@@ -677,3 +579,33 @@ java_lang_VMClass_isMemberClass(struct Hjava_lang_Class* klass)
   return (klass->this_inner_index >= 0);
 }
 
+const nativeBinding kaffeNativesVMClass[] = {
+	NATIVE_BINDING(java_lang_VMClass_forName),
+	NATIVE_BINDING(java_lang_VMClass_loadArrayClass),
+	NATIVE_BINDING(java_lang_VMClass_initialize),
+	NATIVE_BINDING(java_lang_VMClass_getName),
+	NATIVE_BINDING(java_lang_VMClass_getSuperclass),
+	NATIVE_BINDING(java_lang_VMClass_getInterfaces),
+	NATIVE_BINDING(java_lang_VMClass_getClassLoader),
+	NATIVE_BINDING(java_lang_VMClass_isInterface),
+	NATIVE_BINDING(java_lang_VMClass_isPrimitive),
+	NATIVE_BINDING(java_lang_VMClass_isArray),
+	NATIVE_BINDING(java_lang_VMClass_getComponentType),
+	NATIVE_BINDING(java_lang_VMClass_isAssignableFrom),
+	NATIVE_BINDING(java_lang_VMClass_isInstance),
+	NATIVE_BINDING(java_lang_VMClass_getModifiers),
+	NATIVE_BINDING(java_lang_VMClass_getDeclaredMethods),
+	NATIVE_BINDING(java_lang_VMClass_getDeclaredConstructors),
+	NATIVE_BINDING(java_lang_VMClass_getDeclaredFields),
+	NATIVE_BINDING(java_lang_VMClass_getDeclaringClass),
+	NATIVE_BINDING(java_lang_VMClass_getDeclaredClasses),
+	NATIVE_BINDING(java_lang_VMClass_throwException),
+	NATIVE_BINDING(java_lang_VMClass_getEnclosingClass),
+	NATIVE_BINDING(java_lang_VMClass_getEnclosingConstructor),
+	NATIVE_BINDING(java_lang_VMClass_getEnclosingMethod),
+	NATIVE_BINDING(java_lang_VMClass_getClassSignature),
+	NATIVE_BINDING(java_lang_VMClass_isAnonymousClass),
+	NATIVE_BINDING(java_lang_VMClass_isLocalClass),
+	NATIVE_BINDING(java_lang_VMClass_isMemberClass),
+	NATIVE_BINDING_END
+};
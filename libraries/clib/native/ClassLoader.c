@@ -27,9 +27,11 @@
 #include "stringSupport.h"
 #include "baseClasses.h"
 #include "exception.h"
+#include "startupTrace.h"
 #include "java_lang_ClassLoader.h"
 #include "java_lang_VMClassLoader.h"
 #include "defs.h"
+#include "external.h"
 
 struct Hjava_lang_Class*
 java_lang_VMClassLoader_getPrimitiveClass(jchar typeCode)
@@ -60,6 +62,7 @@ java_lang_VMClassLoader_defineClass(struct Hjava_lang_ClassLoader* this, struct
 	classEntry *centry;
 	errorInfo info;
 	const unsigned char* buf;
+	statTime traceStart = STARTUP_TRACE_START();
 
 	/* This is the error sent by JDK 1.4.2 */
 	if (length == 0)
@@ -94,6 +97,7 @@ java_lang_VMClassLoader_defineClass(struct Hjava_lang_ClassLoader* this, struct
 	if (clazz == 0) {
 		throwError(&info);
 	}
+	STARTUP_TRACE_END(traceStart, "read", CLASS_CNAME(clazz), NULL);
 
 	/* set protection domain of new class */
 	unhand(clazz)->protectionDomain = protectionDomain;
@@ -250,3 +254,11 @@ java_lang_VMClassLoader_loadClass(Hjava_lang_String* jStr, jboolean resolve)
 	return( clazz );
 }
 
+const nativeBinding kaffeNativesVMClassLoader[] = {
+	NATIVE_BINDING(java_lang_VMClassLoader_getPrimitiveClass),
+	NATIVE_BINDING(java_lang_VMClassLoader_defineClass),
+	NATIVE_BINDING(java_lang_VMClassLoader_resolveClass),
+	NATIVE_BINDING(java_lang_VMClassLoader_findLoadedClass),
+	NATIVE_BINDING(java_lang_VMClassLoader_loadClass),
+	NATIVE_BINDING_END
+};
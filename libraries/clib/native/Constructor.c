@@ -25,6 +25,7 @@
 #include <jni.h>
 #include "defs.h"
 #include "stringSupport.h"
+#include "external.h"
 
 jint
 java_lang_reflect_Constructor_getModifiersInternal(struct Hjava_lang_reflect_Constructor* this)
@@ -53,3 +54,9 @@ java_lang_reflect_Constructor_getSignature(struct Hjava_lang_reflect_Constructor
 
 	return utf8Const2Java(Kaffe_get_class_methods(clazz)[slot].extSignature);
 }
+
+const nativeBinding kaffeNativesConstructor[] = {
+	NATIVE_BINDING(java_lang_reflect_Constructor_getModifiersInternal),
+	NATIVE_BINDING(java_lang_reflect_Constructor_getSignature),
+	NATIVE_BINDING_END
+};
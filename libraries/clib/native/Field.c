@@ -29,6 +29,7 @@
 #include "native.h"
 #include "defs.h"
 #include "stringSupport.h"
+#include "external.h"
 
 static
 volatile void*
@@ -177,3 +178,27 @@ java_lang_reflect_Field_getSignature(struct Hjava_lang_reflect_Field* this)
 
 	return utf8Const2Java(CLASS_FIELDS(clazz)[slot].extSignature);
 }
+
+const nativeBinding kaffeNativesField[] = {
+	NATIVE_BINDING(java_lang_reflect_Field_getModifiersInternal),
+	NATIVE_BINDING(java_lang_reflect_Field_getObject0),
+	NATIVE_BINDING(java_lang_reflect_Field_getBoolean0),
+	NATIVE_BINDING(java_lang_reflect_Field_getByte0),
+	NATIVE_BINDING(java_lang_reflect_Field_getChar0),
+	NATIVE_BINDING(java_lang_reflect_Field_getShort0),
+	NATIVE_BINDING(java_lang_reflect_Field_getInt0),
+	NATIVE_BINDING(java_lang_reflect_Field_getLong0),
+	NATIVE_BINDING(java_lang_reflect_Field_getFloat0),
+	NATIVE_BINDING(java_lang_reflect_Field_getDouble0),
+	NATIVE_BINDING(java_lang_reflect_Field_setBoolean0),
+	NATIVE_BINDING(java_lang_reflect_Field_setByte0),
+	NATIVE_BINDING(java_lang_reflect_Field_setChar0),
+	NATIVE_BINDING(java_lang_reflect_Field_setShort0),
+	NATIVE_BINDING(java_lang_reflect_Field_setInt0),
+	NATIVE_BINDING(java_lang_reflect_Field_setLong0),
+	NATIVE_BINDING(java_lang_reflect_Field_setFloat0),
+	NATIVE_BINDING(java_lang_reflect_Field_setDouble0),
+	NATIVE_BINDING(java_lang_reflect_Field_setObject0),
+	NATIVE_BINDING(java_lang_reflect_Field_getSignature),
+	NATIVE_BINDING_END
+};
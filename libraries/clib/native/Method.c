@@ -26,6 +26,7 @@
 #include "jni.h"
 #include "defs.h"
 #include "stringSupport.h"
+#include "external.h"
 
 static jclass Zclass;
 static jclass Bclass;
@@ -324,3 +325,11 @@ Java_java_lang_reflect_Method_invoke0(JNIEnv* env, jobject _this, jobject _obj,
 
 	return (NULL);
 }
+
+const nativeBinding kaffeNativesMethod[] = {
+	NATIVE_BINDING(Java_java_lang_reflect_Method_init0),
+	NATIVE_BINDING(java_lang_reflect_Method_getModifiersInternal),
+	NATIVE_BINDING(java_lang_reflect_Method_getSignature),
+	NATIVE_BINDING(Java_java_lang_reflect_Method_invoke0),
+	NATIVE_BINDING_END
+};
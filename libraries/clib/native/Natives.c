@@ -0,0 +1,62 @@
+/*
+ * Natives.c
+ * Binding tables for the natives built into libkaffevm.
+ *
+ * Copyright (c) 2026
+ *      Kaffe.org contributors.  See ChangeLog for details.
+ *      All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include "config.h"
+#include "config-std.h"
+#include "gtypes.h"
+#include "external.h"
+
+/*
+ * Each source file in this directory ends with a table of the natives
+ * it defines.  initNative() binds them all at once, so that linking
+ * these methods never has to go through the dynamic linker.
+ */
+extern const nativeBinding kaffeNativesVMAccessController[];
+extern const nativeBinding kaffeNativesReference[];
+extern const nativeBinding kaffeNativesConstructor[];
+extern const nativeBinding kaffeNativesField[];
+extern const nativeBinding kaffeNativesMethod[];
+extern const nativeBinding kaffeNativesVMClass[];
+extern const nativeBinding kaffeNativesVMClassLoader[];
+extern const nativeBinding kaffeNativesVMObject[];
+extern const nativeBinding kaffeNativesVMRuntime[];
+extern const nativeBinding kaffeNativesVMRuntimeJNI[];
+extern const nativeBinding kaffeNativesVMString[];
+extern const nativeBinding kaffeNativesVMSystem[];
+extern const nativeBinding kaffeNativesVMThread[];
+extern const nativeBinding kaffeNativesVMThrowable[];
+extern const nativeBinding kaffeNativesVMStackWalker[];
+extern const nativeBinding kaffeNativesVMSystemProperties[];
+extern const nativeBinding kaffeNativesUnsafe[];
+extern const nativeBinding kaffeNativesDiagnostics[];
+
+const nativeBinding* const kaffeNativeBindings[] = {
+	kaffeNativesVMAccessController,
+	kaffeNativesReference,
+	kaffeNativesConstructor,
+	kaffeNativesField,
+	kaffeNativesMethod,
+	kaffeNativesVMClass,
+	kaffeNativesVMClassLoader,
+	kaffeNativesVMObject,
+	kaffeNativesVMRuntime,
+	kaffeNativesVMRuntimeJNI,
+	kaffeNativesVMString,
+	kaffeNativesVMSystem,
+	kaffeNativesVMThread,
+	kaffeNativesVMThrowable,
+	kaffeNativesVMStackWalker,
+	kaffeNativesVMSystemProperties,
+	kaffeNativesUnsafe,
+	kaffeNativesDiagnostics,
+	NULL
+};
@@ -167,3 +167,19 @@ java_lang_VMRuntime_getLibSuffix(void)
 	return checkPtr(stringC2Java(LIBRARYSUFFIX));
 }
 
+const nativeBinding kaffeNativesVMRuntime[] = {
+	NATIVE_BINDING(java_lang_VMRuntime_exit),
+	NATIVE_BINDING(java_lang_VMRuntime_freeMemory),
+	NATIVE_BINDING(java_lang_VMRuntime_maxMemory),
+	NATIVE_BINDING(java_lang_VMRuntime_totalMemory),
+	NATIVE_BINDING(java_lang_VMRuntime_gc),
+	NATIVE_BINDING(java_lang_VMRuntime_runFinalization),
+	NATIVE_BINDING(java_lang_VMRuntime_runFinalizationForExit),
+	NATIVE_BINDING(java_lang_VMRuntime_traceInstructions),
+	NATIVE_BINDING(java_lang_VMRuntime_traceMethodCalls),
+	NATIVE_BINDING(java_lang_VMRuntime_runFinalizersOnExit),
+	NATIVE_BINDING(java_lang_VMRuntime_nativeLoad),
+	NATIVE_BINDING(java_lang_VMRuntime_getLibPrefix),
+	NATIVE_BINDING(java_lang_VMRuntime_getLibSuffix),
+	NATIVE_BINDING_END
+};
@@ -36,6 +36,7 @@
 #include "debug.h"
 #include "exception.h"
 #include "system.h"
+#include "bulkArray.h"
 #include "defs.h"
 #include "java_lang_VMSystem.h"
 #include "java_lang_Throwable.h"
@@ -63,22 +64,24 @@ java_lang_VMSystem_arraycopy0(struct Hjava_lang_Object* src,
 	int elemsz; 	 
 	Hjava_lang_Class* sclass; 	 
 	Hjava_lang_Class* dclass;
+	Hjava_lang_Object* val;
 
 	sclass = OBJECT_CLASS(src); 	 
 	dclass = OBJECT_CLASS(dst);
 
 	sclass = Kaffe_get_array_element_type(sclass); 	 
 	dclass = Kaffe_get_array_element_type(dclass); 	 
-	elemsz = TYPE_SIZE(sclass); 	 
 
-	len *= elemsz; 	 
-	srcpos *= elemsz; 	 
-	dstpos *= elemsz; 	 
+	if (sclass == dclass) {
+		elemsz = TYPE_SIZE(sclass);
 
-	in = &((char*)ARRAY_DATA(src))[srcpos]; 	 
-	out = &((char*)ARRAY_DATA(dst))[dstpos];
+		len *= elemsz;
+		srcpos *= elemsz;
+		dstpos *= elemsz;
+
+		in = &((char*)ARRAY_DATA(src))[srcpos];
+		out = &((char*)ARRAY_DATA(dst))[dstpos];
 
-	if (sclass == dclass) {
 #if defined(HAVE_MEMMOVE) 	 
 		memmove((void*)out, (void*)in, (size_t)len); 	 
 #else 	 
@@ -117,24 +120,26 @@ java_lang_VMSystem_arraycopy0(struct Hjava_lang_Object* src,
 		  throwException(asexc);
 		}
 
-		for (; len > 0; len -= sizeof(Hjava_lang_Object*)) { 	 
-			Hjava_lang_Object* val = *(Hjava_lang_Object**)in; 	 
-			if (val != 0 && !instanceof(dclass, OBJECT_CLASS(val))) { 	 
-			  Hjava_lang_Throwable* asexc;
-			  const char *vtype = CLASS_CNAME(OBJECT_CLASS(val));
-			  const char *atype = CLASS_CNAME(dclass);
-			  char *b;
+		/* Copy the references, checking them as far as needed */
+		val = bulkArrayCopyRefs(src, srcpos, dst, dstpos, len);
+		if (val != NULL) {
+			Hjava_lang_Throwable* asexc;
+			const char *vtype = CLASS_CNAME(OBJECT_CLASS(val));
+			const char *atype = CLASS_CNAME(dclass);
+			char *b;
 #define _FORMAT "can't store `%s' in array of type `%s'"
-			  b = checkPtr(KMALLOC(strlen(vtype)+strlen(atype)+strlen(_FORMAT)));
-			  sprintf(b, _FORMAT, vtype, atype);
+			b = checkPtr(KMALLOC(strlen(vtype)+strlen(atype)+strlen(_FORMAT)));
+			sprintf(b, _FORMAT, vtype, atype);
 #undef _FORMAT
-			  asexc = ArrayStoreException(b);
-			  KFREE(b);
-			  throwException(asexc);
-			}
-			*(Hjava_lang_Object**)out = val; 	 
-			in += sizeof(Hjava_lang_Object*); 	 
-			out += sizeof(Hjava_lang_Object*); 	 
+			asexc = ArrayStoreException(b);
+			KFREE(b);
+			throwException(asexc);
 		}
 	}
 }
+
+const nativeBinding kaffeNativesVMSystem[] = {
+	NATIVE_BINDING(java_lang_VMSystem_identityHashCode),
+	NATIVE_BINDING(java_lang_VMSystem_arraycopy0),
+	NATIVE_BINDING_END
+};
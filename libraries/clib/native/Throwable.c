@@ -16,6 +16,7 @@
 #include <native.h>
 #include "java_lang_Throwable.h"
 #include "java_lang_VMThrowable.h"
+#include "external.h"
 
 extern Hjava_lang_Object* buildStackTrace(void*);
 extern HArrayOfObject* getStackTraceElements(struct Hjava_lang_VMThrowable*,
@@ -39,3 +40,9 @@ java_lang_VMThrowable_getStackTrace(struct Hjava_lang_VMThrowable* state, struct
 {
 	return getStackTraceElements(state, throwable);
 }
+
+const nativeBinding kaffeNativesVMThrowable[] = {
+	NATIVE_BINDING(java_lang_VMThrowable_fillInStackTrace),
+	NATIVE_BINDING(java_lang_VMThrowable_getStackTrace),
+	NATIVE_BINDING_END
+};
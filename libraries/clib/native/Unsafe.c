@@ -41,6 +41,7 @@ exception statement from your version. */
 
 #include "object.h"
 #include "support.h"
+#include "external.h"
 
 /**
  * Get the offset of a field.
@@ -186,3 +187,26 @@ JNIEXPORT void JNICALL Java_sun_misc_Unsafe_park(JNIEnv* env UNUSED, jobject uns
   /** FIXME */
 }
 
+const nativeBinding kaffeNativesUnsafe[] = {
+	NATIVE_BINDING(Java_sun_misc_Unsafe_objectFieldOffset),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_compareAndSwapInt),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_compareAndSwapLong),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_compareAndSwapObject),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_putLong),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_putObject),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_putOrderedInt),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_putOrderedLong),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_putOrderedObject),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_putIntVolatile),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_putLongVolatile),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_putObjectVolatile),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_getLong),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_getIntVolatile),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_getLongVolatile),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_getObjectVolatile),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_arrayBaseOffset),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_arrayIndexScale),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_unpark),
+	NATIVE_BINDING(Java_sun_misc_Unsafe_park),
+	NATIVE_BINDING_END
+};
@@ -51,6 +51,7 @@
 #endif
 
 #include "jni.h"
+#include "external.h"
 
 /*
  * Class:     java_lang_Runtime
@@ -100,3 +101,8 @@ Java_java_lang_VMRuntime_availableProcessors(JNIEnv *env UNUSED,
 	return 1;
 #endif
 }
+
+const nativeBinding kaffeNativesVMRuntimeJNI[] = {
+	NATIVE_BINDING(Java_java_lang_VMRuntime_availableProcessors),
+	NATIVE_BINDING_END
+};
@@ -24,40 +24,37 @@
 #include "support.h"
 #include "gnu_classpath_VMStackWalker.h"
 #include "java_lang_VMClass.h"
+#include "external.h"
 
-static int findCallingMethod (stackTraceInfo *info);
+static Method* findCallingMethod (stackTraceIterator *it);
 
 HArrayOfObject* /* HArrayOfClass */
 gnu_classpath_VMStackWalker_getClassContext(void)
 {
-	stackTraceInfo* info;
-	errorInfo einfo;
+	stackTraceIterator it;
+	Method* meth;
 	int cnt;
-	int i;
-	int start;
 	HArrayOfObject* array;
 
-	info = (stackTraceInfo*)buildStackTrace(NULL);
-	if (info == NULL) {
-		postOutOfMemory(&einfo);
-		throwError(&einfo);
-	}
-
-	start = findCallingMethod (info);
-
+	/* count the frames first, then walk them again to fill the array */
+	stackTraceIterInit(&it, NULL);
 	cnt = 0;
-	for (i = start; info[i].meth != ENDOFSTACK; i++) {
-		if (info[i].meth != NULL && info[i].meth->class != NULL) {
+	for (meth = findCallingMethod (&it); meth != NULL;
+	     meth = stackTraceIterNext(&it)) {
+		if (meth->class != NULL) {
 			cnt++;
 		}
 	}
 
 	array = (HArrayOfObject*)AllocObjectArray(cnt, "Ljava/lang/Class;", NULL);
 
+	stackTraceIterInit(&it, NULL);
 	cnt = 0;
-	for (i = start; info[i].meth != ENDOFSTACK; i++) {
-		if (info[i].meth != NULL && info[i].meth->class != NULL) {
-			unhand_array(array)->body[cnt] = (Hjava_lang_Object*)info[i].meth->class;
+	for (meth = findCallingMethod (&it);
+	     meth != NULL && cnt < ARRAY_SIZE(array);
+	     meth = stackTraceIterNext(&it)) {
+		if (meth->class != NULL) {
+			unhand_array(array)->body[cnt] = (Hjava_lang_Object*)meth->class;
 			cnt++;
 		}
 	}
@@ -66,82 +63,68 @@ gnu_classpath_VMStackWalker_getClassContext(void)
 }
 
 
-static int
-findCallingMethod (stackTraceInfo* info)
+/*
+ * Advance it to the method that called the caller of VMStackWalker and
+ * return that, or NULL if there is none.  Only the frames up to it are
+ * walked.
+ */
+static Method*
+findCallingMethod (stackTraceIterator* it)
 {
 	Hjava_lang_Class*	callerOfVMStackWalker;
-	int 			ret = 0;
+	Method*			meth;
 
 	/* skip VMStackWalker; since we're only called from java code,
 	 * we cannot reach the end of the stack here.
 	 */
-	while ( (info[ret].meth == NULL) ||
-		(strcmp(CLASS_CNAME(info[ret].meth->class), "gnu/classpath/VMStackWalker") == 0))
-	{
-		ret++;
-	}
+	do {
+		meth = stackTraceIterNext(it);
+	} while (meth != NULL &&
+		 strcmp(CLASS_CNAME(meth->class), "gnu/classpath/VMStackWalker") == 0);
 
-	/* since the VMStackWalker methods are not called from native code,
-	 * we can assume that info[ret] is the frame of a java method.
-	 */
-	callerOfVMStackWalker = info[ret].meth->class;
+	if (meth == NULL) {
+		return (NULL);
+	}
 
-	/* advance to possible caller of caller of VMStackWalker */
-	ret++;
+	callerOfVMStackWalker = meth->class;
 
-	/* skip recursions inside the class calling VMStackWalker */
-	while ( (info[ret].meth != ENDOFSTACK) &&
-		((info[ret].meth == NULL) ||
-		 (info[ret].meth->class == callerOfVMStackWalker)) )
-	{
-		ret++;
-	}
+	/* advance to possible caller of caller of VMStackWalker, skipping
+	 * recursions inside the class calling VMStackWalker */
+	do {
+		meth = stackTraceIterNext(it);
+	} while (meth != NULL && meth->class == callerOfVMStackWalker);
 
 	/* if the caller of VMStackWalker was called via reflection, skip that too */
-	while ( (info[ret].meth != ENDOFSTACK) &&
-		((info[ret].meth == NULL) ||
-		 (strncmp (CLASS_CNAME(info[ret].meth->class), "java/lang/reflect/", 18) == 0)) )
-	{
-		ret++;
+	while (meth != NULL &&
+	       strncmp (CLASS_CNAME(meth->class), "java/lang/reflect/", 18) == 0) {
+		meth = stackTraceIterNext(it);
 	}
 
-	return ret;
+	return (meth);
 }
 
 Hjava_lang_Class*
 gnu_classpath_VMStackWalker_getCallingClass(void)
 {
-	stackTraceInfo* info;
-	errorInfo einfo;
-	int start;
-
-	info = (stackTraceInfo*)buildStackTrace(NULL);
-	if (info == NULL) {
-		postOutOfMemory(&einfo);
-		throwError(&einfo);
-	}
+	stackTraceIterator it;
+	Method* meth;
 
-	start = findCallingMethod (info);
+	stackTraceIterInit(&it, NULL);
+	meth = findCallingMethod (&it);
 
-	return (info[start].meth == ENDOFSTACK) ? NULL : info[start].meth->class;
+	return (meth == NULL) ? NULL : meth->class;
 }
 
 Hjava_lang_ClassLoader*
 gnu_classpath_VMStackWalker_getCallingClassLoader(void)
 {
-	stackTraceInfo* info;
-	errorInfo einfo;
-	int start;
-
-	info = (stackTraceInfo*)buildStackTrace(NULL);
-	if (info == NULL) {
-		postOutOfMemory(&einfo);
-		throwError(&einfo);
-	}
+	stackTraceIterator it;
+	Method* meth;
 
-	start = findCallingMethod (info);
+	stackTraceIterInit(&it, NULL);
+	meth = findCallingMethod (&it);
 
-	return (info[start].meth == ENDOFSTACK) ? NULL : info[start].meth->class->loader;
+	return (meth == NULL) ? NULL : meth->class->loader;
 }
 
 struct Hjava_lang_ClassLoader* 
@@ -150,3 +133,10 @@ gnu_classpath_VMStackWalker_getClassLoader(struct Hjava_lang_Class* clazz)
 	return java_lang_VMClass_getClassLoader(clazz);
 }
 
+const nativeBinding kaffeNativesVMStackWalker[] = {
+	NATIVE_BINDING(gnu_classpath_VMStackWalker_getClassContext),
+	NATIVE_BINDING(gnu_classpath_VMStackWalker_getCallingClass),
+	NATIVE_BINDING(gnu_classpath_VMStackWalker_getCallingClassLoader),
+	NATIVE_BINDING(gnu_classpath_VMStackWalker_getClassLoader),
+	NATIVE_BINDING_END
+};
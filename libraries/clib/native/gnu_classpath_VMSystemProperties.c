@@ -365,3 +365,25 @@ Java_gnu_classpath_VMSystemProperties_getGnuCpuEndian (JNIEnv *env,
 
   return (*env)->NewStringUTF(env, endian);
 }
+
+const nativeBinding kaffeNativesVMSystemProperties[] = {
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_postInit),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getLocale),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getKaffeLibraryPath),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getSunBootClassPath),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getFileSeparator),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getLineSeparator),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getPathSeparator),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getJavaClassPath),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getJavaIoTmpdir),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getJavaCompiler),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getJavaHome),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getOsName),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getOsArch),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getOsVersion),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getUserDir),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getUserName),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getUserHome),
+	NATIVE_BINDING(Java_gnu_classpath_VMSystemProperties_getGnuCpuEndian),
+	NATIVE_BINDING_END
+};
@@ -30,6 +30,7 @@
 #include "thread.h"
 #include "jvmpi_kaffe.h"
 #include "debug.h"
+#include "external.h"
 
 /*
  * Return class object for this object.
@@ -160,3 +161,12 @@ DBG(VMTHREAD, dprintf ("%p (%p) waiting for %p, %" PRIi64 "\n",
       throwException(InterruptedException);
     }
 }
+
+const nativeBinding kaffeNativesVMObject[] = {
+	NATIVE_BINDING(java_lang_VMObject_getClass),
+	NATIVE_BINDING(java_lang_VMObject_notifyAll),
+	NATIVE_BINDING(java_lang_VMObject_notify),
+	NATIVE_BINDING(java_lang_VMObject_clone),
+	NATIVE_BINDING(java_lang_VMObject_wait),
+	NATIVE_BINDING_END
+};
@@ -17,6 +17,7 @@
 
 #include "stringSupport.h"
 #include "java_lang_String.h"
+#include "external.h"
 
 Hjava_lang_String*
 java_lang_VMString_intern(Hjava_lang_String* str)
@@ -30,3 +31,8 @@ java_lang_VMString_intern(Hjava_lang_String* str)
 	}
 	return ret;
 }
+
+const nativeBinding kaffeNativesVMString[] = {
+	NATIVE_BINDING(java_lang_VMString_intern),
+	NATIVE_BINDING_END
+};
@@ -21,6 +21,7 @@
 #include "support.h"
 #include "jthread.h"
 #include "debug.h"
+#include "external.h"
 
 struct Hjava_lang_Thread*
 java_lang_VMThread_currentThread(void)
@@ -81,3 +82,16 @@ jint java_lang_VMThread_getState0(struct Hjava_lang_VMThread* this)
 {
    return KTHREAD(get_status)((jthread_t)unhand(this)->vmdata);
 }
+
+const nativeBinding kaffeNativesVMThread[] = {
+	NATIVE_BINDING(java_lang_VMThread_currentThread),
+	NATIVE_BINDING(java_lang_VMThread_yield),
+	NATIVE_BINDING(java_lang_VMThread_start),
+	NATIVE_BINDING(java_lang_VMThread_nativeSetPriority),
+	NATIVE_BINDING(java_lang_VMThread_interrupt),
+	NATIVE_BINDING(java_lang_VMThread_finalize),
+	NATIVE_BINDING(java_lang_VMThread_interrupted),
+	NATIVE_BINDING(java_lang_VMThread_isInterrupted),
+	NATIVE_BINDING(java_lang_VMThread_getState0),
+	NATIVE_BINDING_END
+};
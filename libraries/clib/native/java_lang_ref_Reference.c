@@ -9,6 +9,7 @@
 #include "gc.h"
 #include "errors.h"
 #include "utf8const.h"
+#include "external.h"
 
 void JNICALL Java_java_lang_ref_Reference_create(JNIEnv* env, jobject reference, jobject object)
 {
@@ -33,3 +34,8 @@ void JNICALL Java_java_lang_ref_Reference_create(JNIEnv* env, jobject reference,
 
   KaffeVM_registerObjectReference(reference, object, reftype);
 }
+
+const nativeBinding kaffeNativesReference[] = {
+	NATIVE_BINDING(Java_java_lang_ref_Reference_create),
+	NATIVE_BINDING_END
+};
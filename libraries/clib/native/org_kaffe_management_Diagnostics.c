@@ -0,0 +1,97 @@
+/*
+ * org_kaffe_management_Diagnostics.c
+ * Diagnostics asked for by the running program.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include "config.h"
+#include "config-std.h"
+
+#include "jni.h"
+#include "external.h"
+#include "heapDump.h"
+#include "lockProfile.h"
+#include "jitProfile.h"
+
+typedef bool (*diagnosticsWriter)(const char *);
+
+static jboolean
+writeDiagnostics(JNIEnv *env, jstring file, diagnosticsWriter writer)
+{
+	const char *path;
+	jboolean ok;
+
+	path = (*env)->GetStringUTFChars(env, file, NULL);
+	if (path == NULL) {
+		return (JNI_FALSE);
+	}
+	ok = writer(path) ? JNI_TRUE : JNI_FALSE;
+	(*env)->ReleaseStringUTFChars(env, file, path);
+
+	return (ok);
+}
+
+/*
+ * Class:     org_kaffe_management_Diagnostics
+ * Method:    writeHeapHistogram
+ * Signature: (Ljava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL
+Java_org_kaffe_management_Diagnostics_writeHeapHistogram(JNIEnv *env,
+							 jclass clazz UNUSED,
+							 jstring file)
+{
+	return (writeDiagnostics(env, file, heapWriteHistogram));
+}
+
+/*
+ * Class:     org_kaffe_management_Diagnostics
+ * Method:    writeHeapDump
+ * Signature: (Ljava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL
+Java_org_kaffe_management_Diagnostics_writeHeapDump(JNIEnv *env,
+						    jclass clazz UNUSED,
+						    jstring file)
+{
+	return (writeDiagnostics(env, file, heapWriteDump));
+}
+
+/*
+ * Class:     org_kaffe_management_Diagnostics
+ * Method:    writeMonitorContention
+ * Signature: (Ljava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL
+Java_org_kaffe_management_Diagnostics_writeMonitorContention(JNIEnv *env,
+							     jclass clazz UNUSED,
+							     jstring file)
+{
+	return (writeDiagnostics(env, file, lockProfileWrite));
+}
+
+/*
+ * Class:     org_kaffe_management_Diagnostics
+ * Method:    writeCompilations
+ * Signature: (Ljava/lang/String;)Z
+ */
+JNIEXPORT jboolean JNICALL
+Java_org_kaffe_management_Diagnostics_writeCompilations(JNIEnv *env,
+							jclass clazz UNUSED,
+							jstring file)
+{
+	return (writeDiagnostics(env, file, jitProfileWrite));
+}
+
+const nativeBinding kaffeNativesDiagnostics[] = {
+	NATIVE_BINDING(Java_org_kaffe_management_Diagnostics_writeHeapHistogram),
+	NATIVE_BINDING(Java_org_kaffe_management_Diagnostics_writeHeapDump),
+	NATIVE_BINDING(Java_org_kaffe_management_Diagnostics_writeMonitorContention),
+	NATIVE_BINDING(Java_org_kaffe_management_Diagnostics_writeCompilations),
+	NATIVE_BINDING_END
+};
@@ -0,0 +1,70 @@
+/*
+ * Java core library component.
+ *
+ * Copyright (c) 2026
+ *      Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+package org.kaffe.management;
+
+/**
+ * Diagnostics a program can ask the virtual machine for while it runs.
+ *
+ * The heap diagnostics collect the heap first.  Threads that need to
+ * collect while the file is being written wait until it is done.  Only
+ * the default collector can enumerate the heap; with the others they
+ * return false.
+ */
+public final class Diagnostics {
+
+/**
+ * No instance is ever created.
+ */
+private Diagnostics() {
+}
+
+/**
+ * Writes the number of live instances of each class and the bytes they
+ * take up, largest first, in the format printed by jmap -histo.
+ *
+ * @param file the file to write
+ * @return true if the histogram was written
+ */
+public static native boolean writeHeapHistogram(String file);
+
+/**
+ * Writes the live heap in the HPROF binary format, for heap analysers.
+ * Objects are written while other threads keep running, so field values
+ * may be newer than the collection that found the objects.
+ *
+ * @param file the file to write
+ * @return true if the dump was written
+ */
+public static native boolean writeHeapDump(String file);
+
+/**
+ * Writes the monitors threads have waited for, longest waited for
+ * first.  Each comes with the class of its object, how often and how
+ * long threads waited for it, and the places they waited from most.
+ *
+ * @param file the file to write
+ * @return true if the list was written
+ */
+public static native boolean writeMonitorContention(String file);
+
+/**
+ * Writes the methods most recently compiled to native code, oldest
+ * first: their bytecode and native code sizes, the constants and spill
+ * code generated for them, and how long compiling them took.  The file
+ * is written as JSON if its name ends in ".json" and as CSV otherwise.
+ * With the interpreter the list is empty.
+ *
+ * @param file the file to write
+ * @return true if the list was written
+ */
+public static native boolean writeCompilations(String file);
+
+}
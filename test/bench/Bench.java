@@ -0,0 +1,518 @@
+/*
+ * Bench.java -- Microbenchmarks for the virtual machine's hot paths.
+ *
+ * Each benchmark repeats one operation, such as allocating an object or
+ * entering a monitor, enough times for a run to take about bench.time
+ * milliseconds, then times bench.runs runs.  The result of each benchmark
+ * is printed as one JSON object per line, with the best and the median
+ * time per operation in nanoseconds, so runs on different engines and
+ * revisions can be compared by a script.
+ *
+ * Usage: kaffe [-Dbench.engine=<name>] [-Dbench.time=<ms>]
+ *	  [-Dbench.runs=<n>] [-Dbench.jar=<file>] Bench [benchmark...]
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+import java.io.File;
+import java.net.URL;
+import java.net.URLClassLoader;
+import java.util.Arrays;
+
+public class Bench
+{
+	/* Results are added here so no benchmark loop is dead code */
+	static volatile int sink;
+
+	/* Classes in bench.jar, see BenchLoadee.java */
+	static final int LOADEES = 8;
+
+	static abstract class Case
+	{
+		final String name;
+
+		Case(String name)
+		{
+			this.name = name;
+		}
+
+		/* Prepare a run, throw to skip the benchmark */
+		void setup() throws Throwable
+		{
+		}
+
+		/* Do the operation n times */
+		abstract int run(int n) throws Throwable;
+	}
+
+	/* Dispatch targets */
+	static abstract class Shape
+	{
+		abstract int area();
+	}
+
+	static class Square extends Shape
+	{
+		int side = 3;
+
+		int area()
+		{
+			return side * side;
+		}
+	}
+
+	static class Rect extends Shape
+	{
+		int w = 2;
+		int h = 5;
+
+		int area()
+		{
+			return w * h;
+		}
+	}
+
+	interface Sized
+	{
+		int size();
+	}
+
+	static class Small implements Sized
+	{
+		public int size()
+		{
+			return 1;
+		}
+	}
+
+	static class Large implements Sized
+	{
+		public int size()
+		{
+			return 100;
+		}
+	}
+
+	static class Fields
+	{
+		int a;
+		int b = 1;
+		long c;
+		Object d;
+	}
+
+	static class BenchException extends Exception
+	{
+		BenchException()
+		{
+		}
+	}
+
+	static native int nativeNop(int x);
+
+	static int thrower(int depth) throws BenchException
+	{
+		if (depth == 0) {
+			throw new BenchException();
+		}
+		return thrower(depth - 1) + 1;
+	}
+
+	static int recursive(Object lock, int depth)
+	{
+		synchronized (lock) {
+			return depth == 0 ? 1 : recursive(lock, depth - 1) + 1;
+		}
+	}
+
+	static final Case[] CASES = {
+		new Case("alloc") {
+			int run(int n)
+			{
+				Object o = null;
+				for (int i = 0; i < n; i++) {
+					o = new Fields();
+				}
+				return o.hashCode();
+			}
+		},
+		new Case("alloc-array") {
+			int run(int n)
+			{
+				int[] a = null;
+				for (int i = 0; i < n; i++) {
+					a = new int[16];
+				}
+				return a.length;
+			}
+		},
+		new Case("monitor-thin") {
+			final Object lock = new Object();
+			int count;
+
+			int run(int n)
+			{
+				for (int i = 0; i < n; i++) {
+					synchronized (lock) {
+						count++;
+					}
+				}
+				return count;
+			}
+		},
+		/* One operation enters and exits four levels deep */
+		new Case("monitor-recursive") {
+			final Object lock = new Object();
+
+			int run(int n)
+			{
+				int r = 0;
+				for (int i = 0; i < n; i++) {
+					r += recursive(lock, 3);
+				}
+				return r;
+			}
+		},
+		/* One operation is an enter and exit by each of two threads */
+		new Case("monitor-contended") {
+			final Object lock = new Object();
+			int count;
+
+			int run(final int n) throws Throwable
+			{
+				Thread other = new Thread() {
+					public void run()
+					{
+						for (int i = 0; i < n; i++) {
+							synchronized (lock) {
+								count++;
+							}
+						}
+					}
+				};
+				other.start();
+				for (int i = 0; i < n; i++) {
+					synchronized (lock) {
+						count--;
+					}
+				}
+				other.join();
+				return count;
+			}
+		},
+		new Case("dispatch-virtual") {
+			final Shape[] shapes = { new Square(), new Rect() };
+
+			int run(int n)
+			{
+				int r = 0;
+				for (int i = 0; i < n; i++) {
+					r += shapes[i & 1].area();
+				}
+				return r;
+			}
+		},
+		new Case("dispatch-interface") {
+			final Sized[] sized = { new Small(), new Large() };
+
+			int run(int n)
+			{
+				int r = 0;
+				for (int i = 0; i < n; i++) {
+					r += sized[i & 1].size();
+				}
+				return r;
+			}
+		},
+		new Case("field-access") {
+			final Fields f = new Fields();
+
+			int run(int n)
+			{
+				Fields o = f;
+				for (int i = 0; i < n; i++) {
+					o.a = o.b + i;
+					o.c += o.a;
+					o.d = o;
+				}
+				return (int)o.c;
+			}
+		},
+		/* Thrown three frames below the handler */
+		new Case("exception") {
+			int run(int n)
+			{
+				int r = 0;
+				for (int i = 0; i < n; i++) {
+					try {
+						r += thrower(2);
+					}
+					catch (BenchException e) {
+						r++;
+					}
+				}
+				return r;
+			}
+		},
+		new Case("intern") {
+			final String[] strings = new String[256];
+
+			void setup()
+			{
+				for (int i = 0; i < strings.length; i++) {
+					strings[i] = new StringBuffer("bench.intern.")
+						.append(i).toString();
+				}
+			}
+
+			int run(int n)
+			{
+				int r = 0;
+				for (int i = 0; i < n; i++) {
+					r += strings[i & 255].intern().length();
+				}
+				return r;
+			}
+		},
+		new Case("arraycopy-small") {
+			final char[] from = new char[16];
+			final char[] to = new char[16];
+
+			int run(int n)
+			{
+				for (int i = 0; i < n; i++) {
+					System.arraycopy(from, 0, to, i & 7, 8);
+				}
+				return to[0];
+			}
+		},
+		new Case("arraycopy-large") {
+			final int[] from = new int[4096];
+			final int[] to = new int[4096];
+
+			int run(int n)
+			{
+				for (int i = 0; i < n; i++) {
+					System.arraycopy(from, 0, to, 0, from.length);
+				}
+				return to[0];
+			}
+		},
+		new Case("arraycopy-refs") {
+			final String[] from = new String[256];
+			final Object[] to = new Object[256];
+
+			int run(int n)
+			{
+				for (int i = 0; i < n; i++) {
+					System.arraycopy(from, 0, to, 0, from.length);
+				}
+				return to.length;
+			}
+		},
+		new Case("multiarray") {
+			int run(int n)
+			{
+				int[][] a = null;
+				for (int i = 0; i < n; i++) {
+					a = new int[64][8];
+				}
+				return a.length;
+			}
+		},
+		new Case("array-fill") {
+			final int[] a = new int[1024];
+
+			int run(int n)
+			{
+				for (int i = 0; i < n; i++) {
+					Arrays.fill(a, i);
+				}
+				return a[0];
+			}
+		},
+		new Case("array-equals") {
+			final long[] a = new long[1024];
+			final long[] b = new long[1024];
+
+			int run(int n)
+			{
+				int r = 0;
+				for (int i = 0; i < n; i++) {
+					if (Arrays.equals(a, b)) {
+						r++;
+					}
+				}
+				return r;
+			}
+		},
+		new Case("jni-call") {
+			void setup()
+			{
+				System.loadLibrary("benchnative");
+			}
+
+			int run(int n)
+			{
+				int r = 0;
+				for (int i = 0; i < n; i++) {
+					r = nativeNop(r);
+				}
+				return r;
+			}
+		},
+		/* A new class loader for every LOADEES classes */
+		new Case("classload") {
+			URL[] urls;
+
+			void setup() throws Throwable
+			{
+				File jar = new File(System.getProperty("bench.jar",
+							"bench-load.jar"));
+				if (!jar.exists()) {
+					throw new Exception(jar + " not found");
+				}
+				urls = new URL[] { jar.toURL() };
+			}
+
+			int run(int n) throws Throwable
+			{
+				ClassLoader loader = null;
+				int r = 0;
+				for (int i = 0; i < n; i++) {
+					int k = i % LOADEES;
+					if (k == 0) {
+						loader = new URLClassLoader(urls, null);
+					}
+					r += loader.loadClass(k == 0
+						? "BenchLoadee"
+						: "BenchLoadee" + k)
+						.getName().length();
+				}
+				return r;
+			}
+		},
+		/* One operation is a full collection with about 8Mb live */
+		new Case("gc-pause") {
+			Object[] live;
+
+			void setup()
+			{
+				live = new Object[8192];
+				for (int i = 0; i < live.length; i++) {
+					live[i] = new byte[1024];
+				}
+			}
+
+			int run(int n)
+			{
+				for (int i = 0; i < n; i++) {
+					for (int j = 0; j < 256; j++) {
+						live[(i * 256 + j) & 8191] = new byte[1024];
+					}
+					System.gc();
+				}
+				return live.length;
+			}
+		},
+	};
+
+	static String quote(String s)
+	{
+		StringBuffer b = new StringBuffer("\"");
+		for (int i = 0; i < s.length(); i++) {
+			char c = s.charAt(i);
+			if (c == '"' || c == '\\') {
+				b.append('\\');
+			}
+			if (c >= ' ') {
+				b.append(c);
+			}
+		}
+		return b.append('"').toString();
+	}
+
+	static String header(Case c)
+	{
+		return "{\"benchmark\": " + quote(c.name)
+			+ ", \"engine\": " + quote(System.getProperty(
+				"bench.engine", "unknown"))
+			+ ", \"vm\": " + quote(System.getProperty(
+				"java.vm.version", ""));
+	}
+
+	static long time(Case c, int n) throws Throwable
+	{
+		long start = System.nanoTime();
+		sink += c.run(n);
+		return System.nanoTime() - start;
+	}
+
+	static void measure(Case c, long target, int runs) throws Throwable
+	{
+		long[] times = new long[runs];
+		long t;
+		int n = 1;
+
+		/* Find how many operations take about target ns */
+		while ((t = time(c, n)) < target && n < (1 << 28)) {
+			n *= t < target / 64 ? 8 : 2;
+		}
+
+		for (int i = 0; i < runs; i++) {
+			times[i] = time(c, n);
+		}
+		java.util.Arrays.sort(times);
+
+		System.out.println(header(c)
+			+ ", \"ops\": " + n
+			+ ", \"runs\": " + runs
+			+ ", \"best_ns\": " + (double)times[0] / n
+			+ ", \"median_ns\": " + (double)times[runs / 2] / n
+			+ "}");
+	}
+
+	public static void main(String[] args) throws Throwable
+	{
+		long target = Long.getLong("bench.time", 250).longValue() * 1000000L;
+		int runs = Math.max(1, Integer.getInteger("bench.runs", 5).intValue());
+		boolean failed = false;
+
+		for (int i = 0; i < CASES.length; i++) {
+			Case c = CASES[i];
+
+			if (args.length > 0) {
+				boolean wanted = false;
+				for (int j = 0; j < args.length; j++) {
+					wanted |= args[j].equals(c.name);
+				}
+				if (!wanted) {
+					continue;
+				}
+			}
+
+			try {
+				c.setup();
+			}
+			catch (Throwable t) {
+				System.out.println(header(c) + ", \"skipped\": "
+					+ quote(t.toString()) + "}");
+				continue;
+			}
+
+			try {
+				measure(c, target, runs);
+			}
+			catch (Throwable t) {
+				System.out.println(header(c) + ", \"failed\": "
+					+ quote(t.toString()) + "}");
+				failed = true;
+			}
+		}
+		System.exit(failed ? 1 : 0);
+	}
+}
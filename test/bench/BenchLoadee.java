@@ -0,0 +1,67 @@
+/*
+ * BenchLoadee.java -- Classes the classload benchmark loads from a jar.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+public class BenchLoadee
+{
+	int value;
+
+	public int get()
+	{
+		return value;
+	}
+}
+
+class BenchLoadee1 extends BenchLoadee
+{
+	public int get()
+	{
+		return 1;
+	}
+}
+
+class BenchLoadee2 extends BenchLoadee
+{
+	String name = "two";
+}
+
+class BenchLoadee3 implements Runnable
+{
+	public void run()
+	{
+	}
+}
+
+class BenchLoadee4
+{
+	static final int[] TABLE = { 1, 2, 3, 4 };
+}
+
+class BenchLoadee5
+{
+	long a, b, c, d;
+
+	long sum()
+	{
+		return a + b + c + d;
+	}
+}
+
+class BenchLoadee6 extends BenchLoadee5
+{
+	Object next;
+}
+
+class BenchLoadee7 implements Comparable
+{
+	public int compareTo(Object o)
+	{
+		return 0;
+	}
+}
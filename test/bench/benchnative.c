@@ -0,0 +1,19 @@
+/*
+ * benchnative.c -- Native methods for the jni-call benchmark.
+ *
+ * Copyright (c) 2026
+ *	Kaffe.org contributors. See ChangeLog for details. All rights reserved.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include <jni.h>
+
+JNIEXPORT jint JNICALL
+Java_Bench_nativeNop(JNIEnv *env, jclass clazz, jint x)
+{
+	(void)env;
+	(void)clazz;
+	return x + 1;
+}
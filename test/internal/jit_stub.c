@@ -131,6 +131,7 @@ int main(int argc, char *argv[])
 	Code_name = utf8ConstFromString("Code");
 	LineNumberTable_name = utf8ConstFromString("LineNumberTable");
 	LocalVariableTable_name = utf8ConstFromString("LocalVariableTable");
+	StackMapTable_name = utf8ConstFromString("StackMapTable");
 	ConstantValue_name = utf8ConstFromString("ConstantValue");
 	Exceptions_name = utf8ConstFromString("Exceptions");
 	SourceFile_name = utf8ConstFromString("SourceFile");
@@ -0,0 +1,102 @@
+/*
+ * JNICriticalTest.java -- Test JNI critical regions against concurrent
+ * garbage collection.
+ *
+ * Copyright (C) 2026
+ *    The Kaffe.org's developers. See ChangeLog for details.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+public class JNICriticalTest
+{
+	static {
+		System.out.println("Loading jnicriticallib...");
+		System.loadLibrary("jnicriticallib");
+	}
+
+	static final int ROUNDS = 2000;
+	static final int WORKERS = 4;
+
+	static volatile boolean done;
+
+	/* Fill and check both arrays inside nested critical regions. */
+	static native boolean fillCritical(byte[] a, int[] b, int rounds);
+
+	/* Stay inside a critical region for millis milliseconds. */
+	static native boolean holdCritical(byte[] a, int millis);
+	static native boolean criticalEntered();
+	static native boolean criticalLeft();
+
+	static class Collector extends Thread
+	{
+		public void run()
+		{
+			while (!done) {
+				Object[] garbage = new Object[64];
+
+				for (int i = 0; i < garbage.length; i++) {
+					garbage[i] = new byte[256];
+				}
+				System.gc();
+			}
+		}
+	}
+
+	static class Holder extends Thread
+	{
+		public void run()
+		{
+			holdCritical(new byte[16], 500);
+		}
+	}
+
+	static class Worker extends Thread
+	{
+		boolean ok;
+
+		public void run()
+		{
+			ok = fillCritical(new byte[4096], new int[1024], ROUNDS);
+		}
+	}
+
+	static public void main(String args[]) throws InterruptedException
+	{
+		Collector collector = new Collector();
+		Worker[] workers = new Worker[WORKERS];
+		boolean ok = true;
+
+		collector.start();
+		for (int i = 0; i < WORKERS; i++) {
+			workers[i] = new Worker();
+			workers[i].start();
+		}
+		for (int i = 0; i < WORKERS; i++) {
+			workers[i].join();
+			ok &= workers[i].ok;
+		}
+		done = true;
+		collector.join();
+
+		/* The collector must still work once all regions are left */
+		System.gc();
+
+		System.out.println(ok ? "Critical OK !" : "Critical FAIL !");
+
+		/* A collection asked for inside a region must wait for it */
+		Holder holder = new Holder();
+
+		holder.start();
+		while (!criticalEntered()) {
+			Thread.sleep(10);
+		}
+		System.gc();
+		if (!criticalLeft()) {
+			throw new RuntimeException("collected inside a critical region");
+		}
+		holder.join();
+		System.out.println("Hold off OK !");
+	}
+}
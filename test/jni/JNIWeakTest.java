@@ -1,5 +1,5 @@
 /*
- * JNIWeakTest.java -- Test the handling of JNI weak reference.
+ * JNIWeakTest.java -- Test the handling of JNI weak and global references.
  *
  * Copyright (C) 2005
  *    The Kaffe.org's developers. See ChangeLog for details.
@@ -34,6 +34,13 @@ public class JNIWeakTest
 
 	static native void invokeWeak(Object a);
 
+	static native boolean churnGlobal(Object a, int count);
+
+	static void collect()
+	{
+		System.gc();
+	}
+
 	static public void main(String args[])
 	{
 		JNIWeakTest o = new JNIWeakTest();
@@ -49,6 +56,11 @@ public class JNIWeakTest
 		passWeakArg(new Object());
 
 		invokeWeak(o);
+
+		if (churnGlobal(new Object(), 10000))
+			System.out.println("Global OK !");
+		else
+			System.out.println("Global FAIL !");
 	}
 }
 
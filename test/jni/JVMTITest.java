@@ -0,0 +1,24 @@
+/*
+ * JVMTITest.java -- Allocate and collect for jvmtiAgentTest, which
+ * watches from a JVMTI agent.
+ *
+ * Copyright (C) 2026
+ *    The Kaffe.org's developers. See ChangeLog for details.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+public class JVMTITest
+{
+	static Object keep;
+
+	public static void main(String[] args)
+	{
+		for (int i = 0; i < 1000; i++) {
+			keep = new int[16];
+		}
+		System.gc();
+		System.out.println("JVMTITest done");
+	}
+}
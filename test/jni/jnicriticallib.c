@@ -0,0 +1,100 @@
+/*
+ * jnicriticallib.c -- Test JNI critical regions against concurrent
+ * garbage collection.
+ *
+ * Copyright (C) 2026
+ *    The Kaffe.org's developers. See ChangeLog for details.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+
+#include <jni.h>
+#include <unistd.h>
+
+/* Set by holdCritical once inside its region and just before leaving */
+static volatile int inside;
+static volatile int released;
+
+JNIEXPORT jboolean JNICALL
+Java_JNICriticalTest_fillCritical(JNIEnv *env, jclass clazz,
+				  jbyteArray a, jintArray b, jint rounds)
+{
+  jsize alen = (*env)->GetArrayLength(env, a);
+  jsize blen = (*env)->GetArrayLength(env, b);
+  jint round;
+  jsize i;
+
+  for (round = 0; round < rounds; round++)
+    {
+      jbyte *ap;
+      jint *bp;
+
+      ap = (*env)->GetPrimitiveArrayCritical(env, a, NULL);
+      bp = (*env)->GetPrimitiveArrayCritical(env, b, NULL);
+      if (ap == NULL || bp == NULL)
+	return JNI_FALSE;
+
+      /* The previous round must have left its pattern in place */
+      if (round > 0)
+	{
+	  for (i = 0; i < alen; i++)
+	    if (ap[i] != (jbyte)(round - 1 + i))
+	      return JNI_FALSE;
+	  for (i = 0; i < blen; i++)
+	    if (bp[i] != round - 1 + i)
+	      return JNI_FALSE;
+	}
+
+      for (i = 0; i < alen; i++)
+	ap[i] = (jbyte)(round + i);
+      for (i = 0; i < blen; i++)
+	bp[i] = round + i;
+
+      /* Allocating inside a critical region is not allowed by the JNI
+       * specification, but must not dead lock the collector either.
+       */
+      if ((round & 63) == 0)
+	(*env)->DeleteLocalRef(env, (*env)->NewByteArray(env, 1024));
+
+      /* Leave the regions in the same order as they were entered */
+      (*env)->ReleasePrimitiveArrayCritical(env, a, ap, 0);
+      (*env)->ReleasePrimitiveArrayCritical(env, b, bp, 0);
+    }
+
+  return JNI_TRUE;
+}
+
+/*
+ * Stay inside a critical region for a while, so that a collection
+ * requested meanwhile has to wait for it.
+ */
+JNIEXPORT jboolean JNICALL
+Java_JNICriticalTest_holdCritical(JNIEnv *env, jclass clazz,
+				  jbyteArray a, jint millis)
+{
+  jbyte *ap;
+
+  ap = (*env)->GetPrimitiveArrayCritical(env, a, NULL);
+  if (ap == NULL)
+    return JNI_FALSE;
+
+  inside = 1;
+  usleep(millis * 1000);
+  released = 1;
+
+  (*env)->ReleasePrimitiveArrayCritical(env, a, ap, 0);
+  return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_JNICriticalTest_criticalEntered(JNIEnv *env, jclass clazz)
+{
+  return inside ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_JNICriticalTest_criticalLeft(JNIEnv *env, jclass clazz)
+{
+  return released ? JNI_TRUE : JNI_FALSE;
+}
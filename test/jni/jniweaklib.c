@@ -1,5 +1,5 @@
 /*
- * jniweaklib.c -- Test the handling of JNI weak reference.
+ * jniweaklib.c -- Test the handling of JNI weak and global references.
  *
  * Copyright (C) 2005
  *    The Kaffe.org's developers. See ChangeLog for details.
@@ -38,3 +38,31 @@ Java_JNIWeakTest_invokeWeak(JNIEnv *env, jclass clazz,
 
   (*env)->CallVoidMethod(env, wo, weak_fun);
 }
+
+JNIEXPORT jboolean JNICALL
+Java_JNIWeakTest_churnGlobal(JNIEnv *env, jclass clazz, jobject o,
+			     jint count)
+{
+  jobject keep = (*env)->NewGlobalRef(env, o);
+  jmethodID gc = (*env)->GetStaticMethodID(env, clazz, "collect", "()V");
+  jboolean ok = JNI_TRUE;
+  jint i;
+
+  for (i = 0; i < count; i++)
+    {
+      jobject ref = (*env)->NewGlobalRef(env, o);
+
+      if (!(*env)->IsSameObject(env, ref, o)
+	  || !(*env)->IsSameObject(env, ref, keep))
+	ok = JNI_FALSE;
+      (*env)->DeleteGlobalRef(env, ref);
+    }
+
+  (*env)->CallStaticVoidMethod(env, clazz, gc);
+
+  if (!(*env)->IsSameObject(env, keep, o))
+    ok = JNI_FALSE;
+  (*env)->DeleteGlobalRef(env, keep);
+
+  return ok;
+}
@@ -0,0 +1,317 @@
+/*
+ * jvmtiAgentTest.c
+ *
+ * Act as a JVMTI agent built against the standard jvmti.h: find the
+ * functions by their slot number in the specification, not through
+ * Kaffe's header, and check that they are where an agent expects them.
+ *
+ * Copyright (c) 2026
+ *    The Kaffe.org's developers. See ChangeLog for details.
+ *
+ * See the file "license.terms" for information on usage and redistribution
+ * of this file.
+ */
+#include <jni.h>
+#include <jvmti.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ltdl.h>
+
+/* Slots of the function table, numbered as in the specification */
+#define	SLOT_SET_EVENT_NOTIFICATION_MODE	2
+#define	SLOT_GET_ALL_THREADS			4
+#define	SLOT_ALLOCATE				46
+#define	SLOT_DEALLOCATE				47
+#define	SLOT_GET_CLASS_SIGNATURE		48
+#define	SLOT_GET_METHOD_NAME			64
+#define	SLOT_GET_METHOD_DECLARING_CLASS		65
+#define	SLOT_GET_VERSION_NUMBER			88
+#define	SLOT_GET_CAPABILITIES			89
+#define	SLOT_GET_STACK_TRACE			104
+#define	SLOT_SET_EVENT_CALLBACKS		122
+#define	SLOT_GET_POTENTIAL_CAPABILITIES		140
+#define	SLOT_ADD_CAPABILITIES			142
+#define	SLOT_SET_HEAP_SAMPLING_INTERVAL		156
+
+#define	SLOT(env, n)	(((void * const *)*(env))[(n) - 1])
+
+typedef jvmtiError (JNICALL *SetEventNotificationModeFn)
+	(jvmtiEnv *, jvmtiEventMode, jvmtiEvent, jthread, ...);
+typedef jvmtiError (JNICALL *GetAllThreadsFn)(jvmtiEnv *, jint *, jthread **);
+typedef jvmtiError (JNICALL *DeallocateFn)(jvmtiEnv *, unsigned char *);
+typedef jvmtiError (JNICALL *GetClassSignatureFn)
+	(jvmtiEnv *, jclass, char **, char **);
+typedef jvmtiError (JNICALL *GetMethodNameFn)
+	(jvmtiEnv *, jmethodID, char **, char **, char **);
+typedef jvmtiError (JNICALL *GetMethodDeclaringClassFn)
+	(jvmtiEnv *, jmethodID, jclass *);
+typedef jvmtiError (JNICALL *GetVersionNumberFn)(jvmtiEnv *, jint *);
+typedef jvmtiError (JNICALL *GetCapabilitiesFn)
+	(jvmtiEnv *, jvmtiCapabilities *);
+typedef jvmtiError (JNICALL *GetStackTraceFn)
+	(jvmtiEnv *, jthread, jint, jint, jvmtiFrameInfo *, jint *);
+typedef jvmtiError (JNICALL *SetEventCallbacksFn)
+	(jvmtiEnv *, const jvmtiEventCallbacks *, jint);
+typedef jvmtiError (JNICALL *AddCapabilitiesFn)
+	(jvmtiEnv *, const jvmtiCapabilities *);
+typedef jvmtiError (JNICALL *SetHeapSamplingIntervalFn)(jvmtiEnv *, jint);
+
+static jvmtiEnv *jvmti;
+static int gcStarts;
+static int gcFinishes;
+static int allocs;
+static int mainSeen;
+
+static char *concatString(const char *s1, const char *s2)
+{
+	char *s;
+
+	if (s1 == NULL)
+		s1 = "";
+	if (s2 == NULL)
+		s2 = "";
+	s = (char *) malloc(strlen(s1) + strlen(s2) + 1);
+	return strcat(strcpy(s, s1), s2);
+}
+
+static int fail(const char *what)
+{
+	fprintf(stderr, "%s has failed\n", what);
+	return 1;
+}
+
+static void JNICALL gcStart(jvmtiEnv *env)
+{
+	(void) env;
+	gcStarts++;
+}
+
+static void JNICALL gcFinish(jvmtiEnv *env)
+{
+	(void) env;
+	gcFinishes++;
+}
+
+/* Look for JVMTITest.main on the stack of the allocating thread */
+static void JNICALL objectAlloc(jvmtiEnv *env, JNIEnv *jni_env,
+				jthread thread, jobject object,
+				jclass object_klass, jlong size)
+{
+	jvmtiFrameInfo frames[8];
+	jint count, i;
+	jclass cls;
+	char *name, *sig;
+
+	(void) jni_env; (void) object; (void) object_klass; (void) size;
+	allocs++;
+	if (((GetStackTraceFn)SLOT(env, SLOT_GET_STACK_TRACE))
+	    (env, thread, 0, 8, frames, &count) != JVMTI_ERROR_NONE)
+		return;
+	for (i = 0; i < count; i++) {
+		if (((GetMethodDeclaringClassFn)
+		     SLOT(env, SLOT_GET_METHOD_DECLARING_CLASS))
+		    (env, frames[i].method, &cls) != JVMTI_ERROR_NONE)
+			continue;
+		if (((GetClassSignatureFn)SLOT(env, SLOT_GET_CLASS_SIGNATURE))
+		    (env, cls, &sig, NULL) != JVMTI_ERROR_NONE)
+			continue;
+		if (((GetMethodNameFn)SLOT(env, SLOT_GET_METHOD_NAME))
+		    (env, frames[i].method, &name, NULL, NULL)
+		    == JVMTI_ERROR_NONE) {
+			if (strcmp(sig, "LJVMTITest;") == 0
+			    && strcmp(name, "main") == 0)
+				mainSeen = 1;
+			((DeallocateFn)SLOT(env, SLOT_DEALLOCATE))
+				(env, (unsigned char *)name);
+		}
+		((DeallocateFn)SLOT(env, SLOT_DEALLOCATE))
+			(env, (unsigned char *)sig);
+	}
+}
+
+JNIEXPORT jint JNICALL Agent_OnLoad(JavaVM *vm, char *options, void *reserved)
+{
+	jvmtiCapabilities caps;
+	jvmtiEventCallbacks cbs;
+	jint version;
+
+	(void) options; (void) reserved;
+	if ((*vm)->GetEnv(vm, (void **)&jvmti, JVMTI_VERSION_11) != JNI_OK)
+		return fail("GetEnv");
+	if ((*vm)->GetEnv(vm, (void **)&jvmti, JVMTI_VERSION_1_0) != JNI_OK)
+		return fail("GetEnv of version 1.0");
+
+	/* Reserved slots are empty */
+	if (SLOT(jvmti, 1) != NULL || SLOT(jvmti, 67) != NULL)
+		return fail("reserved slots");
+
+	if (((GetVersionNumberFn)SLOT(jvmti, SLOT_GET_VERSION_NUMBER))
+	    (jvmti, &version) != JVMTI_ERROR_NONE
+	    || (version & 0xFFFF0000) != JVMTI_VERSION_11)
+		return fail("GetVersionNumber");
+
+	if (((GetCapabilitiesFn)SLOT(jvmti, SLOT_GET_POTENTIAL_CAPABILITIES))
+	    (jvmti, &caps) != JVMTI_ERROR_NONE
+	    || !caps.can_generate_garbage_collection_events
+	    || !caps.can_generate_vm_object_alloc_events)
+		return fail("GetPotentialCapabilities");
+	memset(&caps, 0, sizeof(caps));
+	caps.can_generate_garbage_collection_events = 1;
+	caps.can_generate_vm_object_alloc_events = 1;
+	if (((AddCapabilitiesFn)SLOT(jvmti, SLOT_ADD_CAPABILITIES))
+	    (jvmti, &caps) != JVMTI_ERROR_NONE)
+		return fail("AddCapabilities");
+	memset(&caps, 0, sizeof(caps));
+	caps.can_pop_frame = 1;
+	if (((AddCapabilitiesFn)SLOT(jvmti, SLOT_ADD_CAPABILITIES))
+	    (jvmti, &caps) != JVMTI_ERROR_NOT_AVAILABLE)
+		return fail("AddCapabilities of a missing capability");
+	if (((GetCapabilitiesFn)SLOT(jvmti, SLOT_GET_CAPABILITIES))
+	    (jvmti, &caps) != JVMTI_ERROR_NONE
+	    || !caps.can_generate_garbage_collection_events
+	    || caps.can_pop_frame)
+		return fail("GetCapabilities");
+
+	memset(&cbs, 0, sizeof(cbs));
+	cbs.GarbageCollectionStart = gcStart;
+	cbs.GarbageCollectionFinish = gcFinish;
+	cbs.VMObjectAlloc = objectAlloc;
+	if (((SetEventCallbacksFn)SLOT(jvmti, SLOT_SET_EVENT_CALLBACKS))
+	    (jvmti, &cbs, sizeof(cbs)) != JVMTI_ERROR_NONE)
+		return fail("SetEventCallbacks");
+	if (((SetEventNotificationModeFn)
+	     SLOT(jvmti, SLOT_SET_EVENT_NOTIFICATION_MODE))
+	    (jvmti, JVMTI_ENABLE, JVMTI_EVENT_GARBAGE_COLLECTION_START, NULL)
+	    != JVMTI_ERROR_NONE
+	    || ((SetEventNotificationModeFn)
+		SLOT(jvmti, SLOT_SET_EVENT_NOTIFICATION_MODE))
+	    (jvmti, JVMTI_ENABLE, JVMTI_EVENT_GARBAGE_COLLECTION_FINISH, NULL)
+	    != JVMTI_ERROR_NONE
+	    || ((SetEventNotificationModeFn)
+		SLOT(jvmti, SLOT_SET_EVENT_NOTIFICATION_MODE))
+	    (jvmti, JVMTI_ENABLE, JVMTI_EVENT_VM_OBJECT_ALLOC, NULL)
+	    != JVMTI_ERROR_NONE)
+		return fail("SetEventNotificationMode");
+
+	/* Sample every object */
+	if (((SetHeapSamplingIntervalFn)
+	     SLOT(jvmti, SLOT_SET_HEAP_SAMPLING_INTERVAL))(jvmti, 0)
+	    != JVMTI_ERROR_NONE)
+		return fail("SetHeapSamplingInterval");
+	return 0;
+}
+
+int main(void)
+{
+  JavaVMInitArgs vmargs;
+  JavaVM *vm;
+  void *env;
+  JNIEnv *jni_env;
+  JavaVMOption myoptions[2];
+  jclass cls, scls;
+  jarray args;
+  jmethodID mainid;
+  jint nthreads;
+  jthread *threads;
+  jclass tcls;
+  jobject gref;
+  jvmtiFrameInfo frames[8];
+  jint count;
+  char *sig;
+
+  /* Kaffe's header must agree with the slots used above */
+  if (offsetof(struct jvmtiInterface_1_, GetStackTrace)
+      != (SLOT_GET_STACK_TRACE - 1) * sizeof(void *)
+      || offsetof(struct jvmtiInterface_1_, SetHeapSamplingInterval)
+      != (SLOT_SET_HEAP_SAMPLING_INTERVAL - 1) * sizeof(void *))
+    return fail("jvmti.h layout");
+
+  /* set up libtool/libltdl dlopen emulation */
+  LTDL_SET_PRELOADED_SYMBOLS();
+
+  myoptions[0].optionString = concatString("-Xbootclasspath:", getenv("BOOTCLASSPATH"));
+  myoptions[1].optionString = concatString("-Xclasspath:", CLASSPATH_SOURCE_DIR);
+
+  vmargs.version = JNI_VERSION_1_2;
+  if (JNI_GetDefaultJavaVMInitArgs (&vmargs) < 0)
+    {
+      fprintf(stderr, " Cannot retrieve default arguments\n");
+      return 1;
+    }
+
+  vmargs.nOptions = 2;
+  vmargs.options = myoptions;
+
+  if (JNI_CreateJavaVM (&vm, (void **)&env, &vmargs) < 0)
+    {
+      fprintf(stderr, " Cannot create the Java VM\n");
+      return 1;
+    }
+
+  jni_env = env;
+
+  if (Agent_OnLoad(vm, "", NULL) != 0)
+    return 1;
+
+  if (((GetAllThreadsFn)SLOT(jvmti, SLOT_GET_ALL_THREADS))
+      (jvmti, &nthreads, &threads) != JVMTI_ERROR_NONE || nthreads < 1)
+    return fail("GetAllThreads");
+  ((DeallocateFn)SLOT(jvmti, SLOT_DEALLOCATE))(jvmti, (unsigned char *)threads);
+
+  cls = (*jni_env)->FindClass(jni_env, "JVMTITest");
+  if ((*jni_env)->ExceptionOccurred(jni_env))
+    {
+      (*jni_env)->ExceptionDescribe(jni_env);
+      return fail("FindClass");
+    }
+
+  mainid = (*jni_env)->GetStaticMethodID(jni_env, cls, "main", "([Ljava/lang/String;)V");
+  if ((*jni_env)->ExceptionOccurred(jni_env))
+    return fail("GetStaticMethodID");
+
+  /* Global references are taken as well as local ones */
+  gref = (*jni_env)->NewGlobalRef(jni_env, cls);
+  if (((GetClassSignatureFn)SLOT(jvmti, SLOT_GET_CLASS_SIGNATURE))
+      (jvmti, gref, &sig, NULL) != JVMTI_ERROR_NONE
+      || strcmp(sig, "LJVMTITest;") != 0)
+    return fail("GetClassSignature of a global reference");
+  ((DeallocateFn)SLOT(jvmti, SLOT_DEALLOCATE))(jvmti, (unsigned char *)sig);
+  (*jni_env)->DeleteGlobalRef(jni_env, gref);
+
+  tcls = (*jni_env)->FindClass(jni_env, "java/lang/Thread");
+  if ((*jni_env)->ExceptionOccurred(jni_env))
+    return fail("FindClass(java/lang/Thread)");
+  gref = (*jni_env)->NewGlobalRef(jni_env,
+    (*jni_env)->CallStaticObjectMethod(jni_env, tcls,
+      (*jni_env)->GetStaticMethodID(jni_env, tcls, "currentThread",
+				    "()Ljava/lang/Thread;")));
+  if (((GetStackTraceFn)SLOT(jvmti, SLOT_GET_STACK_TRACE))
+      (jvmti, gref, 0, 8, frames, &count) != JVMTI_ERROR_NONE)
+    return fail("GetStackTrace of a global reference");
+  (*jni_env)->DeleteGlobalRef(jni_env, gref);
+
+  scls = (*jni_env)->FindClass(jni_env, "java/lang/String");
+  if ((*jni_env)->ExceptionOccurred(jni_env))
+    return fail("FindClass(java/lang/String)");
+
+  args = (*jni_env)->NewObjectArray(jni_env, 0, scls, 0);
+  if ((*jni_env)->ExceptionOccurred(jni_env))
+    return fail("NewObjectArray");
+
+  (*jni_env)->CallStaticVoidMethod(jni_env, cls, mainid, args);
+  if ((*jni_env)->ExceptionOccurred(jni_env))
+    return fail("CallStaticMethod");
+
+  if (gcStarts == 0 || gcFinishes == 0)
+    return fail("GarbageCollectionStart/Finish");
+  if (allocs == 0)
+    return fail("VMObjectAlloc");
+  if (!mainSeen)
+    return fail("GetStackTrace");
+
+  (*vm)->DestroyJavaVM(vm);
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+import java.util.Arrays;
+
+/**
+ * Multi-dimensional arrays are allocated a row at a time, System.arraycopy
+ * checks reference arrays once where it can, and Arrays.fill and
+ * Arrays.equals may be done by the VM.  Check they all still behave.
+ */
+public class BulkArrays {
+
+  private static void check(String what, boolean ok) {
+    System.out.println(what + ": " + (ok ? "ok" : "FAILED"));
+  }
+
+  public static void main(String[] args) {
+    int[][][] a = new int[3][4][5];
+    boolean ok = a.length == 3;
+    for (int i = 0; i < a.length; i++) {
+      ok &= a[i].length == 4;
+      for (int j = 0; j < a[i].length; j++) {
+        ok &= a[i][j].length == 5 && a[i][j][4] == 0;
+        a[i][j][i] = i + j;
+        for (int k = 0; k < i * 4 + j; k++) {
+          ok &= a[i][j] != a[k / 4][k % 4];
+        }
+      }
+    }
+    System.gc();
+    ok &= a[2][3][2] == 5;
+    check("multiarray", ok);
+
+    String[][][] p = new String[2][3][];
+    Object[][][] z = new Object[2][0][7];
+    check("partial multiarray", p[1].length == 3 && p[1][2] == null
+          && z[1].length == 0);
+
+    String[] strs = { "a", "b", "c" };
+    Object[] objs = new Object[4];
+    System.arraycopy(strs, 0, objs, 1, 3);
+    check("copy to supertype", objs[0] == null && objs[3] == "c");
+
+    Object[] mixed = { "x", "y", new Integer(1), "z" };
+    String[] into = new String[4];
+    try {
+      System.arraycopy(mixed, 0, into, 0, 4);
+      check("copy to subtype", false);
+    }
+    catch (ArrayStoreException e) {
+      check("copy to subtype", into[0] == "x" && into[1] == "y"
+            && into[2] == null);
+    }
+
+    Object[] self = { "0", "1", "2", "3" };
+    System.arraycopy(self, 0, self, 1, 3);
+    check("overlapping copy", self[1] == "0" && self[3] == "2");
+
+    int[] ints = new int[13];
+    Arrays.fill(ints, 0x01020304);
+    long[] longs = new long[5];
+    Arrays.fill(longs, -1L);
+    char[] chars = new char[7];
+    Arrays.fill(chars, 'q');
+    byte[] bytes = new byte[9];
+    Arrays.fill(bytes, (byte)7);
+    double[] doubles = new double[3];
+    Arrays.fill(doubles, 2.5);
+    check("fill", ints[12] == 0x01020304 && longs[4] == -1L
+          && chars[6] == 'q' && bytes[8] == 7 && doubles[2] == 2.5);
+
+    int[] ints2 = (int[])ints.clone();
+    check("equals", Arrays.equals(ints, ints2)
+          && !Arrays.equals(ints, new int[13])
+          && !Arrays.equals(ints, new int[12])
+          && !Arrays.equals(ints, null)
+          && Arrays.equals((int[])null, (int[])null));
+
+    float nan1 = Float.intBitsToFloat(0x7fc00000);
+    float nan2 = Float.intBitsToFloat(0x7fc00001);
+    check("float equals", Arrays.equals(new float[] { nan1 },
+                                        new float[] { nan2 })
+          && !Arrays.equals(new float[] { 0.0f }, new float[] { -0.0f }));
+    check("double equals", Arrays.equals(new double[] { Double.NaN, 1 },
+                                         new double[] { 0.0 / 0.0, 1 })
+          && !Arrays.equals(new double[] { 0.0 }, new double[] { -0.0 }));
+
+    try {
+      Arrays.fill((int[])null, 1);
+      check("fill null", false);
+    }
+    catch (NullPointerException e) {
+      check("fill null", true);
+    }
+  }
+}
+
+/* Expected Output:
+multiarray: ok
+partial multiarray: ok
+copy to supertype: ok
+copy to subtype: ok
+overlapping copy: ok
+fill: ok
+equals: ok
+float equals: ok
+double equals: ok
+fill null: ok
+*/
@@ -0,0 +1,86 @@
+/**
+ * Classes are tested for being initialized without their lock.  Let
+ * several threads race into a class whose static initializer is slow,
+ * through a static field, a static method and a field of a second class,
+ * and make sure each sees everything the initializer did.
+ */
+public class ClassInitRace {
+
+  static class Slow {
+    static int[] table;
+    static int sum;
+    static String name;
+
+    static {
+      try {
+        Thread.sleep(200);
+      } catch (InterruptedException e) {
+      }
+      table = new int[100];
+      for (int i = 0; i < table.length; i++) {
+        table[i] = i;
+        sum += i;
+      }
+      name = "slow";
+    }
+
+    static int total() {
+      int s = 0;
+      for (int i = 0; i < table.length; i++) {
+        s += table[i];
+      }
+      return s;
+    }
+  }
+
+  static class Other {
+    static long value = 0x0102030405060708L;
+  }
+
+  static final int THREADS = 8;
+  static volatile boolean go;
+  static boolean[] ok = new boolean[THREADS];
+
+  public static void main(String[] args) throws Exception {
+    Thread[] threads = new Thread[THREADS];
+
+    for (int i = 0; i < THREADS; i++) {
+      final int n = i;
+      threads[i] = new Thread() {
+        public void run() {
+          while (!go) {
+            Thread.yield();
+          }
+          boolean good = true;
+          for (int j = 0; j < 1000; j++) {
+            switch ((n + j) % 3) {
+            case 0:
+              good &= Slow.sum == 4950 && "slow".equals(Slow.name);
+              break;
+            case 1:
+              good &= Slow.total() == 4950;
+              break;
+            default:
+              good &= Other.value == 0x0102030405060708L;
+              break;
+            }
+          }
+          ok[n] = good;
+        }
+      };
+      threads[i].start();
+    }
+
+    go = true;
+    boolean all = true;
+    for (int i = 0; i < THREADS; i++) {
+      threads[i].join();
+      all &= ok[i];
+    }
+    System.out.println("initialized: " + (all ? "ok" : "FAILED"));
+  }
+}
+
+/* Expected Output:
+initialized: ok
+*/
@@ -0,0 +1,103 @@
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.FileReader;
+import java.io.InputStreamReader;
+import java.util.HashSet;
+import java.util.Set;
+
+/**
+ * Run a copy of the VM with -Xclinitrecord and check the classes it
+ * writes at exit, then run another copy with -Xclinitahead on them and
+ * check that the program still sees its classes initialized once and
+ * in the order the language wants.
+ */
+public class ClinitAhead {
+
+  static class First {
+    static final StringBuffer order = new StringBuffer("first");
+  }
+
+  static class Second {
+    static final String value;
+    static {
+      First.order.append(" second");
+      value = First.order.toString();
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    if (args.length > 1) {
+      // child
+      java.util.Vector v = new java.util.Vector();
+      v.addElement(new java.util.Date(0).toString());
+      System.out.println(Second.value);
+      return;
+    }
+
+    // parent
+    File order = new File("ClinitAhead.order");
+    order.delete();
+    System.out.println("record: "
+                       + run(args[0], "-Xclinitrecord", order.getPath()));
+    System.out.println("written: " + order.exists());
+
+    BufferedReader in = new BufferedReader(new FileReader(order));
+    String line;
+    int count = 0;
+    boolean loadable = true;
+    boolean bootstrap = true;
+    boolean once = true;
+    Set seen = new HashSet();
+    while ((line = in.readLine()) != null) {
+      count++;
+      if (!seen.add(line)) {
+        once = false;
+      }
+      try {
+        Class c = Class.forName(line.replace('/', '.'), false, null);
+        if (c.getClassLoader() != null) {
+          bootstrap = false;
+        }
+      }
+      catch (ClassNotFoundException e) {
+        loadable = false;
+      }
+    }
+    in.close();
+    System.out.println("classes: " + (count > 0));
+    System.out.println("loadable: " + loadable);
+    System.out.println("bootstrap only: " + bootstrap);
+    System.out.println("once each: " + once);
+
+    System.out.println("ahead: "
+                       + run(args[0], "-Xclinitahead", order.getPath()));
+    order.delete();
+  }
+
+  /*
+   * Run the child with option and file, return its exit status and the
+   * line it prints.
+   */
+  static String run(String java, String option, String file)
+    throws Exception {
+    Process p = Runtime.getRuntime().exec(new String[] {
+      java, option, file, "ClinitAhead", "-child", "x"
+    });
+    BufferedReader out = new BufferedReader(
+      new InputStreamReader(p.getInputStream()));
+    String line = out.readLine();
+    out.close();
+    return p.waitFor() + " " + line;
+  }
+}
+
+// java args: ClinitAhead $JAVA
+/* Expected Output:
+record: 0 first second
+written: true
+classes: true
+loadable: true
+bootstrap only: true
+once each: true
+ahead: 0 first second
+*/
@@ -0,0 +1,96 @@
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.FileReader;
+
+/**
+ * Run a copy of the VM with -Xcpuprof on a program that keeps one
+ * thread computing and another allocating, so that samples also land
+ * inside the allocator and the collector, and check the profile it
+ * writes at exit.  Each line must be a stack of frames separated by
+ * semicolons followed by a sample count.
+ */
+public class CpuProfile {
+
+  static final long RUN = 2000;
+
+  static volatile long sink;
+
+  static void compute() {
+    long end = System.currentTimeMillis() + RUN;
+    long x = 1;
+    while (System.currentTimeMillis() < end) {
+      for (int i = 0; i < 10000; i++) {
+        x = x * 31 + i;
+      }
+    }
+    sink = x;
+  }
+
+  static void allocate() {
+    long end = System.currentTimeMillis() + RUN;
+    Object[] keep = new Object[64];
+    int i = 0;
+    while (System.currentTimeMillis() < end) {
+      keep[i++ & 63] = new int[i & 1023];
+    }
+    sink = keep.length;
+  }
+
+  public static void main(String[] args) throws Exception {
+    if (args.length > 1) {
+      // child
+      Thread t = new Thread() {
+        public void run() {
+          allocate();
+        }
+      };
+      t.start();
+      compute();
+      t.join();
+      return;
+    }
+
+    // parent
+    File prof = new File("CpuProfile.prof");
+    Process p = Runtime.getRuntime().exec(new String[] {
+      args[0], "-Xcpuprof", prof.getPath(), "-Xcpuprof_interval", "1000",
+      "CpuProfile", "-child", "x"
+    });
+    System.out.println("exit: " + p.waitFor());
+
+    BufferedReader in = new BufferedReader(new FileReader(prof));
+    String line;
+    long samples = 0;
+    boolean wellFormed = true;
+    boolean computed = false;
+    while ((line = in.readLine()) != null) {
+      int space = line.lastIndexOf(' ');
+      if (space <= 0) {
+        wellFormed = false;
+        continue;
+      }
+      long n = Long.parseLong(line.substring(space + 1));
+      if (n <= 0) {
+        wellFormed = false;
+      }
+      samples += n;
+      if (line.indexOf("CpuProfile.compute") >= 0) {
+        computed = true;
+      }
+    }
+    in.close();
+    prof.delete();
+
+    System.out.println("well formed: " + wellFormed);
+    System.out.println("sampled: " + (samples > 0));
+    System.out.println("compute seen: " + computed);
+  }
+}
+
+// java args: CpuProfile $JAVA
+/* Expected Output:
+exit: 0
+well formed: true
+sampled: true
+compute seen: true
+*/
@@ -0,0 +1,81 @@
+import java.lang.reflect.*;
+
+/**
+ * The VM reorders the instance fields of a class by size and puts the
+ * references together.  Make sure fields of every size keep their
+ * values, through the bytecode and through reflection, and that the
+ * objects the references point to survive garbage collections.
+ */
+public class FieldLayout {
+
+  static class Base {
+    byte b1 = 1;
+    Object o1 = "base";
+    long l1 = 0x1122334455667788L;
+    short s1 = 2;
+    int[] a1 = { 3 };
+    boolean z1 = true;
+  }
+
+  static class Derived extends Base {
+    char c2 = 'x';
+    double d2 = 4.5;
+    String str2 = "derived";
+    byte b2 = 5;
+    float f2 = 6.5f;
+    Object o2 = new Object[] { "inner" };
+    int i2 = 7;
+  }
+
+  private static void check(String what, boolean ok) {
+    System.out.println(what + ": " + (ok ? "ok" : "FAILED"));
+  }
+
+  private static boolean values(Derived d) {
+    return d.b1 == 1 && "base".equals(d.o1) && d.l1 == 0x1122334455667788L
+        && d.s1 == 2 && d.a1[0] == 3 && d.z1 && d.c2 == 'x'
+        && d.d2 == 4.5 && "derived".equals(d.str2) && d.b2 == 5
+        && d.f2 == 6.5f && "inner".equals(((Object[])d.o2)[0])
+        && d.i2 == 7;
+  }
+
+  public static void main(String[] args) throws Exception {
+    Derived[] objs = new Derived[1000];
+    for (int i = 0; i < objs.length; i++) {
+      objs[i] = new Derived();
+      objs[i].a1 = new int[] { 3 };
+      objs[i].str2 = new String("derived");
+    }
+
+    for (int i = 0; i < 5; i++) {
+      Object[] junk = new Object[10000];
+      for (int j = 0; j < junk.length; j++) {
+        junk[j] = new int[4];
+      }
+      System.gc();
+    }
+
+    boolean ok = true;
+    for (int i = 0; i < objs.length; i++) {
+      ok &= values(objs[i]);
+    }
+    check("values after gc", ok);
+
+    Derived d = new Derived();
+    Field f = Base.class.getDeclaredField("l1");
+    f.setLong(d, -1L);
+    check("reflect long", d.l1 == -1L && d.s1 == 2 && d.b1 == 1);
+    f = Derived.class.getDeclaredField("b2");
+    f.setByte(d, (byte)-3);
+    check("reflect byte", d.b2 == -3 && d.f2 == 6.5f && d.i2 == 7);
+    f = Derived.class.getDeclaredField("o2");
+    check("reflect object", f.get(d) == d.o2);
+  }
+}
+
+/* Expected Output:
+values after gc: ok
+reflect long: ok
+reflect byte: ok
+reflect object: ok
+*/
@@ -0,0 +1,153 @@
+import java.io.BufferedReader;
+import java.io.DataInputStream;
+import java.io.EOFException;
+import java.io.File;
+import java.io.FileInputStream;
+import java.io.FileReader;
+import java.util.StringTokenizer;
+
+import org.kaffe.management.Diagnostics;
+
+/**
+ * Write a heap histogram and a heap dump while some objects of our own
+ * are alive, then read both back and check that they hold together.
+ */
+public class HeapDiagnostics {
+
+  static class Marker {
+    int[] payload = new int[4];
+  }
+
+  static final int MARKERS = 100;
+
+  static Marker[] markers = new Marker[MARKERS];
+
+  public static void main(String[] args) throws Exception {
+    for (int i = 0; i < MARKERS; i++) {
+      markers[i] = new Marker();
+    }
+
+    File histo = new File("HeapDiagnostics.histo");
+    File dump = new File("HeapDiagnostics.hprof");
+    try {
+      System.out.println("histogram written: "
+                         + Diagnostics.writeHeapHistogram(histo.getPath()));
+      checkHistogram(histo);
+      System.out.println("dump written: "
+                         + Diagnostics.writeHeapDump(dump.getPath()));
+      checkDump(dump);
+    }
+    finally {
+      histo.delete();
+      dump.delete();
+    }
+
+    // keep the markers alive until both files are written
+    System.out.println("markers: " + markers.length);
+  }
+
+  /*
+   * " num     #instances         #bytes  class name", a rule, one line
+   * per class and a "Total" line adding them up.
+   */
+  static void checkHistogram(File file) throws Exception {
+    BufferedReader in = new BufferedReader(new FileReader(file));
+    String line = in.readLine();
+    System.out.println("histogram header: "
+                       + (line != null && line.trim().startsWith("num")));
+    in.readLine();
+
+    long count = 0;
+    long bytes = 0;
+    long markerCount = -1;
+    long lastBytes = Long.MAX_VALUE;
+    boolean sorted = true;
+    boolean total = false;
+    while ((line = in.readLine()) != null) {
+      StringTokenizer st = new StringTokenizer(line);
+      String first = st.nextToken();
+      long c = Long.parseLong(st.nextToken());
+      long b = Long.parseLong(st.nextToken());
+      if (first.equals("Total")) {
+        total = c == count && b == bytes;
+        break;
+      }
+      if (b > lastBytes) {
+        sorted = false;
+      }
+      lastBytes = b;
+      count += c;
+      bytes += b;
+      if (st.nextToken().equals("HeapDiagnostics$Marker")) {
+        markerCount = c;
+      }
+    }
+    in.close();
+    System.out.println("histogram sorted: " + sorted);
+    System.out.println("histogram total: " + total);
+    System.out.println("histogram markers: " + (markerCount >= MARKERS));
+  }
+
+  /*
+   * The header, then records of a tag, a time and a length, the last of
+   * which ends the heap dump.
+   */
+  static void checkDump(File file) throws Exception {
+    DataInputStream in = new DataInputStream(new FileInputStream(file));
+    StringBuffer magic = new StringBuffer();
+    int c;
+    while ((c = in.read()) > 0) {
+      magic.append((char)c);
+    }
+    System.out.println("dump magic: " + magic);
+    int idSize = in.readInt();
+    System.out.println("dump id size: " + (idSize == 4 || idSize == 8));
+    in.readLong();
+
+    boolean markerName = false;
+    boolean segment = false;
+    int last = -1;
+    for (;;) {
+      int tag;
+      try {
+        tag = in.readUnsignedByte();
+      }
+      catch (EOFException e) {
+        break;
+      }
+      in.readInt();
+      int len = in.readInt();
+      byte[] body = new byte[len];
+      in.readFully(body);
+      if (tag == 0x01 && len > idSize) {
+        String name = new String(body, idSize, len - idSize, "UTF-8");
+        if (name.equals("HeapDiagnostics$Marker")) {
+          markerName = true;
+        }
+      }
+      else if (tag == 0x1C) {
+        segment = true;
+      }
+      last = tag;
+    }
+    in.close();
+    System.out.println("dump names marker: " + markerName);
+    System.out.println("dump has heap: " + segment);
+    System.out.println("dump ends: " + (last == 0x2C));
+  }
+}
+
+/* Expected Output:
+histogram written: true
+histogram header: true
+histogram sorted: true
+histogram total: true
+histogram markers: true
+dump written: true
+dump magic: JAVA PROFILE 1.0.2
+dump id size: true
+dump names marker: true
+dump has heap: true
+dump ends: true
+markers: 100
+*/
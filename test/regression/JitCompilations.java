@@ -0,0 +1,98 @@
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.FileReader;
+
+import org.kaffe.management.Diagnostics;
+
+/**
+ * Write the list of recent compilations as CSV and as JSON and check
+ * both.  With the JIT the method we call must be listed with its sizes;
+ * with the interpreter both lists are empty.
+ */
+public class JitCompilations {
+
+  static int hot(int n) {
+    int r = 0;
+    for (int i = 0; i < n; i++) {
+      r += i * n;
+    }
+    return r;
+  }
+
+  static String readAll(File file) throws Exception {
+    BufferedReader in = new BufferedReader(new FileReader(file));
+    StringBuffer sb = new StringBuffer();
+    String line;
+    while ((line = in.readLine()) != null) {
+      sb.append(line).append('\n');
+    }
+    in.close();
+    file.delete();
+    return sb.toString();
+  }
+
+  public static void main(String[] args) throws Exception {
+    int r = 0;
+    for (int i = 0; i < 100; i++) {
+      r += hot(i);
+    }
+    System.out.println("result: " + r);
+
+    File csv = new File("JitCompilations.csv");
+    System.out.println("csv written: "
+                       + Diagnostics.writeCompilations(csv.getPath()));
+    BufferedReader in = new BufferedReader(new FileReader(csv));
+    String line = in.readLine();
+    String header = "class,method,signature,bytecode,code,"
+      + "memory,constants,spills,reloads,wait_ns,compile_ns";
+    System.out.println("csv header: " + header.equals(line));
+    int rows = 0;
+    boolean fields = true;
+    boolean hotListed = false;
+    while ((line = in.readLine()) != null) {
+      rows++;
+      String[] f = line.split(",");
+      if (f.length != 11) {
+        fields = false;
+        continue;
+      }
+      for (int i = 3; i < 11; i++) {
+        Long.parseLong(f[i]);
+      }
+      if (f[0].equals("\"JitCompilations\"") && f[1].equals("\"hot\"")) {
+        hotListed = f[2].equals("\"(I)I\"")
+          && Long.parseLong(f[3]) > 0 && Long.parseLong(f[4]) > 0;
+      }
+    }
+    in.close();
+    csv.delete();
+    System.out.println("csv fields: " + fields);
+    System.out.println("csv lists hot: " + (rows == 0 || hotListed));
+
+    File json = new File("JitCompilations.json");
+    System.out.println("json written: "
+                       + Diagnostics.writeCompilations(json.getPath()));
+    String text = readAll(json).trim();
+    System.out.println("json object: " + (text.startsWith("{\"compiled\": ")
+                                          && text.endsWith("]}")));
+    int methods = 0;
+    for (int at = text.indexOf("{\"class\": "); at >= 0;
+         at = text.indexOf("{\"class\": ", at + 1)) {
+      methods++;
+    }
+    long compiled = Long.parseLong(text.substring(13, text.indexOf(',')));
+    System.out.println("json count: " + (methods <= compiled
+                                         && methods >= rows));
+  }
+}
+
+/* Expected Output:
+result: 12087075
+csv written: true
+csv header: true
+csv fields: true
+csv lists hot: true
+json written: true
+json object: true
+json count: true
+*/
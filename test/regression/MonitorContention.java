@@ -0,0 +1,93 @@
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.FileReader;
+
+import org.kaffe.management.Diagnostics;
+
+/**
+ * Have a few threads fight over one monitor, holding it long enough
+ * that the others must wait, and check that the contention list names
+ * the monitor, counts the waits and shows where they came from.
+ */
+public class MonitorContention {
+
+  static class Shared {
+    int count;
+  }
+
+  static final int THREADS = 4;
+  static final int ROUNDS = 50;
+
+  static final Shared shared = new Shared();
+
+  static void work() throws InterruptedException {
+    synchronized (shared) {
+      shared.count++;
+      Thread.sleep(2);
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    Thread[] threads = new Thread[THREADS];
+    for (int i = 0; i < THREADS; i++) {
+      threads[i] = new Thread() {
+        public void run() {
+          try {
+            for (int j = 0; j < ROUNDS; j++) {
+              work();
+            }
+          }
+          catch (InterruptedException e) {
+          }
+        }
+      };
+      threads[i].start();
+    }
+    for (int i = 0; i < THREADS; i++) {
+      threads[i].join();
+    }
+    System.out.println("count: " + shared.count);
+
+    File file = new File("MonitorContention.txt");
+    System.out.println("written: "
+                       + Diagnostics.writeMonitorContention(file.getPath()));
+
+    BufferedReader in = new BufferedReader(new FileReader(file));
+    String line = in.readLine();
+    System.out.println("header: "
+                       + (line != null && line.startsWith("Contended monitors")));
+
+    // "   n: Class@addr: W waits, ..." followed by "      count  stack"
+    boolean found = false;
+    boolean waits = false;
+    boolean site = false;
+    while ((line = in.readLine()) != null) {
+      String trimmed = line.trim();
+      if (trimmed.length() > 0 && trimmed.indexOf('@') > 0
+          && trimmed.endsWith("at most")) {
+        found = trimmed.indexOf("MonitorContention$Shared@") >= 0;
+        if (found) {
+          int colon = trimmed.indexOf(": ", trimmed.indexOf('@'));
+          int end = trimmed.indexOf(" waits");
+          waits = Long.parseLong(trimmed.substring(colon + 2, end)) > 0;
+        }
+      }
+      else if (found && trimmed.indexOf("MonitorContention.work") >= 0) {
+        site = true;
+      }
+    }
+    in.close();
+    file.delete();
+
+    System.out.println("monitor listed: " + waits);
+    System.out.println("site listed: " + site);
+  }
+}
+
+/* Expected Output:
+count: 200
+written: true
+header: true
+monitor listed: true
+site listed: true
+*/
@@ -0,0 +1,60 @@
+import java.io.File;
+
+/**
+ * The natives built into the VM are bound in bulk from a table when
+ * the VM starts, those of the other libraries by looking up their
+ * symbols.  Call a few of either kind to make sure they still resolve.
+ */
+public class NativeBinding implements Cloneable {
+
+  int value = 42;
+
+  public static void main(String[] args) throws Exception {
+    NativeBinding nb = new NativeBinding();
+
+    // java.lang.VMObject
+    NativeBinding copy = (NativeBinding)nb.clone();
+    System.out.println("clone: " + (copy != nb) + " " + copy.value);
+    System.out.println("getClass: " + copy.getClass().getName());
+
+    // java.lang.VMSystem
+    int[] from = { 1, 2, 3 };
+    int[] to = new int[3];
+    System.arraycopy(from, 0, to, 0, 3);
+    System.out.println("arraycopy: " + to[0] + to[1] + to[2]);
+    System.out.println("identityHashCode: "
+                       + (System.identityHashCode(nb) == nb.hashCode()));
+
+    // java.lang.VMString
+    String s = new String("native");
+    System.out.println("intern: " + (s.intern() == "native"));
+
+    // java.lang.VMRuntime
+    System.out.println("totalMemory: " + (Runtime.getRuntime().totalMemory() > 0));
+
+    // java.lang.VMThread, java.lang.VMThrowable
+    System.out.println("currentThread: " + (Thread.currentThread() != null));
+    StackTraceElement[] trace = new Throwable().getStackTrace();
+    System.out.println("stack trace: " + trace[0].getMethodName());
+
+    // java.lang.VMClass, java.lang.reflect.Field
+    System.out.println("field: "
+                       + NativeBinding.class.getDeclaredField("value").getInt(nb));
+
+    // not built into the VM
+    System.out.println("file: " + new File(".").exists());
+  }
+}
+
+/* Expected Output:
+clone: true 42
+getClass: NativeBinding
+arraycopy: 123
+identityHashCode: true
+intern: true
+totalMemory: true
+currentThread: true
+stack trace: main
+field: 42
+file: true
+*/
@@ -0,0 +1,92 @@
+import java.lang.reflect.*;
+
+/**
+ * The VM caches the reflection objects of a class.  Make sure every
+ * caller still gets its own copies, also after the cache has been
+ * dropped by the garbage collector.
+ */
+public class ReflectCache {
+
+  public int pub;
+  private int priv;
+
+  public ReflectCache() {
+  }
+
+  private ReflectCache(int x) {
+  }
+
+  public void foo(int a, String b) {
+  }
+
+  private void bar() {
+  }
+
+  private static Method find(Method[] meth, String name) {
+    for (int i = 0; i < meth.length; i++) {
+      if (meth[i].getName().equals(name)) {
+        return meth[i];
+      }
+    }
+    return null;
+  }
+
+  private static void check(String what, boolean ok) {
+    System.out.println(what + ": " + (ok ? "ok" : "FAILED"));
+  }
+
+  public static void main(String[] args) throws Exception {
+    Class cls = ReflectCache.class;
+
+    for (int round = 0; round < 2; round++) {
+      Method[] m1 = cls.getDeclaredMethods();
+      Method[] m2 = cls.getDeclaredMethods();
+      Method foo1 = find(m1, "foo");
+      Method foo2 = find(m2, "foo");
+      Method bar1 = find(m1, "bar");
+      Method bar2 = find(m2, "bar");
+
+      check("methods", m1.length == 5 && m2.length == 5);
+      check("method copies", m1 != m2 && foo1 != foo2 && foo1.equals(foo2));
+      check("parameter types",
+            foo1.getParameterTypes() != foo2.getParameterTypes()
+            && foo1.getParameterTypes().length == 2
+            && foo1.getParameterTypes()[1] == String.class);
+      bar1.setAccessible(true);
+      check("accessible", bar1.isAccessible() && !bar2.isAccessible());
+
+      Constructor[] c1 = cls.getDeclaredConstructors();
+      Constructor[] c2 = cls.getConstructors();
+      check("constructors", c1.length == 2 && c2.length == 1
+            && c2[0].getParameterTypes().length == 0);
+
+      Field[] f1 = cls.getDeclaredFields();
+      Field[] f2 = cls.getDeclaredFields();
+      check("fields", f1.length == 2 && f1[0] != f2[0] && f1[0].equals(f2[0]));
+      check("public fields", cls.getFields().length == 1);
+
+      /* Give the collector a chance to drop the cache. */
+      m1 = m2 = null;
+      for (int i = 0; i < 8; i++) {
+        System.gc();
+      }
+    }
+  }
+}
+
+/* Expected Output:
+methods: ok
+method copies: ok
+parameter types: ok
+accessible: ok
+constructors: ok
+fields: ok
+public fields: ok
+methods: ok
+method copies: ok
+parameter types: ok
+accessible: ok
+constructors: ok
+fields: ok
+public fields: ok
+*/
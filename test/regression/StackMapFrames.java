@@ -0,0 +1,294 @@
+import java.io.BufferedReader;
+import java.io.ByteArrayOutputStream;
+import java.io.DataOutputStream;
+import java.io.IOException;
+import java.io.InputStreamReader;
+import java.lang.reflect.InvocationTargetException;
+import java.util.StringTokenizer;
+
+/**
+ * Version 50 class files carry a StackMapTable the verifier checks each
+ * method against in one pass.  When a table doesn't fit its code the
+ * types are inferred instead, so a method with bad frames but good code
+ * still verifies and one with bad code is still rejected.  Older class
+ * files have their table ignored.
+ *
+ * Each case defines one class assembled here and calls its method m in
+ * a copy of the VM, whose verify statistics tell how many methods were
+ * checked against their frames and how many fell back.  Only classes
+ * not loaded by the bootstrap loader are verified, and a run defining
+ * no class gives the counts for this one.
+ */
+public class StackMapFrames {
+
+  static final String[] CASES = {
+    "good", "uninit", "nogoto", "badlocal", "baduninit", "badcode", "old"
+  };
+
+  /* Constant pool indices, see classFile */
+  static final int OBJECT = 4;
+  static final int OBJECT_INIT = 12;
+
+  /*
+   * int m(int x) { return x != 0 ? 1 : 2; }
+   *
+   *  0: iload_0
+   *  1: ifeq 8
+   *  4: iconst_1
+   *  5: goto 9
+   *  8: iconst_2
+   *  9: ireturn
+   */
+  static final byte[] CHOOSE = {
+    0x1a, (byte)0x99, 0, 7, 0x04, (byte)0xa7, 0, 4, 0x05, (byte)0xac
+  };
+
+  /* The same with a float on one way to ireturn */
+  static final byte[] CHOOSE_FLOAT = {
+    0x1a, (byte)0x99, 0, 7, 0x04, (byte)0xa7, 0, 4, 0x0c, (byte)0xac
+  };
+
+  /* Frames at 8, same as the start, and 9, an int on the stack */
+  static final byte[] CHOOSE_FRAMES = { 0, 2, 8, 64, 1 };
+
+  /* The frame after the goto left out */
+  static final byte[] CHOOSE_NO_GOTO_FRAME = { 0, 1, 64 + 9, 1 };
+
+  /* A float local at 8, where an int comes in */
+  static final byte[] CHOOSE_FLOAT_LOCAL = {
+    0, 2, (byte)255, 0, 8, 0, 1, 2, 0, 0, 64, 1
+  };
+
+  /*
+   * Object m(int x) { return new Object(); } with a branch while the
+   * new object is on the stack.
+   *
+   *  0: new Object
+   *  3: iload_0
+   *  4: ifeq 7
+   *  7: dup
+   *  8: invokespecial Object.<init>
+   * 11: areturn
+   */
+  static final byte[] CREATE = {
+    (byte)0xbb, 0, OBJECT, 0x1a, (byte)0x99, 0, 3, 0x59,
+    (byte)0xb7, 0, OBJECT_INIT, (byte)0xb0
+  };
+
+  /* A frame at 7 with the object created at 0 on the stack */
+  static final byte[] CREATE_FRAMES = { 0, 1, 64 + 7, 8, 0, 0 };
+
+  /* The same frame naming the iload_0 at 3 as the new */
+  static final byte[] CREATE_BAD_OFFSET = { 0, 1, 64 + 7, 8, 0, 3 };
+
+  /* Not a table at all */
+  static final byte[] GARBAGE = { 0, 5, (byte)0xff };
+
+  public static void main(String[] args) throws Exception {
+    if (args.length > 1) {
+      // child
+      child(args[1]);
+      return;
+    }
+
+    // parent
+    int[] base = run(args[0], "none");
+    for (int i = 0; i < CASES.length; i++) {
+      int[] counts = run(args[0], CASES[i]);
+      System.out.println(CASES[i] + ": checked " + (counts[0] - base[0])
+                         + ", fell back " + (counts[1] - base[1]));
+    }
+  }
+
+  static class Loader extends ClassLoader {
+    Class define(String name, byte[] b) {
+      return defineClass(name, b, 0, b.length);
+    }
+  }
+
+  static void child(String which) throws Exception {
+    Loader loader = new Loader();
+    byte[] b;
+
+    if (which.equals("good")) {
+      b = classFile(50, which, "(I)I", 1, 1, CHOOSE, CHOOSE_FRAMES);
+    }
+    else if (which.equals("uninit")) {
+      b = classFile(50, which, "(I)Ljava/lang/Object;", 2, 1, CREATE,
+                    CREATE_FRAMES);
+    }
+    else if (which.equals("nogoto")) {
+      b = classFile(50, which, "(I)I", 1, 1, CHOOSE,
+                    CHOOSE_NO_GOTO_FRAME);
+    }
+    else if (which.equals("badlocal")) {
+      b = classFile(50, which, "(I)I", 1, 1, CHOOSE,
+                    CHOOSE_FLOAT_LOCAL);
+    }
+    else if (which.equals("baduninit")) {
+      b = classFile(50, which, "(I)Ljava/lang/Object;", 2, 1, CREATE,
+                    CREATE_BAD_OFFSET);
+    }
+    else if (which.equals("badcode")) {
+      b = classFile(50, which, "(I)I", 1, 1, CHOOSE_FLOAT,
+                    CHOOSE_FRAMES);
+    }
+    else if (which.equals("old")) {
+      b = classFile(49, which, "(I)I", 1, 1, CHOOSE, GARBAGE);
+    }
+    else {
+      System.out.println(which);
+      return;
+    }
+
+    try {
+      Class c = loader.define(which, b);
+      Object r0 = c.getMethod("m", new Class[] { int.class })
+        .invoke(null, new Object[] { new Integer(0) });
+      Object r1 = c.getMethod("m", new Class[] { int.class })
+        .invoke(null, new Object[] { new Integer(1) });
+      System.out.println(which + " " + (r0 instanceof Integer ? r0 : "obj")
+                         + " " + (r1 instanceof Integer ? r1 : "obj"));
+    }
+    catch (InvocationTargetException e) {
+      System.out.println(which + " "
+                         + e.getTargetException().getClass().getName());
+    }
+    catch (LinkageError e) {
+      System.out.println(which + " " + e.getClass().getName());
+    }
+  }
+
+  /*
+   * Run a child on one case with the verify statistics on.  Return how
+   * many methods were checked against their frames and how many fell
+   * back, after printing what the child printed.
+   */
+  static int[] run(String java, String which) throws Exception {
+    Process p = Runtime.getRuntime().exec(new String[] {
+      java, "-verifyremote", "-vmstats", "verify",
+      "StackMapFrames", "-child", which
+    });
+
+    BufferedReader out = new BufferedReader(
+      new InputStreamReader(p.getInputStream()));
+    String line;
+    while ((line = out.readLine()) != null) {
+      if (!line.equals("none")) {
+        System.out.println(line);
+      }
+    }
+    out.close();
+
+    int[] counts = new int[2];
+    BufferedReader err = new BufferedReader(
+      new InputStreamReader(p.getErrorStream()));
+    while ((line = err.readLine()) != null) {
+      StringTokenizer st = new StringTokenizer(line);
+      if (st.countTokens() != 2) {
+        continue;
+      }
+      String name = st.nextToken();
+      if (name.equals("verify-stackmap")) {
+        counts[0] = Integer.parseInt(st.nextToken());
+      }
+      else if (name.equals("verify-fallback")) {
+        counts[1] = Integer.parseInt(st.nextToken());
+      }
+    }
+    err.close();
+
+    if (p.waitFor() != 0) {
+      System.out.println(which + " exit " + p.exitValue());
+    }
+    return counts;
+  }
+
+  /*
+   * A public class called name with one public static method m of
+   * signature sig and the given code and StackMapTable.
+   */
+  static byte[] classFile(int major, String name, String sig,
+                          int maxStack, int maxLocals,
+                          byte[] code, byte[] frames) throws IOException {
+    ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+    DataOutputStream out = new DataOutputStream(bytes);
+
+    out.writeInt(0xcafebabe);
+    out.writeShort(0);
+    out.writeShort(major);
+
+    out.writeShort(13);
+    utf8(out, name);                    // 1
+    classRef(out, 1);                   // 2
+    utf8(out, "java/lang/Object");      // 3
+    classRef(out, 3);                   // 4 OBJECT
+    utf8(out, "Code");                  // 5
+    utf8(out, "StackMapTable");         // 6
+    utf8(out, "m");                     // 7
+    utf8(out, sig);                     // 8
+    utf8(out, "<init>");                // 9
+    utf8(out, "()V");                   // 10
+    out.writeByte(12);                  // 11 NameAndType
+    out.writeShort(9);
+    out.writeShort(10);
+    out.writeByte(10);                  // 12 OBJECT_INIT
+    out.writeShort(OBJECT);
+    out.writeShort(11);
+
+    out.writeShort(0x21);               // public super
+    out.writeShort(2);
+    out.writeShort(OBJECT);
+    out.writeShort(0);                  // interfaces
+    out.writeShort(0);                  // fields
+
+    out.writeShort(1);
+    out.writeShort(0x09);               // public static
+    out.writeShort(7);
+    out.writeShort(8);
+    out.writeShort(1);
+    out.writeShort(5);
+    out.writeInt(12 + code.length + 6 + frames.length);
+    out.writeShort(maxStack);
+    out.writeShort(maxLocals);
+    out.writeInt(code.length);
+    out.write(code);
+    out.writeShort(0);                  // exception table
+    out.writeShort(1);
+    out.writeShort(6);
+    out.writeInt(frames.length);
+    out.write(frames);
+
+    out.writeShort(0);                  // class attributes
+    out.close();
+    return bytes.toByteArray();
+  }
+
+  static void utf8(DataOutputStream out, String s) throws IOException {
+    out.writeByte(1);
+    out.writeUTF(s);
+  }
+
+  static void classRef(DataOutputStream out, int name) throws IOException {
+    out.writeByte(7);
+    out.writeShort(name);
+  }
+}
+
+// java args: StackMapFrames $JAVA
+/* Expected Output:
+good 2 1
+good: checked 1, fell back 0
+uninit obj obj
+uninit: checked 1, fell back 0
+nogoto 2 1
+nogoto: checked 0, fell back 1
+badlocal 2 1
+badlocal: checked 0, fell back 1
+baduninit obj obj
+baduninit: checked 0, fell back 1
+badcode java.lang.VerifyError
+badcode: checked 0, fell back 1
+old 2 1
+old: checked 0, fell back 0
+*/
@@ -0,0 +1,76 @@
+import gnu.classpath.VMStackWalker;
+import java.lang.reflect.Method;
+import java.security.AccessControlContext;
+import java.security.AccessController;
+import java.security.PrivilegedAction;
+
+/**
+ * The natives that find the caller of a method only walk the frames they
+ * need.  Check they skip the frames they should: the callee's own
+ * recursion and reflection.
+ */
+public class StackWalk {
+
+  static class Callee {
+    static Class who() {
+      return VMStackWalker.getCallingClass();
+    }
+
+    static Class deep(int n) {
+      return n == 0 ? who() : deep(n - 1);
+    }
+
+    static ClassLoader loader() {
+      return VMStackWalker.getCallingClassLoader();
+    }
+
+    static Class[] context() {
+      return VMStackWalker.getClassContext();
+    }
+  }
+
+  static Object deepPrivileged(int n) {
+    if (n > 0) {
+      return deepPrivileged(n - 1);
+    }
+    return AccessController.doPrivileged(new PrivilegedAction() {
+      public Object run() {
+        return AccessController.getContext();
+      }
+    });
+  }
+
+  private static void check(String what, boolean ok) {
+    System.out.println(what + ": " + (ok ? "ok" : "FAILED"));
+  }
+
+  public static void main(String[] args) throws Exception {
+    check("direct caller", Callee.who() == StackWalk.class);
+    check("recursive callee", Callee.deep(100) == StackWalk.class);
+
+    Method m = Callee.class.getDeclaredMethod("who", new Class[0]);
+    check("through reflection", m.invoke(null, new Object[0]) == StackWalk.class);
+
+    check("calling loader",
+          Callee.loader() == StackWalk.class.getClassLoader());
+
+    Class[] ctx = Callee.context();
+    check("class context", ctx.length > 0 && ctx[0] == StackWalk.class);
+
+    Object o = Class.forName("StackWalk$Callee");
+    check("forName", o == Callee.class);
+
+    check("privileged context",
+          deepPrivileged(100) instanceof AccessControlContext);
+  }
+}
+
+/* Expected Output:
+direct caller: ok
+recursive callee: ok
+through reflection: ok
+calling loader: ok
+class context: ok
+forName: ok
+privileged context: ok
+*/
@@ -0,0 +1,103 @@
+import java.io.File;
+import java.io.FileReader;
+import java.io.Reader;
+
+/**
+ * Run a copy of the VM with -Xstarttrace and check the trace it writes
+ * at exit.  It must be a JSON object in the Chrome trace format: a list
+ * of events, complete ones for the phases of startup and one per class
+ * path entry, followed by the display unit.
+ */
+public class StartupTrace {
+
+  public static void main(String[] args) throws Exception {
+    if (args.length > 1) {
+      // child
+      System.out.println("started");
+      return;
+    }
+
+    // parent
+    File trace = new File("StartupTrace.json");
+    trace.delete();
+    Process p = Runtime.getRuntime().exec(new String[] {
+      args[0], "-Xstarttrace", trace.getPath(),
+      "StartupTrace", "-child", "x"
+    });
+    System.out.println("exit: " + p.waitFor());
+    System.out.println("written: " + trace.exists());
+
+    StringBuffer buf = new StringBuffer();
+    Reader in = new FileReader(trace);
+    char[] chunk = new char[4096];
+    int n;
+    while ((n = in.read(chunk)) > 0) {
+      buf.append(chunk, 0, n);
+    }
+    in.close();
+    trace.delete();
+    String json = buf.toString();
+
+    System.out.println("starts: " + json.startsWith("{\"traceEvents\": ["));
+    System.out.println("balanced: " + balanced(json));
+    System.out.println("unit: "
+                       + (json.indexOf("\"displayTimeUnit\": \"ms\"") >= 0));
+    System.out.println("complete events: "
+                       + (json.indexOf("\"ph\": \"X\"") >= 0));
+    System.out.println("class path: "
+                       + (json.indexOf("\"cat\": \"classpath\"") >= 0));
+  }
+
+  /*
+   * Braces and brackets outside of strings must nest, and the whole
+   * text must be a single object.
+   */
+  static boolean balanced(String json) {
+    StringBuffer open = new StringBuffer();
+    boolean inString = false;
+    for (int i = 0; i < json.length(); i++) {
+      char c = json.charAt(i);
+      if (inString) {
+        if (c == '\\') {
+          i++;
+        }
+        else if (c == '"') {
+          inString = false;
+        }
+        continue;
+      }
+      switch (c) {
+      case '"':
+        inString = true;
+        break;
+      case '{':
+      case '[':
+        open.append(c);
+        break;
+      case '}':
+      case ']':
+        int top = open.length() - 1;
+        if (top < 0 || open.charAt(top) != (c == '}' ? '{' : '[')) {
+          return false;
+        }
+        open.setLength(top);
+        if (top == 0 && json.substring(i + 1).trim().length() != 0) {
+          return false;
+        }
+        break;
+      }
+    }
+    return !inString && open.length() == 0;
+  }
+}
+
+// java args: StartupTrace $JAVA
+/* Expected Output:
+exit: 0
+written: true
+starts: true
+balanced: true
+unit: true
+complete events: true
+class path: true
+*/